@@ -0,0 +1,97 @@
+// clang-format off
+/*
+** Copyright 2021 Robotic Systems Lab - ETH Zurich:
+** Linghao Zhang, Jonas Junger, Lennart Nachtigall
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions are met:
+**
+** 1. Redistributions of source code must retain the above copyright notice,
+**    this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright notice,
+**    this list of conditions and the following disclaimer in the documentation
+**    and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its contributors
+**    may be used to endorse or promote products derived from this software without
+**    specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+** AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+** IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+** DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+** FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+** DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+** SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+** CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+** OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+// clang-format on
+
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <ethercat_sdk_master/EthercatDevice.hpp>
+
+namespace maxon {
+/*!
+ * @brief	EtherCAT bus without hardware
+ * The process image of every slave is backed by plain buffers, such that
+ * readTxPdo / writeRxPdo only copy memory. The bus is never started, SDOs
+ * are therefore not available.
+ */
+class FakeEthercatBus : public soem_interface::EthercatBusBase {
+ public:
+  FakeEthercatBus() : soem_interface::EthercatBusBase("fake") {}
+
+  /*!
+   * Give a slave a process image of the given sizes.
+   * @param[in] address	the address of the slave (starting at 1)
+   * @param[in] rxPdoSize	size of the Rx PDO in bytes
+   * @param[in] txPdoSize	size of the Tx PDO in bytes
+   */
+  void addSlave(uint16_t address, uint16_t rxPdoSize, uint16_t txPdoSize) {
+    auto& processImage = processImages_[address];
+    processImage.first.assign(rxPdoSize, 0);
+    processImage.second.assign(txPdoSize, 0);
+    ecatContext_.slavelist[address].outputs = processImage.first.data();
+    ecatContext_.slavelist[address].Obytes = rxPdoSize;
+    ecatContext_.slavelist[address].inputs = processImage.second.data();
+    ecatContext_.slavelist[address].Ibytes = txPdoSize;
+    if (*ecatContext_.slavecount < address) {
+      *ecatContext_.slavecount = address;
+    }
+  }
+
+  // the process image of a slave, see Maxon::bindProcessImage()
+  uint8_t* getRxPdo(uint16_t address) {
+    return processImages_.at(address).first.data();
+  }
+  const uint8_t* getTxPdo(uint16_t address) const {
+    return processImages_.at(address).second.data();
+  }
+
+  /*!
+   * Set the statusword the slave replies with. All Tx PDOs of the SDK start
+   * with the statusword.
+   */
+  void setStatusword(uint16_t address, uint16_t statusword) {
+    std::memcpy(processImages_.at(address).second.data(), &statusword,
+                sizeof(statusword));
+  }
+
+ private:
+  // address -> {Rx PDO, Tx PDO}
+  std::map<uint16_t, std::pair<std::vector<uint8_t>, std::vector<uint8_t>>>
+      processImages_;
+};
+
+}  // namespace maxon
@@ -0,0 +1,517 @@
+// clang-format off
+/*
+** Copyright 2021 Robotic Systems Lab - ETH Zurich:
+** Linghao Zhang, Jonas Junger, Lennart Nachtigall
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions are met:
+**
+** 1. Redistributions of source code must retain the above copyright notice,
+**    this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright notice,
+**    this list of conditions and the following disclaimer in the documentation
+**    and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its contributors
+**    may be used to endorse or promote products derived from this software without
+**    specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+** AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+** IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+** DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+** FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+** DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+** SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+** CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+** OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+// clang-format on
+
+/*!
+ * Benchmarks of the cyclic hot path of the SDK, without hardware.
+ * Every benchmark reports the time per call and the number of heap
+ * allocations per call ("allocs/op").
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <future>
+#include <memory>
+#include <new>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "FakeEthercatBus.hpp"
+#include "maxon_epos_ethercat_sdk/BusExecutor.hpp"
+#include "maxon_epos_ethercat_sdk/Maxon.hpp"
+#include "maxon_epos_ethercat_sdk/MaxonGroup.hpp"
+#include "maxon_epos_ethercat_sdk/VirtualEpos4Bus.hpp"
+
+#ifdef MAXON_EPOS_ETHERCAT_SDK_RT_AUDIT_ALLOCATIONS
+#error "The benchmarks replace the global operator new, which the library " \
+    "already does with RT_AUDIT_ALLOCATIONS."
+#endif
+
+namespace {
+std::atomic<uint64_t> numberOfAllocations{0};
+}  // namespace
+
+// the replacements are not inlined such that the compiler does not mistake
+// the matching malloc / free for a mismatched new / free
+__attribute__((noinline)) void* operator new(std::size_t size) {
+  numberOfAllocations.fetch_add(1, std::memory_order_relaxed);
+  maxon::rt_audit::recordAllocation();
+  if (void* pointer = std::malloc(size)) {
+    return pointer;
+  }
+  throw std::bad_alloc();
+}
+__attribute__((noinline)) void operator delete(void* pointer) noexcept {
+  std::free(pointer);
+}
+__attribute__((noinline)) void operator delete(void* pointer,
+                                               std::size_t) noexcept {
+  std::free(pointer);
+}
+
+namespace maxon {
+namespace {
+constexpr uint16_t address = 1;
+constexpr uint16_t statuswordSwitchOnDisabled = 0x0040;
+
+/*!
+ * Exposes the internals which are needed to attach the drive to the fake bus
+ * and to drive the state machine directly.
+ */
+class BenchmarkMaxon : public Maxon {
+ public:
+  explicit BenchmarkMaxon(uint16_t slaveAddress = address)
+      : Maxon("benchmark", slaveAddress) {}
+  using Maxon::engagePdoStateMachine;
+  uint16_t getRxPdoSizeInBytes() const { return rxPdoSize_; }
+  uint16_t getTxPdoSizeInBytes() const { return txPdoSize_; }
+};
+
+// the PDO types which are benchmarked, selected by the benchmark argument
+struct PdoTypeCase {
+  const char* name_;
+  std::vector<ModeOfOperationEnum> modesOfOperation_;
+  std::vector<std::string> customRxPdo_;
+  std::vector<std::string> customTxPdo_;
+};
+
+const std::vector<PdoTypeCase>& getPdoTypeCases() {
+  static const std::vector<PdoTypeCase> pdoTypeCases = {
+      {"CSP", {ModeOfOperationEnum::CyclicSynchronousPositionMode}, {}, {}},
+      {"CST", {ModeOfOperationEnum::CyclicSynchronousTorqueMode}, {}, {}},
+      {"CSV", {ModeOfOperationEnum::CyclicSynchronousVelocityMode}, {}, {}},
+      {"CSTCSP",
+       {ModeOfOperationEnum::CyclicSynchronousTorqueMode,
+        ModeOfOperationEnum::CyclicSynchronousPositionMode},
+       {},
+       {}},
+      {"CSTCSPCSV",
+       {ModeOfOperationEnum::CyclicSynchronousTorqueMode,
+        ModeOfOperationEnum::CyclicSynchronousPositionMode,
+        ModeOfOperationEnum::CyclicSynchronousVelocityMode},
+       {},
+       {}},
+      {"PVM", {ModeOfOperationEnum::ProfiledVelocityMode}, {}, {}},
+      {"Custom",
+       {ModeOfOperationEnum::CyclicSynchronousTorqueMode},
+       {"controlword", "mode_of_operation", "target_torque"},
+       {"statusword", "position_actual", "velocity_actual", "torque_actual"}},
+  };
+  return pdoTypeCases;
+}
+
+Configuration getConfiguration(const PdoTypeCase& pdoTypeCase) {
+  Configuration configuration;
+  configuration.modesOfOperation = pdoTypeCase.modesOfOperation_;
+  configuration.customRxPdo = pdoTypeCase.customRxPdo_;
+  configuration.customTxPdo = pdoTypeCase.customTxPdo_;
+  configuration.positionEncoderResolution = 4096;
+  configuration.nominalCurrentA = 1.0;
+  configuration.torqueConstantNmA = 0.1;
+  configuration.maxCurrentA = 2.0;
+  configuration.speedConstant = 100.0;
+  configuration.maxProfileVelocity = 10000;
+  configuration.driveStateChangeMinTimeout = 0;
+  return configuration;
+}
+
+// a drive which is attached to the fake bus and has read at least once
+class BenchmarkSetup {
+ public:
+  explicit BenchmarkSetup(const PdoTypeCase& pdoTypeCase) {
+    maxon_.loadConfiguration(getConfiguration(pdoTypeCase));
+    bus_.addSlave(address, maxon_.getRxPdoSizeInBytes(),
+                  maxon_.getTxPdoSizeInBytes());
+    bus_.setStatusword(address, statuswordSwitchOnDisabled);
+    maxon_.setEthercatBusBasePointer(&bus_);
+    maxon_.setTimeStep(0.001);
+    maxon_.updateRead();
+  }
+
+  FakeEthercatBus bus_;
+  BenchmarkMaxon maxon_;
+};
+
+Command getCommand(const PdoTypeCase& pdoTypeCase) {
+  Command command;
+  command.setModeOfOperation(pdoTypeCase.modesOfOperation_[0]);
+  command.setTargetPosition(1.0);
+  command.setTargetVelocity(2.0);
+  command.setTargetTorque(0.05);
+  return command;
+}
+
+/*!
+ * Run the benchmark loop and report the heap allocations per iteration.
+ */
+template <typename Function>
+void runBenchmark(benchmark::State& state, Function&& function) {
+  const uint64_t allocationsBefore = numberOfAllocations.load();
+  for (auto _ : state) {
+    function();
+  }
+  state.counters["allocs/op"] =
+      benchmark::Counter(numberOfAllocations.load() - allocationsBefore,
+                         benchmark::Counter::kAvgIterations);
+}
+
+// the second argument selects direct access to the process image
+void bindProcessImage(benchmark::State& state, BenchmarkSetup& setup) {
+  const PdoTypeCase& pdoTypeCase = getPdoTypeCases()[state.range(0)];
+  if (state.range(1) == 0) {
+    state.SetLabel(pdoTypeCase.name_);
+    return;
+  }
+  state.SetLabel(std::string(pdoTypeCase.name_) + " process image");
+  setup.maxon_.bindProcessImage(
+      setup.bus_.getRxPdo(address), setup.maxon_.getRxPdoSizeInBytes(),
+      setup.bus_.getTxPdo(address), setup.maxon_.getTxPdoSizeInBytes());
+}
+
+void benchmarkUpdateWrite(benchmark::State& state) {
+  const PdoTypeCase& pdoTypeCase = getPdoTypeCases()[state.range(0)];
+  BenchmarkSetup setup(pdoTypeCase);
+  bindProcessImage(state, setup);
+  setup.maxon_.stageCommand(getCommand(pdoTypeCase));
+  runBenchmark(state, [&]() { setup.maxon_.updateWrite(); });
+}
+
+void benchmarkUpdateRead(benchmark::State& state) {
+  BenchmarkSetup setup(getPdoTypeCases()[state.range(0)]);
+  bindProcessImage(state, setup);
+  runBenchmark(state, [&]() { setup.maxon_.updateRead(); });
+}
+
+// one cycle, with the argument set the PDOs are recorded to a file
+void benchmarkUpdateCycle(benchmark::State& state) {
+  const PdoTypeCase& pdoTypeCase = getPdoTypeCases().front();
+  BenchmarkSetup setup(pdoTypeCase);
+  setup.maxon_.stageCommand(getCommand(pdoTypeCase));
+  auto recorder = std::make_shared<TelemetryRecorder>(
+      "/tmp/maxon_benchmark_telemetry", 16 << 20, 2);
+  if (state.range(0) != 0) {
+    state.SetLabel("telemetry");
+    setup.maxon_.setTelemetryRecorder(recorder);
+    recorder->start();
+  }
+  runBenchmark(state, [&]() {
+    setup.maxon_.updateRead();
+    setup.maxon_.updateWrite();
+  });
+  recorder->stop();
+  state.counters["dropped"] = recorder->getNumberOfDroppedRecords();
+}
+
+// one audited cycle, aborts on the first real-time violation
+void benchmarkUpdateCycleAudited(benchmark::State& state) {
+  const PdoTypeCase& pdoTypeCase = getPdoTypeCases().front();
+  BenchmarkSetup setup(pdoTypeCase);
+  setup.maxon_.stageCommand(getCommand(pdoTypeCase));
+  auto audit = std::make_shared<RtAudit>();
+  audit->setViolationHandler(&RtAudit::abortOnViolation);
+  setup.maxon_.setRtAudit(audit);
+  runBenchmark(state, [&]() {
+    setup.maxon_.updateRead();
+    setup.maxon_.updateWrite();
+  });
+  const RtAuditStatistics statistics = audit->getStatistics();
+  state.counters["locks/cycle"] =
+      statistics.maxPerCycle_[static_cast<std::size_t>(
+          RtAuditEventType::Lock)];
+}
+
+void benchmarkStageCommand(benchmark::State& state) {
+  const PdoTypeCase& pdoTypeCase = getPdoTypeCases().front();
+  BenchmarkSetup setup(pdoTypeCase);
+  const Command command = getCommand(pdoTypeCase);
+  runBenchmark(state, [&]() { setup.maxon_.stageCommand(command); });
+}
+
+void benchmarkStageCsp(benchmark::State& state) {
+  BenchmarkSetup setup(getPdoTypeCases().front());
+  runBenchmark(state, [&]() { setup.maxon_.stageCsp(1.0, 0.1, 0.01); });
+}
+
+void benchmarkGetReading(benchmark::State& state) {
+  BenchmarkSetup setup(getPdoTypeCases().front());
+  // the first call sizes the error and fault storage of the reading
+  Reading reading;
+  setup.maxon_.getReading(reading);
+  runBenchmark(state, [&]() {
+    setup.maxon_.getReading(reading);
+    benchmark::DoNotOptimize(reading);
+  });
+}
+
+void benchmarkGetReadingSnapshot(benchmark::State& state) {
+  BenchmarkSetup setup(getPdoTypeCases().front());
+  ReadingSnapshot snapshot;
+  runBenchmark(state, [&]() {
+    benchmark::DoNotOptimize(setup.maxon_.getReadingSnapshot(snapshot));
+  });
+}
+
+// the statusword is decoded once when it is set, the getter only loads it
+void benchmarkReadingGetDriveState(benchmark::State& state) {
+  Reading reading;
+  reading.setStatusword(0x0637);
+  runBenchmark(state,
+               [&]() { benchmark::DoNotOptimize(reading.getDriveState()); });
+}
+
+void benchmarkReadingAddError(benchmark::State& state) {
+  Configuration configuration = getConfiguration(getPdoTypeCases().front());
+  configuration.errorStorageCapacity = 100;
+  Reading reading;
+  reading.configureReading(configuration);
+  // fill the storage such that every new error overwrites the oldest one
+  for (unsigned int i = 0; i < configuration.errorStorageCapacity; i++) {
+    reading.addError(ErrorType::PdoMappingError);
+  }
+  runBenchmark(state,
+               [&]() { reading.addError(ErrorType::PdoMappingError); });
+}
+
+void benchmarkEngagePdoStateMachine(benchmark::State& state) {
+  BenchmarkSetup setup(getPdoTypeCases().front());
+  // the fake drive never leaves SwitchOnDisabled, such that every call
+  // computes the next controlword
+  setup.maxon_.setDriveStateViaPdo(DriveState::OperationEnabled, false);
+  runBenchmark(state, [&]() { setup.maxon_.engagePdoStateMachine(); });
+}
+
+constexpr size_t numberOfGroupDrives = 18;
+
+// drives of a group, each of them attached to the same fake bus
+class GroupBenchmarkSetup {
+ public:
+  GroupBenchmarkSetup() {
+    const PdoTypeCase& pdoTypeCase = getPdoTypeCases().front();
+    std::vector<Maxon::SharedPtr> drives;
+    for (uint16_t i = 1; i <= numberOfGroupDrives; i++) {
+      auto drive = std::make_shared<BenchmarkMaxon>(i);
+      drive->loadConfiguration(getConfiguration(pdoTypeCase));
+      bus_.addSlave(i, drive->getRxPdoSizeInBytes(),
+                    drive->getTxPdoSizeInBytes());
+      drive->setEthercatBusBasePointer(&bus_);
+      drive->updateRead();
+      drives.push_back(drive);
+    }
+    group_.reset(new MaxonGroup(drives));
+    command_.resize(numberOfGroupDrives);
+    for (size_t i = 0; i < numberOfGroupDrives; i++) {
+      command_.modeOfOperation_[i] = pdoTypeCase.modesOfOperation_[0];
+      command_.targetPosition_[i] = 1.0;
+    }
+  }
+
+  FakeEthercatBus bus_;
+  std::unique_ptr<MaxonGroup> group_;
+  MaxonGroupCommand command_;
+};
+
+void benchmarkGroupStageCommands(benchmark::State& state) {
+  GroupBenchmarkSetup setup;
+  runBenchmark(state, [&]() { setup.group_->stageCommands(setup.command_); });
+}
+
+void benchmarkGroupGetReadings(benchmark::State& state) {
+  GroupBenchmarkSetup setup;
+  MaxonGroupReading reading;
+  setup.group_->getReadings(reading);
+  runBenchmark(state, [&]() { setup.group_->getReadings(reading); });
+}
+
+// drives on a bus of virtual EPOS4s
+class VirtualBusBenchmarkSetup {
+ public:
+  explicit VirtualBusBenchmarkSetup(
+      uint16_t numberOfDrives,
+      const VirtualEpos4Parameters& parameters = VirtualEpos4Parameters()) {
+    const PdoTypeCase& pdoTypeCase = getPdoTypeCases().front();
+    for (uint16_t i = 1; i <= numberOfDrives; i++) {
+      auto drive = std::make_shared<Maxon>("virtual", i);
+      drive->loadConfiguration(getConfiguration(pdoTypeCase));
+      drive->setTimeStep(0.001);
+      bus_.attach(*drive, parameters);
+      drives_.push_back(drive);
+    }
+  }
+
+  // start all drives and enable them via PDO
+  bool enable() {
+    bool success = Maxon::startupDrives(drives_);
+    for (const auto& drive : drives_) {
+      success &= drive->putIntoOperation();
+    }
+    auto stateChange =
+        Maxon::setDriveStatesViaPdoAsync(drives_, DriveState::OperationEnabled);
+    while (stateChange.wait_for(std::chrono::seconds(0)) !=
+           std::future_status::ready) {
+      cycle();
+    }
+    return success && stateChange.get();
+  }
+
+  void cycle() {
+    for (const auto& drive : drives_) {
+      drive->updateWrite();
+    }
+    bus_.update(0.001);
+    for (const auto& drive : drives_) {
+      drive->updateRead();
+    }
+  }
+
+  VirtualEpos4Bus bus_;
+  std::vector<Maxon::SharedPtr> drives_;
+};
+
+// one cycle of all drives of a virtual bus, in CSP
+void benchmarkVirtualBusCycle(benchmark::State& state) {
+  VirtualBusBenchmarkSetup setup(static_cast<uint16_t>(state.range(0)));
+  if (!setup.enable()) {
+    state.SkipWithError("the virtual drives could not be enabled");
+    return;
+  }
+  for (const auto& drive : setup.drives_) {
+    drive->stageCsp(1.0);
+  }
+  runBenchmark(state, [&]() { setup.cycle(); });
+  // simulated seconds per second, with a cycle time of 1 ms
+  state.counters["realtime"] = benchmark::Counter(
+      0.001 * state.iterations(), benchmark::Counter::kIsRate);
+}
+
+// startupDrives() of all drives of a virtual bus, with an SDO latency
+void benchmarkVirtualBusStartup(benchmark::State& state) {
+  VirtualEpos4Parameters parameters;
+  parameters.sdoLatency_ = 1e-6 * state.range(1);
+  std::unique_ptr<VirtualBusBenchmarkSetup> setup;
+  for (auto _ : state) {
+    state.PauseTiming();
+    setup.reset(new VirtualBusBenchmarkSetup(
+        static_cast<uint16_t>(state.range(0)), parameters));
+    state.ResumeTiming();
+    benchmark::DoNotOptimize(Maxon::startupDrives(setup->drives_));
+    state.PauseTiming();
+    setup.reset();
+    state.ResumeTiming();
+  }
+  state.SetLabel(std::to_string(state.range(1)) + " us SDO latency");
+}
+
+// back to back cycles of several virtual buses of 4 drives on a BusExecutor,
+// the cycles per bus stay constant as long as every bus has its own core
+void benchmarkBusExecutor(benchmark::State& state) {
+  const std::size_t numberOfBuses = static_cast<std::size_t>(state.range(0));
+  const unsigned int numberOfCpus = std::thread::hardware_concurrency();
+  std::vector<std::unique_ptr<VirtualBusBenchmarkSetup>> setups;
+  std::vector<std::unique_ptr<VirtualEpos4BusExchange>> exchanges;
+  BusExecutor executor;
+  for (std::size_t i = 0; i < numberOfBuses; i++) {
+    setups.emplace_back(new VirtualBusBenchmarkSetup(4));
+    if (!setups.back()->enable()) {
+      state.SkipWithError("the virtual drives could not be enabled");
+      return;
+    }
+    exchanges.emplace_back(
+        new VirtualEpos4BusExchange(&setups.back()->bus_, 0.001));
+    BusOptions options;
+    options.cpu_ = numberOfCpus > 0 ? static_cast<int>(i % numberOfCpus) : -1;
+    // free running SCHED_FIFO threads would starve the machine
+    options.priority_ = 0;
+    options.cycleTime_ = 0;
+    const std::size_t bus = executor.addBus(exchanges.back().get(), options);
+    for (const auto& drive : setups.back()->drives_) {
+      drive->stageCsp(1.0);
+      executor.addDrive(bus, drive);
+    }
+  }
+  executor.start();
+  for (auto _ : state) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  executor.stop();
+  uint64_t cycles = 0;
+  for (std::size_t i = 0; i < numberOfBuses; i++) {
+    cycles += executor.getStatistics(i).cycles_;
+  }
+  state.counters["cycles"] = benchmark::Counter(static_cast<double>(cycles),
+                                                benchmark::Counter::kIsRate);
+  state.counters["cycles_per_bus"] = benchmark::Counter(
+      static_cast<double>(cycles) / numberOfBuses,
+      benchmark::Counter::kIsRate);
+}
+
+void applyPdoTypeCases(benchmark::internal::Benchmark* benchmark) {
+  for (size_t i = 0; i < getPdoTypeCases().size(); i++) {
+    benchmark->Args({static_cast<int64_t>(i), 0});
+    benchmark->Args({static_cast<int64_t>(i), 1});
+  }
+}
+}  // namespace
+}  // namespace maxon
+
+BENCHMARK(maxon::benchmarkUpdateWrite)->Apply(maxon::applyPdoTypeCases);
+BENCHMARK(maxon::benchmarkUpdateRead)->Apply(maxon::applyPdoTypeCases);
+BENCHMARK(maxon::benchmarkUpdateCycle)->Arg(0)->Arg(1);
+BENCHMARK(maxon::benchmarkUpdateCycleAudited);
+BENCHMARK(maxon::benchmarkStageCommand);
+BENCHMARK(maxon::benchmarkStageCsp);
+BENCHMARK(maxon::benchmarkGetReading);
+BENCHMARK(maxon::benchmarkGetReadingSnapshot);
+BENCHMARK(maxon::benchmarkReadingGetDriveState);
+BENCHMARK(maxon::benchmarkReadingAddError);
+BENCHMARK(maxon::benchmarkEngagePdoStateMachine);
+BENCHMARK(maxon::benchmarkGroupStageCommands);
+BENCHMARK(maxon::benchmarkGroupGetReadings);
+BENCHMARK(maxon::benchmarkVirtualBusCycle)
+    ->Arg(1)
+    ->Arg(maxon::numberOfGroupDrives)
+    ->Arg(maxon::VirtualEpos4Bus::maxNumberOfDrives);
+BENCHMARK(maxon::benchmarkVirtualBusStartup)
+    ->Args({maxon::numberOfGroupDrives, 0})
+    ->Args({maxon::numberOfGroupDrives, 200})
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+BENCHMARK(maxon::benchmarkBusExecutor)
+    ->Arg(1)
+    ->Arg(2)
+    ->Arg(3)
+    ->UseRealTime();
+
+BENCHMARK_MAIN();
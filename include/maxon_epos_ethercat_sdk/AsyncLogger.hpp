@@ -0,0 +1,175 @@
+// clang-format off
+/*
+** Copyright 2021 Robotic Systems Lab - ETH Zurich:
+** Linghao Zhang, Jonas Junger, Lennart Nachtigall
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions are met:
+**
+** 1. Redistributions of source code must retain the above copyright notice,
+**    this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright notice,
+**    this list of conditions and the following disclaimer in the documentation
+**    and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its contributors
+**    may be used to endorse or promote products derived from this software without
+**    specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+** AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+** IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+** DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+** FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+** DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+** SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+** CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+** OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+// clang-format on
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <limits>
+#include <thread>
+
+#include "maxon_epos_ethercat_sdk/BoundedQueue.hpp"
+
+namespace maxon {
+/*!
+ * Events which may occur in the cyclic update. They are logged through the
+ * AsyncLogger, such that the EtherCAT thread never formats a message.
+ */
+enum class LogEventType : uint8_t {
+  ModeOfOperationNotSet,
+  // values: the mode of operation
+  ModeOfOperationNotAllowed,
+  RxPdoTypeNotSupported,
+  TxPdoTypeNotSupported,
+  FaultReactionActive,
+  Fault,
+  // values: the drive state
+  DriveStateAlreadyReached,
+  // values: the current and the requested drive state
+  StateTransitionNotImplemented,
+  // values: the LimitQuantity and the raw value
+  LimitViolation,
+  // not an event, the number of event types
+  NumberOfTypes
+};
+
+/*!
+ * Compact record of an event, the message is only built by the logging
+ * thread.
+ */
+struct LogEvent {
+  LogEventType type_{LogEventType::NumberOfTypes};
+  uint32_t address_{0};
+  // truncated copy of the device name, such that the event does not depend
+  // on the lifetime of the device
+  char deviceName_[32]{};
+  int64_t values_[2]{0, 0};
+  // equal events which were dropped by the rate limit before this one
+  uint32_t numberOfSuppressedEvents_{0};
+  std::chrono::steady_clock::time_point timePoint_;
+};
+
+/*!
+ * @brief	Rate limit of one event type of one device
+ * The first event passes, equal events within the interval are only
+ * counted. The count is reported with the next event which passes.
+ */
+class LogThrottle {
+ public:
+  /*!
+   * @param[in] now	the time of the event
+   * @param[in] interval	minimal time between two logged events
+   * @param[out] numberOfSuppressedEvents	events dropped since the last one
+   * @return	true if the event should be logged
+   */
+  bool pass(std::chrono::steady_clock::time_point now,
+            std::chrono::steady_clock::duration interval,
+            uint32_t& numberOfSuppressedEvents) {
+    const int64_t nowTicks = now.time_since_epoch().count();
+    const int64_t lastTicks = lastTicks_.load(std::memory_order_relaxed);
+    if (lastTicks != neverTicks_ && nowTicks - lastTicks < interval.count()) {
+      numberOfSuppressedEvents_.fetch_add(1, std::memory_order_relaxed);
+      return false;
+    }
+    lastTicks_.store(nowTicks, std::memory_order_relaxed);
+    numberOfSuppressedEvents =
+        numberOfSuppressedEvents_.exchange(0, std::memory_order_relaxed);
+    return true;
+  }
+
+ private:
+  static constexpr int64_t neverTicks_ = std::numeric_limits<int64_t>::min();
+  std::atomic<int64_t> lastTicks_{neverTicks_};
+  std::atomic<uint32_t> numberOfSuppressedEvents_{0};
+};
+
+/*!
+ * @brief	Logs events from the real-time threads in the background
+ * Pushing an event neither allocates nor locks. A background thread takes
+ * the events from a bounded lock-free queue, formats them and prints them
+ * with the message_logger. Events are dropped (and counted) if the queue is
+ * full.
+ */
+class AsyncLogger {
+ public:
+  static AsyncLogger& getInstance();
+  ~AsyncLogger();
+
+  AsyncLogger(const AsyncLogger&) = delete;
+  AsyncLogger& operator=(const AsyncLogger&) = delete;
+
+  /*!
+   * Queue an event, may be called from any thread.
+   * @return	false if the event was dropped
+   */
+  bool push(const LogEvent& event);
+
+  /*!
+   * Block until every event which was pushed before has been printed.
+   */
+  void flush();
+
+  uint64_t getNumberOfDroppedEvents() const {
+    return numberOfDroppedEvents_.load(std::memory_order_relaxed);
+  }
+
+  /*!
+   * Minimal time between two logged events of the same type and device.
+   */
+  std::chrono::steady_clock::duration getRateLimitInterval() const {
+    return std::chrono::steady_clock::duration(
+        rateLimitInterval_.load(std::memory_order_relaxed));
+  }
+  void setRateLimitInterval(std::chrono::steady_clock::duration interval) {
+    rateLimitInterval_.store(interval.count(), std::memory_order_relaxed);
+  }
+
+ private:
+  AsyncLogger();
+  void run();
+  // print all queued events, returns the number of printed events
+  unsigned int printEvents();
+  static void print(const LogEvent& event);
+
+  static constexpr std::size_t capacity_{1024};
+  BoundedQueue<LogEvent, capacity_> queue_;
+  std::atomic<uint64_t> numberOfPushedEvents_{0};
+  std::atomic<uint64_t> numberOfPrintedEvents_{0};
+  std::atomic<uint64_t> numberOfDroppedEvents_{0};
+  std::atomic<int64_t> rateLimitInterval_{
+      std::chrono::steady_clock::duration(std::chrono::seconds(1)).count()};
+  std::atomic<bool> running_{true};
+  std::thread thread_;
+};
+
+}  // namespace maxon
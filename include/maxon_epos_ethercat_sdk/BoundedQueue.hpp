@@ -0,0 +1,131 @@
+// clang-format off
+/*
+** Copyright 2021 Robotic Systems Lab - ETH Zurich:
+** Linghao Zhang, Jonas Junger, Lennart Nachtigall
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions are met:
+**
+** 1. Redistributions of source code must retain the above copyright notice,
+**    this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright notice,
+**    this list of conditions and the following disclaimer in the documentation
+**    and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its contributors
+**    may be used to endorse or promote products derived from this software without
+**    specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+** AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+** IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+** DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+** FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+** DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+** SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+** CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+** OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+// clang-format on
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace maxon {
+/*!
+ * @brief	Bounded multiple producer / multiple consumer queue
+ * Lock-free and allocation free: every cell carries a sequence number which
+ * tells producers and consumers whether it is free or holds a value.
+ * Pushing fails instead of blocking if the queue is full.
+ */
+template <typename T, std::size_t Capacity>
+class BoundedQueue {
+  static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0,
+                "The capacity of a BoundedQueue must be a power of two");
+
+ public:
+  BoundedQueue() {
+    for (std::size_t i = 0; i < Capacity; i++) {
+      cells_[i].sequence_.store(i, std::memory_order_relaxed);
+    }
+  }
+
+  /*!
+   * Add a value, may be called from any thread.
+   * @param[in] value	the value
+   * @return	false if the queue is full
+   */
+  bool tryPush(const T& value) {
+    Cell* cell;
+    std::size_t position = enqueuePosition_.load(std::memory_order_relaxed);
+    while (true) {
+      cell = &cells_[position & (Capacity - 1)];
+      const std::size_t sequence =
+          cell->sequence_.load(std::memory_order_acquire);
+      const auto difference = static_cast<std::intptr_t>(sequence) -
+                              static_cast<std::intptr_t>(position);
+      if (difference == 0) {
+        if (enqueuePosition_.compare_exchange_weak(
+                position, position + 1, std::memory_order_relaxed)) {
+          break;
+        }
+      } else if (difference < 0) {
+        return false;
+      } else {
+        position = enqueuePosition_.load(std::memory_order_relaxed);
+      }
+    }
+    cell->value_ = value;
+    cell->sequence_.store(position + 1, std::memory_order_release);
+    return true;
+  }
+
+  /*!
+   * Take the oldest value, may be called from any thread.
+   * @param[out] value	the value
+   * @return	false if the queue is empty
+   */
+  bool tryPop(T& value) {
+    Cell* cell;
+    std::size_t position = dequeuePosition_.load(std::memory_order_relaxed);
+    while (true) {
+      cell = &cells_[position & (Capacity - 1)];
+      const std::size_t sequence =
+          cell->sequence_.load(std::memory_order_acquire);
+      const auto difference = static_cast<std::intptr_t>(sequence) -
+                              static_cast<std::intptr_t>(position + 1);
+      if (difference == 0) {
+        if (dequeuePosition_.compare_exchange_weak(
+                position, position + 1, std::memory_order_relaxed)) {
+          break;
+        }
+      } else if (difference < 0) {
+        return false;
+      } else {
+        position = dequeuePosition_.load(std::memory_order_relaxed);
+      }
+    }
+    value = cell->value_;
+    cell->sequence_.store(position + Capacity, std::memory_order_release);
+    return true;
+  }
+
+ private:
+  struct Cell {
+    std::atomic<std::size_t> sequence_;
+    T value_;
+  };
+
+  std::array<Cell, Capacity> cells_;
+  // separate cache lines, such that producers and consumers do not contend
+  alignas(64) std::atomic<std::size_t> enqueuePosition_{0};
+  alignas(64) std::atomic<std::size_t> dequeuePosition_{0};
+};
+
+}  // namespace maxon
@@ -0,0 +1,180 @@
+// clang-format off
+/*
+** Copyright 2021 Robotic Systems Lab - ETH Zurich:
+** Linghao Zhang, Jonas Junger, Lennart Nachtigall
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions are met:
+**
+** 1. Redistributions of source code must retain the above copyright notice,
+**    this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright notice,
+**    this list of conditions and the following disclaimer in the documentation
+**    and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its contributors
+**    may be used to endorse or promote products derived from this software without
+**    specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+** AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+** IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+** DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+** FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+** DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+** SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+** CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+** OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+// clang-format on
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "maxon_epos_ethercat_sdk/Maxon.hpp"
+#include "maxon_epos_ethercat_sdk/ProcessDataExchange.hpp"
+#include "maxon_epos_ethercat_sdk/TimingStatistics.hpp"
+
+namespace maxon {
+/*!
+ * Thread of a bus of a BusExecutor.
+ */
+struct BusOptions {
+  // the core the thread is pinned to, -1 to not pin it
+  int cpu_{-1};
+  // SCHED_FIFO priority (1 to 99), 0 keeps the default scheduler
+  int priority_{80};
+  // 0 runs the cycles back to back, e.g. for benchmarks [s]
+  double cycleTime_{0.001};
+};
+
+/*!
+ * @brief	Runs the cyclic update of several buses on pinned threads
+ * Every bus gets its own thread which is pinned to a core and scheduled with
+ * SCHED_FIFO. A cycle of a bus receives the frame, calls updateRead() of the
+ * drives of the bus, the cycle callback and updateWrite() of the drives, and
+ * sends the frame. The bus threads share no locks, the user threads exchange
+ * data with them through the lock-free command and reading mailboxes of the
+ * drives (stageCommand(), getReadingSnapshot()).
+ * Drives which are created with createDrive() are allocated by the thread of
+ * their bus, the Linux first touch policy then places their readings,
+ * commands and PDO buffers on the NUMA node of its core.
+ */
+class BusExecutor {
+ public:
+  /*!
+   * Called by the thread of a bus between updateRead() and updateWrite() of
+   * its drives, must be real-time safe.
+   * @param[in] bus	the index of the bus
+   * @param[in] drives	the drives of the bus
+   */
+  typedef std::function<void(std::size_t bus,
+                             const std::vector<Maxon::SharedPtr>& drives)>
+      CycleCallback;
+
+  BusExecutor() = default;
+  /// stops the cycles and joins the bus threads
+  ~BusExecutor();
+
+  BusExecutor(const BusExecutor&) = delete;
+  BusExecutor& operator=(const BusExecutor&) = delete;
+
+  /*!
+   * Add a bus and start its thread, which idles until start(). Pinning and
+   * the real-time priority are best effort, a warning is logged if they are
+   * not permitted.
+   * @param[in] exchange	the process data exchange, must outlive the executor
+   * @param[in] callback	optional, see CycleCallback
+   * @return	the index of the bus
+   */
+  std::size_t addBus(ProcessDataExchange* exchange,
+                     const BusOptions& options = BusOptions(),
+                     CycleCallback callback = CycleCallback());
+
+  /*!
+   * Run a function on the thread of a bus and wait for it, e.g. to allocate
+   * data on the NUMA node of the bus. Not possible while running.
+   * @return	false if the bus does not exist or the executor is running
+   */
+  bool runOnBusThread(std::size_t bus, const std::function<void()>& function);
+
+  /*!
+   * Create a drive on the thread of a bus and add it to the bus.
+   * @param[in] factory	creates the drive, e.g. Maxon::deviceFromFile()
+   * @return	the drive, nullptr if it could not be added
+   */
+  Maxon::SharedPtr createDrive(
+      std::size_t bus, const std::function<Maxon::SharedPtr()>& factory);
+  /*!
+   * Add a drive to a bus, its cyclic update must not be called by anyone
+   * else. Not possible while running.
+   */
+  bool addDrive(std::size_t bus, const Maxon::SharedPtr& drive);
+
+  std::size_t getNumberOfBuses() const { return buses_.size(); }
+  const std::vector<Maxon::SharedPtr>& getDrives(std::size_t bus) const;
+
+  /// start the cycles of all buses
+  bool start();
+  /// stop the cycles and wait until the last cycle of every bus has finished
+  void stop();
+  bool isRunning() const { return running_; }
+
+  /// may be called from any thread
+  BusStatistics getStatistics(std::size_t bus) const;
+  void resetStatistics();
+
+ private:
+  // written by the thread of a bus only, allocated by it
+  struct CycleState {
+    LatencyHistogram cycleDuration_;
+    LatencyHistogram wakeupLatency_;
+    std::atomic<uint64_t> cycles_{0};
+    std::atomic<uint64_t> overruns_{0};
+  };
+
+  struct Bus {
+    std::size_t index_{0};
+    ProcessDataExchange* exchange_{nullptr};
+    BusOptions options_;
+    CycleCallback callback_;
+    std::vector<Maxon::SharedPtr> drives_;
+    std::unique_ptr<CycleState> cycleState_;
+    int cpu_{-1};
+    int numaNode_{-1};
+    bool realtime_{false};
+
+    std::mutex mutex_;
+    std::condition_variable condition_;
+    std::deque<std::function<void()>> tasks_;
+    // set by the thread once it is configured
+    bool ready_{false};
+    // the thread runs the cycles
+    bool cycling_{false};
+    bool quit_{false};
+    std::atomic<bool> running_{false};
+    std::thread thread_;
+  };
+
+  void run(Bus& bus);
+  void configureThread(Bus& bus);
+  void runCycles(Bus& bus);
+
+  std::vector<std::unique_ptr<Bus>> buses_;
+  bool running_{false};
+};
+
+}  // namespace maxon
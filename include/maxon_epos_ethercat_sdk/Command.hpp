@@ -37,20 +37,34 @@
 #include <cmath>
 #include <cstdint>
 #include <iostream>
-#include <mutex>
 #include <string>
 
 #include "maxon_epos_ethercat_sdk/ModeOfOperationEnum.hpp"
 
 namespace maxon {
+/*!
+ * The converted values of a Command, exactly as they are written to the Rx
+ * PDO. This is a trivially copyable type, such that it can be handed over to
+ * the EtherCAT thread without locking.
+ */
+struct RawCommand {
+  int32_t targetPosition_{0};
+  int32_t targetVelocity_{0};
+  int16_t targetTorque_{0};
+  int32_t positionOffset_{0};
+  int16_t torqueOffset_{0};
+  int32_t velocityOffset_{0};
+  uint32_t profileAccel_{0};
+  uint32_t profileDeccel_{0};
+  int16_t motionProfileType_{0};
+  ModeOfOperationEnum modeOfOperation_{ModeOfOperationEnum::NA};
+};
+
 class Command {
  public:
   Command() = default;
-  Command(const Command& other);
   virtual ~Command() = default;
 
-  Command& operator=(const Command& other);
-
   /*!
    * Set raw commands
    * This requires the "SET_USE_RAW_COMMANDS" variable of the config file to be
@@ -115,6 +129,9 @@ class Command {
   /// Convert the units
   void doUnitConversion();
 
+  /// get the raw values (after the unit conversion)
+  RawCommand getRawCommand() const;
+
   /// only works if commands in user units (A, Nm, rad/s,..) are used
   friend std::ostream& operator<<(std::ostream& os, Command& command);
 
@@ -138,12 +155,11 @@ class Command {
   uint32_t profileDeccel_{0};
   int16_t motionProfileType_{0};
 
-  std::mutex targetTorqueCommandMutex_;
-
   uint32_t digitalOutputs_{0};
 
   double positionFactorRadToInteger_{1};
-  const double velocityFactorRadPerSecToMicroRPM_{1.0 / (2 * M_PI) * 60 * 1e6};
+  static constexpr double velocityFactorRadPerSecToMicroRPM_ =
+      1.0 / (2 * M_PI) * 60 * 1e6;
   double torqueFactorNmToInteger_{1};
   double currentFactorAToInteger_{1};
 
@@ -34,6 +34,7 @@
 
 #include <cstdint>
 #include <iostream>
+#include <string>
 #include <utility>
 #include <vector>
 
@@ -49,6 +50,30 @@ class Configuration {
   unsigned int driveStateChangeMinTimeout{20000};
   unsigned int minNumberOfSuccessfulTargetStateReadings{10};
   unsigned int driveStateChangeMaxTimeout{300000};
+  /*!
+   * Write the next controlword of a PDO state change as soon as the
+   * statusword acknowledges the previous one and complete on the first
+   * reading of the target state. driveStateChangeMinTimeout is then only
+   * the time after which an unacknowledged controlword is repeated.
+   */
+  bool fastDriveStateChange{false};
+  /*!
+   * Period of the setpoints [us], written to the interpolation time period
+   * of the drive. 0: the time step of the EtherCAT master.
+   */
+  unsigned int cycleTime{0};
+  /// Synchronize the drive to SYNC0 of the distributed clock
+  bool useDistributedClock{false};
+  /// Shift of SYNC0 relative to the start of the cycle [us]
+  int distributedClockShift{0};
+  /*!
+   * Quick stop the drive from within the cyclic update as soon as the
+   * reading exceeds the position, velocity or current limits, see
+   * LimitGuard.
+   */
+  bool useLimitGuard{false};
+  /// Relative margin on the velocity and current limits of the guard
+  double limitGuardMargin{0.1};
   bool forceAppendEqualError{true};
   bool forceAppendEqualFault{false};
   unsigned int errorStorageCapacity{100};
@@ -76,6 +101,24 @@ class Configuration {
   double positionDGainSI{0.016};
   double velocityPGainSI{0.02};
   double velocityIGainSI{0.5};
+  /*!
+   * Directory in which the fingerprints of the configured drives are cached.
+   * Empty: always configure the drives.
+   */
+  std::string configurationCacheDirectory{""};
+  /*!
+   * Names of the objects of a custom Rx / Tx PDO (see CustomPdo).
+   * If not empty, the custom PDO is used instead of the one which is derived
+   * from the modes of operation.
+   */
+  std::vector<std::string> customRxPdo;
+  std::vector<std::string> customTxPdo;
+  /*!
+   * Only map the objects the configured modes need and the usedPdoObjects
+   * (Rx and Tx object names), see planPdoMapping().
+   */
+  bool minimizePdoMapping{false};
+  std::vector<std::string> usedPdoObjects;
 
  public:
   // stream operator
@@ -92,6 +135,22 @@ class Configuration {
   bool sanityCheck(bool silent = false) const;
 
   std::pair<RxPdoTypeEnum, TxPdoTypeEnum> getPdoTypeSolution() const;
+
+  /*!
+   * @brief Hash of all parameters which are written to the drive.
+   * Parameters which only affect the SDK (e.g. the error storage) are not
+   * included.
+   */
+  uint64_t getHardwareFingerprint() const;
 };
 
+/*!
+ * Encode a cycle time as interpolation time period (0x60C2), i.e. as
+ * mantissa * 10^exponent s with the largest possible exponent.
+ * @param[in] cycleTime	the cycle time [us]
+ * @return	false if the cycle time cannot be represented
+ */
+bool getInterpolationTimePeriod(unsigned int cycleTime, uint8_t& mantissa,
+                                int8_t& exponent);
+
 }  // namespace maxon
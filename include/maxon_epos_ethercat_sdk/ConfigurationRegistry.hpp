@@ -0,0 +1,110 @@
+// clang-format off
+/*
+** Copyright 2021 Robotic Systems Lab - ETH Zurich:
+** Linghao Zhang, Jonas Junger, Lennart Nachtigall
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions are met:
+**
+** 1. Redistributions of source code must retain the above copyright notice,
+**    this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright notice,
+**    this list of conditions and the following disclaimer in the documentation
+**    and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its contributors
+**    may be used to endorse or promote products derived from this software without
+**    specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+** AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+** IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+** DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+** FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+** DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+** SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+** CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+** OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+// clang-format on
+
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+
+#include "maxon_epos_ethercat_sdk/Configuration.hpp"
+
+namespace maxon {
+/*!
+ * A configuration together with the results of its validation, which are
+ * computed once and shared by all drives using it.
+ */
+struct ValidatedConfiguration {
+  Configuration configuration_;
+  std::pair<RxPdoTypeEnum, TxPdoTypeEnum> pdoTypeSolution_{RxPdoTypeEnum::NA,
+                                                           TxPdoTypeEnum::NA};
+  bool sane_{false};
+};
+
+/*!
+ * @brief	Parses and validates every configuration file once
+ * The drives share the resulting immutable configuration. Optionally the
+ * validated configuration is stored in a binary cache, keyed by a
+ * fingerprint of the file content, such that later processes do not parse
+ * the YAML file at all.
+ */
+class ConfigurationRegistry {
+ public:
+  typedef std::shared_ptr<const ValidatedConfiguration> ConfigurationPtr;
+
+  static ConfigurationRegistry& getInstance();
+
+  /*!
+   * Get the configuration of a file. The file is parsed again if its
+   * content has changed.
+   * @param[in] fileName	path to the YAML file
+   * @return	nullptr if the file cannot be read or parsed, the error is
+   * logged
+   */
+  ConfigurationPtr getConfiguration(const std::string& fileName);
+
+  /*!
+   * @param[in] directory	directory of the binary cache, empty: no cache
+   */
+  void setCacheDirectory(const std::string& directory);
+  void clear();
+
+  /*!
+   * Run the sanity check (printing its result) and solve the PDO types.
+   */
+  static ConfigurationPtr validate(const Configuration& configuration,
+                                   bool silent = false);
+
+  /*!
+   * Binary cache of a validated configuration, only readable by a build
+   * with the same Configuration layout.
+   * @param[in] sourceFingerprint	fingerprint of the YAML file content
+   */
+  static bool writeBinary(const ValidatedConfiguration& configuration,
+                          uint64_t sourceFingerprint,
+                          const std::string& fileName);
+  static ConfigurationPtr readBinary(const std::string& fileName,
+                                     uint64_t sourceFingerprint);
+
+ private:
+  std::string getCacheFile(uint64_t sourceFingerprint) const;
+
+  std::mutex mutex_;
+  // file name -> fingerprint of the content and configuration
+  std::map<std::string, std::pair<uint64_t, ConfigurationPtr>> configurations_;
+  std::string cacheDirectory_;
+};
+
+}  // namespace maxon
@@ -0,0 +1,129 @@
+// clang-format off
+/*
+** Copyright 2021 Robotic Systems Lab - ETH Zurich:
+** Linghao Zhang, Jonas Junger, Lennart Nachtigall
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions are met:
+**
+** 1. Redistributions of source code must retain the above copyright notice,
+**    this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright notice,
+**    this list of conditions and the following disclaimer in the documentation
+**    and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its contributors
+**    may be used to endorse or promote products derived from this software without
+**    specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+** AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+** IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+** DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+** FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+** DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+** SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+** CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+** OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+// clang-format on
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "maxon_epos_ethercat_sdk/Command.hpp"
+#include "maxon_epos_ethercat_sdk/PdoMapping.hpp"
+#include "maxon_epos_ethercat_sdk/Reading.hpp"
+
+namespace maxon {
+/*!
+ * Upper bound of the size of a custom PDO in bytes.
+ */
+constexpr std::size_t maxCustomPdoSize = 64;
+
+/*!
+ * Raw process data of a custom PDO with a size known at compile time, such
+ * that it can be passed to the bus like the other PDO structs.
+ */
+template <std::size_t Size>
+struct CustomPdoBuffer {
+  uint8_t data_[Size];
+} __attribute__((packed));
+
+/*!
+ * Everything a custom Rx PDO can be encoded from.
+ */
+struct CustomRxPdoSource {
+  RawCommand command_;
+  uint16_t controlword_{0};
+};
+
+/*!
+ * @brief	PDO layout defined in the configuration file
+ * The objects are identified by name (e.g. "statusword", "digital_inputs").
+ * The byte offsets in the process data and in the bound RawCommand /
+ * ReadingSnapshot member are computed once when the object is added, the
+ * cyclic encode() / decode() only copy bytes.
+ */
+class CustomPdo {
+ public:
+  /*!
+   * Append an object to a custom Rx (resp. Tx) PDO.
+   * @param[in] name	name of the object
+   * @return	false if the object is unknown or the PDO would get too large
+   */
+  bool addRxObject(const std::string& name);
+  bool addTxObject(const std::string& name);
+  /// same, the object is identified by its mapping (e.g. of a PDO struct)
+  bool addRxObject(const PdoMappingEntry& entry);
+  bool addTxObject(const PdoMappingEntry& entry);
+
+  void clear();
+  bool empty() const { return mapping_.empty(); }
+  /// size of the process data in bytes
+  std::size_t getSize() const { return size_; }
+  const std::vector<PdoMappingEntry>& getMapping() const { return mapping_; }
+
+  void encode(const CustomRxPdoSource& source, uint8_t* data) const;
+  void decode(const uint8_t* data, ReadingSnapshot& snapshot) const;
+  /// inverse of encode(), e.g. to decode recorded Rx PDOs
+  void decode(const uint8_t* data, CustomRxPdoSource& source) const;
+
+  /// names of all objects which can be added to a custom Rx (resp. Tx) PDO
+  static std::vector<std::string> getRxObjectNames();
+  static std::vector<std::string> getTxObjectNames();
+
+ public:
+  /*!
+   * An object which can be mapped and the member it is bound to.
+   */
+  struct Object {
+    const char* name_;
+    PdoMappingEntry mapping_;
+    uint16_t valueOffset_;
+    uint8_t valueSize_;
+  };
+
+ private:
+  struct Binding {
+    uint16_t pdoOffset_;
+    uint16_t valueOffset_;
+    uint8_t size_;
+    uint8_t valueSize_;
+  };
+
+  bool addObject(const Object& object);
+  void decodeValues(const uint8_t* data, uint8_t* values) const;
+
+  std::vector<PdoMappingEntry> mapping_;
+  std::vector<Binding> bindings_;
+  std::size_t size_{0};
+};
+
+}  // namespace maxon
@@ -0,0 +1,139 @@
+// clang-format off
+/*
+** Copyright 2021 Robotic Systems Lab - ETH Zurich:
+** Linghao Zhang, Jonas Junger, Lennart Nachtigall
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions are met:
+**
+** 1. Redistributions of source code must retain the above copyright notice,
+**    this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright notice,
+**    this list of conditions and the following disclaimer in the documentation
+**    and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its contributors
+**    may be used to endorse or promote products derived from this software without
+**    specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+** AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+** IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+** DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+** FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+** DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+** SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+** CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+** OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+// clang-format on
+
+#pragma once
+
+#include <cstdint>
+#include <cstdlib>
+#include <string>
+#include <type_traits>
+
+#include "maxon_epos_ethercat_sdk/Configuration.hpp"
+#include "maxon_epos_ethercat_sdk/ConversionFactors.hpp"
+#include "maxon_epos_ethercat_sdk/Reading.hpp"
+
+namespace maxon {
+enum class LimitQuantity : uint8_t {
+  None,
+  // min_position / max_position
+  Position,
+  // max_profile_velocity, compared with the magnitude
+  Velocity,
+  // max_current, compared with the magnitude
+  Current
+};
+
+std::string getLimitQuantityString(LimitQuantity quantity);
+
+/*!
+ * The reading which tripped the LimitGuard, in drive units.
+ */
+struct LimitViolation {
+  LimitQuantity quantity_{LimitQuantity::None};
+  int64_t value_{0};
+  int64_t limit_{0};
+  uint64_t sequenceNumber_{0};
+  ReadingTimePoint timePoint_;
+};
+static_assert(std::is_trivially_copyable<LimitViolation>::value,
+              "LimitViolation must stay trivially copyable");
+
+/*!
+ * @brief	Bounds of the raw reading, checked by the EtherCAT thread
+ * The limits of the configuration are converted to drive units once, such
+ * that the check in the cyclic update only compares integers.
+ * The velocity and current limits are widened by limit_guard_margin, since
+ * the drive itself regulates to them. The position is only checked if
+ * min_position < max_position.
+ */
+class LimitGuard {
+ public:
+  // all checks disabled unless the configuration enables the guard
+  void configure(const Configuration& configuration,
+                 const ConversionFactors& conversionFactors);
+  bool isEnabled() const { return enabled_; }
+
+  /*!
+   * Tolerate a position outside of the bounds until the drive has moved
+   * back into them, such that it can be enabled again after a violation.
+   */
+  void release() { positionReleased_ = true; }
+
+  /*!
+   * @param[in] snapshot	the latest reading
+   * @param[out] violation	the first exceeded limit, untouched otherwise
+   * @return	true if a limit is exceeded
+   */
+  bool check(const ReadingSnapshot& snapshot, LimitViolation& violation) {
+    if (!enabled_) {
+      return false;
+    }
+    const bool positionOutside =
+        checkPosition_ && (snapshot.actualPosition_ < minPosition_ ||
+                           snapshot.actualPosition_ > maxPosition_);
+    positionReleased_ &= positionOutside;
+    if (positionOutside && !positionReleased_) {
+      violation.quantity_ = LimitQuantity::Position;
+      violation.value_ = snapshot.actualPosition_;
+      violation.limit_ = snapshot.actualPosition_ < minPosition_
+                             ? minPosition_
+                             : maxPosition_;
+    } else if (maxVelocity_ > 0 &&
+               std::llabs(snapshot.actualVelocity_) > maxVelocity_) {
+      violation.quantity_ = LimitQuantity::Velocity;
+      violation.value_ = snapshot.actualVelocity_;
+      violation.limit_ = maxVelocity_;
+    } else if (maxCurrent_ > 0 &&
+               std::llabs(snapshot.actualCurrent_) > maxCurrent_) {
+      violation.quantity_ = LimitQuantity::Current;
+      violation.value_ = snapshot.actualCurrent_;
+      violation.limit_ = maxCurrent_;
+    } else {
+      return false;
+    }
+    violation.sequenceNumber_ = snapshot.sequenceNumber_;
+    violation.timePoint_ = snapshot.timePoint_;
+    return true;
+  }
+
+ protected:
+  bool enabled_{false};
+  bool checkPosition_{false};
+  bool positionReleased_{false};
+  int64_t minPosition_{0};
+  int64_t maxPosition_{0};
+  // 0: not checked
+  int64_t maxVelocity_{0};
+  int64_t maxCurrent_{0};
+};
+
+}  // namespace maxon
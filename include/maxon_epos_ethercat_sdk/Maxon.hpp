@@ -34,22 +34,57 @@
 
 #include <yaml-cpp/yaml.h>
 
+#include <array>
 #include <atomic>
 #include <chrono>
 #include <cstdint>
+#include <cstring>
 #include <ethercat_sdk_master/EthercatDevice.hpp>
+#include <functional>
+#include <future>
+#include <memory>
 #include <mutex>
 #include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
 
+#include "maxon_epos_ethercat_sdk/AsyncLogger.hpp"
+#include "maxon_epos_ethercat_sdk/BoundedQueue.hpp"
 #include "maxon_epos_ethercat_sdk/Command.hpp"
+#include "maxon_epos_ethercat_sdk/ConfigurationRegistry.hpp"
 #include "maxon_epos_ethercat_sdk/Controlword.hpp"
+#include "maxon_epos_ethercat_sdk/ConversionFactors.hpp"
+#include "maxon_epos_ethercat_sdk/CustomPdo.hpp"
 #include "maxon_epos_ethercat_sdk/DriveState.hpp"
+#include "maxon_epos_ethercat_sdk/LimitGuard.hpp"
+#include "maxon_epos_ethercat_sdk/PdoPlanner.hpp"
 #include "maxon_epos_ethercat_sdk/Reading.hpp"
+#include "maxon_epos_ethercat_sdk/ReadingEvents.hpp"
+#include "maxon_epos_ethercat_sdk/RtAudit.hpp"
+#include "maxon_epos_ethercat_sdk/SdoWorker.hpp"
+#include "maxon_epos_ethercat_sdk/SeqLock.hpp"
+#include "maxon_epos_ethercat_sdk/SetpointStream.hpp"
+#include "maxon_epos_ethercat_sdk/SharedMemoryExport.hpp"
+#include "maxon_epos_ethercat_sdk/SlaveBackend.hpp"
+#include "maxon_epos_ethercat_sdk/StateTransitionTable.hpp"
+#include "maxon_epos_ethercat_sdk/TelemetryRecorder.hpp"
+#include "maxon_epos_ethercat_sdk/TimingStatistics.hpp"
+#include "maxon_epos_ethercat_sdk/TripleBuffer.hpp"
 
 namespace maxon {
 class Maxon : public ecat_master::EthercatDevice {
  public:
   typedef std::shared_ptr<Maxon> SharedPtr;
+  /*!
+   * Completion handler of a PDO drive state change. The argument is true if
+   * the target state was reached and false if the change timed out or was
+   * superseded by a new request. Called from the EtherCAT thread in
+   * updateWrite() with the state machine mutex held, also for a superseded
+   * request. It must therefore return quickly and must not wait for another
+   * thread which calls into the drive.
+   */
+  typedef std::function<void(bool)> DriveStateCallback;
 
   // create Maxon Drive from setup file
   static SharedPtr deviceFromFile(const std::string& configFile,
@@ -58,6 +93,7 @@ class Maxon : public ecat_master::EthercatDevice {
   // constructor
   Maxon() = default;
   Maxon(const std::string& name, const uint32_t address);
+  ~Maxon() override;
 
   // pure virtual overwrites
  public:
@@ -68,30 +104,291 @@ class Maxon : public ecat_master::EthercatDevice {
   void updateRead() override;
   bool putIntoOperation() {
     bool success;
-    bus_->setState(EC_STATE_OPERATIONAL, getAddress());
-    success =
-        bus_->waitForState(EC_STATE_OPERATIONAL, getAddress(), 1000, 0.001);
+    setEthercatState(EC_STATE_OPERATIONAL);
+    success = waitForEthercatState(EC_STATE_OPERATIONAL, 1000, 0.001);
     return success;
   }
   PdoInfo getCurrentPdoInfo() const override { return pdoInfo_; }
+  /*!
+   * @return	the time the last call to startup() took
+   */
+  std::chrono::microseconds getStartupDuration() const {
+    return startupDuration_;
+  }
 
  public:
+  /*!
+   * Convert a command and hand it over to the EtherCAT thread.
+   * Never blocks, the latest staged command is used by the next updateWrite().
+   * Must always be called from the same thread.
+   * @param[in] command	the command in user units or raw units
+   */
   void stageCommand(const Command& command);
+
+  /*!
+   * Access the PDOs directly in the process image of the bus, such that
+   * updateWrite() encodes into the outgoing frame and updateRead() decodes
+   * from the received one without intermediate copies. Only safe if the
+   * process image is exchanged by the thread which calls updateRead() and
+   * updateWrite(). Otherwise (and if the sizes no longer match the PDO
+   * types after loading a new configuration) the PDOs are copied through
+   * the bus, which guards the process image.
+   * @param[in] rxPdo	outputs of this drive in the process image
+   * @param[in] rxPdoSize	size of the outputs in bytes
+   * @param[in] txPdo	inputs of this drive in the process image
+   * @param[in] txPdoSize	size of the inputs in bytes
+   * @return	false if the sizes do not match the configured PDO types
+   */
+  bool bindProcessImage(uint8_t* rxPdo, std::size_t rxPdoSize,
+                        const uint8_t* txPdo, std::size_t txPdoSize);
+  void unbindProcessImage();
+
+  /*!
+   * Record the raw PDOs of every cycle. Must be called after the
+   * configuration has been loaded and before the recorder is started.
+   * @param[in] recorder	the recorder, nullptr stops recording this drive
+   * @return	false if the recorder is already running
+   */
+  bool setTelemetryRecorder(const TelemetryRecorder::SharedPtr& recorder);
+  /*!
+   * Publish the reading and the command of every cycle in shared memory.
+   * @param[in] sharedMemoryExport	an open export, nullptr stops publishing
+   * @return	false if the export is not open or has no free drive slot
+   */
+  bool setSharedMemoryExport(
+      const SharedMemoryExport::SharedPtr& sharedMemoryExport);
+  /*!
+   * Count the allocations, locks and blocking calls of updateRead() and
+   * updateWrite(), see RtAudit. Every drive needs its own audit.
+   * @param[in] audit	the audit, nullptr stops auditing
+   */
+  void setRtAudit(const RtAudit::SharedPtr& audit);
+  /*!
+   * Hand a command which is already in drive units over to the EtherCAT
+   * thread, see stageCommand().
+   * @param[in] rawCommand	the converted command
+   */
+  void stageRawCommand(const RawCommand& rawCommand);
+
+  /*!
+   * Stage a command of a cyclic synchronous mode without building a Command.
+   * The targets are given in user units (rad, rad/s, Nm) and converted with
+   * the precomputed factors, independent of use_raw_commands.
+   * @return	false (and nothing is staged) if the mode of operation is not
+   * configured
+   */
+  bool stageCsp(double targetPosition, double positionOffset = 0.0,
+                double torqueOffset = 0.0);
+  bool stageCsv(double targetVelocity, double velocityOffset = 0.0);
+  bool stageCst(double targetTorque, double torqueOffset = 0.0);
+
+  /*!
+   * Stream timestamped setpoints instead of staging the latest command, e.g.
+   * from a planner which runs slower than the bus. Every updateWrite() uses
+   * the setpoint (or the interpolation between the setpoints) at its time.
+   * Staged commands are only used before the first setpoint is due and after
+   * clearSetpoints(). The last setpoint is held if the stream runs dry.
+   * Must always be called from the same thread.
+   * @return	false if the mode of operation is not configured, the time
+   * point is not later than the one of the previous setpoint or the queue of
+   * SetpointStream::capacity setpoints is full, pushSetpoints() returns the
+   * number of queued setpoints
+   */
+  bool pushSetpoint(const Setpoint& setpoint);
+  std::size_t pushSetpoints(const Setpoint* setpoints,
+                            std::size_t numberOfSetpoints);
+  bool pushCspSetpoint(ReadingTimePoint timePoint, double targetPosition,
+                       double positionOffset = 0.0, double torqueOffset = 0.0);
+  bool pushCsvSetpoint(ReadingTimePoint timePoint, double targetVelocity,
+                       double velocityOffset = 0.0);
+  bool pushCstSetpoint(ReadingTimePoint timePoint, double targetTorque,
+                       double torqueOffset = 0.0);
+  void clearSetpoints() { setpointStream_.clear(); }
+  void setSetpointInterpolation(SetpointInterpolation interpolation) {
+    setpointStream_.setInterpolation(interpolation);
+  }
+  SetpointStatistics getSetpointStatistics() const {
+    return setpointStream_.getStatistics();
+  }
+  void resetSetpointStatistics() { setpointStream_.resetStatistics(); }
+  std::size_t getNumberOfQueuedSetpoints() const {
+    return setpointStream_.getNumberOfQueuedSetpoints();
+  }
+
+  /*!
+   * Factors between user units and drive units, updated when the
+   * configuration is loaded and when startup() reads the rated current.
+   */
+  const ConversionFactors& getConversionFactors() const {
+    return conversionFactors_;
+  }
+  /*!
+   * Incremented whenever the conversion factors change, such that copies of
+   * them, e.g. in a MaxonGroup, can be refreshed.
+   */
+  uint64_t getConversionFactorsVersion() const {
+    return conversionFactorsVersion_.load(std::memory_order_acquire);
+  }
+  /*!
+   * Get the latest reading with the stored errors and faults. The returned
+   * copy allocates its error and fault storage, a cyclic consumer reuses a
+   * Reading with getReading(reading) or takes getReadingSnapshot().
+   */
   Reading getReading() const;
+  /*!
+   * Same, allocation free once the reading has the configured capacities,
+   * i.e. after the first call.
+   */
   void getReading(Reading& reading) const;
 
+  /*!
+   * Get the raw values of the latest Tx PDO without locking.
+   * Never blocks the EtherCAT thread and is safe to call from any number of
+   * threads.
+   * @param[out] snapshot	consistent copy of the latest raw reading
+   * @return	the sequence number of the snapshot
+   */
+  uint64_t getReadingSnapshot(ReadingSnapshot& snapshot) const;
+  ReadingSnapshot getReadingSnapshot() const;
+
+  /*!
+   * Get notified about changes of the reading instead of polling it.
+   * updateRead() compares every new Tx PDO with the previous one and queues
+   * an event per statusword / drive state change and threshold crossing.
+   * Errors and faults are queued by the next updateRead() after they have
+   * been added to the reading. The thresholds are converted with the latest
+   * conversion factors, e.g. after startup() read the rated current.
+   * @param[in] eventMask	bitwise or of readingEventMask() values
+   * @param[in] thresholds	thresholds in user units, see ReadingThreshold
+   * @return	the subscription, which receives events until unsubscribed
+   */
+  ReadingSubscription::SharedPtr subscribeReadingEvents(
+      uint32_t eventMask = allReadingEvents,
+      const std::vector<ReadingThreshold>& thresholds = {});
+  void unsubscribeReadingEvents(
+      const ReadingSubscription::SharedPtr& subscription);
+
+  /*!
+   * The limit guard (limit_guard in the configuration) checks every reading
+   * of an enabled drive against the configured limits. On a violation the
+   * next updateWrite() writes the quick stop controlword (transition 11), PDO
+   * state changes fail and a LimitViolation event is queued.
+   * The guard stays tripped, i.e. keeps the drive in quick stop, until it is
+   * reset. Lock-free, may be called from any thread.
+   */
+  bool isLimitGuardTripped() const {
+    return limitGuardTripped_.load(std::memory_order_acquire);
+  }
+  LimitViolation getLimitViolation() const { return limitViolation_.read(); }
+  /*!
+   * Release the drive after a violation. It stays in its current state
+   * until a new state is requested via setDriveStateViaPdo(). A position
+   * outside of the bounds is tolerated until the drive is back within them.
+   */
+  void resetLimitGuard();
+
+ protected:
+  // count snapshots which are older than two cycles
+  void countStaleReading(const ReadingSnapshot& snapshot) const;
+
+ public:
+  /*!
+   * Get the timing of updateRead() and updateWrite() since the last reset.
+   * Lock-free, may be called from any thread.
+   */
+  TimingStatistics getTimingStatistics() const;
+  void resetTimingStatistics();
+  /*!
+   * Get the latencies of the PDO state transitions since the last reset,
+   * e.g. to tune drive_state_change_min_timeout. Lock-free.
+   */
+  StateTransitionStatistics getStateTransitionStatistics() const;
+  void resetStateTransitionStatistics();
+
+  /*!
+   * Compare the host cycle with the distributed clock. The time is read in
+   * every updateRead(), e.g. the DC time of the SOEM context, which the bus
+   * updates with every received frame.
+   * @param[in] distributedClockTime	the DC time [ns], nullptr to disable
+   */
+  void setDistributedClockTimeSource(const int64_t* distributedClockTime);
+
+  /*!
+   * @return	the period of the setpoints [us], which is written to the
+   * interpolation time period: cycle_time of the configuration, otherwise
+   * the time step of the EtherCAT master, otherwise 2 ms
+   */
+  unsigned int getCycleTime() const;
+
   bool loadConfigFile(const std::string& fileName);
   bool loadConfigNode(YAML::Node configNode);
   bool loadConfiguration(const Configuration& configuration);
+  /*!
+   * Load a configuration of the ConfigurationRegistry, which has already
+   * been validated.
+   * @param[in] configuration	the shared configuration
+   * @param[in] override	per-drive changes, the result is validated again
+   */
+  bool loadConfiguration(
+      const ConfigurationRegistry::ConfigurationPtr& configuration,
+      const std::function<void(Configuration&)>& override = nullptr);
   Configuration getConfiguration() const;
+  /// the PDO mapping of the loaded configuration, see planPdoMapping()
+  PdoPlan getPdoPlan() const;
 
   // SDO
  public:
+  /*!
+   * Send the SDOs and EtherCAT state requests of this drive to a backend
+   * instead of the bus, e.g. a VirtualEpos4Bus. Must be set before startup().
+   * Only the calls made through Maxon are redirected, not those made through
+   * a pointer to the EthercatSlaveBase.
+   * @param[in] slaveBackend	the backend, nullptr uses the bus again
+   */
+  void setSlaveBackend(SlaveBackend* slaveBackend) {
+    slaveBackend_ = slaveBackend;
+  }
+  /// hide the SDO access of the EthercatSlaveBase, see setSlaveBackend()
+  template <typename Value>
+  bool sendSdoRead(uint16_t index, uint8_t subIndex, bool completeAccess,
+                   Value& value);
+  template <typename Value>
+  bool sendSdoWrite(uint16_t index, uint8_t subIndex, bool completeAccess,
+                    const Value& value);
+
   bool getStatuswordViaSdo(Statusword& statusword);
   bool setControlwordViaSdo(Controlword& controlword);
   bool setDriveStateViaSdo(const DriveState& driveState);
 
+  /*!
+   * Asynchronous SDO access. The requests are queued to the SDO worker of the
+   * bus, which serializes the mailbox transfers of all its drives, and the
+   * calling thread never blocks. Pending requests of a drive are dropped
+   * when it is destroyed, their futures then hold a broken_promise error.
+   */
+  template <typename Value>
+  std::future<std::pair<bool, Value>> sendSdoReadAsync(uint16_t index,
+                                                       uint8_t subIndex,
+                                                       bool completeAccess);
+  template <typename Value>
+  std::future<bool> sendSdoWriteAsync(uint16_t index, uint8_t subIndex,
+                                      bool completeAccess, const Value& value);
+  std::future<std::pair<bool, Statusword>> getStatuswordViaSdoAsync();
+  std::future<bool> setDriveStateViaSdoAsync(const DriveState& driveState);
+
  protected:
+  // queue a request to the SDO worker of the bus
+  template <typename Function>
+  auto submitSdoRequest(Function function)
+      -> std::future<decltype(function())>;
+  SdoWorker& getSdoWorker();
+  // EtherCAT state and distributed clock, through the backend if there is one
+  void setEthercatState(uint16_t state);
+  bool waitForEthercatState(uint16_t state, unsigned int maxRetries,
+                            double retrySleep);
+  void syncDistributedClock0(bool activate, double cycleTime,
+                             double cycleShift);
+  SlaveBackend* slaveBackend_{nullptr};
   bool stateTransitionViaSdo(const StateTransition& stateTransition);
 
   // PDO
@@ -100,14 +397,151 @@ class Maxon : public ecat_master::EthercatDevice {
                            const bool waitForState);
   bool lastPdoStateChangeSuccessful() const { return stateChangeSuccessful_; }
 
+  /*!
+   * Request a drive state change via PDO without blocking.
+   * @param[in] driveState	the target drive state
+   * @return	future which becomes ready once the state change has completed,
+   * see DriveStateCallback
+   */
+  std::future<bool> setDriveStateViaPdoAsync(const DriveState& driveState);
+  /*!
+   * Request a drive state change via PDO without blocking.
+   * @param[in] driveState	the target drive state
+   * @param[in] callback	called exactly once when the state change has
+   * completed
+   */
+  void setDriveStateViaPdoAsync(const DriveState& driveState,
+                                DriveStateCallback callback);
+
+  /*!
+   * Request the same drive state change for several drives at once.
+   * @return	future which becomes ready once every drive has completed, true
+   * if all of them reached the target state
+   */
+  static std::future<bool> setDriveStatesViaPdoAsync(
+      const std::vector<SharedPtr>& drives, const DriveState& driveState);
+  static bool setDriveStatesViaPdo(const std::vector<SharedPtr>& drives,
+                                   const DriveState& driveState,
+                                   const bool waitForState);
+
+  /*!
+   * Run startup() of several drives concurrently, such that the bring-up
+   * time is given by the slowest drive instead of the sum of all of them.
+   * Waiting for the drives (state changes, SDO read back) overlaps, the
+   * mailbox transfers themselves are as concurrent as the bus allows.
+   * The next startup() call of each drive returns its result without
+   * starting it again.
+   * @param[in] drives	the drives, typically all drives of a bus
+   * @param[in] maxNumberOfThreads	0 starts every drive on its own thread
+   * @return	true if all drives were started successfully
+   */
+  static bool startupDrives(const std::vector<SharedPtr>& drives,
+                            unsigned int maxNumberOfThreads = 0);
+  /*!
+   * Start these drives concurrently as soon as the bus starts up the first
+   * one of them, see startupDrives(). The other drives then only return
+   * their result when the bus starts them.
+   */
+  static void setParallelStartup(const std::vector<SharedPtr>& drives,
+                                 unsigned int maxNumberOfThreads = 0);
+
+  /*!
+   * Process data and estimated frame time of these drives with their loaded
+   * configurations, at the cycle time of the first drive. Logged by
+   * startupDrives().
+   * @param[in] drives	the drives, typically all drives of a bus
+   */
+  static BusPlan planBus(const std::vector<SharedPtr>& drives);
+
  protected:
+  // called by updateWrite(), which holds mutex_
   void engagePdoStateMachine();
-  bool mapPdos(RxPdoTypeEnum rxPdoTypeEnum, TxPdoTypeEnum txPdoTypeEnum);
+  // signal the pending DriveStateCallback, if there is one
+  void completeDriveStateChange(bool success);
+  // signal the callbacks of superseded requests, called by updateWrite()
+  void completeSupersededDriveStateChanges();
+  bool mapPdos();
+  /*!
+   * Bind the PDO handlers of the given PDO types, such that the cyclic update
+   * does not need to branch over the PDO type.
+   * @return	false if one of the PDO types is not implemented
+   */
+  bool bindPdoTypes(RxPdoTypeEnum rxPdoTypeEnum, TxPdoTypeEnum txPdoTypeEnum);
+  /*!
+   * PDO handlers generated from the descriptors in RxPdo.hpp and TxPdo.hpp
+   */
+  template <typename RxPdo>
+  void bindRxPdo();
+  template <typename TxPdo>
+  void bindTxPdo();
+  template <typename RxPdo>
+  void writeRxPdo(const RawCommand& command);
+  template <typename TxPdo>
+  void readTxPdo();
+  template <typename RxPdo>
+  bool mapRxPdo();
+  template <typename TxPdo>
+  bool mapTxPdo();
+  template <typename Pdo>
+  bool mapPdo(uint16_t assignmentIndex, uint16_t mappingIndex);
+  template <typename Mapping>
+  bool mapPdoEntryByEntry(uint16_t assignmentIndex, uint16_t mappingIndex,
+                          const Mapping& mapping);
+  /*!
+   * PDO handlers of the PDOs defined in the configuration file. The size of
+   * the process data has to be known at compile time, the handler matching
+   * the size of the custom PDO is bound.
+   */
+  template <std::size_t Size>
+  void writeCustomRxPdo(const RawCommand& command);
+  template <std::size_t Size>
+  void readCustomTxPdo();
+  template <std::size_t... Sizes>
+  bool bindCustomRxPdo(std::index_sequence<Sizes...>);
+  template <std::size_t... Sizes>
+  bool bindCustomTxPdo(std::index_sequence<Sizes...>);
+  bool mapCustomRxPdo();
+  bool mapCustomTxPdo();
+  /*!
+   * Compare the PDO sizes reported by the bus with the bound PDO types.
+   * @return	false on a mismatch
+   */
+  bool checkPdoSizes();
+  /*!
+   * Write a configuration value via SDO.
+   * The write is skipped if the drive already holds the value. Otherwise the
+   * value is read back until it matches, for at most
+   * configRunSdoVerifyTimeout [us].
+   */
+  template <typename Value>
+  bool sdoWriteIfChanged(uint16_t index, uint8_t subIndex,
+                         bool completeAccess, const Value& value);
+  /*!
+   * Sleep between two SDO polls, such that polling does not occupy the
+   * mailbox. The sleep starts at 50 us and doubles up to 1 ms, but never
+   * extends beyond the deadline.
+   * @param[in,out] backoff	the duration of the sleep, updated for the next
+   * poll
+   */
+  static void waitForNextSdoPoll(
+      std::chrono::steady_clock::time_point deadline,
+      std::chrono::microseconds& backoff);
   bool configParam();
-  Controlword getNextStateTransitionControlword(
+  // the next step of the PDO state machine, see getStateTransitionStep()
+  StateTransitionStep getNextStateTransitionStep(
       const DriveState& requestedDriveState,
       const DriveState& currentDriveState);
   void autoConfigurePdoSizes();
+  /*!
+   * Configuration cache: the fingerprint of the last successful configuration
+   * of a drive is stored in configurationCacheDirectory, keyed by the serial
+   * number of the drive.
+   */
+  uint64_t getConfigurationFingerprint() const;
+  bool isConfigurationCached(uint64_t fingerprint);
+  void cacheConfiguration(uint64_t fingerprint);
+  std::string getConfigurationCacheFile();
+  DriveState getCurrentDriveState() const;
 
   uint16_t getTxPdoSize();
   uint16_t getRxPdoSize();
@@ -118,37 +552,301 @@ class Maxon : public ecat_master::EthercatDevice {
 
   // Errors
  protected:
+  /*!
+   * Queue an error (resp. fault) for reading_, lock-free and allocation free
+   * such that any thread may call it. It is added to reading_ by the next
+   * getReading().
+   */
   void addErrorToReading(const ErrorType& errorType);
+  void addFaultToReading(uint16_t errorCode);
+  // add the queued errors and faults to reading_, readingMutex_ is held
+  void drainPendingDiagnoses() const;
+
+  /*!
+   * Read the error code, the error history and the diagnosis of the drive
+   * after the fault bit of the statusword has risen. Run by the SDO worker,
+   * the error code is added to the faults of the reading, the error history
+   * and the diagnosis are logged.
+   */
+  void captureFault();
+  friend class SdoWorker;
 
  public:
   void printErrorCode();
+  void printErrorHistory();
   void printDiagnosis();
+  std::future<void> printErrorCodeAsync();
+  std::future<void> printDiagnosisAsync();
 
  public:
   Configuration configuration_;
 
  protected:
-  Command stagedCommand_;
-  Reading reading_;
+  // hand over of the converted commands to the EtherCAT thread
+  TripleBuffer<RawCommand> stagedCommandBuffer_;
+  // setpoints of the planner, interpolated by updateWrite()
+  SetpointStream setpointStream_;
+  // only accessed by the EtherCAT thread
+  RawCommand streamedCommand_;
+  // errors, faults and unit conversion factors, guarded by readingMutex_
+  mutable Reading reading_;
+  // an error or fault on its way to reading_, see addErrorToReading()
+  struct PendingDiagnosis {
+    bool isFault_{false};
+    ErrorType errorType_{ErrorType::ErrorReadingError};
+    uint16_t faultCode_{0};
+    ReadingTimePoint timePoint_;
+  };
+  // errors and faults which do not fit are dropped until the next drain
+  mutable BoundedQueue<PendingDiagnosis, 64> pendingDiagnoses_;
+  // latest raw Tx PDO values, only accessed by the EtherCAT thread
+  ReadingSnapshot readingSnapshot_;
+  // lock-free hand over of readingSnapshot_ to the consumers
+  SeqLock<ReadingSnapshot> publishedReadingSnapshot_;
   RxPdoTypeEnum rxPdoTypeEnum_{RxPdoTypeEnum::NA};
   TxPdoTypeEnum txPdoTypeEnum_{TxPdoTypeEnum::NA};
-  Controlword controlword_;
+  // handlers of the configured PDO types, bound by bindPdoTypes()
+  void (Maxon::*writeRxPdoFunction_)(const RawCommand&){nullptr};
+  void (Maxon::*readTxPdoFunction_)(){nullptr};
+  bool (Maxon::*mapRxPdoFunction_)(){nullptr};
+  bool (Maxon::*mapTxPdoFunction_)(){nullptr};
+  // sizes of the bound PDO types in bytes
+  std::size_t rxPdoSize_{0};
+  std::size_t txPdoSize_{0};
+  // slices of the process image for direct access, see bindProcessImage()
+  uint8_t* processImageRxPdo_{nullptr};
+  const uint8_t* processImageTxPdo_{nullptr};
+  std::size_t processImageRxPdoSize_{0};
+  std::size_t processImageTxPdoSize_{0};
+  // mappings of the bound PDO types, stored in telemetry files
+  std::vector<PdoMappingEntry> rxPdoMapping_;
+  std::vector<PdoMappingEntry> txPdoMapping_;
+  // guarded by mutex_, the record is filled by updateRead() / updateWrite()
+  TelemetryRecorder::SharedPtr telemetryRecorder_;
+  TelemetryRecord telemetryRecord_;
+  TelemetryDriveInfo getTelemetryDriveInfo() const;
+  // guarded by mutex_, published by updateWrite()
+  SharedMemoryExport::SharedPtr sharedMemoryExport_;
+  int sharedMemoryIndex_{-1};
+  // guarded by mutex_
+  RtAudit::SharedPtr rtAudit_;
+  // lock mutex_ in the cyclic update, true if it had to wait
+  bool lockCyclicMutex();
+  void recordRxPdo(const void* data, std::size_t size) {
+    if (telemetryRecorder_ != nullptr) {
+      std::memcpy(telemetryRecord_.rxPdo_, data, size);
+    }
+  }
+  void recordTxPdo(const void* data, std::size_t size) {
+    if (telemetryRecorder_ != nullptr) {
+      std::memcpy(telemetryRecord_.txPdo_, data, size);
+    }
+  }
+  // created on first use, guarded by mutex_
+  SdoWorker::SharedPtr sdoWorker_;
+  // guarded by mutex_, the events are detected by updateRead()
+  std::vector<ReadingSubscription::SharedPtr> readingSubscriptions_;
+  uint16_t lastEventStatusword_{0};
+  bool hasLastEventStatusword_{false};
+  void detectReadingEvents();
+  // check the latest reading, called by updateRead()
+  void checkLimits();
+  LimitGuard limitGuard_;
+  std::atomic<bool> limitGuardTripped_{false};
+  SeqLock<LimitViolation> limitViolation_;
+  /*!
+   * Queue an event for the subscriptions, lock-free such that any thread,
+   * e.g. the SDO worker, may call it without contending with the EtherCAT
+   * thread. The next updateRead() passes it on, an event which does not fit
+   * is dropped.
+   */
+  void publishReadingEvent(const ReadingEvent& event);
+  BoundedQueue<ReadingEvent, 64> pendingReadingEvents_;
+  // pass an event to the subscriptions, mutex_ is held
+  void notifyReadingSubscriptions(const ReadingEvent& event);
+  CustomPdo customRxPdo_;
+  CustomPdo customTxPdo_;
+  PdoPlan pdoPlan_;
+  // the raw controlword written to the Rx PDO
+  uint16_t controlword_{0};
   PdoInfo pdoInfo_;
   bool hasRead_{false};
+  // the mode of operation error is only added once per NA episode
+  bool modeOfOperationErrorLatched_{false};
   bool conductStateChange_{false};
   DriveState targetDriveState_{DriveState::NA};
   std::chrono::time_point<std::chrono::steady_clock> driveStateChangeTimePoint_;
+  std::chrono::time_point<std::chrono::steady_clock>
+      driveStateChangeStartTimePoint_;
+  // the completed callback is kept until the next request such that its
+  // captures are not released in the EtherCAT thread
+  DriveStateCallback driveStateCallback_;
+  DriveStateCallback completedDriveStateCallback_;
+  bool driveStateCallbackPending_{false};
+  // callbacks of requests which were superseded by a new request, completed
+  // (with false) by the next updateWrite()
+  DriveStateCallback supersededDriveStateCallback_;
+  bool supersededDriveStateCallbackPending_{false};
   uint16_t numberOfSuccessfulTargetStateReadings_{0};
+  // the transition of the last controlword until the drive acknowledges it
+  StateTransitionStep pendingStateTransitionStep_{
+      state_transition_table::none};
+  bool stateTransitionPending_{false};
+  // the drive state in which the last controlword was written
+  DriveState lastControlwordDriveState_{DriveState::NA};
   std::atomic<bool> stateChangeSuccessful_{false};
+  std::chrono::microseconds startupDuration_{0};
+  // configuration and hardware setup, the body of startup()
+  bool runStartup();
+  struct StartupGroup {
+    std::vector<std::weak_ptr<Maxon>> drives_;
+    unsigned int maxNumberOfThreads_{0};
+  };
+  std::shared_ptr<StartupGroup> startupGroup_;
+  // the result of startupDrives(), consumed by the next startup()
+  bool startupCompleted_{false};
+  bool startupSuccessful_{false};
+  // statistics of sdoWriteIfChanged() during the last startup
+  unsigned int numberOfSdoWrites_{0};
+  unsigned int numberOfSkippedSdoWrites_{0};
+
+  // timing of the cyclic update, recorded by the EtherCAT thread
+  LatencyHistogram updateReadHistogram_;
+  LatencyHistogram updateWriteHistogram_;
+  LatencyHistogram mutexWaitHistogram_;
+  LatencyHistogram cycleTimeHistogram_;
+  LatencyHistogram distributedClockCycleTimeHistogram_;
+  LatencyHistogram distributedClockJitterHistogram_;
+  std::array<LatencyHistogram, numberOfStateTransitions>
+      stateTransitionHistograms_;
+  LatencyHistogram stateChangeHistogram_;
+  std::atomic<uint64_t> repeatedStateTransitions_{0};
+  const int64_t* distributedClockTime_{nullptr};
+  int64_t lastDistributedClockTime_{0};
+  ReadingTimePoint lastUpdateReadTimePoint_;
+  std::atomic<uint64_t> missedCycles_{0};
+  mutable std::atomic<uint64_t> staleReadings_{0};
 
   // Configurable parameters
  protected:
   bool allowModeChange_{false};
+  // the last staged mode of operation, only accessed by the staging thread
   ModeOfOperationEnum modeOfOperation_{ModeOfOperationEnum::NA};
+  ConversionFactors conversionFactors_;
+  std::atomic<uint64_t> conversionFactorsVersion_{0};
+  // one bit per configured mode of operation, indexed by its value
+  uint32_t allowedModesOfOperation_{0};
+
+  void updateConversionFactors();
+  // bind the PDOs and the factors, returns false if a custom PDO is invalid
+  bool applyConfiguration(
+      const Configuration& configuration,
+      const std::pair<RxPdoTypeEnum, TxPdoTypeEnum>& pdoTypeSolution);
+
+  /*!
+   * Log an event of the cyclic update without formatting a message in the
+   * calling thread, rate limited per event type.
+   */
+  void logEvent(LogEventType type, int64_t value0 = 0,
+                int64_t value1 = 0) const;
+  mutable std::array<LogThrottle,
+                     static_cast<std::size_t>(LogEventType::NumberOfTypes)>
+      logThrottles_;
+  bool isModeOfOperationAllowed(ModeOfOperationEnum modeOfOperation) const {
+    const auto bit = static_cast<uint8_t>(modeOfOperation);
+    return bit < 32 && ((allowedModesOfOperation_ >> bit) & 1u) != 0;
+  }
+  // stage a command of the given mode, if it is allowed
+  bool stageCyclicCommand(const RawCommand& rawCommand);
+  // convert the targets of a cyclic synchronous mode
+  RawCommand getCspCommand(double targetPosition, double positionOffset,
+                           double torqueOffset) const;
+  RawCommand getCsvCommand(double targetVelocity, double velocityOffset) const;
+  RawCommand getCstCommand(double targetTorque, double torqueOffset) const;
 
  protected:
-  mutable std::recursive_mutex stagedCommandMutex_;  // TODO required?
-  mutable std::recursive_mutex readingMutex_;        // TODO required?
-  mutable std::recursive_mutex mutex_;               // TODO: change name!!!!
+  mutable std::recursive_mutex readingMutex_;  // guards reading_
+  mutable std::recursive_mutex mutex_;         // TODO: change name!!!!
 };
+
+template <typename Value>
+bool Maxon::sendSdoRead(uint16_t index, uint8_t subIndex, bool completeAccess,
+                        Value& value) {
+  static_assert(std::is_trivially_copyable<Value>::value,
+                "SDO values are transferred as raw bytes");
+  if (slaveBackend_ != nullptr) {
+    return slaveBackend_->sdoRead(static_cast<uint16_t>(address_), index,
+                                  subIndex, completeAccess, &value,
+                                  sizeof(Value));
+  }
+  return EthercatDevice::sendSdoRead(index, subIndex, completeAccess, value);
+}
+
+template <typename Value>
+bool Maxon::sendSdoWrite(uint16_t index, uint8_t subIndex,
+                         bool completeAccess, const Value& value) {
+  static_assert(std::is_trivially_copyable<Value>::value,
+                "SDO values are transferred as raw bytes");
+  if (slaveBackend_ != nullptr) {
+    return slaveBackend_->sdoWrite(static_cast<uint16_t>(address_), index,
+                                   subIndex, completeAccess, &value,
+                                   sizeof(Value));
+  }
+  return EthercatDevice::sendSdoWrite(index, subIndex, completeAccess, value);
+}
+
+template <typename Value>
+bool Maxon::sdoWriteIfChanged(uint16_t index, uint8_t subIndex,
+                              bool completeAccess, const Value& value) {
+  Value currentValue{};
+  if (sendSdoRead(index, subIndex, completeAccess, currentValue) &&
+      currentValue == value) {
+    numberOfSkippedSdoWrites_++;
+    return true;
+  }
+
+  numberOfSdoWrites_++;
+  if (!sendSdoWrite(index, subIndex, completeAccess, value)) {
+    return false;
+  }
+
+  // poll the value instead of waiting for a fixed time
+  const auto deadline =
+      std::chrono::steady_clock::now() +
+      std::chrono::microseconds(configuration_.configRunSdoVerifyTimeout);
+  std::chrono::microseconds backoff{0};
+  do {
+    if (sendSdoRead(index, subIndex, completeAccess, currentValue) &&
+        currentValue == value) {
+      return true;
+    }
+    waitForNextSdoPoll(deadline, backoff);
+  } while (std::chrono::steady_clock::now() < deadline);
+  return false;
+}
+
+template <typename Function>
+auto Maxon::submitSdoRequest(Function function)
+    -> std::future<decltype(function())> {
+  return getSdoWorker().submit(this, std::move(function));
+}
+
+template <typename Value>
+std::future<std::pair<bool, Value>> Maxon::sendSdoReadAsync(
+    uint16_t index, uint8_t subIndex, bool completeAccess) {
+  return submitSdoRequest([this, index, subIndex, completeAccess]() {
+    Value value{};
+    const bool success = sendSdoRead(index, subIndex, completeAccess, value);
+    return std::make_pair(success, value);
+  });
+}
+
+template <typename Value>
+std::future<bool> Maxon::sendSdoWriteAsync(uint16_t index, uint8_t subIndex,
+                                           bool completeAccess,
+                                           const Value& value) {
+  return submitSdoRequest([this, index, subIndex, completeAccess, value]() {
+    return sendSdoWrite(index, subIndex, completeAccess, value);
+  });
+}
 }  // namespace maxon
@@ -0,0 +1,161 @@
+// clang-format off
+/*
+** Copyright 2021 Robotic Systems Lab - ETH Zurich:
+** Linghao Zhang, Jonas Junger, Lennart Nachtigall
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions are met:
+**
+** 1. Redistributions of source code must retain the above copyright notice,
+**    this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright notice,
+**    this list of conditions and the following disclaimer in the documentation
+**    and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its contributors
+**    may be used to endorse or promote products derived from this software without
+**    specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+** AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+** IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+** DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+** FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+** DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+** SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+** CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+** OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+// clang-format on
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <future>
+#include <vector>
+
+#include "maxon_epos_ethercat_sdk/Maxon.hpp"
+
+namespace maxon {
+/*!
+ * Targets of all drives of a MaxonGroup in user units (rad, rad/s, Nm), one
+ * entry per drive.
+ */
+struct MaxonGroupCommand {
+  void resize(size_t numberOfDrives);
+
+  std::vector<double> targetPosition_;
+  std::vector<double> targetVelocity_;
+  std::vector<double> targetTorque_;
+  std::vector<double> positionOffset_;
+  std::vector<double> velocityOffset_;
+  std::vector<double> torqueOffset_;
+  std::vector<ModeOfOperationEnum> modeOfOperation_;
+};
+
+/*!
+ * Actual values of all drives of a MaxonGroup in user units (rad, rad/s, A,
+ * Nm), one entry per drive.
+ */
+struct MaxonGroupReading {
+  void resize(size_t numberOfDrives);
+
+  std::vector<double> actualPosition_;
+  std::vector<double> actualVelocity_;
+  std::vector<double> actualCurrent_;
+  std::vector<double> actualTorque_;
+  std::vector<uint16_t> statusword_;
+  std::vector<DecodedStatusword> decodedStatusword_;
+  std::vector<uint64_t> sequenceNumber_;
+};
+
+/*!
+ * @brief	Stages the commands and collects the readings of several drives
+ * at once
+ * The unit conversions of all drives are done in one pass over contiguous
+ * arrays, which the compiler can vectorize. Staging and reading never lock,
+ * see Maxon::stageRawCommand() and Maxon::getReadingSnapshot().
+ * The conversion factors of a drive are copied again whenever they change,
+ * e.g. when startup() reads the rated current.
+ */
+class MaxonGroup {
+ public:
+  explicit MaxonGroup(std::vector<Maxon::SharedPtr> drives);
+
+  size_t size() const { return drives_.size(); }
+  const std::vector<Maxon::SharedPtr>& getDrives() const { return drives_; }
+
+  /*!
+   * Copy the conversion factors of all drives. Not required in general, the
+   * factors of a drive are copied again by stageCommands() and getReadings()
+   * once they changed. Must not be called concurrently with those.
+   */
+  void updateConversionFactors();
+
+  /*!
+   * Convert the targets of all drives and hand them over to the EtherCAT
+   * thread. Must always be called from the same thread.
+   * @param[in] command	targets of all drives, resized with size()
+   * @return	false if the size of the command does not match
+   */
+  bool stageCommands(const MaxonGroupCommand& command);
+
+  /*!
+   * Collect and convert the latest readings of all drives. Must always be
+   * called from the same thread.
+   * @param[out] reading	actual values of all drives, resized if required
+   */
+  void getReadings(MaxonGroupReading& reading);
+
+  bool setDriveStateViaPdo(const DriveState& driveState,
+                           const bool waitForState);
+  std::future<bool> setDriveStateViaPdoAsync(const DriveState& driveState);
+
+  /*!
+   * Start all drives concurrently, see Maxon::startupDrives().
+   */
+  bool startup(unsigned int maxNumberOfThreads = 0);
+  /*!
+   * Start all drives concurrently when the bus starts the first one, see
+   * Maxon::setParallelStartup().
+   */
+  void setParallelStartup(unsigned int maxNumberOfThreads = 0);
+  /*!
+   * Process data and estimated frame time of all drives, see
+   * Maxon::planBus().
+   */
+  BusPlan planBus() const;
+
+ protected:
+  std::vector<Maxon::SharedPtr> drives_;
+
+  // copy the factors of the drives which changed since the last copy
+  void refreshCommandFactors();
+  void refreshReadingFactors();
+
+  // conversion factors, one entry per drive, each set with the version of
+  // Maxon::getConversionFactorsVersion() it has been copied at. The command
+  // and the reading factors are refreshed separately since stageCommands()
+  // and getReadings() may run on different threads.
+  std::vector<double> positionFactorRadToInteger_;
+  std::vector<double> torqueFactorNmToInteger_;
+  std::vector<uint64_t> commandFactorsVersion_;
+  std::vector<double> positionFactorIntegerToRad_;
+  std::vector<double> currentFactorIntegerToAmp_;
+  std::vector<double> torqueFactorIntegerToNm_;
+  std::vector<uint64_t> readingFactorsVersion_;
+
+  // preallocated buffers of the raw values
+  std::vector<int32_t> targetPositionRaw_;
+  std::vector<int32_t> targetVelocityRaw_;
+  std::vector<int16_t> targetTorqueRaw_;
+  std::vector<int32_t> positionOffsetRaw_;
+  std::vector<int32_t> velocityOffsetRaw_;
+  std::vector<int16_t> torqueOffsetRaw_;
+  std::vector<ReadingSnapshot> snapshots_;
+};
+
+}  // namespace maxon
@@ -30,6 +30,8 @@
 */
 // clang-format on
 
+#pragma once
+
 #include <cstdint>
 #include <vector>
 
@@ -48,6 +50,7 @@
 
 #define OD_INDEX_ERROR_REGISTER (0x1001)
 #define OD_INDEX_ERROR_HISTORY (0x1003)
+#define OD_INDEX_IDENTITY_OBJECT (0x1018)
 #define OD_INDEX_DIAGNOSIS (0x10F3)
 #define OD_INDEX_5VDC_SUPPLY (0x2200)
 #define OD_INDEX_MOTOR_DATA (0x3001)
@@ -65,6 +68,7 @@
 #define OD_INDEX_FOLLOW_ERROR_WINDOW (0x6065)
 #define OD_INDEX_VELOCITY_DEMAND (0x606B)
 #define OD_INDEX_SENSOR_SSI (0x3012)
+#define OD_INDEX_ANALOG_INPUTS (0x3160)
 #define OD_INDEX_HALL_SENSOR (0x301A)
 #define OD_INDEX_VELOCITY_ACTUAL (0x606C)
 #define OD_INDEX_TARGET_TORQUE (0x6071)
@@ -0,0 +1,129 @@
+// clang-format off
+/*
+** Copyright 2021 Robotic Systems Lab - ETH Zurich:
+** Linghao Zhang, Jonas Junger, Lennart Nachtigall
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions are met:
+**
+** 1. Redistributions of source code must retain the above copyright notice,
+**    this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright notice,
+**    this list of conditions and the following disclaimer in the documentation
+**    and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its contributors
+**    may be used to endorse or promote products derived from this software without
+**    specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+** AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+** IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+** DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+** FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+** DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+** SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+** CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+** OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+// clang-format on
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+namespace maxon {
+/*!
+ * One object of a PDO mapping (e.g. 0x1602 subindex 1..n).
+ */
+struct PdoMappingEntry {
+  uint16_t index_;
+  uint8_t subIndex_;
+  uint8_t bitLength_;
+
+  /*!
+   * @return	the value which is written to the PDO mapping object
+   */
+  constexpr uint32_t getMappingObject() const {
+    return (static_cast<uint32_t>(index_) << 16) |
+           (static_cast<uint32_t>(subIndex_) << 8) |
+           static_cast<uint32_t>(bitLength_);
+  }
+};
+
+/*!
+ * @param[in] mapping	the objects of a PDO mapping
+ * @return	the size of the mapped process data in bytes
+ */
+template <std::size_t N>
+constexpr std::size_t getPdoMappingSize(
+    const std::array<PdoMappingEntry, N>& mapping) {
+  std::size_t bits = 0;
+  for (std::size_t i = 0; i < N; i++) {
+    bits += mapping[i].bitLength_;
+  }
+  return bits / 8;
+}
+
+/*!
+ * A PDO mapping object (e.g. 0x1602) as it is transferred with SDO Complete
+ * Access. Subindex 0 is padded to 16 bit in a Complete Access transfer.
+ */
+template <std::size_t N>
+struct PdoMappingObject {
+  uint8_t numberOfEntries_{0};
+  uint8_t padding_{0};
+  uint32_t entries_[N];
+
+  bool operator==(const PdoMappingObject& other) const {
+    return numberOfEntries_ == other.numberOfEntries_ &&
+           std::memcmp(static_cast<const void*>(entries_),
+                       static_cast<const void*>(other.entries_),
+                       sizeof(entries_)) == 0;
+  }
+} __attribute__((packed));
+
+/*!
+ * A PDO assignment object (0x1C12 / 0x1C13) with a single assigned mapping,
+ * as it is transferred with SDO Complete Access.
+ */
+struct PdoAssignmentObject {
+  uint8_t numberOfEntries_{0};
+  uint8_t padding_{0};
+  uint16_t mappingIndex_{0};
+
+  bool operator==(const PdoAssignmentObject& other) const {
+    return numberOfEntries_ == other.numberOfEntries_ &&
+           mappingIndex_ == other.mappingIndex_;
+  }
+} __attribute__((packed));
+
+/*!
+ * @param[in] mapping	the objects of a PDO mapping
+ * @return	the mapping object which is written with Complete Access
+ */
+template <std::size_t N>
+PdoMappingObject<N> getPdoMappingObject(
+    const std::array<PdoMappingEntry, N>& mapping) {
+  PdoMappingObject<N> mappingObject;
+  mappingObject.numberOfEntries_ = static_cast<uint8_t>(N);
+  for (std::size_t i = 0; i < N; i++) {
+    mappingObject.entries_[i] = mapping[i].getMappingObject();
+  }
+  return mappingObject;
+}
+
+/*!
+ * Checks at compile time that a PDO struct matches its mapping.
+ */
+template <typename Pdo>
+constexpr bool pdoMatchesMapping() {
+  return sizeof(Pdo) == getPdoMappingSize(Pdo::getMapping());
+}
+
+}  // namespace maxon
@@ -0,0 +1,116 @@
+// clang-format off
+/*
+** Copyright 2021 Robotic Systems Lab - ETH Zurich:
+** Linghao Zhang, Jonas Junger, Lennart Nachtigall
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions are met:
+**
+** 1. Redistributions of source code must retain the above copyright notice,
+**    this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright notice,
+**    this list of conditions and the following disclaimer in the documentation
+**    and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its contributors
+**    may be used to endorse or promote products derived from this software without
+**    specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+** AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+** IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+** DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+** FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+** DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+** SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+** CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+** OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+// clang-format on
+
+#pragma once
+
+#include <cstddef>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "maxon_epos_ethercat_sdk/Configuration.hpp"
+#include "maxon_epos_ethercat_sdk/PdoTypeEnum.hpp"
+
+namespace maxon {
+/*!
+ * The PDO mapping of one drive and its size on the wire.
+ */
+struct PdoPlan {
+  RxPdoTypeEnum rxPdoType_{RxPdoTypeEnum::NA};
+  TxPdoTypeEnum txPdoType_{TxPdoTypeEnum::NA};
+  /// objects of the custom PDOs, empty if a fixed PDO type is used
+  std::vector<std::string> rxObjects_;
+  std::vector<std::string> txObjects_;
+  /// size of the process data [bytes]
+  std::size_t rxSize_{0};
+  std::size_t txSize_{0};
+  /// size of the PDOs derived from the modes of operation [bytes]
+  std::size_t defaultRxSize_{0};
+  std::size_t defaultTxSize_{0};
+};
+
+/*!
+ * Process data and estimated frame time of all drives of a bus.
+ */
+struct BusPlan {
+  std::size_t numberOfDrives_{0};
+  /// process data of all drives [bytes]
+  std::size_t rxSize_{0};
+  std::size_t txSize_{0};
+  /// same, with the PDOs derived from the modes of operation
+  std::size_t defaultRxSize_{0};
+  std::size_t defaultTxSize_{0};
+  std::size_t numberOfFrames_{0};
+  /// bytes on the wire per cycle, including preamble and inter-frame gap
+  std::size_t wireSize_{0};
+  /// estimated round trip time of the process data frames [us]
+  double frameTime_{0};
+  unsigned int cycleTime_{0};
+  /// frameTime_ / cycleTime_
+  double utilization_{0};
+};
+
+/*!
+ * Share of the cycle the process data frames may take, the rest is left to
+ * the master and to its jitter.
+ */
+constexpr double maxBusUtilization = 0.5;
+
+/*!
+ * Plan the PDO mapping of a drive.
+ * Custom PDOs of the configuration are used as they are. Otherwise, with
+ * minimizePdoMapping, the Rx PDO only contains the controlword, the mode of
+ * operation (if more than one mode is configured, the single mode is written
+ * via SDO at startup), the targets of the configured modes and the
+ * usedPdoObjects. The Tx PDO contains the statusword and the usedPdoObjects,
+ * or the objects derived from the modes if none of them is a Tx object.
+ * Without minimizePdoMapping the PDOs derived from the modes are used.
+ */
+PdoPlan planPdoMapping(
+    const Configuration& configuration,
+    const std::pair<RxPdoTypeEnum, TxPdoTypeEnum>& pdoTypeSolution);
+
+/*!
+ * Estimate the round trip time of the process data of these drives on a
+ * 100 Mbit/s line: the wire time of the logical read / write frames plus the
+ * forwarding delay of every slave. Other slaves of the bus are not included.
+ * @param[in] cycleTime	the cycle time [us]
+ * @param[in] distributedClock	a frame also carries the DC time datagram
+ */
+BusPlan planBus(const std::vector<PdoPlan>& plans, unsigned int cycleTime,
+                bool distributedClock);
+
+std::ostream& operator<<(std::ostream& os, const PdoPlan& plan);
+std::ostream& operator<<(std::ostream& os, const BusPlan& plan);
+
+}  // namespace maxon
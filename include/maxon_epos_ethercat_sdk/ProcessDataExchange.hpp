@@ -0,0 +1,70 @@
+// clang-format off
+/*
+** Copyright 2021 Robotic Systems Lab - ETH Zurich:
+** Linghao Zhang, Jonas Junger, Lennart Nachtigall
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions are met:
+**
+** 1. Redistributions of source code must retain the above copyright notice,
+**    this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright notice,
+**    this list of conditions and the following disclaimer in the documentation
+**    and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its contributors
+**    may be used to endorse or promote products derived from this software without
+**    specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+** AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+** IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+** DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+** FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+** DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+** SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+** CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+** OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+// clang-format on
+
+#pragma once
+
+#include <ethercat_sdk_master/EthercatDevice.hpp>
+
+namespace maxon {
+/*!
+ * @brief	Exchange of the process data frame of one bus
+ * Called by the BusExecutor once per cycle: receive() before updateRead() of
+ * the drives of the bus, send() after their updateWrite().
+ * Implemented by SoemProcessDataExchange and VirtualEpos4BusExchange.
+ */
+class ProcessDataExchange {
+ public:
+  virtual ~ProcessDataExchange() = default;
+
+  /// receive the frame which was sent by the last send()
+  virtual void receive() = 0;
+  /// send the Rx PDOs written by the drives
+  virtual void send() = 0;
+};
+
+/*!
+ * Process data exchange of a SOEM bus, see EthercatBusBase::updateRead() and
+ * EthercatBusBase::updateWrite().
+ */
+class SoemProcessDataExchange : public ProcessDataExchange {
+ public:
+  explicit SoemProcessDataExchange(soem_interface::EthercatBusBase* bus)
+      : bus_(bus) {}
+
+  void receive() override { bus_->updateRead(); }
+  void send() override { bus_->updateWrite(); }
+
+ private:
+  soem_interface::EthercatBusBase* bus_;
+};
+
+}  // namespace maxon
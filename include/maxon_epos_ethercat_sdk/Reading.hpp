@@ -38,12 +38,14 @@
 #include <iomanip>
 #include <iostream>
 #include <string>
+#include <type_traits>
 #define _USE_MATH_DEFINES
 #include <cmath>
 
 #include "maxon_epos_ethercat_sdk/Configuration.hpp"
 #include "maxon_epos_ethercat_sdk/DriveState.hpp"
 #include "maxon_epos_ethercat_sdk/Error.hpp"
+#include "maxon_epos_ethercat_sdk/RingBuffer.hpp"
 #include "maxon_epos_ethercat_sdk/Statusword.hpp"
 
 namespace maxon {
@@ -62,6 +64,35 @@ using FaultPair = std::pair<uint16_t, ReadingTimePoint>;
 using ErrorTimePairDeque = std::deque<std::pair<ErrorType, double>>;
 using FaultTimePairDeque = std::deque<std::pair<uint16_t, double>>;
 
+/*!
+ * The raw values of a Reading which are updated from the Tx PDO every cycle.
+ * This is a trivially copyable type, such that it can be handed over from
+ * the EtherCAT thread to any number of consumers without locking.
+ */
+struct ReadingSnapshot {
+  int32_t actualPosition_{0};
+  int32_t digitalInputs_{0};
+  int32_t actualVelocity_{0};
+  int32_t demandVelocity_{0};
+  uint16_t statusword_{0};
+  // decoded by Maxon::updateRead(), the edges are relative to the previous
+  // Tx PDO
+  DecodedStatusword decodedStatusword_;
+  int16_t analogInput_{0};
+  int16_t actualCurrent_{0};
+  uint32_t busVoltage_{0};
+
+  ReadingTimePoint timePoint_;
+
+  /*!
+   * Incremented by one for every Tx PDO that has been read.
+   * Equal sequence numbers belong to the same EtherCAT cycle.
+   */
+  uint64_t sequenceNumber_{0};
+};
+static_assert(std::is_trivially_copyable<ReadingSnapshot>::value,
+              "ReadingSnapshot must stay trivially copyable");
+
 class Reading {
  public:
   /*!
@@ -91,7 +122,9 @@ class Reading {
   int32_t getDigitalInputs() const;
   Statusword getStatusword() const;
   std::string getDigitalInputString() const;
+  // decoded once per statusword, O(1)
   DriveState getDriveState() const;
+  const DecodedStatusword& getDecodedStatusword() const;
 
   /*!
    * set methods (only raw)
@@ -104,6 +137,7 @@ class Reading {
 
   void setDemandVelocity(int32_t demandVelocity);
 
+  // also decodes the statusword, the edges are relative to the previous one
   void setStatusword(uint16_t statusword);
 
   void setAnalogInput(int16_t analogInput);
@@ -120,15 +154,15 @@ class Reading {
 
   void setTorqueFactorIntegerToNm(double torqueFactor);
 
+  /*!
+   * Access to the raw values which are updated every cycle.
+   */
+  const ReadingSnapshot& getSnapshot() const;
+  void setSnapshot(const ReadingSnapshot& snapshot);
+  uint64_t getSequenceNumber() const;
+
  protected:
-  int32_t actualPosition_{0};
-  int32_t digitalInputs_{0};
-  int32_t actualVelocity_{0};
-  int32_t demandVelocity_{0};
-  uint16_t statusword_{0};
-  int16_t analogInput_{0};
-  int16_t actualCurrent_{0};
-  uint32_t busVoltage_{0};
+  ReadingSnapshot snapshot_;
 
   double positionFactorIntegerToRad_{1};
   static constexpr double velocityFactorMicroRPMToRadPerSec_ =
@@ -136,8 +170,6 @@ class Reading {
   double currentFactorIntegerToAmp_{1};
   double torqueFactorIntegerToNm_{1};
 
-  ReadingTimePoint lastReadingTimePoint_;
-
  public:
   /*!
    * returns the age of the last added error in microseconds
@@ -162,6 +194,17 @@ class Reading {
    */
   FaultTimePairDeque getFaults() const;
 
+  /*!
+   * Allocation free access to the stored errors and faults.
+   * Index 0 is the newest entry.
+   * @param[in] index	must be smaller than the number of stored entries
+   * @return	the error / fault and its age in microseconds
+   */
+  unsigned int getNumberOfErrors() const;
+  unsigned int getNumberOfFaults() const;
+  std::pair<ErrorType, double> getError(unsigned int index) const;
+  std::pair<uint16_t, double> getFault(unsigned int index) const;
+
   /*!
    * Returns the last Error that occured
    * @return	The error type of tha last error
@@ -180,12 +223,16 @@ class Reading {
    * @param errorType	The type of the error
    */
   void addError(ErrorType errorType);
+  /// same, with the time point at which the error occurred
+  void addError(ErrorType errorType, ReadingTimePoint timePoint);
   /*!
    * Adds a fault code to the reading
    * A time point is set automatically
    * @param faultCode	The Code of the fault
    */
   void addFault(uint16_t faultCode);
+  /// same, with the time point at which the fault occurred
+  void addFault(uint16_t faultCode, ReadingTimePoint timePoint);
 
   /*!
    * The default constructor
@@ -217,8 +264,11 @@ class Reading {
           bool forceAppendEqualError, bool forceAppendEqualFault);
 
  private:
-  std::deque<ErrorPair> errors_;
-  std::deque<FaultPair> faults_;
+  /*!
+   * preallocated storage, the capacities are set by the Configuration
+   */
+  RingBuffer<ErrorPair> errors_{25};
+  RingBuffer<FaultPair> faults_{25};
 
   ErrorPair lastError_;
   FaultPair lastFault_;
@@ -229,8 +279,6 @@ class Reading {
   /*!
    * paramaters changeable with a Configuration object
    */
-  unsigned int errorStorageCapacity_{25};
-  unsigned int faultStorageCapacity_{25};
   bool forceAppendEqualError_{false};
   bool forceAppendEqualFault_{false};
 };
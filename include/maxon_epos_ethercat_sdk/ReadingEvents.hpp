@@ -0,0 +1,190 @@
+// clang-format off
+/*
+** Copyright 2021 Robotic Systems Lab - ETH Zurich:
+** Linghao Zhang, Jonas Junger, Lennart Nachtigall
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions are met:
+**
+** 1. Redistributions of source code must retain the above copyright notice,
+**    this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright notice,
+**    this list of conditions and the following disclaimer in the documentation
+**    and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its contributors
+**    may be used to endorse or promote products derived from this software without
+**    specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+** AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+** IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+** DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+** FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+** DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+** SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+** CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+** OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+// clang-format on
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "maxon_epos_ethercat_sdk/BoundedQueue.hpp"
+#include "maxon_epos_ethercat_sdk/ConversionFactors.hpp"
+#include "maxon_epos_ethercat_sdk/Reading.hpp"
+
+namespace maxon {
+enum class ReadingEventType : uint8_t {
+  // value: new raw statusword, previous value: last raw statusword
+  StatuswordChanged,
+  // value / previous value: the drive states as integers
+  DriveStateChanged,
+  // value: the ErrorType as integer
+  Error,
+  // value: the error code (0x603F) read after the fault bit has risen
+  Fault,
+  // value: the raw value, index: the index of the threshold
+  ThresholdCrossed,
+  // value: the raw value, previous value: the raw limit, index: the
+  // LimitQuantity, see LimitGuard
+  LimitViolation,
+  NumberOfTypes
+};
+
+std::string getReadingEventTypeString(ReadingEventType type);
+
+constexpr uint32_t readingEventMask(ReadingEventType type) {
+  return 1u << static_cast<uint8_t>(type);
+}
+constexpr uint32_t allReadingEvents = 0xFFFFFFFF;
+
+/*!
+ * A change of the reading, detected by Maxon::updateRead().
+ * Trivially copyable such that it can be queued without allocating.
+ */
+struct ReadingEvent {
+  ReadingEventType type_{ReadingEventType::NumberOfTypes};
+  // ThresholdCrossed only: true if the value rose above the threshold
+  bool rising_{false};
+  uint32_t address_{0};
+  std::size_t index_{0};
+  int64_t previousValue_{0};
+  int64_t value_{0};
+  // the sequence number of the reading snapshot the event was detected in,
+  // 0 for errors and faults, which are not bound to a reading
+  uint64_t sequenceNumber_{0};
+  ReadingTimePoint timePoint_;
+};
+static_assert(std::is_trivially_copyable<ReadingEvent>::value,
+              "ReadingEvent must stay trivially copyable");
+
+enum class ReadingQuantity : uint8_t {
+  ActualPosition,  // rad
+  ActualVelocity,  // rad/s
+  DemandVelocity,  // rad/s
+  ActualCurrent,   // A
+  ActualTorque,    // Nm
+  AnalogInput,     // V
+  BusVoltage       // V
+};
+
+/*!
+ * Emit a ThresholdCrossed event whenever the quantity crosses the threshold,
+ * in either direction. The threshold is given in user units and compared
+ * with the raw values, converted again whenever the conversion factors of
+ * the drive change.
+ */
+struct ReadingThreshold {
+  ReadingQuantity quantity_{ReadingQuantity::ActualPosition};
+  double threshold_{0.0};
+};
+
+/*!
+ * @brief	Queue of the reading events of one subscriber
+ * Filled by the EtherCAT thread (and the SDO worker for faults) without
+ * locking or allocating. Events are dropped and counted if the subscriber
+ * does not keep up.
+ */
+class ReadingSubscription {
+ public:
+  typedef std::shared_ptr<ReadingSubscription> SharedPtr;
+  static constexpr std::size_t capacity = 256;
+
+  ReadingSubscription(uint32_t eventMask,
+                      const std::vector<ReadingThreshold>& thresholds);
+
+  /*!
+   * Take the oldest event without blocking.
+   * @param[out] event	the event
+   * @return	false if there is no event
+   */
+  bool tryPop(ReadingEvent& event) { return queue_.tryPop(event); }
+
+  /*!
+   * Wait for the next event.
+   * @param[out] event	the event
+   * @param[in] timeout	the maximum time to wait
+   * @return	false if no event arrived within the timeout
+   */
+  bool waitPop(ReadingEvent& event, std::chrono::microseconds timeout);
+
+  uint32_t getEventMask() const { return eventMask_; }
+  uint64_t getNumberOfDroppedEvents() const {
+    return droppedEvents_.load(std::memory_order_relaxed);
+  }
+
+ protected:
+  friend class Maxon;
+
+  struct RawThreshold {
+    ReadingQuantity quantity_;
+    double threshold_;
+    // threshold_ in drive units
+    double rawThreshold_;
+    // -1: unknown, 0: below, 1: above, only accessed by the EtherCAT thread
+    int8_t state_{-1};
+  };
+
+  bool wants(ReadingEventType type) const {
+    return (eventMask_ & readingEventMask(type)) != 0;
+  }
+  // lock-free, wakes a waiting consumer
+  void push(const ReadingEvent& event);
+  /*!
+   * Compare the snapshot with the thresholds, called by the EtherCAT thread.
+   * The thresholds are converted again if the version of the conversion
+   * factors differs from the one of the last call.
+   */
+  void checkThresholds(const ReadingSnapshot& snapshot, uint32_t address,
+                       const ConversionFactors& conversionFactors,
+                       uint64_t conversionFactorsVersion);
+
+  const uint32_t eventMask_;
+  std::vector<RawThreshold> thresholds_;
+  // only accessed by the EtherCAT thread
+  uint64_t conversionFactorsVersion_{0};
+  bool hasRawThresholds_{false};
+  BoundedQueue<ReadingEvent, capacity> queue_;
+  std::atomic<uint64_t> droppedEvents_{0};
+
+  // consumers blocked in waitPop()
+  std::atomic<int> waiters_{0};
+  std::mutex waitMutex_;
+  std::condition_variable waitCondition_;
+};
+
+}  // namespace maxon
@@ -0,0 +1,113 @@
+// clang-format off
+/*
+** Copyright 2021 Robotic Systems Lab - ETH Zurich:
+** Linghao Zhang, Jonas Junger, Lennart Nachtigall
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions are met:
+**
+** 1. Redistributions of source code must retain the above copyright notice,
+**    this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright notice,
+**    this list of conditions and the following disclaimer in the documentation
+**    and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its contributors
+**    may be used to endorse or promote products derived from this software without
+**    specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+** AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+** IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+** DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+** FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+** DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+** SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+** CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+** OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+// clang-format on
+
+#pragma once
+
+#include <vector>
+
+namespace maxon {
+/*!
+ * @brief	Fixed capacity ring buffer
+ * The storage is allocated once when the capacity is set. Adding elements
+ * never allocates, the oldest element is dropped as soon as the buffer is
+ * full. Elements are indexed from the newest (0) to the oldest (size - 1).
+ */
+template <typename T>
+class RingBuffer {
+ public:
+  explicit RingBuffer(unsigned int capacity = 0) { setCapacity(capacity); }
+
+  /*!
+   * Change the capacity.
+   * This allocates and clears the buffer if the capacity changes, it is a
+   * no-op otherwise.
+   * @param[in] capacity	the maximum number of stored elements
+   */
+  void setCapacity(unsigned int capacity) {
+    if (capacity == storage_.size()) {
+      return;
+    }
+    storage_.assign(capacity, T{});
+    clear();
+  }
+
+  /*!
+   * Add a new element in front, overwrites the oldest one if full.
+   * @param[in] value	the new element
+   */
+  void pushFront(const T& value) {
+    if (storage_.empty()) {
+      return;
+    }
+    front_ = (front_ + storage_.size() - 1) % storage_.size();
+    storage_[front_] = value;
+    if (size_ < storage_.size()) {
+      size_++;
+    }
+  }
+
+  /*!
+   * Overwrite the newest element, adds it if the buffer is empty.
+   * @param[in] value	the new element
+   */
+  void replaceFront(const T& value) {
+    if (size_ == 0) {
+      pushFront(value);
+    } else {
+      storage_[front_] = value;
+    }
+  }
+
+  void clear() {
+    front_ = 0;
+    size_ = 0;
+  }
+
+  /*!
+   * @param[in] index	0 is the newest element
+   * @return	the element, index must be smaller than size()
+   */
+  const T& operator[](unsigned int index) const {
+    return storage_[(front_ + index) % storage_.size()];
+  }
+
+  unsigned int size() const { return size_; }
+  unsigned int capacity() const { return storage_.size(); }
+  bool empty() const { return size_ == 0; }
+
+ private:
+  std::vector<T> storage_;
+  unsigned int front_{0};
+  unsigned int size_{0};
+};
+
+}  // namespace maxon
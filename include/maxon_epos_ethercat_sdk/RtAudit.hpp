@@ -0,0 +1,234 @@
+// clang-format off
+/*
+** Copyright 2021 Robotic Systems Lab - ETH Zurich:
+** Linghao Zhang, Jonas Junger, Lennart Nachtigall
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions are met:
+**
+** 1. Redistributions of source code must retain the above copyright notice,
+**    this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright notice,
+**    this list of conditions and the following disclaimer in the documentation
+**    and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its contributors
+**    may be used to endorse or promote products derived from this software without
+**    specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+** AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+** IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+** DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+** FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+** DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+** SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+** CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+** OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+// clang-format on
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <string>
+
+#include "maxon_epos_ethercat_sdk/SeqLock.hpp"
+
+namespace maxon {
+/*!
+ * What the cyclic update must not do (or only a few times per cycle).
+ */
+enum class RtAuditEventType : uint8_t {
+  Allocation = 0,
+  Lock,
+  // waiting for a contended mutex or a call which may enter the kernel
+  BlockingCall,
+  NumberOfTypes
+};
+
+constexpr std::size_t numberOfRtAuditEventTypes =
+    static_cast<std::size_t>(RtAuditEventType::NumberOfTypes);
+
+std::string getRtAuditEventTypeString(RtAuditEventType type);
+
+/*!
+ * An event beyond the allowed number per cycle. The strings are static, the
+ * violation can therefore be copied around freely.
+ */
+struct RtAuditViolation {
+  RtAuditEventType type_{RtAuditEventType::Allocation};
+  // the innermost audited site, e.g. "Maxon::addErrorToReading"
+  const char* site_{""};
+  // the audited method, e.g. "Maxon::updateRead"
+  const char* scope_{""};
+  const char* driveName_{""};
+  uint64_t cycle_{0};
+  // events of this type in the cycle so far
+  uint64_t count_{0};
+
+  friend std::ostream& operator<<(std::ostream& os,
+                                  const RtAuditViolation& violation);
+};
+
+/*!
+ * Events of the audited cycles, see RtAudit.
+ */
+struct RtAuditStatistics {
+  uint64_t numberOfCycles_{0};
+  uint64_t numberOfViolatingCycles_{0};
+  uint64_t numberOfViolations_{0};
+  std::array<uint64_t, numberOfRtAuditEventTypes> total_{};
+  std::array<uint64_t, numberOfRtAuditEventTypes> maxPerCycle_{};
+  // only valid if numberOfViolations_ > 0
+  RtAuditViolation firstViolation_;
+  RtAuditViolation lastViolation_;
+
+  friend std::ostream& operator<<(std::ostream& os,
+                                  const RtAuditStatistics& statistics);
+};
+
+/*!
+ * The hooks, which only count if an audit is active on the calling thread.
+ */
+namespace rt_audit {
+bool isActive();
+void recordAllocation();
+/// a contended lock also counts as blocking call
+void recordLock(const char* site, bool contended = false);
+void recordBlockingCall(const char* site);
+}  // namespace rt_audit
+
+/*!
+ * @brief	Counts allocations, locks and blocking calls of the cyclic update
+ * of one drive
+ * The counters are incremented by the hooks in rt_audit while an RtAuditScope
+ * of this audit is active on the calling thread. A cycle starts with
+ * updateRead() and ends with the next one. Events beyond the allowed number
+ * per cycle are violations: their site is recorded and the violation handler
+ * is called, e.g. abortOnViolation() to fail fast in tests.
+ * Allocations are only seen if the library is built with RT_AUDIT_ALLOCATIONS
+ * (which replaces the global operator new), or if the application forwards
+ * its own operator new to rt_audit::recordAllocation().
+ */
+class RtAudit {
+ public:
+  using SharedPtr = std::shared_ptr<RtAudit>;
+  // called on the EtherCAT thread, must not throw
+  using ViolationHandler = void (*)(const RtAuditViolation&);
+
+  // updateRead() and updateWrite() each take the state machine mutex
+  static constexpr uint64_t defaultAllowedLocksPerCycle = 2;
+
+  RtAudit();
+
+  /// may be called from any thread
+  void setAllowedPerCycle(RtAuditEventType type, uint64_t allowed);
+  void setViolationHandler(ViolationHandler handler);
+
+  /// print the violation to stderr and abort
+  static void abortOnViolation(const RtAuditViolation& violation);
+
+  /// any thread, lock-free
+  RtAuditStatistics getStatistics() const;
+  /// clear the statistics at the start of the next cycle
+  void reset();
+
+ private:
+  friend class RtAuditScope;
+  friend void rt_audit::recordAllocation();
+  friend void rt_audit::recordLock(const char* site, bool contended);
+  friend void rt_audit::recordBlockingCall(const char* site);
+
+  // count an event of the audit which is active on the calling thread
+  static void recordOnCurrentThread(RtAuditEventType type, const char* site);
+  void beginCycle();
+  void record(RtAuditEventType type, const char* site, const char* scope,
+              const char* driveName);
+  void publish() { publishedStatistics_.write(statistics_); }
+
+  std::array<std::atomic<uint64_t>, numberOfRtAuditEventTypes> allowed_;
+  std::atomic<ViolationHandler> violationHandler_{nullptr};
+  std::atomic<bool> resetRequested_{false};
+
+  // only accessed by the thread of the active scope
+  RtAuditStatistics statistics_;
+  std::array<uint64_t, numberOfRtAuditEventTypes> cycleCounts_{};
+  bool cycleViolated_{false};
+  SeqLock<RtAuditStatistics> publishedStatistics_;
+};
+
+/*!
+ * @brief	Activates an audit on the current thread
+ * Scopes do not nest: an inner scope replaces the outer one until it ends.
+ * Without an audit the scope does nothing.
+ */
+class RtAuditScope {
+ public:
+  /*!
+   * @param[in] audit	the audit, may be nullptr
+   * @param[in] scope	static name of the audited method
+   * @param[in] driveName	name of the drive, must outlive the scope
+   * @param[in] beginsCycle	true for the first audited method of a cycle
+   */
+  RtAuditScope(RtAudit* audit, const char* scope, const char* driveName,
+               bool beginsCycle);
+  ~RtAuditScope();
+
+  RtAuditScope(const RtAuditScope&) = delete;
+  RtAuditScope& operator=(const RtAuditScope&) = delete;
+
+ private:
+  RtAudit* audit_;
+  RtAudit* previousAudit_;
+  const char* previousScope_;
+  const char* previousDriveName_;
+  const char* previousSite_;
+};
+
+/*!
+ * @brief	Names the site of the events within its lifetime
+ * Cheap enough to stay in the code when no audit is active.
+ */
+class RtAuditSite {
+ public:
+  explicit RtAuditSite(const char* site);
+  ~RtAuditSite();
+
+  RtAuditSite(const RtAuditSite&) = delete;
+  RtAuditSite& operator=(const RtAuditSite&) = delete;
+
+ private:
+  const char* previousSite_;
+};
+
+/*!
+ * A lock guard which records the acquisition (and whether it had to wait).
+ */
+template <typename Mutex>
+class RtAuditLockGuard {
+ public:
+  RtAuditLockGuard(Mutex& mutex, const char* site) : mutex_(mutex) {
+    const bool contended = !mutex_.try_lock();
+    if (contended) {
+      mutex_.lock();
+    }
+    rt_audit::recordLock(site, contended);
+  }
+  ~RtAuditLockGuard() { mutex_.unlock(); }
+
+  RtAuditLockGuard(const RtAuditLockGuard&) = delete;
+  RtAuditLockGuard& operator=(const RtAuditLockGuard&) = delete;
+
+ private:
+  Mutex& mutex_;
+};
+
+}  // namespace maxon
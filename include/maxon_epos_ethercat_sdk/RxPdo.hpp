@@ -34,11 +34,19 @@
  * @file	RxPdo.hpp
  * @brief	This file contains the PDOs which are sent to the hardware
  * (RxPdo) Note: each struct MUST contain the controlWord_ variable!
+ * Every struct describes its own layout: getMapping() lists the mapped
+ * objects in the order of the struct members and encode() fills the members
+ * from a converted command.
  */
 #pragma once
 
+#include <array>
 #include <cstdint>
 
+#include "maxon_epos_ethercat_sdk/Command.hpp"
+#include "maxon_epos_ethercat_sdk/ObjectDictionary.hpp"
+#include "maxon_epos_ethercat_sdk/PdoMapping.hpp"
+
 namespace maxon {
 /*!
  * Standard Rx PDO type.
@@ -46,7 +54,21 @@ namespace maxon {
 struct RxPdoStandard {
   uint16_t controlWord_;
   int8_t modeOfOperation_;
+
+  static constexpr const char* getName() {
+    return "Standard Mode";
+  }
+  static constexpr std::array<PdoMappingEntry, 2> getMapping() {
+    return {{{OD_INDEX_CONTROLWORD, 0x00, 16},
+             {OD_INDEX_MODES_OF_OPERATION, 0x00, 8}}};
+  }
+  void encode(const RawCommand& command, uint16_t controlword) {
+    controlWord_ = controlword;
+    modeOfOperation_ = static_cast<int8_t>(command.modeOfOperation_);
+  }
 } __attribute__((packed));
+static_assert(pdoMatchesMapping<RxPdoStandard>(),
+              "RxPdoStandard does not match its mapping");
 
 /*!
  * CSP Rx PDO type.
@@ -57,7 +79,27 @@ struct RxPdoCSP {
   int16_t torqueOffset_;
   uint16_t controlWord_;
   int8_t modeOfOperation_;
+
+  static constexpr const char* getName() {
+    return "Cyclic Synchronous Position Mode";
+  }
+  static constexpr std::array<PdoMappingEntry, 5> getMapping() {
+    return {{{OD_INDEX_TARGET_POSITION, 0x00, 32},
+             {OD_INDEX_OFFSET_POSITION, 0x00, 32},
+             {OD_INDEX_OFFSET_TORQUE, 0x00, 16},
+             {OD_INDEX_CONTROLWORD, 0x00, 16},
+             {OD_INDEX_MODES_OF_OPERATION, 0x00, 8}}};
+  }
+  void encode(const RawCommand& command, uint16_t controlword) {
+    targetPosition_ = command.targetPosition_;
+    positionOffset_ = command.positionOffset_;
+    torqueOffset_ = command.torqueOffset_;
+    controlWord_ = controlword;
+    modeOfOperation_ = static_cast<int8_t>(command.modeOfOperation_);
+  }
 } __attribute__((packed));
+static_assert(pdoMatchesMapping<RxPdoCSP>(),
+              "RxPdoCSP does not match its mapping");
 
 /*!
  * CST Rx PDO type.
@@ -67,7 +109,25 @@ struct RxPdoCST {
   int16_t torqueOffset_;
   uint16_t controlWord_;
   int8_t modeOfOperation_;
+
+  static constexpr const char* getName() {
+    return "Cyclic Synchronous Torque Mode";
+  }
+  static constexpr std::array<PdoMappingEntry, 4> getMapping() {
+    return {{{OD_INDEX_TARGET_TORQUE, 0x00, 16},
+             {OD_INDEX_OFFSET_TORQUE, 0x00, 16},
+             {OD_INDEX_CONTROLWORD, 0x00, 16},
+             {OD_INDEX_MODES_OF_OPERATION, 0x00, 8}}};
+  }
+  void encode(const RawCommand& command, uint16_t controlword) {
+    targetTorque_ = command.targetTorque_;
+    torqueOffset_ = command.torqueOffset_;
+    controlWord_ = controlword;
+    modeOfOperation_ = static_cast<int8_t>(command.modeOfOperation_);
+  }
 } __attribute__((packed));
+static_assert(pdoMatchesMapping<RxPdoCST>(),
+              "RxPdoCST does not match its mapping");
 
 /*!
  * CSV Rx PDO type.
@@ -77,7 +137,25 @@ struct RxPdoCSV {
   int32_t velocityOffset_;
   uint16_t controlWord_;
   int8_t modeOfOperation_;
+
+  static constexpr const char* getName() {
+    return "Cyclic Synchronous Velocity Mode";
+  }
+  static constexpr std::array<PdoMappingEntry, 4> getMapping() {
+    return {{{OD_INDEX_TARGET_VELOCITY, 0x00, 32},
+             {OD_INDEX_OFFSET_VELOCITY, 0x00, 32},
+             {OD_INDEX_CONTROLWORD, 0x00, 16},
+             {OD_INDEX_MODES_OF_OPERATION, 0x00, 8}}};
+  }
+  void encode(const RawCommand& command, uint16_t controlword) {
+    targetVelocity_ = command.targetVelocity_;
+    velocityOffset_ = command.velocityOffset_;
+    controlWord_ = controlword;
+    modeOfOperation_ = static_cast<int8_t>(command.modeOfOperation_);
+  }
 } __attribute__((packed));
+static_assert(pdoMatchesMapping<RxPdoCSV>(),
+              "RxPdoCSV does not match its mapping");
 
 // Mixed operation mode for CST and CSP
 struct RxPdoCSTCSP {
@@ -87,7 +165,29 @@ struct RxPdoCSTCSP {
   int32_t positionOffset_;
   uint16_t controlWord_;
   int8_t modeOfOperation_;
+
+  static constexpr const char* getName() {
+    return "Cyclic Synchronous Torque/Position Mixed Mode";
+  }
+  static constexpr std::array<PdoMappingEntry, 6> getMapping() {
+    return {{{OD_INDEX_TARGET_TORQUE, 0x00, 16},
+             {OD_INDEX_OFFSET_TORQUE, 0x00, 16},
+             {OD_INDEX_TARGET_POSITION, 0x00, 32},
+             {OD_INDEX_OFFSET_POSITION, 0x00, 32},
+             {OD_INDEX_CONTROLWORD, 0x00, 16},
+             {OD_INDEX_MODES_OF_OPERATION, 0x00, 8}}};
+  }
+  void encode(const RawCommand& command, uint16_t controlword) {
+    targetTorque_ = command.targetTorque_;
+    torqueOffset_ = command.torqueOffset_;
+    targetPosition_ = command.targetPosition_;
+    positionOffset_ = command.positionOffset_;
+    controlWord_ = controlword;
+    modeOfOperation_ = static_cast<int8_t>(command.modeOfOperation_);
+  }
 } __attribute__((packed));
+static_assert(pdoMatchesMapping<RxPdoCSTCSP>(),
+              "RxPdoCSTCSP does not match its mapping");
 
 // Mixed operation mode for CST, CSP and CSV
 struct RxPdoCSTCSPCSV {
@@ -99,7 +199,33 @@ struct RxPdoCSTCSPCSV {
   int32_t velocityOffset_;
   uint16_t controlWord_;
   int8_t modeOfOperation_;
+
+  static constexpr const char* getName() {
+    return "Cyclic Synchronous Torque/Position/Velocity Mixed Mode";
+  }
+  static constexpr std::array<PdoMappingEntry, 8> getMapping() {
+    return {{{OD_INDEX_TARGET_TORQUE, 0x00, 16},
+             {OD_INDEX_OFFSET_TORQUE, 0x00, 16},
+             {OD_INDEX_TARGET_POSITION, 0x00, 32},
+             {OD_INDEX_OFFSET_POSITION, 0x00, 32},
+             {OD_INDEX_TARGET_VELOCITY, 0x00, 32},
+             {OD_INDEX_OFFSET_VELOCITY, 0x00, 32},
+             {OD_INDEX_CONTROLWORD, 0x00, 16},
+             {OD_INDEX_MODES_OF_OPERATION, 0x00, 8}}};
+  }
+  void encode(const RawCommand& command, uint16_t controlword) {
+    targetTorque_ = command.targetTorque_;
+    torqueOffset_ = command.torqueOffset_;
+    targetPosition_ = command.targetPosition_;
+    positionOffset_ = command.positionOffset_;
+    targetVelocity_ = command.targetVelocity_;
+    velocityOffset_ = command.velocityOffset_;
+    controlWord_ = controlword;
+    modeOfOperation_ = static_cast<int8_t>(command.modeOfOperation_);
+  }
 } __attribute__((packed));
+static_assert(pdoMatchesMapping<RxPdoCSTCSPCSV>(),
+              "RxPdoCSTCSPCSV does not match its mapping");
 
 struct RxPdoPVM {
   uint16_t controlWord_;
@@ -107,6 +233,26 @@ struct RxPdoPVM {
   uint32_t profileAccel_;
   uint32_t profileDeccel_;
   int16_t motionProfileType_;
+
+  static constexpr const char* getName() {
+    return "Profile Velocity Mode";
+  }
+  static constexpr std::array<PdoMappingEntry, 5> getMapping() {
+    return {{{OD_INDEX_CONTROLWORD, 0x00, 16},
+             {OD_INDEX_TARGET_VELOCITY, 0x00, 32},
+             {OD_INDEX_PROFILE_ACCELERATION, 0x00, 32},
+             {OD_INDEX_PROFILE_DECELERATION, 0x00, 32},
+             {OD_INDEX_MOTION_PROFILE_TYPE, 0x00, 16}}};
+  }
+  void encode(const RawCommand& command, uint16_t controlword) {
+    controlWord_ = controlword;
+    targetVelocity_ = command.targetVelocity_;
+    profileAccel_ = command.profileAccel_;
+    profileDeccel_ = command.profileDeccel_;
+    motionProfileType_ = command.motionProfileType_;
+  }
 } __attribute__((packed));
+static_assert(pdoMatchesMapping<RxPdoPVM>(),
+              "RxPdoPVM does not match its mapping");
 
 }  // namespace maxon
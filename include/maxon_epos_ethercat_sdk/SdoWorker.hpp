@@ -0,0 +1,145 @@
+// clang-format off
+/*
+** Copyright 2021 Robotic Systems Lab - ETH Zurich:
+** Linghao Zhang, Jonas Junger, Lennart Nachtigall
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions are met:
+**
+** 1. Redistributions of source code must retain the above copyright notice,
+**    this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright notice,
+**    this list of conditions and the following disclaimer in the documentation
+**    and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its contributors
+**    may be used to endorse or promote products derived from this software without
+**    specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+** AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+** IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+** DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+** FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+** DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+** SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+** CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+** OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+// clang-format on
+
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <utility>
+
+#include "maxon_epos_ethercat_sdk/BoundedQueue.hpp"
+
+namespace maxon {
+class Maxon;
+
+/*!
+ * @brief	Serializes the asynchronous SDO requests of the drives of one bus
+ * A background thread runs the requests one after the other, such that
+ * mailbox transfers never block the calling thread. Fault captures are
+ * requested lock-free from the EtherCAT thread and polled by the worker.
+ */
+class SdoWorker {
+ public:
+  typedef std::shared_ptr<SdoWorker> SharedPtr;
+
+  /*!
+   * Get the worker of a bus, it is created on first use and lives as long as
+   * one of its drives holds it.
+   * @param[in] bus	the bus, only used as key
+   */
+  static SharedPtr getInstance(const void* bus);
+
+  SdoWorker();
+  ~SdoWorker();
+
+  SdoWorker(const SdoWorker&) = delete;
+  SdoWorker& operator=(const SdoWorker&) = delete;
+
+  /*!
+   * Queue a request.
+   * @param[in] owner	the drive which owns the request
+   * @param[in] function	the request, run by the worker thread
+   * @return	future of the result of the request, a value-initialized result
+   * (e.g. false) if the request is dropped by removeDevice()
+   */
+  template <typename Function>
+  auto submit(const Maxon* owner, Function function)
+      -> std::future<decltype(function())>;
+
+  /*!
+   * Request a capture of the fault information of a drive. Lock-free and
+   * allocation free, may be called from the EtherCAT thread.
+   * @return	false if too many captures are pending
+   */
+  bool requestFaultCapture(Maxon* drive) {
+    return faultCaptureRequests_.tryPush(drive);
+  }
+
+  void addDevice(Maxon* drive);
+  /*!
+   * Drop the pending requests of a drive and wait for its running request,
+   * must be called before the drive is destroyed. The futures of the dropped
+   * requests become ready with a value-initialized result.
+   */
+  void removeDevice(Maxon* drive);
+
+ private:
+  struct Request {
+    const Maxon* owner_;
+    // called with true to complete the request without running it
+    std::function<void(bool)> function_;
+  };
+
+  void run();
+
+  std::mutex mutex_;
+  // signals new requests to the worker thread
+  std::condition_variable requestCondition_;
+  // signals finished requests to removeDevice()
+  std::condition_variable doneCondition_;
+  std::deque<Request> requests_;
+  std::set<const Maxon*> devices_;
+  const Maxon* runningOwner_{nullptr};
+  BoundedQueue<Maxon*, 64> faultCaptureRequests_;
+  bool running_{true};
+  std::thread thread_;
+};
+
+template <typename Function>
+auto SdoWorker::submit(const Maxon* owner, Function function)
+    -> std::future<decltype(function())> {
+  using Result = decltype(function());
+  auto task = std::make_shared<std::packaged_task<Result(bool)>>(
+      [function = std::move(function)](bool cancel) mutable -> Result {
+        if (cancel) {
+          return Result();
+        }
+        return function();
+      });
+  std::future<Result> future = task->get_future();
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    requests_.push_back(
+        Request{owner, [task](bool cancel) { (*task)(cancel); }});
+  }
+  requestCondition_.notify_one();
+  return future;
+}
+
+}  // namespace maxon
@@ -0,0 +1,118 @@
+// clang-format off
+/*
+** Copyright 2021 Robotic Systems Lab - ETH Zurich:
+** Linghao Zhang, Jonas Junger, Lennart Nachtigall
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions are met:
+**
+** 1. Redistributions of source code must retain the above copyright notice,
+**    this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright notice,
+**    this list of conditions and the following disclaimer in the documentation
+**    and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its contributors
+**    may be used to endorse or promote products derived from this software without
+**    specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+** AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+** IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+** DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+** FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+** DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+** SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+** CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+** OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+// clang-format on
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+namespace maxon {
+/*!
+ * @brief	Single writer / multiple reader sequence lock
+ * The writer never blocks and never waits for the readers. A reader retries
+ * until it got a copy which was not overwritten while reading, so readers
+ * always receive a consistent value.
+ * The payload is stored in atomic words, which makes concurrent access well
+ * defined without any locks.
+ */
+template <typename T>
+class SeqLock {
+  static_assert(std::is_trivially_copyable<T>::value,
+                "SeqLock requires a trivially copyable type");
+
+ public:
+  SeqLock() {
+    const T value{};
+    storeWords(value);
+  }
+
+  /*!
+   * Publish a new value.
+   * Must only be called from a single thread.
+   * @param[in] value	The new value
+   */
+  void write(const T& value) {
+    const uint64_t sequence = sequence_.load(std::memory_order_relaxed);
+    sequence_.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    storeWords(value);
+    sequence_.store(sequence + 2, std::memory_order_release);
+  }
+
+  /*!
+   * Get a consistent copy of the latest value.
+   * May be called from any number of threads.
+   * @param[out] value	The latest value
+   * @return	the number of writes which happened before the copy was taken
+   */
+  uint64_t read(T& value) const {
+    std::array<uint64_t, numberOfWords_> words;
+    uint64_t sequenceBefore;
+    uint64_t sequenceAfter;
+    do {
+      sequenceBefore = sequence_.load(std::memory_order_acquire);
+      for (unsigned int i = 0; i < numberOfWords_; i++) {
+        words[i] = words_[i].load(std::memory_order_relaxed);
+      }
+      std::atomic_thread_fence(std::memory_order_acquire);
+      sequenceAfter = sequence_.load(std::memory_order_relaxed);
+    } while ((sequenceBefore & 1) != 0 || sequenceBefore != sequenceAfter);
+    std::memcpy(static_cast<void*>(&value), words.data(), sizeof(T));
+    return sequenceBefore / 2;
+  }
+
+  T read() const {
+    T value;
+    read(value);
+    return value;
+  }
+
+ private:
+  void storeWords(const T& value) {
+    std::array<uint64_t, numberOfWords_> words{};
+    std::memcpy(words.data(), &value, sizeof(T));
+    for (unsigned int i = 0; i < numberOfWords_; i++) {
+      words_[i].store(words[i], std::memory_order_relaxed);
+    }
+  }
+
+  static constexpr unsigned int numberOfWords_ =
+      (sizeof(T) + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+
+  std::atomic<uint64_t> sequence_{0};
+  std::array<std::atomic<uint64_t>, numberOfWords_> words_;
+};
+
+}  // namespace maxon
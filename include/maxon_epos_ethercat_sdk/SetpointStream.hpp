@@ -0,0 +1,162 @@
+// clang-format off
+/*
+** Copyright 2021 Robotic Systems Lab - ETH Zurich:
+** Linghao Zhang, Jonas Junger, Lennart Nachtigall
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions are met:
+**
+** 1. Redistributions of source code must retain the above copyright notice,
+**    this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright notice,
+**    this list of conditions and the following disclaimer in the documentation
+**    and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its contributors
+**    may be used to endorse or promote products derived from this software without
+**    specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+** AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+** IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+** DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+** FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+** DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+** SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+** CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+** OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+// clang-format on
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#include "maxon_epos_ethercat_sdk/Command.hpp"
+#include "maxon_epos_ethercat_sdk/Reading.hpp"
+#include "maxon_epos_ethercat_sdk/SpscQueue.hpp"
+
+namespace maxon {
+enum class SetpointInterpolation : uint8_t {
+  // every setpoint is held until the time of the next one has come
+  None,
+  Linear,
+  // Catmull-Rom spline through the setpoints, needs one setpoint look-ahead
+  Cubic
+};
+
+/*!
+ * A command in drive units which applies from the given time on.
+ */
+struct Setpoint {
+  ReadingTimePoint timePoint_;
+  RawCommand command_;
+};
+
+struct SetpointStatistics {
+  // number of times the stream ran dry, i.e. passed its last setpoint
+  uint64_t underruns_{0};
+  // number of cycles which held the last setpoint for lack of a newer one
+  uint64_t starvedCycles_{0};
+  // setpoints which did not fit into the queue
+  uint64_t droppedSetpoints_{0};
+  // setpoints which were not later than the previously pushed one
+  uint64_t rejectedSetpoints_{0};
+  // setpoints which were already superseded when they were dequeued
+  uint64_t skippedSetpoints_{0};
+};
+
+/*!
+ * @brief	Timestamped setpoints, streamed from a planner to the EtherCAT thread
+ * The planner pushes setpoints ahead of time, updateWrite() interpolates
+ * between them at the time of every cycle. Both sides are wait-free and
+ * never allocate.
+ */
+class SetpointStream {
+ public:
+  static constexpr std::size_t capacity = 512;
+
+  /*!
+   * Producer side: queue a setpoint. Its time point must be later than the
+   * one of the previously pushed setpoint, unless clear() was called since.
+   * @param[in] setpoint	the setpoint
+   * @return	false if the setpoint is not later than the previous one or
+   * the queue is full
+   */
+  bool push(const Setpoint& setpoint);
+  /*!
+   * Producer side: queue a batch of setpoints, up to the first one which is
+   * rejected.
+   * @return	the number of queued setpoints, less than given on failure
+   */
+  std::size_t push(const Setpoint* setpoints, std::size_t numberOfSetpoints);
+
+  /*!
+   * Producer side: drop all queued setpoints, the consumer returns to the
+   * staged commands until the next setpoint is due. The next setpoint may
+   * have any time point.
+   */
+  void clear();
+
+  void setInterpolation(SetpointInterpolation interpolation) {
+    interpolation_.store(interpolation, std::memory_order_relaxed);
+  }
+  SetpointInterpolation getInterpolation() const {
+    return interpolation_.load(std::memory_order_relaxed);
+  }
+
+  /*!
+   * Consumer side: the interpolated command at the given time.
+   * @param[in] timePoint	the time of the current cycle
+   * @param[out] command	the command, unchanged if false is returned
+   * @return	false if no setpoint is due yet
+   */
+  bool update(ReadingTimePoint timePoint, RawCommand& command);
+
+  SetpointStatistics getStatistics() const;
+  void resetStatistics();
+  std::size_t getNumberOfQueuedSetpoints() const { return queue_.size(); }
+
+ private:
+  struct QueuedSetpoint {
+    Setpoint setpoint_;
+    // setpoints of a generation before the last clear() are dropped
+    uint32_t generation_{0};
+  };
+
+  // consumer side: move due setpoints from the queue into the window
+  void refill();
+  void popFront();
+  RawCommand interpolate(ReadingTimePoint timePoint) const;
+
+  SpscQueue<QueuedSetpoint, capacity> queue_;
+  std::atomic<uint32_t> generation_{0};
+  std::atomic<SetpointInterpolation> interpolation_{
+      SetpointInterpolation::None};
+
+  // only accessed by the producer: the time point of the last setpoint
+  ReadingTimePoint lastPushedTimePoint_;
+  bool hasLastPushedTimePoint_{false};
+
+  // only accessed by the consumer: the previous setpoint, the start and the
+  // end of the current segment and one setpoint look-ahead
+  Setpoint previous_;
+  bool hasPrevious_{false};
+  std::array<Setpoint, 3> window_;
+  std::size_t windowSize_{0};
+  uint32_t consumerGeneration_{0};
+  bool starving_{false};
+
+  std::atomic<uint64_t> underruns_{0};
+  std::atomic<uint64_t> starvedCycles_{0};
+  std::atomic<uint64_t> droppedSetpoints_{0};
+  std::atomic<uint64_t> rejectedSetpoints_{0};
+  std::atomic<uint64_t> skippedSetpoints_{0};
+};
+
+}  // namespace maxon
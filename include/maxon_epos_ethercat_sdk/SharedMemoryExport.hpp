@@ -0,0 +1,200 @@
+// clang-format off
+/*
+** Copyright 2021 Robotic Systems Lab - ETH Zurich:
+** Linghao Zhang, Jonas Junger, Lennart Nachtigall
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions are met:
+**
+** 1. Redistributions of source code must retain the above copyright notice,
+**    this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright notice,
+**    this list of conditions and the following disclaimer in the documentation
+**    and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its contributors
+**    may be used to endorse or promote products derived from this software without
+**    specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+** AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+** IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+** DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+** FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+** DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+** SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+** CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+** OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+// clang-format on
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <type_traits>
+
+#include "maxon_epos_ethercat_sdk/Command.hpp"
+#include "maxon_epos_ethercat_sdk/ConversionFactors.hpp"
+#include "maxon_epos_ethercat_sdk/Reading.hpp"
+#include "maxon_epos_ethercat_sdk/SeqLock.hpp"
+
+namespace maxon {
+/*!
+ * Static description of an exported drive, written once when it is added.
+ */
+struct SharedMemoryDriveInfo {
+  uint32_t address_{0};
+  char name_[32]{};
+  ConversionFactors conversionFactors_;
+};
+static_assert(std::is_trivially_copyable<SharedMemoryDriveInfo>::value,
+              "SharedMemoryDriveInfo must stay trivially copyable");
+
+/*!
+ * The values of one cycle, published by updateWrite().
+ */
+struct SharedMemoryDriveData {
+  ReadingSnapshot reading_;
+  // the command which was written to the Rx PDO
+  RawCommand command_;
+  uint16_t controlword_{0};
+};
+static_assert(std::is_trivially_copyable<SharedMemoryDriveData>::value,
+              "SharedMemoryDriveData must stay trivially copyable");
+
+struct alignas(64) SharedMemoryDrive {
+  SharedMemoryDriveInfo info_;
+  SeqLock<SharedMemoryDriveData> data_;
+};
+
+/*!
+ * Segment layout: the header, followed by maxNumberOfDrives_ drives.
+ * The native byte order and alignment of the writing machine are used,
+ * readers check the version and the sizes before accessing the drives.
+ */
+struct alignas(64) SharedMemoryHeader {
+  static constexpr uint32_t currentVersion = 1;
+
+  char magic_[8]{'M', 'X', 'S', 'H', 'M', 'E', 'M', '1'};
+  uint32_t version_{currentVersion};
+  uint32_t headerSize_{sizeof(SharedMemoryHeader)};
+  uint32_t driveSize_{sizeof(SharedMemoryDrive)};
+  uint32_t dataSize_{sizeof(SharedMemoryDriveData)};
+  uint32_t maxNumberOfDrives_{0};
+  int32_t writerProcessId_{0};
+  // incremented after the info of a new drive has been written
+  std::atomic<uint32_t> numberOfDrives_{0};
+};
+// atomics in shared memory have to be address free, i.e. lock-free
+static_assert(ATOMIC_LLONG_LOCK_FREE == 2 && ATOMIC_LONG_LOCK_FREE == 2 &&
+                  ATOMIC_INT_LOCK_FREE == 2,
+              "The shared memory layout requires lock-free atomics");
+
+/*!
+ * @brief	Publishes the reading and the command of every cycle in a POSIX
+ * shared memory segment
+ * The EtherCAT thread is the only writer, one SeqLock per drive lets any
+ * number of processes map the segment read-only and take consistent copies
+ * without ever blocking the writer, see SharedMemoryReader.
+ */
+class SharedMemoryExport {
+ public:
+  typedef std::shared_ptr<SharedMemoryExport> SharedPtr;
+
+  /*!
+   * @param[in] name	name of the segment, e.g. "/maxon_drives"
+   * @param[in] maxNumberOfDrives	number of preallocated drive slots
+   */
+  explicit SharedMemoryExport(const std::string& name,
+                              uint32_t maxNumberOfDrives = 32);
+  // unmaps and removes the segment, mapped readers keep their mapping
+  ~SharedMemoryExport();
+
+  SharedMemoryExport(const SharedMemoryExport&) = delete;
+  SharedMemoryExport& operator=(const SharedMemoryExport&) = delete;
+
+  /*!
+   * Create (or replace) the segment.
+   */
+  bool open();
+  bool isOpen() const { return header_ != nullptr; }
+  const std::string& getName() const { return name_; }
+
+  /*!
+   * Add a drive, see Maxon::setSharedMemoryExport().
+   * @return	the index of the drive, -1 if not open or all slots are used
+   */
+  int addDrive(const SharedMemoryDriveInfo& driveInfo);
+
+  /*!
+   * Publish the data of a drive, lock-free and allocation free. Must only be
+   * called by one thread per drive.
+   */
+  void publish(int index, const SharedMemoryDriveData& data) {
+    drives_[index].data_.write(data);
+  }
+
+ private:
+  void close();
+
+  const std::string name_;
+  const uint32_t maxNumberOfDrives_;
+  std::mutex mutex_;
+  std::size_t size_{0};
+  SharedMemoryHeader* header_{nullptr};
+  SharedMemoryDrive* drives_{nullptr};
+};
+
+/*!
+ * @brief	Maps the segment of a SharedMemoryExport read-only
+ * Used by other processes, reading never blocks the writer.
+ */
+class SharedMemoryReader {
+ public:
+  SharedMemoryReader() = default;
+  ~SharedMemoryReader();
+
+  SharedMemoryReader(const SharedMemoryReader&) = delete;
+  SharedMemoryReader& operator=(const SharedMemoryReader&) = delete;
+
+  /*!
+   * Map the segment and check its layout.
+   * @param[in] name	name of the segment
+   * @return	false if it does not exist or has an incompatible layout
+   */
+  bool open(const std::string& name);
+  void close();
+  bool isOpen() const { return header_ != nullptr; }
+
+  // the number of drives which have been added so far
+  uint32_t getNumberOfDrives() const {
+    return header_->numberOfDrives_.load(std::memory_order_acquire);
+  }
+  const SharedMemoryDriveInfo& getDriveInfo(uint32_t index) const {
+    return drives_[index].info_;
+  }
+
+  /*!
+   * Take a consistent copy of the latest data of a drive.
+   * @param[in] index	index of the drive, less than getNumberOfDrives()
+   * @param[out] data	the data
+   * @return	the number of publications of the drive
+   */
+  uint64_t read(uint32_t index, SharedMemoryDriveData& data) const {
+    return drives_[index].data_.read(data);
+  }
+
+ private:
+  std::size_t size_{0};
+  const SharedMemoryHeader* header_{nullptr};
+  const SharedMemoryDrive* drives_{nullptr};
+};
+
+}  // namespace maxon
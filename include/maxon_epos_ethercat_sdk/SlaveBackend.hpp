@@ -0,0 +1,74 @@
+// clang-format off
+/*
+** Copyright 2021 Robotic Systems Lab - ETH Zurich:
+** Linghao Zhang, Jonas Junger, Lennart Nachtigall
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions are met:
+**
+** 1. Redistributions of source code must retain the above copyright notice,
+**    this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright notice,
+**    this list of conditions and the following disclaimer in the documentation
+**    and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its contributors
+**    may be used to endorse or promote products derived from this software without
+**    specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+** AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+** IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+** DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+** FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+** DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+** SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+** CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+** OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+// clang-format on
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace maxon {
+/*!
+ * @brief	Mailbox and EtherCAT state of slaves which are not on a SOEM bus
+ * If a drive has a backend (see Maxon::setSlaveBackend()), its SDOs and
+ * EtherCAT state requests are sent to the backend instead of the bus. The
+ * process data is still exchanged through the process image of the bus.
+ * Implemented by VirtualEpos4Bus.
+ */
+class SlaveBackend {
+ public:
+  virtual ~SlaveBackend() = default;
+
+  /*!
+   * SDO upload (resp. download) of a value of the given size.
+   * @param[in] address	the address of the slave
+   * @param[in] completeAccess	transfer all subindices of the object, see
+   * PdoMappingObject for the layout
+   * @return	false if the slave aborted the transfer
+   */
+  virtual bool sdoRead(uint16_t address, uint16_t index, uint8_t subIndex,
+                       bool completeAccess, void* value,
+                       std::size_t size) = 0;
+  virtual bool sdoWrite(uint16_t address, uint16_t index, uint8_t subIndex,
+                        bool completeAccess, const void* value,
+                        std::size_t size) = 0;
+
+  /// same as EthercatBusBase::setState() / waitForState()
+  virtual void setState(uint16_t state, uint16_t address) = 0;
+  virtual bool waitForState(uint16_t state, uint16_t address,
+                            unsigned int maxRetries, double retrySleep) = 0;
+  /// same as EthercatBusBase::syncDistributedClock0()
+  virtual void syncDistributedClock0(uint16_t /*address*/, bool /*activate*/,
+                                     double /*cycleTime*/,
+                                     double /*cycleShift*/) {}
+};
+
+}  // namespace maxon
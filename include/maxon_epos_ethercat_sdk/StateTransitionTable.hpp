@@ -0,0 +1,231 @@
+// clang-format off
+/*
+** Copyright 2021 Robotic Systems Lab - ETH Zurich:
+** Linghao Zhang, Jonas Junger, Lennart Nachtigall
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions are met:
+**
+** 1. Redistributions of source code must retain the above copyright notice,
+**    this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright notice,
+**    this list of conditions and the following disclaimer in the documentation
+**    and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its contributors
+**    may be used to endorse or promote products derived from this software without
+**    specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+** AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+** IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+** DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+** FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+** DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+** SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+** CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+** OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+// clang-format on
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "maxon_epos_ethercat_sdk/DriveState.hpp"
+
+namespace maxon {
+constexpr std::size_t numberOfDriveStates =
+    static_cast<std::size_t>(DriveState::NA) + 1;
+constexpr std::size_t numberOfStateTransitions =
+    static_cast<std::size_t>(StateTransition::_15) + 1;
+
+/*!
+ * The raw controlwords of the state transitions, indexed by StateTransition.
+ * Equal to Controlword::setStateTransitionX().getRawControlword().
+ */
+constexpr uint16_t stateTransitionControlwords[numberOfStateTransitions] = {
+    0x0006,  // _2 shutdown
+    0x0007,  // _3 switch on
+    0x000F,  // _4 enable operation
+    0x0007,  // _5 disable operation
+    0x0006,  // _6 shutdown
+    0x0000,  // _7 disable voltage
+    0x0006,  // _8 shutdown
+    0x0000,  // _9 disable voltage
+    0x0000,  // _10 disable voltage
+    0x0002,  // _11 quick stop
+    0x0000,  // _12 disable voltage
+    0x0080   // _15 fault reset
+};
+
+// the drive states reached by the state transitions
+constexpr DriveState stateTransitionResults[numberOfStateTransitions] = {
+    DriveState::ReadyToSwitchOn,   // _2
+    DriveState::SwitchedOn,        // _3
+    DriveState::OperationEnabled,  // _4
+    DriveState::SwitchedOn,        // _5
+    DriveState::ReadyToSwitchOn,   // _6
+    DriveState::SwitchOnDisabled,  // _7
+    DriveState::ReadyToSwitchOn,   // _8
+    DriveState::SwitchOnDisabled,  // _9
+    DriveState::SwitchOnDisabled,  // _10
+    DriveState::QuickStopActive,   // _11
+    DriveState::SwitchOnDisabled,  // _12
+    DriveState::SwitchOnDisabled   // _15
+};
+
+constexpr uint16_t getStateTransitionControlword(StateTransition transition) {
+  return stateTransitionControlwords[static_cast<std::size_t>(transition)];
+}
+
+constexpr DriveState getStateTransitionResult(StateTransition transition) {
+  return stateTransitionResults[static_cast<std::size_t>(transition)];
+}
+
+enum class StateTransitionStepType : uint8_t {
+  Transition,
+  TargetReached,
+  NotImplemented
+};
+
+/*!
+ * The next step from a current towards a target drive state: the transition,
+ * its raw controlword and the drive state it leads to.
+ */
+struct StateTransitionStep {
+  StateTransitionStepType type_;
+  StateTransition transition_;
+  uint16_t controlword_;
+  DriveState nextDriveState_;
+};
+
+namespace state_transition_table {
+constexpr StateTransitionStep step(StateTransition transition) {
+  return {StateTransitionStepType::Transition, transition,
+          getStateTransitionControlword(transition),
+          getStateTransitionResult(transition)};
+}
+constexpr StateTransitionStep reached{StateTransitionStepType::TargetReached,
+                                      StateTransition::_2, 0, DriveState::NA};
+constexpr StateTransitionStep none{StateTransitionStepType::NotImplemented,
+                                   StateTransition::_2, 0, DriveState::NA};
+
+using T = StateTransition;
+// clang-format off
+/*!
+ * [target][current], the columns are ordered like DriveState:
+ * NotReadyToSwitchOn, SwitchOnDisabled, ReadyToSwitchOn, SwitchedOn,
+ * OperationEnabled, QuickStopActive, FaultReactionActive, Fault, NA
+ */
+constexpr StateTransitionStep table[numberOfDriveStates][numberOfDriveStates] = {
+    // NotReadyToSwitchOn
+    {none, none, none, none, none, none, none, none, none},
+    // SwitchOnDisabled, the lowest state which can be requested over EtherCAT
+    {none, reached, step(T::_7), step(T::_10), step(T::_9), step(T::_12),
+     none, step(T::_15), none},
+    // ReadyToSwitchOn
+    {none, step(T::_2), reached, step(T::_6), step(T::_8), step(T::_12),
+     none, step(T::_15), none},
+    // SwitchedOn
+    {none, step(T::_2), step(T::_3), reached, step(T::_5), step(T::_12),
+     none, step(T::_15), none},
+    // OperationEnabled
+    {none, step(T::_2), step(T::_3), step(T::_4), reached, step(T::_12),
+     none, step(T::_15), none},
+    // QuickStopActive
+    {none, step(T::_2), step(T::_3), step(T::_4), step(T::_11), reached,
+     none, step(T::_15), none},
+    // FaultReactionActive
+    {none, none, none, none, none, none, none, none, none},
+    // Fault
+    {none, none, none, none, none, none, none, none, none},
+    // NA
+    {none, none, none, none, none, none, none, none, none}};
+// clang-format on
+
+// following the steps must reach the target within the number of states
+constexpr bool isConsistent() {
+  for (std::size_t target = 0; target < numberOfDriveStates; target++) {
+    for (std::size_t current = 0; current < numberOfDriveStates; current++) {
+      std::size_t state = current;
+      std::size_t numberOfSteps = 0;
+      while (table[target][state].type_ ==
+             StateTransitionStepType::Transition) {
+        state = static_cast<std::size_t>(table[target][state].nextDriveState_);
+        if (++numberOfSteps > numberOfDriveStates) {
+          return false;
+        }
+      }
+      if (table[target][state].type_ ==
+              StateTransitionStepType::TargetReached &&
+          state != target) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+static_assert(isConsistent(), "The state transition table has a dead end");
+}  // namespace state_transition_table
+
+/*!
+ * Look up the next step towards the requested drive state, O(1) and without
+ * branching.
+ * @param[in] targetDriveState	the requested drive state
+ * @param[in] currentDriveState	the current drive state
+ * @return	the next step
+ */
+constexpr StateTransitionStep getStateTransitionStep(
+    DriveState targetDriveState, DriveState currentDriveState) {
+  return state_transition_table::table[static_cast<std::size_t>(
+      targetDriveState)][static_cast<std::size_t>(currentDriveState)];
+}
+
+namespace state_transition_table {
+// the state bits 0, 1, 2, 3, 5 and 6 of the statusword as a 6 bit index
+constexpr std::size_t getStatuswordIndex(uint16_t statusword) {
+  return (statusword & 0x0F) | ((statusword >> 1) & 0x30);
+}
+
+// MAN-G-DS402 manual page 47
+constexpr DriveState decodeDriveState(uint16_t statusword) {
+  return (statusword & 0x6F) == 0x00   ? DriveState::NotReadyToSwitchOn
+         : (statusword & 0x6F) == 0x40 ? DriveState::SwitchOnDisabled
+         : (statusword & 0x6F) == 0x21 ? DriveState::ReadyToSwitchOn
+         : (statusword & 0x6F) == 0x23 ? DriveState::SwitchedOn
+         : (statusword & 0x6F) == 0x27 ? DriveState::OperationEnabled
+         : (statusword & 0x6F) == 0x07 ? DriveState::QuickStopActive
+         : (statusword & 0x6F) == 0x0F ? DriveState::FaultReactionActive
+         : (statusword & 0x6F) == 0x08 ? DriveState::Fault
+                                       : DriveState::NA;
+}
+
+struct DriveStateLookup {
+  constexpr DriveStateLookup() : driveStates_() {
+    for (std::size_t i = 0; i < 64; i++) {
+      // the inverse of getStatuswordIndex()
+      driveStates_[i] = decodeDriveState(
+          static_cast<uint16_t>((i & 0x0F) | ((i & 0x30) << 1)));
+    }
+  }
+  DriveState driveStates_[64];
+};
+constexpr DriveStateLookup driveStateLookup{};
+static_assert(driveStateLookup.driveStates_[getStatuswordIndex(0x0637)] ==
+                  DriveState::OperationEnabled,
+              "The drive state lookup is inconsistent");
+}  // namespace state_transition_table
+
+/*!
+ * Decode the drive state from a raw statusword by a table lookup.
+ */
+constexpr DriveState getDriveStateFromStatusword(uint16_t statusword) {
+  return state_transition_table::driveStateLookup
+      .driveStates_[state_transition_table::getStatuswordIndex(statusword)];
+}
+
+}  // namespace maxon
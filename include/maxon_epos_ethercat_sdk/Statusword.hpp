@@ -38,8 +38,45 @@
 #include <string>
 
 #include "maxon_epos_ethercat_sdk/DriveState.hpp"
+#include "maxon_epos_ethercat_sdk/StateTransitionTable.hpp"
 
 namespace maxon {
+// bits of the raw statusword
+namespace statusword_bits {
+constexpr uint16_t fault = 1u << 3;
+constexpr uint16_t warning = 1u << 7;
+constexpr uint16_t targetReached = 1u << 10;
+constexpr uint16_t followingError = 1u << 13;
+// the bits whose edges are tracked by DecodedStatusword
+constexpr uint16_t edges = fault | warning | targetReached | followingError;
+}  // namespace statusword_bits
+
+/*!
+ * The drive state and the edges of a raw statusword, decoded once when the
+ * statusword is read instead of by every consumer.
+ */
+struct DecodedStatusword {
+  DriveState driveState_{DriveState::NotReadyToSwitchOn};
+  // statusword_bits::edges which were set / cleared since the previous
+  // statusword
+  uint16_t rising_{0};
+  uint16_t falling_{0};
+
+  bool rose(uint16_t bits) const { return (rising_ & bits) != 0; }
+  bool fell(uint16_t bits) const { return (falling_ & bits) != 0; }
+};
+
+inline DecodedStatusword decodeStatusword(uint16_t statusword,
+                                          uint16_t previousStatusword) {
+  DecodedStatusword decodedStatusword;
+  decodedStatusword.driveState_ = getDriveStateFromStatusword(statusword);
+  const uint16_t changedBits = (statusword ^ previousStatusword) &
+                               statusword_bits::edges;
+  decodedStatusword.rising_ = changedBits & statusword;
+  decodedStatusword.falling_ = changedBits & previousStatusword;
+  return decodedStatusword;
+}
+
 class Statusword {
  private:
   bool readyToSwitchOn_{false};      // bit 0
@@ -0,0 +1,269 @@
+// clang-format off
+/*
+** Copyright 2021 Robotic Systems Lab - ETH Zurich:
+** Linghao Zhang, Jonas Junger, Lennart Nachtigall
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions are met:
+**
+** 1. Redistributions of source code must retain the above copyright notice,
+**    this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright notice,
+**    this list of conditions and the following disclaimer in the documentation
+**    and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its contributors
+**    may be used to endorse or promote products derived from this software without
+**    specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+** AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+** IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+** DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+** FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+** DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+** SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+** CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+** OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+// clang-format on
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include "maxon_epos_ethercat_sdk/AsyncLogger.hpp"
+#include "maxon_epos_ethercat_sdk/BoundedQueue.hpp"
+#include "maxon_epos_ethercat_sdk/ConversionFactors.hpp"
+#include "maxon_epos_ethercat_sdk/CustomPdo.hpp"
+#include "maxon_epos_ethercat_sdk/ModeOfOperationEnum.hpp"
+#include "maxon_epos_ethercat_sdk/PdoMapping.hpp"
+
+namespace maxon {
+/*!
+ * The raw process data of one drive in one cycle.
+ */
+struct TelemetryRecord {
+  // time the Tx PDO was read [ns], steady clock
+  int64_t timeStamp_{0};
+  uint64_t sequenceNumber_{0};
+  uint32_t address_{0};
+  uint16_t controlword_{0};
+  uint16_t statusword_{0};
+  // the packed PDOs as they are on the wire
+  uint8_t rxPdo_[maxCustomPdoSize]{};
+  uint8_t txPdo_[maxCustomPdoSize]{};
+};
+static_assert(std::is_trivially_copyable<TelemetryRecord>::value,
+              "TelemetryRecord must stay trivially copyable");
+
+/*!
+ * Everything which is needed to decode the records of a drive, stored at the
+ * beginning of every telemetry file.
+ */
+struct TelemetryDriveInfo {
+  uint32_t address_{0};
+  char name_[32]{};
+  ConversionFactors conversionFactors_;
+  uint32_t rxPdoMappingSize_{0};
+  uint32_t txPdoMappingSize_{0};
+  PdoMappingEntry rxPdoMapping_[maxCustomPdoSize]{};
+  PdoMappingEntry txPdoMapping_[maxCustomPdoSize]{};
+};
+static_assert(std::is_trivially_copyable<TelemetryDriveInfo>::value,
+              "TelemetryDriveInfo must stay trivially copyable");
+
+/*!
+ * File layout: header, numberOfDrives_ drive infos, numberOfRecords_
+ * records. The native byte order and alignment of the recording machine are
+ * used.
+ */
+struct TelemetryFileHeader {
+  char magic_[8]{'M', 'X', 'T', 'E', 'L', 'E', 'M', '1'};
+  uint32_t recordSize_{sizeof(TelemetryRecord)};
+  uint32_t driveInfoSize_{sizeof(TelemetryDriveInfo)};
+  uint32_t numberOfDrives_{0};
+  uint32_t reserved_{0};
+  // updated after every batch of records, such that a file stays readable
+  // if the process is killed
+  uint64_t numberOfRecords_{0};
+};
+
+/*!
+ * @brief	Records the raw PDOs of every cycle of the attached drives
+ * The EtherCAT thread copies the records into a preallocated lock-free
+ * queue, a writer thread drains it into memory mapped files. When a file is
+ * full the next one is started, after numberOfFiles files the oldest one is
+ * overwritten. Records are dropped (and counted) if the queue is full, or
+ * if the next file cannot be opened.
+ */
+class TelemetryRecorder {
+ public:
+  typedef std::shared_ptr<TelemetryRecorder> SharedPtr;
+  static constexpr std::size_t queueCapacity = 8192;
+
+  /*!
+   * @param[in] fileName	the files are named <fileName>.0, <fileName>.1, ...
+   * @param[in] maxFileSize	size of a file in bytes
+   * @param[in] numberOfFiles	number of files which are kept
+   */
+  explicit TelemetryRecorder(const std::string& fileName,
+                             std::size_t maxFileSize = 256 << 20,
+                             unsigned int numberOfFiles = 4);
+  ~TelemetryRecorder();
+
+  TelemetryRecorder(const TelemetryRecorder&) = delete;
+  TelemetryRecorder& operator=(const TelemetryRecorder&) = delete;
+
+  /*!
+   * Add the description of a drive, see Maxon::setTelemetryRecorder().
+   * @return	false if the recorder is already running
+   */
+  bool addDrive(const TelemetryDriveInfo& driveInfo);
+
+  /*!
+   * Open the first file and start the writer thread.
+   */
+  bool start();
+  /*!
+   * Write the queued records and close the file.
+   */
+  void stop();
+  bool isRunning() const { return running_.load(std::memory_order_relaxed); }
+
+  /*!
+   * Queue a record, lock-free and allocation free.
+   * @return	false if the recorder is not running or the queue is full
+   */
+  bool record(const TelemetryRecord& record) {
+    if (!isRunning()) {
+      return false;
+    }
+    if (!queue_.tryPush(record)) {
+      numberOfDroppedRecords_.fetch_add(1, std::memory_order_relaxed);
+      return false;
+    }
+    return true;
+  }
+
+  uint64_t getNumberOfDroppedRecords() const {
+    return numberOfDroppedRecords_.load(std::memory_order_relaxed);
+  }
+  uint64_t getNumberOfWrittenRecords() const {
+    return numberOfWrittenRecords_.load(std::memory_order_relaxed);
+  }
+  /*!
+   * Records which were dropped by the writer thread because no file could be
+   * opened, e.g. when the disk is full. Opening is retried once per second.
+   */
+  uint64_t getNumberOfUnwrittenRecords() const {
+    return numberOfUnwrittenRecords_.load(std::memory_order_relaxed);
+  }
+
+ private:
+  bool openFile();
+  // openFile() at most once per second after opening a file failed, such
+  // that the failure is not logged for every record
+  bool retryOpenFile();
+  void closeFile();
+  // move the queued records into the file, returns the number of records
+  std::size_t drainQueue();
+  void run();
+
+  const std::string fileName_;
+  const std::size_t maxFileSize_;
+  const unsigned int numberOfFiles_;
+  std::vector<TelemetryDriveInfo> driveInfos_;
+  std::mutex mutex_;
+
+  BoundedQueue<TelemetryRecord, queueCapacity> queue_;
+  std::atomic<bool> running_{false};
+  std::atomic<uint64_t> numberOfDroppedRecords_{0};
+  std::atomic<uint64_t> numberOfWrittenRecords_{0};
+  std::atomic<uint64_t> numberOfUnwrittenRecords_{0};
+  std::thread thread_;
+
+  // only accessed by the writer thread while running
+  unsigned int fileIndex_{0};
+  LogThrottle openFileThrottle_;
+  int fileDescriptor_{-1};
+  uint8_t* map_{nullptr};
+  TelemetryFileHeader* header_{nullptr};
+  TelemetryRecord* records_{nullptr};
+  std::size_t recordCapacity_{0};
+};
+
+/*!
+ * One decoded record, in user units (rad, rad/s, A, Nm, V).
+ */
+struct TelemetrySample {
+  int64_t timeStamp_{0};
+  uint64_t sequenceNumber_{0};
+  uint32_t address_{0};
+  uint16_t controlword_{0};
+  uint16_t statusword_{0};
+  ModeOfOperationEnum modeOfOperation_{ModeOfOperationEnum::NA};
+
+  double targetPosition_{0};
+  double positionOffset_{0};
+  double targetVelocity_{0};
+  double velocityOffset_{0};
+  double targetTorque_{0};
+  double torqueOffset_{0};
+
+  double actualPosition_{0};
+  double actualVelocity_{0};
+  double demandVelocity_{0};
+  double actualCurrent_{0};
+  double actualTorque_{0};
+  double analogInput_{0};
+  double busVoltage_{0};
+  int32_t digitalInputs_{0};
+};
+
+/*!
+ * @brief	Offline decoder of the files of a TelemetryRecorder
+ * The PDOs are decoded with the mappings and converted with the factors
+ * which are stored in the file.
+ */
+class TelemetryDecoder {
+ public:
+  bool open(const std::string& fileName);
+
+  const std::vector<TelemetryDriveInfo>& getDriveInfos() const {
+    return driveInfos_;
+  }
+  std::size_t getNumberOfRecords() const { return records_.size(); }
+  const TelemetryRecord& getRecord(std::size_t i) const { return records_[i]; }
+
+  /*!
+   * @return	false if the record belongs to no drive of the file
+   */
+  bool decode(std::size_t i, TelemetrySample& sample) const;
+
+  /// one line per record, the time in seconds since the first record
+  void writeCsv(std::ostream& os) const;
+
+ private:
+  struct Drive {
+    CustomPdo rxPdo_;
+    CustomPdo txPdo_;
+  };
+
+  std::vector<TelemetryDriveInfo> driveInfos_;
+  std::vector<Drive> drives_;
+  std::vector<TelemetryRecord> records_;
+};
+
+}  // namespace maxon
@@ -0,0 +1,185 @@
+// clang-format off
+/*
+** Copyright 2021 Robotic Systems Lab - ETH Zurich:
+** Linghao Zhang, Jonas Junger, Lennart Nachtigall
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions are met:
+**
+** 1. Redistributions of source code must retain the above copyright notice,
+**    this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright notice,
+**    this list of conditions and the following disclaimer in the documentation
+**    and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its contributors
+**    may be used to endorse or promote products derived from this software without
+**    specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+** AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+** IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+** DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+** FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+** DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+** SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+** CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+** OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+// clang-format on
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <iostream>
+
+#include "maxon_epos_ethercat_sdk/StateTransitionTable.hpp"
+
+namespace maxon {
+/*!
+ * Summary of a LatencyHistogram, all durations in microseconds.
+ */
+struct LatencyStatistics {
+  uint64_t count_{0};
+  double min_{0};
+  double mean_{0};
+  double max_{0};
+  double p50_{0};
+  double p90_{0};
+  double p99_{0};
+  double p999_{0};
+};
+
+/*!
+ * Timing of the cyclic update of a drive, see Maxon::getTimingStatistics().
+ */
+struct TimingStatistics {
+  LatencyStatistics updateRead_;
+  LatencyStatistics updateWrite_;
+  // time spent waiting for the state machine mutex in updateRead/updateWrite
+  LatencyStatistics mutexWait_;
+  // time between two consecutive calls of updateRead
+  LatencyStatistics cycleTime_;
+  // only recorded with a distributed clock time source: the cycle time
+  // according to the distributed clock and its deviation from cycleTime_
+  LatencyStatistics distributedClockCycleTime_;
+  LatencyStatistics distributedClockJitter_;
+  // cycles without an updateRead, derived from the cycle time
+  uint64_t missedCycles_{0};
+  // readings handed out which were older than two cycles
+  uint64_t staleReadings_{0};
+
+  friend std::ostream& operator<<(std::ostream& os,
+                                  const TimingStatistics& statistics);
+};
+
+/*!
+ * Latency of the PDO state machine, see
+ * Maxon::getStateTransitionStatistics().
+ */
+struct StateTransitionStatistics {
+  // from writing the controlword of a transition until the statusword shows
+  // its resulting drive state, indexed by StateTransition
+  std::array<LatencyStatistics, numberOfStateTransitions> transitions_;
+  // from the request of a state change until it has completed successfully
+  LatencyStatistics stateChange_;
+  // controlwords which were written again because the drive did not
+  // acknowledge them within drive_state_change_min_timeout
+  uint64_t repeatedTransitions_{0};
+
+  friend std::ostream& operator<<(std::ostream& os,
+                                  const StateTransitionStatistics& statistics);
+};
+
+/*!
+ * Timing of the cycles of a bus, see BusExecutor::getStatistics().
+ */
+struct BusStatistics {
+  // where the thread actually runs, -1 if unknown
+  int cpu_{-1};
+  int numaNode_{-1};
+  // the thread runs with SCHED_FIFO
+  bool realtime_{false};
+  uint64_t cycles_{0};
+  // cycles which were skipped because a cycle took too long
+  uint64_t overruns_{0};
+  // from the start of receive() until send() has returned
+  LatencyStatistics cycleDuration_;
+  // from the scheduled start of a cycle until the thread woke up
+  LatencyStatistics wakeupLatency_;
+
+  friend std::ostream& operator<<(std::ostream& os,
+                                  const BusStatistics& statistics);
+};
+
+/*!
+ * @brief	Lock-free log-linear (HDR style) histogram of durations
+ * Every power of two is divided into 2^subBucketBits_ buckets, the relative
+ * error of the percentiles is therefore below 12.5%. Durations are recorded
+ * in nanoseconds by a single thread, any thread may read the statistics.
+ */
+class LatencyHistogram {
+ public:
+  /*!
+   * Record a duration. Only one thread may record.
+   * @param[in] nanoseconds	the duration
+   */
+  void record(uint64_t nanoseconds) {
+    buckets_[getBucketIndex(nanoseconds)].fetch_add(1,
+                                                     std::memory_order_relaxed);
+    sum_.fetch_add(nanoseconds, std::memory_order_relaxed);
+    if (count_.fetch_add(1, std::memory_order_relaxed) == 0 ||
+        nanoseconds < min_.load(std::memory_order_relaxed)) {
+      min_.store(nanoseconds, std::memory_order_relaxed);
+    }
+    if (nanoseconds > max_.load(std::memory_order_relaxed)) {
+      max_.store(nanoseconds, std::memory_order_relaxed);
+    }
+  }
+
+  /*!
+   * @return	count, extremes, mean and percentiles of the recorded durations
+   */
+  LatencyStatistics getStatistics() const;
+
+  /*!
+   * Clear the histogram. Durations which are recorded concurrently may be
+   * lost.
+   */
+  void reset();
+
+ private:
+  static constexpr unsigned int subBucketBits_{3};
+  static constexpr unsigned int subBucketCount_{1u << subBucketBits_};
+  // durations above 2^maxExponent_ ns (~34 s) end up in the last bucket
+  static constexpr unsigned int maxExponent_{35};
+  static constexpr unsigned int bucketCount_{
+      ((maxExponent_ - subBucketBits_ + 1) << subBucketBits_) +
+      subBucketCount_};
+
+  static unsigned int getBucketIndex(uint64_t value) {
+    if (value < subBucketCount_) {
+      return static_cast<unsigned int>(value);
+    }
+    unsigned int exponent = 63 - __builtin_clzll(value);
+    if (exponent > maxExponent_) {
+      return bucketCount_ - 1;
+    }
+    const unsigned int mantissa = static_cast<unsigned int>(
+        (value >> (exponent - subBucketBits_)) & (subBucketCount_ - 1));
+    return ((exponent - subBucketBits_ + 1) << subBucketBits_) + mantissa;
+  }
+  static uint64_t getBucketLowerBound(unsigned int index);
+
+  std::array<std::atomic<uint64_t>, bucketCount_> buckets_{};
+  std::atomic<uint64_t> count_{0};
+  std::atomic<uint64_t> sum_{0};
+  std::atomic<uint64_t> min_{0};
+  std::atomic<uint64_t> max_{0};
+};
+
+}  // namespace maxon
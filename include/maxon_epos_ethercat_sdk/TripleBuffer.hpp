@@ -0,0 +1,104 @@
+// clang-format off
+/*
+** Copyright 2021 Robotic Systems Lab - ETH Zurich:
+** Linghao Zhang, Jonas Junger, Lennart Nachtigall
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions are met:
+**
+** 1. Redistributions of source code must retain the above copyright notice,
+**    this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright notice,
+**    this list of conditions and the following disclaimer in the documentation
+**    and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its contributors
+**    may be used to endorse or promote products derived from this software without
+**    specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+** AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+** IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+** DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+** FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+** DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+** SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+** CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+** OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+// clang-format on
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+namespace maxon {
+/*!
+ * @brief	Single producer / single consumer triple buffer
+ * Both sides are wait-free: the producer always has a buffer to write into
+ * and the consumer always has a buffer to read from. The consumer only ever
+ * sees the latest published value, intermediate values are dropped.
+ */
+template <typename T>
+class TripleBuffer {
+ public:
+  /*!
+   * Producer side: copy a value into the back buffer and publish it.
+   * @param[in] value	the new value
+   */
+  void write(const T& value) {
+    buffers_[writeIndex_] = value;
+    publish();
+  }
+
+  /*!
+   * Producer side: the back buffer, which may be filled in place.
+   * Call publish() when done.
+   */
+  T& getWriteBuffer() { return buffers_[writeIndex_]; }
+
+  /*!
+   * Producer side: swap the back buffer with the middle buffer.
+   */
+  void publish() {
+    const uint8_t published = static_cast<uint8_t>(writeIndex_ | newDataFlag_);
+    writeIndex_ =
+        middle_.exchange(published, std::memory_order_acq_rel) & indexMask_;
+  }
+
+  /*!
+   * Consumer side: fetch the latest published value if there is one.
+   * @return	true if a new value was published since the last update
+   */
+  bool update() {
+    if ((middle_.load(std::memory_order_relaxed) & newDataFlag_) == 0) {
+      return false;
+    }
+    readIndex_ =
+        middle_.exchange(readIndex_, std::memory_order_acq_rel) & indexMask_;
+    return true;
+  }
+
+  /*!
+   * Consumer side: the value fetched by the last update().
+   */
+  const T& getReadBuffer() const { return buffers_[readIndex_]; }
+
+ private:
+  static constexpr uint8_t indexMask_{0x03};
+  static constexpr uint8_t newDataFlag_{0x04};
+
+  std::array<T, 3> buffers_{};
+  // index of the middle buffer and the "new data" flag
+  std::atomic<uint8_t> middle_{1};
+  // only accessed by the producer
+  uint8_t writeIndex_{0};
+  // only accessed by the consumer
+  uint8_t readIndex_{2};
+};
+
+}  // namespace maxon
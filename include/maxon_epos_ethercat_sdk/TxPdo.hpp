@@ -34,18 +34,38 @@
  * @brief	This file contains the different Tx Pdo structs. Each struct
  * must contain a statusword_, or else the state changes won't work! Each struct
  * can contain either the actual torque or the actual current but not both.
+ * Every struct describes its own layout: getMapping() lists the mapped
+ * objects in the order of the struct members and decode() copies the members
+ * into a reading.
  */
 #pragma once
 
+#include <array>
 #include <cstdint>
 
+#include "maxon_epos_ethercat_sdk/ObjectDictionary.hpp"
+#include "maxon_epos_ethercat_sdk/PdoMapping.hpp"
+#include "maxon_epos_ethercat_sdk/Reading.hpp"
+
 namespace maxon {
 /*!
  * Standard Tx Pdo type
  */
 struct TxPdoStandard {
   uint16_t statusword_;
+
+  static constexpr const char* getName() {
+    return "Standard Mode";
+  }
+  static constexpr std::array<PdoMappingEntry, 1> getMapping() {
+    return {{{OD_INDEX_STATUSWORD, 0x00, 16}}};
+  }
+  void decode(ReadingSnapshot& snapshot) const {
+    snapshot.statusword_ = statusword_;
+  }
 } __attribute__((packed));
+static_assert(pdoMatchesMapping<TxPdoStandard>(),
+              "TxPdoStandard does not match its mapping");
 
 /*!
  * CST Tx PDO type
@@ -56,21 +76,75 @@ struct TxPdoCSP {
   int16_t actualTorque_;
   int32_t actualVelocity_;
   int32_t actualPosition_;
+
+  static constexpr const char* getName() {
+    return "Cyclic Synchronous Position Mode";
+  }
+  static constexpr std::array<PdoMappingEntry, 4> getMapping() {
+    return {{{OD_INDEX_STATUSWORD, 0x00, 16},
+             {OD_INDEX_TORQUE_ACTUAL, 0x00, 16},
+             {OD_INDEX_VELOCITY_ACTUAL, 0x00, 32},
+             {OD_INDEX_POSITION_ACTUAL, 0x00, 32}}};
+  }
+  void decode(ReadingSnapshot& snapshot) const {
+    snapshot.statusword_ = statusword_;
+    snapshot.actualCurrent_ = actualTorque_;
+    snapshot.actualVelocity_ = actualVelocity_;
+    snapshot.actualPosition_ = actualPosition_;
+  }
 } __attribute__((packed));
+static_assert(pdoMatchesMapping<TxPdoCSP>(),
+              "TxPdoCSP does not match its mapping");
 
 struct TxPdoCST {
   uint16_t statusword_;
   int16_t actualTorque_;
   int32_t actualVelocity_;
   int32_t actualPosition_;
+
+  static constexpr const char* getName() {
+    return "Cyclic Synchronous Torque Mode";
+  }
+  static constexpr std::array<PdoMappingEntry, 4> getMapping() {
+    return {{{OD_INDEX_STATUSWORD, 0x00, 16},
+             {OD_INDEX_TORQUE_ACTUAL, 0x00, 16},
+             {OD_INDEX_VELOCITY_ACTUAL, 0x00, 32},
+             {OD_INDEX_POSITION_ACTUAL, 0x00, 32}}};
+  }
+  void decode(ReadingSnapshot& snapshot) const {
+    snapshot.statusword_ = statusword_;
+    snapshot.actualCurrent_ = actualTorque_;
+    snapshot.actualVelocity_ = actualVelocity_;
+    snapshot.actualPosition_ = actualPosition_;
+  }
 } __attribute__((packed));
+static_assert(pdoMatchesMapping<TxPdoCST>(),
+              "TxPdoCST does not match its mapping");
 
 struct TxPdoCSV {
   uint16_t statusword_;
   int16_t actualTorque_;
   int32_t actualVelocity_;
   int32_t actualPosition_;
+
+  static constexpr const char* getName() {
+    return "Cyclic Synchronous Velocity Mode";
+  }
+  static constexpr std::array<PdoMappingEntry, 4> getMapping() {
+    return {{{OD_INDEX_STATUSWORD, 0x00, 16},
+             {OD_INDEX_TORQUE_ACTUAL, 0x00, 16},
+             {OD_INDEX_VELOCITY_ACTUAL, 0x00, 32},
+             {OD_INDEX_POSITION_ACTUAL, 0x00, 32}}};
+  }
+  void decode(ReadingSnapshot& snapshot) const {
+    snapshot.statusword_ = statusword_;
+    snapshot.actualCurrent_ = actualTorque_;
+    snapshot.actualVelocity_ = actualVelocity_;
+    snapshot.actualPosition_ = actualPosition_;
+  }
 } __attribute__((packed));
+static_assert(pdoMatchesMapping<TxPdoCSV>(),
+              "TxPdoCSV does not match its mapping");
 
 // Mixed operation mode for CST and CSP
 struct TxPdoCSTCSP {
@@ -78,7 +152,25 @@ struct TxPdoCSTCSP {
   int16_t actualTorque_;
   int32_t actualVelocity_;
   int32_t actualPosition_;
+
+  static constexpr const char* getName() {
+    return "Cyclic Synchronous Torque/Position Mixed Mode";
+  }
+  static constexpr std::array<PdoMappingEntry, 4> getMapping() {
+    return {{{OD_INDEX_STATUSWORD, 0x00, 16},
+             {OD_INDEX_TORQUE_ACTUAL, 0x00, 16},
+             {OD_INDEX_VELOCITY_ACTUAL, 0x00, 32},
+             {OD_INDEX_POSITION_ACTUAL, 0x00, 32}}};
+  }
+  void decode(ReadingSnapshot& snapshot) const {
+    snapshot.statusword_ = statusword_;
+    snapshot.actualCurrent_ = actualTorque_;
+    snapshot.actualVelocity_ = actualVelocity_;
+    snapshot.actualPosition_ = actualPosition_;
+  }
 } __attribute__((packed));
+static_assert(pdoMatchesMapping<TxPdoCSTCSP>(),
+              "TxPdoCSTCSP does not match its mapping");
 
 // Mixed operation mode for CST, CSP, and CSV
 struct TxPdoCSTCSPCSV {
@@ -86,11 +178,43 @@ struct TxPdoCSTCSPCSV {
   int16_t actualTorque_;
   int32_t actualVelocity_;
   int32_t actualPosition_;
+
+  static constexpr const char* getName() {
+    return "Cyclic Synchronous Torque/Position/Velocity Mixed Mode";
+  }
+  static constexpr std::array<PdoMappingEntry, 4> getMapping() {
+    return {{{OD_INDEX_STATUSWORD, 0x00, 16},
+             {OD_INDEX_TORQUE_ACTUAL, 0x00, 16},
+             {OD_INDEX_VELOCITY_ACTUAL, 0x00, 32},
+             {OD_INDEX_POSITION_ACTUAL, 0x00, 32}}};
+  }
+  void decode(ReadingSnapshot& snapshot) const {
+    snapshot.statusword_ = statusword_;
+    snapshot.actualCurrent_ = actualTorque_;
+    snapshot.actualVelocity_ = actualVelocity_;
+    snapshot.actualPosition_ = actualPosition_;
+  }
 } __attribute__((packed));
+static_assert(pdoMatchesMapping<TxPdoCSTCSPCSV>(),
+              "TxPdoCSTCSPCSV does not match its mapping");
 
 struct TxPdoPVM {
   uint16_t statusword_;
   int32_t demandVelocity_;
+
+  static constexpr const char* getName() {
+    return "Profile Velocity Mode";
+  }
+  static constexpr std::array<PdoMappingEntry, 2> getMapping() {
+    return {{{OD_INDEX_STATUSWORD, 0x00, 16},
+             {OD_INDEX_VELOCITY_DEMAND, 0x00, 32}}};
+  }
+  void decode(ReadingSnapshot& snapshot) const {
+    snapshot.statusword_ = statusword_;
+    snapshot.demandVelocity_ = demandVelocity_;
+  }
 } __attribute__((packed));
+static_assert(pdoMatchesMapping<TxPdoPVM>(),
+              "TxPdoPVM does not match its mapping");
 
 }  // namespace maxon
@@ -0,0 +1,232 @@
+// clang-format off
+/*
+** Copyright 2021 Robotic Systems Lab - ETH Zurich:
+** Linghao Zhang, Jonas Junger, Lennart Nachtigall
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions are met:
+**
+** 1. Redistributions of source code must retain the above copyright notice,
+**    this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright notice,
+**    this list of conditions and the following disclaimer in the documentation
+**    and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its contributors
+**    may be used to endorse or promote products derived from this software without
+**    specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+** AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+** IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+** DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+** FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+** DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+** SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+** CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+** OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+// clang-format on
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <vector>
+
+#include "maxon_epos_ethercat_sdk/CustomPdo.hpp"
+#include "maxon_epos_ethercat_sdk/DriveState.hpp"
+
+namespace maxon {
+/*!
+ * Parameters of a VirtualEpos4. The motor model works in drive units:
+ * positions in increments, velocities in rpm (scaled by velocityUnitsPerRpm_
+ * in the object dictionary), accelerations in rpm/s and torques in per mille
+ * of the rated torque.
+ */
+struct VirtualEpos4Parameters {
+  // duration of every SDO transfer [s], the calling thread sleeps
+  double sdoLatency_{0.0};
+  // simulated time from SwitchedOn to OperationEnabled [s]
+  double enableTime_{0.0};
+  // serial number of the identity object, 0 derives it from the address
+  uint32_t serialNumber_{0};
+  double incrementsPerRevolution_{4096.0};
+  // velocity unit of the object dictionary, 1e6 is the uRPM of the SDK
+  double velocityUnitsPerRpm_{1e6};
+  // time constant of the position (resp. velocity) tracking of CSP (CSV)
+  // [s], 0 follows the target immediately
+  double trackingTimeConstant_{1e-3};
+  // acceleration per torque of CST [rpm/s per per mille]
+  double accelerationPerTorque_{10.0};
+  // viscous friction of CST [1/s]
+  double damping_{1.0};
+};
+
+/*!
+ * @brief	Simulated EPOS4 slave
+ * Holds the objects of ObjectDictionary.hpp, accepts the PDO mappings and
+ * assignments written by Maxon::mapPdos() (with and without Complete
+ * Access), runs the CiA-402 state machine on the controlword and moves a
+ * simple motor model in the cyclic synchronous modes and in PVM. Transfers
+ * to unknown objects, read-only objects or with the wrong size are aborted
+ * like on the drive. Thread safe, the simulation only advances in update().
+ */
+class VirtualEpos4 {
+ public:
+  VirtualEpos4(uint16_t address, const VirtualEpos4Parameters& parameters);
+
+  VirtualEpos4(const VirtualEpos4&) = delete;
+  VirtualEpos4& operator=(const VirtualEpos4&) = delete;
+
+  /*!
+   * SDO upload (resp. download), see SlaveBackend.
+   * @return	false if the transfer is aborted
+   */
+  bool sdoRead(uint16_t index, uint8_t subIndex, bool completeAccess,
+               void* value, std::size_t size);
+  bool sdoWrite(uint16_t index, uint8_t subIndex, bool completeAccess,
+                const void* value, std::size_t size);
+
+  /// EtherCAT state (EC_STATE_...), PRE-OP after construction
+  void setEthercatState(uint16_t state);
+  uint16_t getEthercatState() const;
+
+  /*!
+   * Advance the simulation by one cycle: decode the Rx PDO (in OP), run the
+   * state machine and the motor model and encode the Tx PDO (in SAFE-OP and
+   * OP). Must not run concurrently with the exchange of the process image.
+   * @param[in] timeStep	the simulated time of the cycle [s]
+   */
+  void update(double timeStep);
+
+  /*!
+   * The process image of the drive, its address never changes. The sizes
+   * follow the assigned PDO mappings.
+   */
+  uint8_t* getRxPdo() { return rxPdo_.data(); }
+  uint8_t* getTxPdo() { return txPdo_.data(); }
+  std::size_t getRxPdoSize() const;
+  std::size_t getTxPdoSize() const;
+
+  /*!
+   * Enter the Fault state with the given error code, which is also added to
+   * the error history. A fault reset leaves it again.
+   */
+  void injectFault(uint16_t errorCode);
+
+  uint16_t getAddress() const { return address_; }
+  DriveState getDriveState() const;
+  uint16_t getStatusword() const;
+  // motor state [increments], [rpm], [per mille]
+  double getPosition() const;
+  double getVelocity() const;
+  double getTorque() const;
+  // simulated time since construction [s]
+  double getTime() const;
+  uint64_t getNumberOfSdoReads() const;
+  uint64_t getNumberOfSdoWrites() const;
+
+ private:
+  /*!
+   * An entry of the object dictionary, the value is stored in the byte
+   * order of the process image.
+   */
+  struct Object {
+    uint8_t data_[8];
+    uint8_t size_;
+    // see the flags in VirtualEpos4.cpp
+    uint8_t flags_;
+  };
+  // an object of the process image
+  struct PdoBinding {
+    uint16_t offset_;
+    uint8_t size_;
+    Object* object_;
+  };
+
+  static constexpr uint32_t getKey(uint16_t index, uint8_t subIndex) {
+    return (static_cast<uint32_t>(index) << 8) | subIndex;
+  }
+  Object* findObject(uint16_t index, uint8_t subIndex);
+  bool readObject(uint16_t index, uint8_t subIndex, void* value,
+                  std::size_t size);
+  bool writeObject(uint16_t index, uint8_t subIndex, const void* value,
+                   std::size_t size);
+  bool readCompleteAccess(uint16_t index, uint8_t* value, std::size_t size);
+  bool writeCompleteAccess(uint16_t index, const uint8_t* value,
+                           std::size_t size);
+  /*!
+   * Append the objects of a PDO mapping to the bindings.
+   * @return	false if an object cannot be mapped in this direction or the
+   * process data gets larger than maxCustomPdoSize
+   */
+  bool bindPdoMapping(uint16_t mappingIndex, uint8_t pdoFlag,
+                      std::vector<PdoBinding>& bindings, std::size_t& size);
+  // rebuild the bindings of an assignment object, false if it is invalid
+  bool bindPdoAssignment(uint16_t assignmentIndex);
+  bool bindPdoAssignments();
+
+  // CiA-402 state machine and motor model, mutex_ is held
+  void evaluateControlword();
+  void enterDriveState(DriveState driveState);
+  void updateMotor(double timeStep);
+  void updateStatusword();
+
+  const uint16_t address_;
+  const VirtualEpos4Parameters parameters_;
+  mutable std::mutex mutex_;
+  // key: getKey(), the nodes (and thus the bindings) never move
+  std::map<uint32_t, Object> objects_;
+
+  std::array<uint8_t, maxCustomPdoSize> rxPdo_{};
+  std::array<uint8_t, maxCustomPdoSize> txPdo_{};
+  std::vector<PdoBinding> rxPdoBindings_;
+  std::vector<PdoBinding> txPdoBindings_;
+  std::size_t rxPdoSize_{0};
+  std::size_t txPdoSize_{0};
+
+  uint16_t ethercatState_;
+  DriveState driveState_{DriveState::SwitchOnDisabled};
+  uint16_t lastControlword_{0};
+  // simulated time at which a pending enable operation completes
+  bool enablePending_{false};
+  double enableTimePoint_{0.0};
+  double time_{0.0};
+  double position_{0.0};
+  double velocity_{0.0};
+  double torque_{0.0};
+  uint64_t numberOfSdoReads_{0};
+  uint64_t numberOfSdoWrites_{0};
+
+  // objects used by the simulation
+  Object* controlword_;
+  Object* statusword_;
+  Object* modesOfOperation_;
+  Object* modesOfOperationDisplay_;
+  Object* errorCode_;
+  Object* errorRegister_;
+  Object* targetPosition_;
+  Object* targetVelocity_;
+  Object* targetTorque_;
+  Object* positionOffset_;
+  Object* velocityOffset_;
+  Object* torqueOffset_;
+  Object* profileAcceleration_;
+  Object* profileDeceleration_;
+  Object* quickStopDeceleration_;
+  Object* quickStopOptionCode_;
+  Object* positionActual_;
+  Object* velocityActual_;
+  Object* velocityDemand_;
+  Object* torqueActual_;
+  Object* currentActual_;
+  Object* nominalCurrent_;
+};
+
+}  // namespace maxon
@@ -0,0 +1,132 @@
+// clang-format off
+/*
+** Copyright 2021 Robotic Systems Lab - ETH Zurich:
+** Linghao Zhang, Jonas Junger, Lennart Nachtigall
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions are met:
+**
+** 1. Redistributions of source code must retain the above copyright notice,
+**    this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright notice,
+**    this list of conditions and the following disclaimer in the documentation
+**    and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its contributors
+**    may be used to endorse or promote products derived from this software without
+**    specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+** AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+** IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+** DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+** FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+** DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+** SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+** CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+** OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+// clang-format on
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <ethercat_sdk_master/EthercatDevice.hpp>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "maxon_epos_ethercat_sdk/ProcessDataExchange.hpp"
+#include "maxon_epos_ethercat_sdk/SlaveBackend.hpp"
+#include "maxon_epos_ethercat_sdk/VirtualEpos4.hpp"
+
+namespace maxon {
+class Maxon;
+
+/*!
+ * @brief	EtherCAT bus of simulated EPOS4 drives
+ * The process image of every slave is backed by its VirtualEpos4, such that
+ * readTxPdo / writeRxPdo (and Maxon::bindProcessImage()) work like on a
+ * SOEM bus. SDOs and state requests of the attached drives reach the virtual
+ * drives through the SlaveBackend interface. The bus is never started and
+ * time only advances in update(), which is typically called between
+ * updateWrite() and updateRead() of all drives instead of sending a frame.
+ * Larger setups use one bus per maxNumberOfDrives drives.
+ */
+class VirtualEpos4Bus : public soem_interface::EthercatBusBase,
+                        public SlaveBackend {
+ public:
+  // the slave list of SOEM has EC_MAXSLAVE entries, 0 is the master
+  static constexpr uint16_t maxNumberOfDrives = EC_MAXSLAVE - 1;
+
+  explicit VirtualEpos4Bus(const std::string& name = "virtual_epos4");
+
+  /*!
+   * Add a virtual drive, not thread safe.
+   * @param[in] address	the address of the slave (1 to maxNumberOfDrives)
+   * @return	the drive, nullptr if the address is invalid or taken
+   */
+  VirtualEpos4* addDrive(
+      uint16_t address,
+      const VirtualEpos4Parameters& parameters = VirtualEpos4Parameters());
+  /*!
+   * Add a virtual drive at the address of the given drive, and connect the
+   * drive to this bus and its backend. Must be called before startup().
+   */
+  VirtualEpos4* attach(
+      Maxon& drive,
+      const VirtualEpos4Parameters& parameters = VirtualEpos4Parameters());
+  /// nullptr if there is no drive at this address
+  VirtualEpos4* getDrive(uint16_t address) const;
+  std::size_t getNumberOfDrives() const { return drives_.size(); }
+
+  /*!
+   * Advance all drives by one cycle, see VirtualEpos4::update().
+   * @param[in] timeStep	the simulated time of the cycle [s]
+   */
+  void update(double timeStep);
+
+  // SlaveBackend
+  bool sdoRead(uint16_t address, uint16_t index, uint8_t subIndex,
+               bool completeAccess, void* value, std::size_t size) override;
+  bool sdoWrite(uint16_t address, uint16_t index, uint8_t subIndex,
+                bool completeAccess, const void* value,
+                std::size_t size) override;
+  // address 0 addresses all drives
+  void setState(uint16_t state, uint16_t address) override;
+  bool waitForState(uint16_t state, uint16_t address, unsigned int maxRetries,
+                    double retrySleep) override;
+
+ private:
+  // sizes of the process image after a PDO assignment could have changed
+  void updateProcessImage(const VirtualEpos4& drive);
+
+  // indexed by address
+  std::vector<std::unique_ptr<VirtualEpos4>> drivesByAddress_;
+  std::vector<VirtualEpos4*> drives_;
+};
+
+/*!
+ * Process data exchange of a VirtualEpos4Bus, for a BusExecutor: sending a
+ * frame advances the virtual drives by one cycle.
+ */
+class VirtualEpos4BusExchange : public ProcessDataExchange {
+ public:
+  /*!
+   * @param[in] timeStep	the simulated time of a cycle [s]
+   */
+  VirtualEpos4BusExchange(VirtualEpos4Bus* bus, double timeStep)
+      : bus_(bus), timeStep_(timeStep) {}
+
+  void receive() override {}
+  void send() override { bus_->update(timeStep_); }
+
+ private:
+  VirtualEpos4Bus* bus_;
+  double timeStep_;
+};
+
+}  // namespace maxon
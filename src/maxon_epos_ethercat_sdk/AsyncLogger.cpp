@@ -0,0 +1,169 @@
+// clang-format off
+/*
+** Copyright 2021 Robotic Systems Lab - ETH Zurich:
+** Linghao Zhang, Jonas Junger, Lennart Nachtigall
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions are met:
+**
+** 1. Redistributions of source code must retain the above copyright notice,
+**    this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright notice,
+**    this list of conditions and the following disclaimer in the documentation
+**    and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its contributors
+**    may be used to endorse or promote products derived from this software without
+**    specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+** AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+** IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+** DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+** FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+** DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+** SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+** CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+** OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+// clang-format on
+
+#include "maxon_epos_ethercat_sdk/AsyncLogger.hpp"
+
+#include <message_logger/message_logger.hpp>
+
+#include "maxon_epos_ethercat_sdk/DriveState.hpp"
+#include "maxon_epos_ethercat_sdk/LimitGuard.hpp"
+#include "maxon_epos_ethercat_sdk/ModeOfOperationEnum.hpp"
+
+namespace maxon {
+constexpr int64_t LogThrottle::neverTicks_;
+constexpr std::size_t AsyncLogger::capacity_;
+
+AsyncLogger& AsyncLogger::getInstance() {
+  static AsyncLogger asyncLogger;
+  return asyncLogger;
+}
+
+AsyncLogger::AsyncLogger() : thread_(&AsyncLogger::run, this) {}
+
+AsyncLogger::~AsyncLogger() {
+  running_ = false;
+  thread_.join();
+  // the events which were pushed while shutting down
+  printEvents();
+}
+
+bool AsyncLogger::push(const LogEvent& event) {
+  if (!queue_.tryPush(event)) {
+    numberOfDroppedEvents_.fetch_add(1, std::memory_order_relaxed);
+    return false;
+  }
+  numberOfPushedEvents_.fetch_add(1, std::memory_order_release);
+  return true;
+}
+
+void AsyncLogger::flush() {
+  const uint64_t numberOfPushedEvents =
+      numberOfPushedEvents_.load(std::memory_order_acquire);
+  while (numberOfPrintedEvents_.load(std::memory_order_acquire) <
+         numberOfPushedEvents) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+}
+
+void AsyncLogger::run() {
+  // the producers never signal, such that pushing stays free of system calls
+  while (running_) {
+    if (printEvents() == 0) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+  }
+}
+
+unsigned int AsyncLogger::printEvents() {
+  unsigned int numberOfPrintedEvents = 0;
+  LogEvent event;
+  while (queue_.tryPop(event)) {
+    print(event);
+    numberOfPrintedEvents_.fetch_add(1, std::memory_order_release);
+    numberOfPrintedEvents++;
+  }
+  return numberOfPrintedEvents;
+}
+
+void AsyncLogger::print(const LogEvent& event) {
+  const std::string name(event.deviceName_);
+  std::string suffix;
+  if (event.numberOfSuppressedEvents_ > 0) {
+    suffix = " (repeated " + std::to_string(event.numberOfSuppressedEvents_) +
+             " times since the last message)";
+  }
+  switch (event.type_) {
+    case LogEventType::ModeOfOperationNotSet:
+      MELO_ERROR_STREAM(
+          "[maxon_epos_ethercat_sdk:Maxon::updateWrite] Mode of operation "
+          "for '"
+          << name << "' has not been set." << suffix);
+      break;
+    case LogEventType::ModeOfOperationNotAllowed:
+      MELO_ERROR_STREAM(
+          "[maxon_epos_ethercat_sdk:Maxon::stageCommand] Target mode of "
+          "operation '"
+          << static_cast<ModeOfOperationEnum>(event.values_[0])
+          << "' for device '" << name << "' not allowed" << suffix);
+      break;
+    case LogEventType::RxPdoTypeNotSupported:
+      MELO_ERROR_STREAM(
+          "[maxon_epos_ethercat_sdk:Maxon::updateWrite] Unsupported Rx Pdo "
+          "type for '"
+          << name << "'" << suffix);
+      break;
+    case LogEventType::TxPdoTypeNotSupported:
+      MELO_ERROR_STREAM(
+          "[maxon_epos_ethercat_sdk:Maxon::updateRead] Unsupported Tx Pdo "
+          "type for '"
+          << name << "'" << suffix);
+      break;
+    case LogEventType::FaultReactionActive:
+      MELO_ERROR_STREAM("[maxon_epos_ethercat_sdk:Maxon::updateRead] '"
+                        << name << "' is in drive state 'FaultReactionActive'"
+                        << suffix);
+      break;
+    case LogEventType::Fault:
+      MELO_ERROR_STREAM("[maxon_epos_ethercat_sdk:Maxon::updateRead] '"
+                        << name << "' is in drive state 'Fault'" << suffix);
+      break;
+    case LogEventType::DriveStateAlreadyReached:
+      MELO_ERROR_STREAM(
+          "[maxon_epos_ethercat_sdk:Maxon::"
+          "getNextStateTransitionStep] drive state '"
+          << static_cast<DriveState>(event.values_[0])
+          << "' has already been reached for '" << name << "'" << suffix);
+      break;
+    case LogEventType::StateTransitionNotImplemented:
+      MELO_ERROR_STREAM(
+          "[maxon_epos_ethercat_sdk:Maxon::"
+          "getNextStateTransitionStep] PDO state transition not "
+          "implemented for '"
+          << name << "'\n"
+          << "Current: " << static_cast<DriveState>(event.values_[0]) << "\n"
+          << "Requested: " << static_cast<DriveState>(event.values_[1])
+          << suffix);
+      break;
+    case LogEventType::LimitViolation:
+      MELO_ERROR_STREAM(
+          "[maxon_epos_ethercat_sdk:Maxon::updateRead] Quick stop of '"
+          << name << "', the "
+          << getLimitQuantityString(
+                 static_cast<LimitQuantity>(event.values_[0]))
+          << " " << event.values_[1] << " (raw) exceeds its limit" << suffix);
+      break;
+    default:
+      break;
+  }
+}
+
+}  // namespace maxon
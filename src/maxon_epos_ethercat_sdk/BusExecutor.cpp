@@ -0,0 +1,336 @@
+// clang-format off
+/*
+** Copyright 2021 Robotic Systems Lab - ETH Zurich:
+** Linghao Zhang, Jonas Junger, Lennart Nachtigall
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions are met:
+**
+** 1. Redistributions of source code must retain the above copyright notice,
+**    this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright notice,
+**    this list of conditions and the following disclaimer in the documentation
+**    and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its contributors
+**    may be used to endorse or promote products derived from this software without
+**    specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+** AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+** IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+** DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+** FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+** DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+** SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+** CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+** OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+// clang-format on
+
+#include "maxon_epos_ethercat_sdk/BusExecutor.hpp"
+
+#include <pthread.h>
+#include <sched.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <future>
+#include <message_logger/message_logger.hpp>
+
+namespace maxon {
+namespace {
+int64_t getMonotonicTime() {
+  timespec time;
+  clock_gettime(CLOCK_MONOTONIC, &time);
+  return static_cast<int64_t>(time.tv_sec) * 1000000000 + time.tv_nsec;
+}
+
+timespec toTimespec(int64_t nanoseconds) {
+  timespec time;
+  time.tv_sec = static_cast<time_t>(nanoseconds / 1000000000);
+  time.tv_nsec = static_cast<long>(nanoseconds % 1000000000);
+  return time;
+}
+}  // namespace
+
+BusExecutor::~BusExecutor() {
+  stop();
+  for (const auto& bus : buses_) {
+    {
+      std::lock_guard<std::mutex> lock(bus->mutex_);
+      bus->quit_ = true;
+    }
+    bus->condition_.notify_all();
+    bus->thread_.join();
+  }
+}
+
+std::size_t BusExecutor::addBus(ProcessDataExchange* exchange,
+                                const BusOptions& options,
+                                CycleCallback callback) {
+  std::unique_ptr<Bus> bus(new Bus());
+  bus->index_ = buses_.size();
+  bus->exchange_ = exchange;
+  bus->options_ = options;
+  bus->callback_ = std::move(callback);
+  Bus& busReference = *bus;
+  bus->thread_ = std::thread(&BusExecutor::run, this, std::ref(busReference));
+  {
+    std::unique_lock<std::mutex> lock(bus->mutex_);
+    bus->condition_.wait(lock, [&bus]() { return bus->ready_; });
+    // a bus which is added while running starts right away
+    bus->running_.store(running_, std::memory_order_release);
+  }
+  bus->condition_.notify_all();
+  buses_.push_back(std::move(bus));
+  return buses_.size() - 1;
+}
+
+bool BusExecutor::runOnBusThread(std::size_t bus,
+                                 const std::function<void()>& function) {
+  if (bus >= buses_.size()) {
+    MELO_ERROR_STREAM("[maxon_epos_ethercat_sdk:BusExecutor::runOnBusThread] "
+                      << "There is no bus " << bus << ".");
+    return false;
+  }
+  if (running_) {
+    MELO_ERROR_STREAM("[maxon_epos_ethercat_sdk:BusExecutor::runOnBusThread] "
+                      << "Not possible while the executor is running.");
+    return false;
+  }
+  std::promise<void> done;
+  std::future<void> doneFuture = done.get_future();
+  Bus& target = *buses_[bus];
+  {
+    std::lock_guard<std::mutex> lock(target.mutex_);
+    target.tasks_.push_back([&function, &done]() {
+      function();
+      done.set_value();
+    });
+  }
+  target.condition_.notify_all();
+  doneFuture.wait();
+  return true;
+}
+
+Maxon::SharedPtr BusExecutor::createDrive(
+    std::size_t bus, const std::function<Maxon::SharedPtr()>& factory) {
+  Maxon::SharedPtr drive;
+  if (!runOnBusThread(bus, [&drive, &factory]() { drive = factory(); })) {
+    return nullptr;
+  }
+  if (!addDrive(bus, drive)) {
+    return nullptr;
+  }
+  return drive;
+}
+
+bool BusExecutor::addDrive(std::size_t bus, const Maxon::SharedPtr& drive) {
+  if (bus >= buses_.size()) {
+    MELO_ERROR_STREAM("[maxon_epos_ethercat_sdk:BusExecutor::addDrive] "
+                      << "There is no bus " << bus << ".");
+    return false;
+  }
+  if (!drive) {
+    MELO_ERROR_STREAM("[maxon_epos_ethercat_sdk:BusExecutor::addDrive] "
+                      << "The drive is null.");
+    return false;
+  }
+  if (running_) {
+    MELO_ERROR_STREAM("[maxon_epos_ethercat_sdk:BusExecutor::addDrive] "
+                      << "Not possible while the executor is running.");
+    return false;
+  }
+  buses_[bus]->drives_.push_back(drive);
+  return true;
+}
+
+const std::vector<Maxon::SharedPtr>& BusExecutor::getDrives(
+    std::size_t bus) const {
+  return buses_[bus]->drives_;
+}
+
+bool BusExecutor::start() {
+  if (running_) {
+    MELO_WARN_STREAM("[maxon_epos_ethercat_sdk:BusExecutor::start] "
+                     << "The executor is already running.");
+    return false;
+  }
+  for (const auto& bus : buses_) {
+    {
+      std::lock_guard<std::mutex> lock(bus->mutex_);
+      bus->running_.store(true, std::memory_order_release);
+    }
+    bus->condition_.notify_all();
+  }
+  running_ = true;
+  return true;
+}
+
+void BusExecutor::stop() {
+  for (const auto& bus : buses_) {
+    bus->running_.store(false, std::memory_order_release);
+  }
+  for (const auto& bus : buses_) {
+    std::unique_lock<std::mutex> lock(bus->mutex_);
+    bus->condition_.wait(lock, [&bus]() { return !bus->cycling_; });
+  }
+  running_ = false;
+}
+
+BusStatistics BusExecutor::getStatistics(std::size_t bus) const {
+  BusStatistics statistics;
+  if (bus >= buses_.size()) {
+    return statistics;
+  }
+  const Bus& source = *buses_[bus];
+  statistics.cpu_ = source.cpu_;
+  statistics.numaNode_ = source.numaNode_;
+  statistics.realtime_ = source.realtime_;
+  const CycleState& state = *source.cycleState_;
+  statistics.cycles_ = state.cycles_.load(std::memory_order_relaxed);
+  statistics.overruns_ = state.overruns_.load(std::memory_order_relaxed);
+  statistics.cycleDuration_ = state.cycleDuration_.getStatistics();
+  statistics.wakeupLatency_ = state.wakeupLatency_.getStatistics();
+  return statistics;
+}
+
+void BusExecutor::resetStatistics() {
+  for (const auto& bus : buses_) {
+    bus->cycleState_->cycleDuration_.reset();
+    bus->cycleState_->wakeupLatency_.reset();
+    bus->cycleState_->cycles_.store(0, std::memory_order_relaxed);
+    bus->cycleState_->overruns_.store(0, std::memory_order_relaxed);
+  }
+}
+
+void BusExecutor::run(Bus& bus) {
+  configureThread(bus);
+  std::unique_lock<std::mutex> lock(bus.mutex_);
+  // first touch by the pinned thread, see createDrive()
+  bus.cycleState_.reset(new CycleState());
+  bus.ready_ = true;
+  bus.condition_.notify_all();
+  while (true) {
+    bus.condition_.wait(lock, [&bus]() {
+      return bus.quit_ || !bus.tasks_.empty() ||
+             bus.running_.load(std::memory_order_acquire);
+    });
+    if (bus.quit_) {
+      return;
+    }
+    if (!bus.tasks_.empty()) {
+      std::function<void()> task = std::move(bus.tasks_.front());
+      bus.tasks_.pop_front();
+      lock.unlock();
+      task();
+      lock.lock();
+      continue;
+    }
+    bus.cycling_ = true;
+    lock.unlock();
+    runCycles(bus);
+    lock.lock();
+    bus.cycling_ = false;
+    bus.condition_.notify_all();
+  }
+}
+
+void BusExecutor::configureThread(Bus& bus) {
+  const std::string prefix =
+      "[maxon_epos_ethercat_sdk:BusExecutor::configureThread] Bus " +
+      std::to_string(bus.index_) + ": ";
+  const int cpu = bus.options_.cpu_;
+  if (cpu >= CPU_SETSIZE) {
+    MELO_WARN_STREAM(prefix << "There is no cpu " << cpu
+                            << ", the thread is not pinned.");
+  } else if (cpu >= 0) {
+    cpu_set_t cpuSet;
+    CPU_ZERO(&cpuSet);
+    CPU_SET(cpu, &cpuSet);
+    const int result =
+        pthread_setaffinity_np(pthread_self(), sizeof(cpuSet), &cpuSet);
+    if (result != 0) {
+      MELO_WARN_STREAM(prefix << "Could not pin the thread to cpu " << cpu
+                              << ": " << std::strerror(result));
+    }
+  }
+
+  if (bus.options_.priority_ > 0) {
+    sched_param parameters;
+    parameters.sched_priority = bus.options_.priority_;
+    const int result =
+        pthread_setschedparam(pthread_self(), SCHED_FIFO, &parameters);
+    if (result != 0) {
+      MELO_WARN_STREAM(prefix << "Could not set the SCHED_FIFO priority "
+                              << bus.options_.priority_ << ": "
+                              << std::strerror(result)
+                              << ", the default scheduler is used.");
+    } else {
+      bus.realtime_ = true;
+    }
+  }
+
+  char name[16];
+  std::snprintf(name, sizeof(name), "maxon_bus%zu", bus.index_);
+  pthread_setname_np(pthread_self(), name);
+
+  unsigned int currentCpu = 0;
+  unsigned int numaNode = 0;
+  if (syscall(SYS_getcpu, &currentCpu, &numaNode, nullptr) == 0) {
+    bus.cpu_ = static_cast<int>(currentCpu);
+    bus.numaNode_ = static_cast<int>(numaNode);
+  }
+}
+
+void BusExecutor::runCycles(Bus& bus) {
+  CycleState& state = *bus.cycleState_;
+  const int64_t cycleTime =
+      static_cast<int64_t>(std::llround(1e9 * bus.options_.cycleTime_));
+  int64_t nextCycle = getMonotonicTime();
+  while (bus.running_.load(std::memory_order_acquire)) {
+    if (cycleTime > 0) {
+      nextCycle += cycleTime;
+      const timespec wakeupTime = toTimespec(nextCycle);
+      while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &wakeupTime,
+                             nullptr) == EINTR) {
+      }
+    }
+    const int64_t start = getMonotonicTime();
+    if (cycleTime > 0) {
+      state.wakeupLatency_.record(start > nextCycle ? start - nextCycle : 0);
+    }
+
+    bus.exchange_->receive();
+    for (const auto& drive : bus.drives_) {
+      drive->updateRead();
+    }
+    if (bus.callback_) {
+      bus.callback_(bus.index_, bus.drives_);
+    }
+    for (const auto& drive : bus.drives_) {
+      drive->updateWrite();
+    }
+    bus.exchange_->send();
+
+    const int64_t end = getMonotonicTime();
+    state.cycleDuration_.record(end - start);
+    state.cycles_.fetch_add(1, std::memory_order_relaxed);
+    if (cycleTime > 0 && end - nextCycle >= cycleTime) {
+      // skip the missed cycles instead of running them back to back
+      const int64_t missedCycles = (end - nextCycle) / cycleTime;
+      nextCycle += missedCycles * cycleTime;
+      state.overruns_.fetch_add(missedCycles, std::memory_order_relaxed);
+    }
+  }
+}
+
+}  // namespace maxon
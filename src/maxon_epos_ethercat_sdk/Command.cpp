@@ -34,54 +34,9 @@
 
 #include <iomanip>
 
-namespace maxon {
-Command::Command(const Command& other) {
-  targetPositionUU_ = other.targetPositionUU_;
-  targetVelocityUU_ = other.targetVelocityUU_;
-  targetTorqueUU_ = other.targetTorqueUU_;
-  torqueOffsetUU_ = other.torqueOffsetUU_;
-
-  targetPosition_ = other.targetPosition_;
-  targetVelocity_ = other.targetVelocity_;
-  targetTorque_ = other.targetTorque_;
-  torqueOffset_ = other.torqueOffset_;
-
-  positionFactorRadToInteger_ = other.positionFactorRadToInteger_;
-  torqueFactorNmToInteger_ = other.torqueFactorNmToInteger_;
-  currentFactorAToInteger_ = other.currentFactorAToInteger_;
-
-  modeOfOperation_ = other.modeOfOperation_;
-
-  useRawCommands_ = other.useRawCommands_;
-  targetTorqueCommandUsed_ = other.targetTorqueCommandUsed_;
-}
-
-Command& Command::operator=(const Command& other) {
-  targetPositionUU_ = other.targetPositionUU_;
-  positionOffsetUU_ = other.positionOffsetUU_;
-  targetVelocityUU_ = other.targetVelocityUU_;
-  velocityOffsetUU_ = other.velocityOffsetUU_;
-  targetTorqueUU_ = other.targetTorqueUU_;
-  torqueOffsetUU_ = other.torqueOffsetUU_;
-
-  targetPosition_ = other.targetPosition_;
-  positionOffset_ = other.positionOffset_;
-  targetVelocity_ = other.targetVelocity_;
-  velocityOffset_ = other.velocityOffset_;
-  targetTorque_ = other.targetTorque_;
-  torqueOffset_ = other.torqueOffset_;
-
-  positionFactorRadToInteger_ = other.positionFactorRadToInteger_;
-  torqueFactorNmToInteger_ = other.torqueFactorNmToInteger_;
-  currentFactorAToInteger_ = other.currentFactorAToInteger_;
-
-  modeOfOperation_ = other.modeOfOperation_;
-
-  useRawCommands_ = other.useRawCommands_;
-  targetTorqueCommandUsed_ = other.targetTorqueCommandUsed_;
-  return *this;
-}
+#include "maxon_epos_ethercat_sdk/SaturatingCast.hpp"
 
+namespace maxon {
 std::ostream& operator<<(std::ostream& os, Command& command) {
   os << std::left << std::setw(25)
      << "Target Position:" << command.targetPositionUU_ << "\n"
@@ -148,8 +103,6 @@ void Command::setTargetVelocity(double targetVelocity) {
   targetVelocityUU_ = targetVelocity;
 }
 void Command::setTargetTorque(double targetTorque) {
-  // lock for thread safety
-  std::lock_guard<std::mutex> lockGuard(targetTorqueCommandMutex_);
   targetTorqueUU_ = targetTorque;
   targetTorqueCommandUsed_ = true;
 }
@@ -213,22 +166,37 @@ double Command::getVelocityOffset() const { return velocityOffsetUU_; }
 
 void Command::doUnitConversion() {
   if (!useRawCommands_) {
-    targetPosition_ =
-        static_cast<int32_t>(positionFactorRadToInteger_ * targetPositionUU_);
-    targetVelocity_ = static_cast<int32_t>(velocityFactorRadPerSecToMicroRPM_ *
-                                           targetVelocityUU_);
+    targetPosition_ = saturatingCast<int32_t>(positionFactorRadToInteger_ *
+                                              targetPositionUU_);
+    targetVelocity_ = saturatingCast<int32_t>(
+        velocityFactorRadPerSecToMicroRPM_ * targetVelocityUU_);
     targetTorque_ =
-        static_cast<int16_t>(torqueFactorNmToInteger_ * targetTorqueUU_);
+        saturatingCast<int16_t>(torqueFactorNmToInteger_ * targetTorqueUU_);
 
-    positionOffset_ =
-        static_cast<int32_t>(positionFactorRadToInteger_ * positionOffsetUU_);
+    positionOffset_ = saturatingCast<int32_t>(positionFactorRadToInteger_ *
+                                              positionOffsetUU_);
     torqueOffset_ =
-        static_cast<int16_t>(torqueFactorNmToInteger_ * torqueOffsetUU_);
-    velocityOffset_ = static_cast<int32_t>(velocityFactorRadPerSecToMicroRPM_ *
-                                           velocityOffsetUU_);
+        saturatingCast<int16_t>(torqueFactorNmToInteger_ * torqueOffsetUU_);
+    velocityOffset_ = saturatingCast<int32_t>(
+        velocityFactorRadPerSecToMicroRPM_ * velocityOffsetUU_);
   }
 }
 
+RawCommand Command::getRawCommand() const {
+  RawCommand rawCommand;
+  rawCommand.targetPosition_ = targetPosition_;
+  rawCommand.targetVelocity_ = targetVelocity_;
+  rawCommand.targetTorque_ = targetTorque_;
+  rawCommand.positionOffset_ = positionOffset_;
+  rawCommand.torqueOffset_ = torqueOffset_;
+  rawCommand.velocityOffset_ = velocityOffset_;
+  rawCommand.profileAccel_ = profileAccel_;
+  rawCommand.profileDeccel_ = profileDeccel_;
+  rawCommand.motionProfileType_ = motionProfileType_;
+  rawCommand.modeOfOperation_ = modeOfOperation_;
+  return rawCommand;
+}
+
 /// other get methods
 ModeOfOperationEnum Command::getModeOfOperation() const {
   return modeOfOperation_;
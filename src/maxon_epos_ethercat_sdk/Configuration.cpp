@@ -32,6 +32,10 @@
 
 #include "maxon_epos_ethercat_sdk/Configuration.hpp"
 
+#include "maxon_epos_ethercat_sdk/CustomPdo.hpp"
+#include "maxon_epos_ethercat_sdk/Fingerprint.hpp"
+
+#include <cstdlib>
 #include <iomanip>
 #include <vector>
 #include <map>
@@ -76,6 +80,8 @@ std::string rxPdoString(RxPdoTypeEnum rxPdo) {
       return "Rx PDO CST/CSP/CSV mixed mode";
     case RxPdoTypeEnum::RxPdoPVM:
       return "Rx PDO PVM";
+    case RxPdoTypeEnum::RxPdoCustom:
+      return "Rx PDO custom";
     default:
       return "Unsupported Type";
   }
@@ -97,6 +103,8 @@ std::string txPdoString(TxPdoTypeEnum txPdo) {
       return "Rx PDO CST/CSP/CSV mixed mode";
     case TxPdoTypeEnum::TxPdoPVM:
       return "Tx PDO PVM";
+    case TxPdoTypeEnum::TxPdoCustom:
+      return "Tx PDO custom";
     case TxPdoTypeEnum::TxPdoStandard:
       return "Tx PDO Standard";
     default:
@@ -104,6 +112,21 @@ std::string txPdoString(TxPdoTypeEnum txPdo) {
   }
 }
 
+bool getInterpolationTimePeriod(unsigned int cycleTime, uint8_t& mantissa,
+                                int8_t& exponent) {
+  // from 1 s down to 1 us
+  unsigned int factor = 1000000;
+  for (int e = 0; e >= -6; e--, factor /= 10) {
+    if (cycleTime != 0 && cycleTime % factor == 0 &&
+        cycleTime / factor <= 255) {
+      mantissa = static_cast<uint8_t>(cycleTime / factor);
+      exponent = static_cast<int8_t>(e);
+      return true;
+    }
+  }
+  return false;
+}
+
 std::ostream& operator<<(std::ostream& os, const Configuration& configuration) {
   std::string modeOfOperation_ =
       modeOfOperationString(configuration.modesOfOperation[0]);
@@ -131,6 +154,19 @@ std::ostream& operator<<(std::ostream& os, const Configuration& configuration) {
      << std::setw(43) << "| Drive State Change Max Timeout:"
      << "| " << std::setw(len2) << configuration.driveStateChangeMaxTimeout
      << "|\n"
+     << std::setw(43) << "| Fast Drive State Change:"
+     << "| " << std::setw(len2) << configuration.fastDriveStateChange << "|\n"
+     << std::setw(43) << "| Cycle Time:"
+     << "| " << std::setw(len2) << configuration.cycleTime << "|\n"
+     << std::setw(43) << "| Use Distributed Clock:"
+     << "| " << std::setw(len2) << configuration.useDistributedClock << "|\n"
+     << std::setw(43) << "| Distributed Clock Shift:"
+     << "| " << std::setw(len2) << configuration.distributedClockShift
+     << "|\n"
+     << std::setw(43) << "| Limit Guard:"
+     << "| " << std::setw(len2) << configuration.useLimitGuard << "|\n"
+     << std::setw(43) << "| Limit Guard Margin:"
+     << "| " << std::setw(len2) << configuration.limitGuardMargin << "|\n"
      << std::setw(43) << "| Min Successful Target State Readings:"
      << "| " << std::setw(len2)
      << configuration.minNumberOfSuccessfulTargetStateReadings << "|\n"
@@ -152,7 +188,8 @@ std::pair<RxPdoTypeEnum, TxPdoTypeEnum> Configuration::getPdoTypeSolution()
     const {
   // clang-format off
   // {ModeOfOperationEnum1, ..., ModeOfOperationEnumN} -> {RxPdoTypeEnum, TxPdoTypeEnum}
-  const std::map<std::vector<ModeOfOperationEnum>, std::pair<RxPdoTypeEnum, TxPdoTypeEnum>> modes2PdoTypeMap = {
+  // built once, the PDO handlers themselves are bound in Maxon::bindPdoTypes()
+  static const std::map<std::vector<ModeOfOperationEnum>, std::pair<RxPdoTypeEnum, TxPdoTypeEnum>> modes2PdoTypeMap = {
       {
         { ModeOfOperationEnum::CyclicSynchronousTorqueMode, ModeOfOperationEnum::CyclicSynchronousPositionMode },
         { RxPdoTypeEnum::RxPdoCSTCSP, TxPdoTypeEnum::TxPdoCSTCSP }
@@ -230,6 +267,18 @@ bool Configuration::sanityCheck(bool silent) const {
     }
   };
   auto pdoTypePair = getPdoTypeSolution();
+  uint8_t mantissa = 0;
+  int8_t exponent = 0;
+  const auto rxObjectNames = CustomPdo::getRxObjectNames();
+  const auto txObjectNames = CustomPdo::getTxObjectNames();
+  bool usedPdoObjectsKnown = true;
+  for (const auto& name : usedPdoObjects) {
+    usedPdoObjectsKnown &=
+        std::find(rxObjectNames.begin(), rxObjectNames.end(), name) !=
+            rxObjectNames.end() ||
+        std::find(txObjectNames.begin(), txObjectNames.end(), name) !=
+            txObjectNames.end();
+  }
   // clang-format off
   const std::vector<std::pair<bool, std::string>> sanity_tests = {
       {
@@ -284,6 +333,30 @@ bool Configuration::sanityCheck(bool silent) const {
         (driveStateChangeMinTimeout <= driveStateChangeMaxTimeout),
         "drive_state_change_min_timeout ≤ drive_state_change_max_timeout"
       },
+      {
+        (cycleTime == 0 || getInterpolationTimePeriod(cycleTime, mantissa, exponent)),
+        "cycle_time representable as interpolation time period"
+      },
+      {
+        (!useDistributedClock || cycleTime == 0 || static_cast<unsigned int>(std::abs(distributedClockShift)) < cycleTime),
+        "|distributed_clock_shift| < cycle_time"
+      },
+      {
+        (customRxPdo.empty() || std::find(customRxPdo.begin(), customRxPdo.end(), "controlword") != customRxPdo.end()),
+        "custom_rx_pdo contains controlword"
+      },
+      {
+        (customTxPdo.empty() || std::find(customTxPdo.begin(), customTxPdo.end(), "statusword") != customTxPdo.end()),
+        "custom_tx_pdo contains statusword"
+      },
+      {
+        usedPdoObjectsKnown,
+        "used_pdo_objects are known PDO objects"
+      },
+      {
+        (limitGuardMargin >= 0),
+        "limit_guard_margin >= 0"
+      },
   };
   // clang-format on
 
@@ -295,4 +368,32 @@ bool Configuration::sanityCheck(bool silent) const {
 
   return success;
 }
+
+uint64_t Configuration::getHardwareFingerprint() const {
+  Fingerprint fingerprint;
+  for (const auto& modeOfOperation : modesOfOperation) {
+    fingerprint.add(modeOfOperation);
+  }
+  fingerprint.add(gearRatio);
+  fingerprint.add(workVoltage);
+  fingerprint.add(speedConstant);
+  fingerprint.add(nominalCurrentA);
+  fingerprint.add(torqueConstantNmA);
+  fingerprint.add(maxCurrentA);
+  fingerprint.add(minPosition);
+  fingerprint.add(maxPosition);
+  fingerprint.add(maxProfileVelocity);
+  fingerprint.add(quickStopDecel);
+  fingerprint.add(profileDecel);
+  fingerprint.add(followErrorWindow);
+  fingerprint.add(currentPGainSI);
+  fingerprint.add(currentIGainSI);
+  fingerprint.add(positionPGainSI);
+  fingerprint.add(positionIGainSI);
+  fingerprint.add(positionDGainSI);
+  fingerprint.add(velocityPGainSI);
+  fingerprint.add(velocityIGainSI);
+  return fingerprint.get();
+}
+
 }  // namespace maxon
@@ -174,6 +174,53 @@ void ConfigurationParser::parseConfiguration(YAML::Node configNode) {
                          driveStateChangeMaxTimeout)) {
       configuration_.driveStateChangeMaxTimeout = driveStateChangeMaxTimeout;
     }
+
+    // optional, no warning if not defined
+    if (maxonNode["fast_drive_state_change"].IsDefined()) {
+      bool fastDriveStateChange;
+      if (getValueFromFile(maxonNode, "fast_drive_state_change",
+                           fastDriveStateChange)) {
+        configuration_.fastDriveStateChange = fastDriveStateChange;
+      }
+    }
+
+    unsigned int cycleTime;
+    if (getValueFromFile(maxonNode, "cycle_time", cycleTime)) {
+      configuration_.cycleTime = cycleTime;
+    }
+
+    bool useDistributedClock;
+    if (getValueFromFile(maxonNode, "use_distributed_clock",
+                         useDistributedClock)) {
+      configuration_.useDistributedClock = useDistributedClock;
+    }
+
+    int distributedClockShift;
+    if (getValueFromFile(maxonNode, "distributed_clock_shift",
+                         distributedClockShift)) {
+      configuration_.distributedClockShift = distributedClockShift;
+    }
+
+    std::string configurationCacheDirectory;
+    if (getValueFromFile(maxonNode, "configuration_cache_directory",
+                         configurationCacheDirectory)) {
+      configuration_.configurationCacheDirectory = configurationCacheDirectory;
+    }
+
+    // optional, no warning if not defined
+    if (maxonNode["limit_guard"].IsDefined()) {
+      bool useLimitGuard;
+      if (getValueFromFile(maxonNode, "limit_guard", useLimitGuard)) {
+        configuration_.useLimitGuard = useLimitGuard;
+      }
+    }
+
+    if (maxonNode["limit_guard_margin"].IsDefined()) {
+      double limitGuardMargin;
+      if (getValueFromFile(maxonNode, "limit_guard_margin", limitGuardMargin)) {
+        configuration_.limitGuardMargin = limitGuardMargin;
+      }
+    }
   }
 
   /// The configuration options for the maxon::ethercat::Reading class
@@ -327,6 +374,36 @@ void ConfigurationParser::parseConfiguration(YAML::Node configNode) {
     if (getValueFromFile(hardwareNode, "velocity_i_gain", velcityIGainSI)) {
       configuration_.velocityIGainSI = velcityIGainSI;
     }
+
+    // optional, no warning if not defined
+    if (hardwareNode["custom_rx_pdo"].IsDefined()) {
+      std::vector<std::string> customRxPdo;
+      if (getValueFromFile(hardwareNode, "custom_rx_pdo", customRxPdo)) {
+        configuration_.customRxPdo = customRxPdo;
+      }
+    }
+
+    if (hardwareNode["custom_tx_pdo"].IsDefined()) {
+      std::vector<std::string> customTxPdo;
+      if (getValueFromFile(hardwareNode, "custom_tx_pdo", customTxPdo)) {
+        configuration_.customTxPdo = customTxPdo;
+      }
+    }
+
+    if (hardwareNode["minimize_pdo_mapping"].IsDefined()) {
+      bool minimizePdoMapping;
+      if (getValueFromFile(hardwareNode, "minimize_pdo_mapping",
+                           minimizePdoMapping)) {
+        configuration_.minimizePdoMapping = minimizePdoMapping;
+      }
+    }
+
+    if (hardwareNode["used_pdo_objects"].IsDefined()) {
+      std::vector<std::string> usedPdoObjects;
+      if (getValueFromFile(hardwareNode, "used_pdo_objects", usedPdoObjects)) {
+        configuration_.usedPdoObjects = usedPdoObjects;
+      }
+    }
   }
 }
 
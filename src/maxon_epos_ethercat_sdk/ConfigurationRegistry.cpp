@@ -0,0 +1,354 @@
+// clang-format off
+/*
+** Copyright 2021 Robotic Systems Lab - ETH Zurich:
+** Linghao Zhang, Jonas Junger, Lennart Nachtigall
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions are met:
+**
+** 1. Redistributions of source code must retain the above copyright notice,
+**    this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright notice,
+**    this list of conditions and the following disclaimer in the documentation
+**    and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its contributors
+**    may be used to endorse or promote products derived from this software without
+**    specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+** AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+** IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+** DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+** FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+** DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+** SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+** CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+** OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+// clang-format on
+
+#include "maxon_epos_ethercat_sdk/ConfigurationRegistry.hpp"
+
+#include <yaml-cpp/yaml.h>
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <message_logger/message_logger.hpp>
+#include <sstream>
+#include <type_traits>
+#include <vector>
+
+#include "maxon_epos_ethercat_sdk/ConfigurationParser.hpp"
+#include "maxon_epos_ethercat_sdk/Fingerprint.hpp"
+
+namespace maxon {
+namespace {
+constexpr char binaryMagic[8] = {'M', 'X', 'C', 'O', 'N', 'F', 'I', 'G'};
+// increment when visitConfiguration() changes
+constexpr uint32_t binaryVersion = 3;
+
+/*!
+ * Every member of the configuration, in the order of the binary cache.
+ * Must be extended together with Configuration.
+ */
+template <typename ConfigurationType, typename Visitor>
+void visitConfiguration(ConfigurationType& c, Visitor& visitor) {
+  visitor(c.modesOfOperation);
+  visitor(c.configRunSdoVerifyTimeout);
+  visitor(c.printDebugMessages);
+  visitor(c.driveStateChangeMinTimeout);
+  visitor(c.minNumberOfSuccessfulTargetStateReadings);
+  visitor(c.driveStateChangeMaxTimeout);
+  visitor(c.fastDriveStateChange);
+  visitor(c.cycleTime);
+  visitor(c.useDistributedClock);
+  visitor(c.distributedClockShift);
+  visitor(c.useLimitGuard);
+  visitor(c.limitGuardMargin);
+  visitor(c.forceAppendEqualError);
+  visitor(c.forceAppendEqualFault);
+  visitor(c.errorStorageCapacity);
+  visitor(c.faultStorageCapacity);
+  visitor(c.positionEncoderResolution);
+  visitor(c.useRawCommands);
+  visitor(c.gearRatio);
+  visitor(c.motorConstant);
+  visitor(c.workVoltage);
+  visitor(c.speedConstant);
+  visitor(c.polePairs);
+  visitor(c.nominalCurrentA);
+  visitor(c.torqueConstantNmA);
+  visitor(c.maxCurrentA);
+  visitor(c.minPosition);
+  visitor(c.maxPosition);
+  visitor(c.maxProfileVelocity);
+  visitor(c.quickStopDecel);
+  visitor(c.profileDecel);
+  visitor(c.followErrorWindow);
+  visitor(c.currentPGainSI);
+  visitor(c.currentIGainSI);
+  visitor(c.positionPGainSI);
+  visitor(c.positionIGainSI);
+  visitor(c.positionDGainSI);
+  visitor(c.velocityPGainSI);
+  visitor(c.velocityIGainSI);
+  visitor(c.configurationCacheDirectory);
+  visitor(c.customRxPdo);
+  visitor(c.customTxPdo);
+  visitor(c.minimizePdoMapping);
+  visitor(c.usedPdoObjects);
+}
+
+class BinaryWriter {
+ public:
+  template <typename T>
+  void operator()(const T& value) {
+    static_assert(std::is_trivially_copyable<T>::value,
+                  "Only trivially copyable values can be written");
+    buffer_.append(reinterpret_cast<const char*>(&value), sizeof(T));
+  }
+  void operator()(const std::string& value) {
+    (*this)(static_cast<uint32_t>(value.size()));
+    buffer_.append(value);
+  }
+  template <typename T>
+  void operator()(const std::vector<T>& values) {
+    (*this)(static_cast<uint32_t>(values.size()));
+    for (const auto& value : values) {
+      (*this)(value);
+    }
+  }
+
+  const std::string& getBuffer() const { return buffer_; }
+
+ private:
+  std::string buffer_;
+};
+
+class BinaryReader {
+ public:
+  explicit BinaryReader(const std::string& buffer) : buffer_(buffer) {}
+
+  template <typename T>
+  void operator()(T& value) {
+    static_assert(std::is_trivially_copyable<T>::value,
+                  "Only trivially copyable values can be read");
+    if (!take(sizeof(T))) {
+      return;
+    }
+    std::memcpy(&value, buffer_.data() + position_ - sizeof(T), sizeof(T));
+  }
+  void operator()(std::string& value) {
+    uint32_t size = 0;
+    (*this)(size);
+    if (!take(size)) {
+      return;
+    }
+    value.assign(buffer_, position_ - size, size);
+  }
+  template <typename T>
+  void operator()(std::vector<T>& values) {
+    uint32_t size = 0;
+    (*this)(size);
+    // every element takes at least one byte, guards against corrupt sizes
+    if (!success_ || size > buffer_.size() - position_) {
+      success_ = false;
+      return;
+    }
+    values.resize(size);
+    for (auto& value : values) {
+      (*this)(value);
+    }
+  }
+
+  bool success() const { return success_ && position_ == buffer_.size(); }
+
+ private:
+  bool take(std::size_t size) {
+    if (!success_ || size > buffer_.size() - position_) {
+      success_ = false;
+      return false;
+    }
+    position_ += size;
+    return true;
+  }
+
+  const std::string& buffer_;
+  std::size_t position_{0};
+  bool success_{true};
+};
+
+bool readFile(const std::string& fileName, std::string& content) {
+  std::ifstream file(fileName, std::ios::binary);
+  if (!file) {
+    return false;
+  }
+  content.assign(std::istreambuf_iterator<char>(file),
+                 std::istreambuf_iterator<char>());
+  return true;
+}
+
+uint64_t getContentFingerprint(const std::string& content) {
+  Fingerprint fingerprint;
+  fingerprint.addBytes(content.data(), content.size());
+  return fingerprint.get();
+}
+}  // namespace
+
+ConfigurationRegistry& ConfigurationRegistry::getInstance() {
+  static ConfigurationRegistry instance;
+  return instance;
+}
+
+ConfigurationRegistry::ConfigurationPtr
+ConfigurationRegistry::getConfiguration(const std::string& fileName) {
+  std::string content;
+  if (!readFile(fileName, content)) {
+    MELO_ERROR_STREAM(
+        "[maxon_epos_ethercat_sdk:ConfigurationRegistry::getConfiguration] "
+        "Loading YAML configuration file '"
+        << fileName << "' failed.");
+    return nullptr;
+  }
+  const uint64_t sourceFingerprint = getContentFingerprint(content);
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = configurations_.find(fileName);
+  if (it != configurations_.end() && it->second.first == sourceFingerprint) {
+    return it->second.second;
+  }
+
+  const std::string cacheFile = getCacheFile(sourceFingerprint);
+  ConfigurationPtr configuration;
+  if (!cacheFile.empty()) {
+    configuration = readBinary(cacheFile, sourceFingerprint);
+  }
+  if (configuration == nullptr) {
+    YAML::Node configNode;
+    try {
+      configNode = YAML::Load(content);
+    } catch (...) {
+      MELO_ERROR_STREAM(
+          "[maxon_epos_ethercat_sdk:ConfigurationRegistry::getConfiguration] "
+          "Parsing YAML configuration file '"
+          << fileName << "' failed.");
+      return nullptr;
+    }
+    MELO_INFO_STREAM("[maxon_epos_ethercat_sdk] Sanity check for '"
+                     << fileName << "':");
+    configuration =
+        validate(ConfigurationParser(configNode).getConfiguration());
+    if (!cacheFile.empty() && configuration->sane_) {
+      writeBinary(*configuration, sourceFingerprint, cacheFile);
+    }
+  }
+  configurations_[fileName] = std::make_pair(sourceFingerprint, configuration);
+  return configuration;
+}
+
+void ConfigurationRegistry::setCacheDirectory(const std::string& directory) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  cacheDirectory_ = directory;
+}
+
+void ConfigurationRegistry::clear() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  configurations_.clear();
+}
+
+ConfigurationRegistry::ConfigurationPtr ConfigurationRegistry::validate(
+    const Configuration& configuration, bool silent) {
+  auto validatedConfiguration = std::make_shared<ValidatedConfiguration>();
+  validatedConfiguration->configuration_ = configuration;
+  validatedConfiguration->pdoTypeSolution_ =
+      configuration.getPdoTypeSolution();
+  validatedConfiguration->sane_ = configuration.sanityCheck(silent);
+  return validatedConfiguration;
+}
+
+bool ConfigurationRegistry::writeBinary(
+    const ValidatedConfiguration& configuration, uint64_t sourceFingerprint,
+    const std::string& fileName) {
+  BinaryWriter writer;
+  for (const char c : binaryMagic) {
+    writer(c);
+  }
+  writer(binaryVersion);
+  writer(static_cast<uint32_t>(sizeof(Configuration)));
+  writer(sourceFingerprint);
+  writer(configuration.pdoTypeSolution_.first);
+  writer(configuration.pdoTypeSolution_.second);
+  writer(configuration.sane_);
+  visitConfiguration(configuration.configuration_, writer);
+
+  // written to a temporary file first, such that concurrently starting
+  // processes never read a partial cache
+  const std::string temporaryFileName = fileName + ".tmp";
+  {
+    std::ofstream file(temporaryFileName, std::ios::binary);
+    file.write(writer.getBuffer().data(), writer.getBuffer().size());
+    if (!file) {
+      MELO_WARN_STREAM(
+          "[maxon_epos_ethercat_sdk:ConfigurationRegistry::writeBinary] "
+          "Cannot write '"
+          << fileName << "'");
+      return false;
+    }
+  }
+  return std::rename(temporaryFileName.c_str(), fileName.c_str()) == 0;
+}
+
+ConfigurationRegistry::ConfigurationPtr ConfigurationRegistry::readBinary(
+    const std::string& fileName, uint64_t sourceFingerprint) {
+  std::string buffer;
+  if (!readFile(fileName, buffer)) {
+    return nullptr;
+  }
+  BinaryReader reader(buffer);
+  char magic[sizeof(binaryMagic)]{};
+  for (char& c : magic) {
+    reader(c);
+  }
+  uint32_t version = 0;
+  uint32_t configurationSize = 0;
+  uint64_t fingerprint = 0;
+  reader(version);
+  reader(configurationSize);
+  reader(fingerprint);
+  if (std::memcmp(magic, binaryMagic, sizeof(binaryMagic)) != 0 ||
+      version != binaryVersion || configurationSize != sizeof(Configuration) ||
+      fingerprint != sourceFingerprint) {
+    return nullptr;
+  }
+
+  auto configuration = std::make_shared<ValidatedConfiguration>();
+  reader(configuration->pdoTypeSolution_.first);
+  reader(configuration->pdoTypeSolution_.second);
+  reader(configuration->sane_);
+  visitConfiguration(configuration->configuration_, reader);
+  if (!reader.success()) {
+    MELO_WARN_STREAM(
+        "[maxon_epos_ethercat_sdk:ConfigurationRegistry::readBinary] '"
+        << fileName << "' is corrupt and ignored.");
+    return nullptr;
+  }
+  return configuration;
+}
+
+std::string ConfigurationRegistry::getCacheFile(
+    uint64_t sourceFingerprint) const {
+  if (cacheDirectory_.empty()) {
+    return "";
+  }
+  std::stringstream fileName;
+  fileName << cacheDirectory_ << "/maxon_configuration_" << std::hex
+           << sourceFingerprint << ".bin";
+  return fileName.str();
+}
+
+}  // namespace maxon
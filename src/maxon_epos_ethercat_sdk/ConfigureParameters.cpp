@@ -31,676 +31,497 @@
 // clang-format on
 
 #include <array>
+#include <fstream>
+#include <sstream>
 #include <thread>
 
+#include "maxon_epos_ethercat_sdk/Fingerprint.hpp"
 #include "maxon_epos_ethercat_sdk/Maxon.hpp"
 #include "maxon_epos_ethercat_sdk/ObjectDictionary.hpp"
+#include "maxon_epos_ethercat_sdk/RxPdo.hpp"
+#include "maxon_epos_ethercat_sdk/TxPdo.hpp"
 
 namespace maxon {
-bool Maxon::mapPdos(RxPdoTypeEnum rxPdoTypeEnum, TxPdoTypeEnum txPdoTypeEnum) {
-  uint8_t subIndex;
+template <typename RxPdo>
+void Maxon::bindRxPdo() {
+  writeRxPdoFunction_ = &Maxon::writeRxPdo<RxPdo>;
+  mapRxPdoFunction_ = &Maxon::mapRxPdo<RxPdo>;
+  rxPdoSize_ = sizeof(RxPdo);
+  const auto mapping = RxPdo::getMapping();
+  rxPdoMapping_.assign(mapping.begin(), mapping.end());
+}
 
-  bool rxSuccess = true;
-  switch (rxPdoTypeEnum) {
-    case RxPdoTypeEnum::RxPdoStandard: {
-      MELO_INFO_STREAM("[maxon_epos_ethercat_sdk:Maxon::mapPdos] Rx Pdo: "
-                       << "Standard Mode");
-
-      // Disable PDO
-      rxSuccess &= sdoVerifyWrite(OD_INDEX_RX_PDO_ASSIGNMENT, 0x00, false,
-                                  static_cast<uint8_t>(0),
-                                  configuration_.configRunSdoVerifyTimeout);
-
-      // Write mapping
-      rxSuccess &= sdoVerifyWrite(OD_INDEX_RX_PDO_ASSIGNMENT, 0x01, false,
-                                  OD_INDEX_RX_PDO_MAPPING_3,
-                                  configuration_.configRunSdoVerifyTimeout);
-
-      // Write number of objects
-      rxSuccess &= sdoVerifyWrite(OD_INDEX_RX_PDO_MAPPING_3, 0x00, false,
-                                  static_cast<uint8_t>(0),
-                                  configuration_.configRunSdoVerifyTimeout);
-
-      // Enable PDO
-      rxSuccess &= sdoVerifyWrite(OD_INDEX_RX_PDO_ASSIGNMENT, 0x00, false,
-                                  static_cast<uint8_t>(1),
-                                  configuration_.configRunSdoVerifyTimeout);
+template <typename TxPdo>
+void Maxon::bindTxPdo() {
+  readTxPdoFunction_ = &Maxon::readTxPdo<TxPdo>;
+  mapTxPdoFunction_ = &Maxon::mapTxPdo<TxPdo>;
+  txPdoSize_ = sizeof(TxPdo);
+  const auto mapping = TxPdo::getMapping();
+  txPdoMapping_.assign(mapping.begin(), mapping.end());
+}
 
-      break;
-    }
-    case RxPdoTypeEnum::RxPdoCSP: {
-      MELO_INFO_STREAM("[maxon_epos_ethercat_sdk:Maxon::mapPdos] Rx Pdo: "
-                       << "Cyclic Synchronous Position Mode");
-
-      // Disable PDO
-      rxSuccess &= sdoVerifyWrite(OD_INDEX_RX_PDO_ASSIGNMENT, 0x00, false,
-                                  static_cast<uint8_t>(0),
-                                  configuration_.configRunSdoVerifyTimeout);
-
-      rxSuccess &= sdoVerifyWrite(OD_INDEX_RX_PDO_MAPPING_3, 0x00, false,
-                                  static_cast<uint8_t>(0),
-                                  configuration_.configRunSdoVerifyTimeout);
-
-      // Write mapping
-      rxSuccess &= sdoVerifyWrite(OD_INDEX_RX_PDO_ASSIGNMENT, 0x01, false,
-                                  OD_INDEX_RX_PDO_MAPPING_3,
-                                  configuration_.configRunSdoVerifyTimeout);
-
-      // Write objects...
-      std::array<uint32_t, 5> objects{
-          (OD_INDEX_TARGET_POSITION << 16) | (0x00 << 8) | sizeof(int32_t) * 8,
-          (OD_INDEX_OFFSET_POSITION << 16) | (0x00 << 8) | sizeof(int32_t) * 8,
-          (OD_INDEX_OFFSET_TORQUE << 16) | (0x00 << 8) | sizeof(int16_t) * 8,
-          (OD_INDEX_CONTROLWORD << 16) | (0x00 << 8) | sizeof(int16_t) * 8,
-          (OD_INDEX_MODES_OF_OPERATION << 16) | (0x00 << 8) |
-              sizeof(int8_t) * 8,
-      };
-
-      subIndex = 0;
-      for (const auto& objectIndex : objects) {
-        subIndex += 1;
-        rxSuccess &= sdoVerifyWrite(OD_INDEX_RX_PDO_MAPPING_3, subIndex, false,
-                                    objectIndex,
-                                    configuration_.configRunSdoVerifyTimeout);
-      }
-
-      // Write number of objects
-      rxSuccess &=
-          sdoVerifyWrite(OD_INDEX_RX_PDO_MAPPING_3, 0x00, false, subIndex,
-                         configuration_.configRunSdoVerifyTimeout);
-
-      // Enable PDO
-      rxSuccess &= sdoVerifyWrite(OD_INDEX_RX_PDO_ASSIGNMENT, 0x00, false,
-                                  static_cast<uint8_t>(1),
-                                  configuration_.configRunSdoVerifyTimeout);
+template <typename RxPdo>
+void Maxon::writeRxPdo(const RawCommand& command) {
+  static_assert(sizeof(RxPdo) <= maxCustomPdoSize,
+                "The Rx PDO does not fit into a TelemetryRecord");
+  if (processImageRxPdoSize_ == sizeof(RxPdo)) {
+    // encode straight into the outgoing frame
+    reinterpret_cast<RxPdo*>(processImageRxPdo_)
+        ->encode(command, controlword_);
+    recordRxPdo(processImageRxPdo_, sizeof(RxPdo));
+    return;
+  }
+  RxPdo rxPdo{};
+  rxPdo.encode(command, controlword_);
+  bus_->writeRxPdo(address_, rxPdo);
+  recordRxPdo(&rxPdo, sizeof(RxPdo));
+}
 
-      break;
-    }
-    case RxPdoTypeEnum::RxPdoCST: {
-      MELO_INFO_STREAM("[maxon_epos_ethercat_sdk:Maxon::mapPdos] Rx Pdo: "
-                       << "Cyclic Synchronous Troque Mode");
-
-      // Disable PDO
-      rxSuccess &= sdoVerifyWrite(OD_INDEX_RX_PDO_ASSIGNMENT, 0x00, false,
-                                  static_cast<uint8_t>(0),
-                                  configuration_.configRunSdoVerifyTimeout);
-
-      rxSuccess &= sdoVerifyWrite(OD_INDEX_RX_PDO_MAPPING_3, 0x00, false,
-                                  static_cast<uint8_t>(0),
-                                  configuration_.configRunSdoVerifyTimeout);
-
-      // Write mapping
-      rxSuccess &= sdoVerifyWrite(OD_INDEX_RX_PDO_ASSIGNMENT, 0x01, false,
-                                  OD_INDEX_RX_PDO_MAPPING_3,
-                                  configuration_.configRunSdoVerifyTimeout);
-
-      // Write objects...
-      std::array<uint32_t, 4> objects{
-          (OD_INDEX_TARGET_TORQUE << 16) | (0x00 << 8) | sizeof(int16_t) * 8,
-          (OD_INDEX_OFFSET_TORQUE << 16) | (0x00 << 8) | sizeof(int16_t) * 8,
-          (OD_INDEX_CONTROLWORD << 16) | (0x00 << 8) | sizeof(int16_t) * 8,
-          (OD_INDEX_MODES_OF_OPERATION << 16) | (0x00 << 8) |
-              sizeof(int8_t) * 8,
-      };
-
-      subIndex = 0;
-      for (const auto& objectIndex : objects) {
-        subIndex += 1;
-        rxSuccess &= sdoVerifyWrite(OD_INDEX_RX_PDO_MAPPING_3, subIndex, false,
-                                    objectIndex,
-                                    configuration_.configRunSdoVerifyTimeout);
-      }
-
-      // Write number of objects
-      rxSuccess &=
-          sdoVerifyWrite(OD_INDEX_RX_PDO_MAPPING_3, 0x00, false, subIndex,
-                         configuration_.configRunSdoVerifyTimeout);
-
-      // Enable PDO
-      rxSuccess &= sdoVerifyWrite(OD_INDEX_RX_PDO_ASSIGNMENT, 0x00, false,
-                                  static_cast<uint8_t>(1),
-                                  configuration_.configRunSdoVerifyTimeout);
+template <typename TxPdo>
+void Maxon::readTxPdo() {
+  static_assert(sizeof(TxPdo) <= maxCustomPdoSize,
+                "The Tx PDO does not fit into a TelemetryRecord");
+  if (processImageTxPdoSize_ == sizeof(TxPdo)) {
+    // decode straight from the received frame
+    reinterpret_cast<const TxPdo*>(processImageTxPdo_)
+        ->decode(readingSnapshot_);
+    recordTxPdo(processImageTxPdo_, sizeof(TxPdo));
+    return;
+  }
+  TxPdo txPdo{};
+  bus_->readTxPdo(address_, txPdo);
+  txPdo.decode(readingSnapshot_);
+  recordTxPdo(&txPdo, sizeof(TxPdo));
+}
 
-      break;
-    }
-    case RxPdoTypeEnum::RxPdoCSV: {
-      MELO_INFO_STREAM("[maxon_epos_ethercat_sdk:Maxon::mapPdos] Rx Pdo: "
-                       << "Cyclic Synchronous Veloctity Mode");
-
-      // Disable PDO
-      rxSuccess &= sdoVerifyWrite(OD_INDEX_RX_PDO_ASSIGNMENT, 0x00, false,
-                                  static_cast<uint8_t>(0),
-                                  configuration_.configRunSdoVerifyTimeout);
-
-      rxSuccess &= sdoVerifyWrite(OD_INDEX_RX_PDO_MAPPING_3, 0x00, false,
-                                  static_cast<uint8_t>(0),
-                                  configuration_.configRunSdoVerifyTimeout);
-
-      // Write mapping
-      rxSuccess &= sdoVerifyWrite(OD_INDEX_RX_PDO_ASSIGNMENT, 0x01, false,
-                                  OD_INDEX_RX_PDO_MAPPING_3,
-                                  configuration_.configRunSdoVerifyTimeout);
-
-      // Write objects...
-      std::array<uint32_t, 4> objects{
-          (OD_INDEX_TARGET_VELOCITY << 16) | (0x00 << 8) | sizeof(int32_t) * 8,
-          (OD_INDEX_OFFSET_VELOCITY << 16) | (0x00 << 8) | sizeof(int32_t) * 8,
-          (OD_INDEX_CONTROLWORD << 16) | (0x00 << 8) | sizeof(int16_t) * 8,
-          (OD_INDEX_MODES_OF_OPERATION << 16) | (0x00 << 8) |
-              sizeof(int8_t) * 8,
-      };
-
-      subIndex = 0;
-      for (const auto& objectIndex : objects) {
-        subIndex += 1;
-        rxSuccess &= sdoVerifyWrite(OD_INDEX_RX_PDO_MAPPING_3, subIndex, false,
-                                    objectIndex,
-                                    configuration_.configRunSdoVerifyTimeout);
-      }
-
-      // Write number of objects
-      rxSuccess &=
-          sdoVerifyWrite(OD_INDEX_RX_PDO_MAPPING_3, 0x00, false, subIndex,
-                         configuration_.configRunSdoVerifyTimeout);
-
-      // Enable PDO
-      rxSuccess &= sdoVerifyWrite(OD_INDEX_RX_PDO_ASSIGNMENT, 0x00, false,
-                                  static_cast<uint8_t>(1),
-                                  configuration_.configRunSdoVerifyTimeout);
+template <typename RxPdo>
+bool Maxon::mapRxPdo() {
+  MELO_INFO_STREAM("[maxon_epos_ethercat_sdk:Maxon::mapPdos] Rx Pdo: "
+                   << RxPdo::getName());
+  return mapPdo<RxPdo>(OD_INDEX_RX_PDO_ASSIGNMENT, OD_INDEX_RX_PDO_MAPPING_3);
+}
 
-      break;
-    }
-    case RxPdoTypeEnum::RxPdoCSTCSP: {
-      MELO_INFO_STREAM("[maxon_epos_ethercat_sdk:Maxon::mapPdos] Rx Pdo: "
-                       << "Cyclic Synchronous Toruqe/Position Mixed Mode");
-
-      // Disable PDO
-      rxSuccess &= sdoVerifyWrite(OD_INDEX_RX_PDO_ASSIGNMENT, 0x00, false,
-                                  static_cast<uint8_t>(0),
-                                  configuration_.configRunSdoVerifyTimeout);
-
-      rxSuccess &= sdoVerifyWrite(OD_INDEX_RX_PDO_MAPPING_3, 0x00, false,
-                                  static_cast<uint8_t>(0),
-                                  configuration_.configRunSdoVerifyTimeout);
-
-      // Write mapping
-      rxSuccess &= sdoVerifyWrite(OD_INDEX_RX_PDO_ASSIGNMENT, 0x01, false,
-                                  OD_INDEX_RX_PDO_MAPPING_3,
-                                  configuration_.configRunSdoVerifyTimeout);
-
-      // Write objects...
-      std::array<uint32_t, 6> objects{
-          (OD_INDEX_TARGET_TORQUE << 16) | (0x00 << 8) | sizeof(int16_t) * 8,
-          (OD_INDEX_OFFSET_TORQUE << 16) | (0x00 << 8) | sizeof(int16_t) * 8,
-          (OD_INDEX_TARGET_POSITION << 16) | (0x00 << 8) | sizeof(int32_t) * 8,
-          (OD_INDEX_OFFSET_POSITION << 16) | (0x00 << 8) | sizeof(int32_t) * 8,
-          (OD_INDEX_CONTROLWORD << 16) | (0x00 << 8) | sizeof(int16_t) * 8,
-          (OD_INDEX_MODES_OF_OPERATION << 16) | (0x00 << 8) |
-              sizeof(int8_t) * 8,
-      };
-
-      subIndex = 0;
-      for (const auto& objectIndex : objects) {
-        subIndex += 1;
-        rxSuccess &= sdoVerifyWrite(OD_INDEX_RX_PDO_MAPPING_3, subIndex, false,
-                                    objectIndex,
-                                    configuration_.configRunSdoVerifyTimeout);
-      }
-
-      // Write number of objects
-      rxSuccess &=
-          sdoVerifyWrite(OD_INDEX_RX_PDO_MAPPING_3, 0x00, false, subIndex,
-                         configuration_.configRunSdoVerifyTimeout);
-
-      // Enable PDO
-      rxSuccess &= sdoVerifyWrite(OD_INDEX_RX_PDO_ASSIGNMENT, 0x00, false,
-                                  static_cast<uint8_t>(1),
-                                  configuration_.configRunSdoVerifyTimeout);
+template <typename TxPdo>
+bool Maxon::mapTxPdo() {
+  MELO_INFO_STREAM("[maxon_epos_ethercat_sdk:Maxon::mapPdos] Tx Pdo: "
+                   << TxPdo::getName());
+  return mapPdo<TxPdo>(OD_INDEX_TX_PDO_ASSIGNMENT, OD_INDEX_TX_PDO_MAPPING_3);
+}
 
-      break;
-    }
-    case RxPdoTypeEnum::RxPdoCSTCSPCSV: {
-      MELO_INFO_STREAM(
-          "[maxon_epos_ethercat_sdk:Maxon::mapPdos] Rx Pdo: "
-          << "Cyclic Synchronous Toruqe/Position/Velocity Mixed Mode");
-
-      // Disable PDO
-      rxSuccess &= sdoVerifyWrite(OD_INDEX_RX_PDO_ASSIGNMENT, 0x00, false,
-                                  static_cast<uint8_t>(0),
-                                  configuration_.configRunSdoVerifyTimeout);
-
-      rxSuccess &= sdoVerifyWrite(OD_INDEX_RX_PDO_MAPPING_3, 0x00, false,
-                                  static_cast<uint8_t>(0),
-                                  configuration_.configRunSdoVerifyTimeout);
-
-      // Write mapping
-      rxSuccess &= sdoVerifyWrite(OD_INDEX_RX_PDO_ASSIGNMENT, 0x01, false,
-                                  OD_INDEX_RX_PDO_MAPPING_3,
-                                  configuration_.configRunSdoVerifyTimeout);
-
-      // Write objects...
-      std::array<uint32_t, 8> objects{
-          (OD_INDEX_TARGET_TORQUE << 16) | (0x00 << 8) | sizeof(int16_t) * 8,
-          (OD_INDEX_OFFSET_TORQUE << 16) | (0x00 << 8) | sizeof(int16_t) * 8,
-          (OD_INDEX_TARGET_POSITION << 16) | (0x00 << 8) | sizeof(int32_t) * 8,
-          (OD_INDEX_OFFSET_POSITION << 16) | (0x00 << 8) | sizeof(int32_t) * 8,
-          (OD_INDEX_TARGET_VELOCITY << 16) | (0x00 << 8) | sizeof(int32_t) * 8,
-          (OD_INDEX_OFFSET_VELOCITY << 16) | (0x00 << 8) | sizeof(int32_t) * 8,
-          (OD_INDEX_CONTROLWORD << 16) | (0x00 << 8) | sizeof(int16_t) * 8,
-          (OD_INDEX_MODES_OF_OPERATION << 16) | (0x00 << 8) |
-              sizeof(int8_t) * 8,
-      };
-
-      subIndex = 0;
-      for (const auto& objectIndex : objects) {
-        subIndex += 1;
-        rxSuccess &= sdoVerifyWrite(OD_INDEX_RX_PDO_MAPPING_3, subIndex, false,
-                                    objectIndex,
-                                    configuration_.configRunSdoVerifyTimeout);
-      }
-
-      // Write number of objects
-      rxSuccess &=
-          sdoVerifyWrite(OD_INDEX_RX_PDO_MAPPING_3, 0x00, false, subIndex,
-                         configuration_.configRunSdoVerifyTimeout);
-
-      // Enable PDO
-      rxSuccess &= sdoVerifyWrite(OD_INDEX_RX_PDO_ASSIGNMENT, 0x00, false,
-                                  static_cast<uint8_t>(1),
-                                  configuration_.configRunSdoVerifyTimeout);
+template <typename Pdo>
+bool Maxon::mapPdo(uint16_t assignmentIndex, uint16_t mappingIndex) {
+  const auto mappingObject = getPdoMappingObject(Pdo::getMapping());
+  PdoAssignmentObject assignmentObject;
+  assignmentObject.numberOfEntries_ = 1;
+  assignmentObject.mappingIndex_ = mappingIndex;
+
+  // Nothing to do if the drive already holds the mapping (e.g. warm restart)
+  PdoAssignmentObject currentAssignmentObject;
+  auto currentMappingObject = mappingObject;
+  if (sendSdoRead(assignmentIndex, 0x00, true, currentAssignmentObject) &&
+      sendSdoRead(mappingIndex, 0x00, true, currentMappingObject) &&
+      currentAssignmentObject == assignmentObject &&
+      currentMappingObject == mappingObject) {
+    numberOfSkippedSdoWrites_ += 2;
+    return true;
+  }
 
-      break;
+  bool success = true;
+
+  // Disable PDO
+  success &=
+      sdoWriteIfChanged(assignmentIndex, 0x00, false, static_cast<uint8_t>(0));
+
+  success &=
+      sdoWriteIfChanged(mappingIndex, 0x00, false, static_cast<uint8_t>(0));
+
+  // Write all objects and their number in one Complete Access transfer
+  if (!sdoWriteIfChanged(mappingIndex, 0x00, true, mappingObject)) {
+    MELO_WARN_STREAM(
+        "[maxon_epos_ethercat_sdk:Maxon::mapPdos] Complete Access to 0x"
+        << std::hex << mappingIndex << std::dec << " of '" << name_
+        << "' failed, writing the objects one by one.");
+    // a failed disable write above still fails the mapping
+    success &= mapPdoEntryByEntry(assignmentIndex, mappingIndex,
+                                  Pdo::getMapping());
+    return success;
+  }
+
+  // Write mapping and enable PDO
+  success &= sdoWriteIfChanged(assignmentIndex, 0x00, true, assignmentObject);
+  return success;
+}
+
+template <typename Mapping>
+bool Maxon::mapPdoEntryByEntry(uint16_t assignmentIndex, uint16_t mappingIndex,
+                               const Mapping& mapping) {
+  bool success = true;
+
+  // Disable PDO
+  success &=
+      sdoWriteIfChanged(assignmentIndex, 0x00, false, static_cast<uint8_t>(0));
+
+  success &=
+      sdoWriteIfChanged(mappingIndex, 0x00, false, static_cast<uint8_t>(0));
+
+  // Write mapping
+  success &= sdoWriteIfChanged(assignmentIndex, 0x01, false, mappingIndex);
+
+  // Write objects...
+  uint8_t subIndex = 0;
+  for (const auto& entry : mapping) {
+    subIndex += 1;
+    success &= sdoWriteIfChanged(mappingIndex, subIndex, false,
+                                 entry.getMappingObject());
+  }
+
+  // Write number of objects
+  success &= sdoWriteIfChanged(mappingIndex, 0x00, false, subIndex);
+
+  // Enable PDO
+  success &=
+      sdoWriteIfChanged(assignmentIndex, 0x00, false, static_cast<uint8_t>(1));
+  return success;
+}
+
+template <std::size_t Size>
+void Maxon::writeCustomRxPdo(const RawCommand& command) {
+  CustomRxPdoSource source{command, controlword_};
+  if (processImageRxPdoSize_ == Size) {
+    customRxPdo_.encode(source, processImageRxPdo_);
+    recordRxPdo(processImageRxPdo_, Size);
+    return;
+  }
+  CustomPdoBuffer<Size> rxPdo;
+  customRxPdo_.encode(source, rxPdo.data_);
+  bus_->writeRxPdo(address_, rxPdo);
+  recordRxPdo(rxPdo.data_, Size);
+}
+
+template <std::size_t Size>
+void Maxon::readCustomTxPdo() {
+  if (processImageTxPdoSize_ == Size) {
+    customTxPdo_.decode(processImageTxPdo_, readingSnapshot_);
+    recordTxPdo(processImageTxPdo_, Size);
+    return;
+  }
+  CustomPdoBuffer<Size> txPdo;
+  bus_->readTxPdo(address_, txPdo);
+  customTxPdo_.decode(txPdo.data_, readingSnapshot_);
+  recordTxPdo(txPdo.data_, Size);
+}
+
+template <std::size_t... Sizes>
+bool Maxon::bindCustomRxPdo(std::index_sequence<Sizes...>) {
+  // handlers of all possible sizes, indexed by size - 1
+  static const std::array<void (Maxon::*)(const RawCommand&),
+                          sizeof...(Sizes)>
+      writeFunctions{{&Maxon::writeCustomRxPdo<Sizes + 1>...}};
+  if (customRxPdo_.empty()) {
+    return false;
+  }
+  writeRxPdoFunction_ = writeFunctions[customRxPdo_.getSize() - 1];
+  mapRxPdoFunction_ = &Maxon::mapCustomRxPdo;
+  rxPdoSize_ = customRxPdo_.getSize();
+  rxPdoMapping_ = customRxPdo_.getMapping();
+  return true;
+}
+
+template <std::size_t... Sizes>
+bool Maxon::bindCustomTxPdo(std::index_sequence<Sizes...>) {
+  // handlers of all possible sizes, indexed by size - 1
+  static const std::array<void (Maxon::*)(), sizeof...(Sizes)> readFunctions{
+      {&Maxon::readCustomTxPdo<Sizes + 1>...}};
+  if (customTxPdo_.empty()) {
+    return false;
+  }
+  readTxPdoFunction_ = readFunctions[customTxPdo_.getSize() - 1];
+  mapTxPdoFunction_ = &Maxon::mapCustomTxPdo;
+  txPdoSize_ = customTxPdo_.getSize();
+  txPdoMapping_ = customTxPdo_.getMapping();
+  return true;
+}
+
+bool Maxon::mapCustomRxPdo() {
+  MELO_INFO_STREAM("[maxon_epos_ethercat_sdk:Maxon::mapPdos] Rx Pdo: "
+                   << "Custom (" << customRxPdo_.getSize() << " bytes)");
+  return mapPdoEntryByEntry(OD_INDEX_RX_PDO_ASSIGNMENT,
+                            OD_INDEX_RX_PDO_MAPPING_3,
+                            customRxPdo_.getMapping());
+}
+
+bool Maxon::mapCustomTxPdo() {
+  MELO_INFO_STREAM("[maxon_epos_ethercat_sdk:Maxon::mapPdos] Tx Pdo: "
+                   << "Custom (" << customTxPdo_.getSize() << " bytes)");
+  return mapPdoEntryByEntry(OD_INDEX_TX_PDO_ASSIGNMENT,
+                            OD_INDEX_TX_PDO_MAPPING_3,
+                            customTxPdo_.getMapping());
+}
+
+bool Maxon::bindProcessImage(uint8_t* rxPdo, std::size_t rxPdoSize,
+                             const uint8_t* txPdo, std::size_t txPdoSize) {
+  std::lock_guard<std::recursive_mutex> lock(mutex_);
+  if (rxPdo == nullptr || txPdo == nullptr || rxPdoSize != rxPdoSize_ ||
+      txPdoSize != txPdoSize_) {
+    MELO_ERROR_STREAM(
+        "[maxon_epos_ethercat_sdk:Maxon::bindProcessImage] Process image of '"
+        << name_ << "' does not match the PDOs (Rx: " << rxPdoSize << " / "
+        << rxPdoSize_ << " bytes, Tx: " << txPdoSize << " / " << txPdoSize_
+        << " bytes)");
+    return false;
+  }
+  processImageRxPdo_ = rxPdo;
+  processImageTxPdo_ = txPdo;
+  processImageRxPdoSize_ = rxPdoSize;
+  processImageTxPdoSize_ = txPdoSize;
+  return true;
+}
+
+void Maxon::unbindProcessImage() {
+  std::lock_guard<std::recursive_mutex> lock(mutex_);
+  processImageRxPdo_ = nullptr;
+  processImageTxPdo_ = nullptr;
+  processImageRxPdoSize_ = 0;
+  processImageTxPdoSize_ = 0;
+}
+
+bool Maxon::setTelemetryRecorder(
+    const TelemetryRecorder::SharedPtr& recorder) {
+  std::lock_guard<std::recursive_mutex> lock(mutex_);
+  if (recorder != nullptr && !recorder->addDrive(getTelemetryDriveInfo())) {
+    return false;
+  }
+  telemetryRecorder_ = recorder;
+  telemetryRecord_ = TelemetryRecord();
+  telemetryRecord_.address_ = address_;
+  return true;
+}
+
+bool Maxon::setSharedMemoryExport(
+    const SharedMemoryExport::SharedPtr& sharedMemoryExport) {
+  std::lock_guard<std::recursive_mutex> lock(mutex_);
+  int index = -1;
+  if (sharedMemoryExport != nullptr) {
+    SharedMemoryDriveInfo driveInfo;
+    driveInfo.address_ = address_;
+    std::strncpy(driveInfo.name_, name_.c_str(), sizeof(driveInfo.name_) - 1);
+    driveInfo.conversionFactors_ = conversionFactors_;
+    index = sharedMemoryExport->addDrive(driveInfo);
+    if (index < 0) {
+      return false;
     }
-    case RxPdoTypeEnum::RxPdoPVM: {
-      MELO_INFO_STREAM("[maxon_epos_ethercat_sdk:Maxon::mapPdos] Rx Pdo: "
-                       << "Profile Velocity Mode");
-
-      // Disable PDO
-      rxSuccess &= sdoVerifyWrite(OD_INDEX_RX_PDO_ASSIGNMENT, 0x00, false,
-                                  static_cast<uint8_t>(0),
-                                  configuration_.configRunSdoVerifyTimeout);
-
-      rxSuccess &= sdoVerifyWrite(OD_INDEX_RX_PDO_MAPPING_3, 0x00, false,
-                                  static_cast<uint8_t>(0),
-                                  configuration_.configRunSdoVerifyTimeout);
-
-      // Write mapping
-      rxSuccess &= sdoVerifyWrite(OD_INDEX_RX_PDO_ASSIGNMENT, 0x01, false,
-                                  OD_INDEX_RX_PDO_MAPPING_3,
-                                  configuration_.configRunSdoVerifyTimeout);
-
-      // Write objects...
-      std::array<uint32_t, 5> objects{
-          (OD_INDEX_CONTROLWORD << 16) | (0x00 << 8) | sizeof(int16_t) * 8,
-          (OD_INDEX_TARGET_VELOCITY << 16) | (0x00 << 8) | sizeof(int32_t) * 8,
-          (OD_INDEX_PROFILE_ACCELERATION << 16) | (0x00 << 8) |
-              sizeof(uint32_t) * 8,
-          (OD_INDEX_PROFILE_DECELERATION << 16) | (0x00 << 8) |
-              sizeof(uint32_t) * 8,
-          (OD_INDEX_MOTION_PROFILE_TYPE << 16) | (0x00 << 8) |
-              sizeof(int16_t) * 8,
-      };
-
-      subIndex = 0;
-      for (const auto& objectIndex : objects) {
-        subIndex += 1;
-        rxSuccess &= sdoVerifyWrite(OD_INDEX_RX_PDO_MAPPING_3, subIndex, false,
-                                    objectIndex,
-                                    configuration_.configRunSdoVerifyTimeout);
-      }
-
-      // Write number of objects
-      rxSuccess &=
-          sdoVerifyWrite(OD_INDEX_RX_PDO_MAPPING_3, 0x00, false, subIndex,
-                         configuration_.configRunSdoVerifyTimeout);
-
-      // Enable PDO
-      rxSuccess &= sdoVerifyWrite(OD_INDEX_RX_PDO_ASSIGNMENT, 0x00, false,
-                                  static_cast<uint8_t>(1),
-                                  configuration_.configRunSdoVerifyTimeout);
+  }
+  sharedMemoryExport_ = sharedMemoryExport;
+  sharedMemoryIndex_ = index;
+  return true;
+}
+
+void Maxon::setRtAudit(const RtAudit::SharedPtr& audit) {
+  std::lock_guard<std::recursive_mutex> lock(mutex_);
+  rtAudit_ = audit;
+}
+
+TelemetryDriveInfo Maxon::getTelemetryDriveInfo() const {
+  TelemetryDriveInfo driveInfo;
+  driveInfo.address_ = address_;
+  std::strncpy(driveInfo.name_, name_.c_str(), sizeof(driveInfo.name_) - 1);
+  driveInfo.conversionFactors_ = conversionFactors_;
+  driveInfo.rxPdoMappingSize_ = static_cast<uint32_t>(rxPdoMapping_.size());
+  driveInfo.txPdoMappingSize_ = static_cast<uint32_t>(txPdoMapping_.size());
+  std::copy(rxPdoMapping_.begin(), rxPdoMapping_.end(),
+            driveInfo.rxPdoMapping_);
+  std::copy(txPdoMapping_.begin(), txPdoMapping_.end(),
+            driveInfo.txPdoMapping_);
+  return driveInfo;
+}
 
+bool Maxon::checkPdoSizes() {
+  const auto pdoSizes =
+      bus_->getHardwarePdoSizes(static_cast<uint16_t>(address_));
+  // the sizes are only known once the bus has mapped the process image
+  if (pdoSizes.first == 0 && pdoSizes.second == 0) {
+    return true;
+  }
+  if (pdoSizes.first != rxPdoSize_ || pdoSizes.second != txPdoSize_) {
+    MELO_ERROR_STREAM(
+        "[maxon_epos_ethercat_sdk:Maxon::checkPdoSizes] PDO sizes of '"
+        << name_ << "' do not match (Rx: " << pdoSizes.first << " / "
+        << rxPdoSize_ << " bytes, Tx: " << pdoSizes.second << " / "
+        << txPdoSize_ << " bytes)");
+    addErrorToReading(ErrorType::PdoMappingError);
+    return false;
+  }
+  return true;
+}
+
+/*!
+ * This is the only place where the PDO types are dispatched. A new PDO type
+ * only needs a descriptor in RxPdo.hpp / TxPdo.hpp and a case here.
+ */
+bool Maxon::bindPdoTypes(RxPdoTypeEnum rxPdoTypeEnum,
+                         TxPdoTypeEnum txPdoTypeEnum) {
+  bool success = true;
+  switch (rxPdoTypeEnum) {
+    case RxPdoTypeEnum::RxPdoStandard:
+      bindRxPdo<RxPdoStandard>();
       break;
-    }
-    case RxPdoTypeEnum::NA:
-      MELO_ERROR_STREAM(
-          "[maxon_epos_ethercat_sdk:Maxon::mapPdos] Cannot map "
-          "RxPdoTypeEnum::NA, PdoType not configured properly");
-      addErrorToReading(ErrorType::PdoMappingError);
-      rxSuccess = false;
+    case RxPdoTypeEnum::RxPdoCSP:
+      bindRxPdo<RxPdoCSP>();
+      break;
+    case RxPdoTypeEnum::RxPdoCST:
+      bindRxPdo<RxPdoCST>();
+      break;
+    case RxPdoTypeEnum::RxPdoCSV:
+      bindRxPdo<RxPdoCSV>();
+      break;
+    case RxPdoTypeEnum::RxPdoCSTCSP:
+      bindRxPdo<RxPdoCSTCSP>();
+      break;
+    case RxPdoTypeEnum::RxPdoCSTCSPCSV:
+      bindRxPdo<RxPdoCSTCSPCSV>();
       break;
-    default:  // Non-implemented type
-      MELO_ERROR_STREAM(
-          "[maxon_epos_ethercat_sdk:Maxon::mapPdos] Cannot map unimplemented "
-          "RxPdo, PdoType not configured properly");
-      addErrorToReading(ErrorType::PdoMappingError);
-      rxSuccess = false;
+    case RxPdoTypeEnum::RxPdoPVM:
+      bindRxPdo<RxPdoPVM>();
+      break;
+    case RxPdoTypeEnum::RxPdoCustom:
+      success &=
+          bindCustomRxPdo(std::make_index_sequence<maxCustomPdoSize>());
+      break;
+    default:  // NA or non-implemented type
+      writeRxPdoFunction_ = nullptr;
+      mapRxPdoFunction_ = nullptr;
+      rxPdoSize_ = 0;
+      rxPdoMapping_.clear();
+      success = false;
       break;
   }
 
-  bool txSuccess = true;
   switch (txPdoTypeEnum) {
-    case TxPdoTypeEnum::TxPdoStandard: {
-      MELO_INFO_STREAM("[maxon_epos_ethercat_sdk:Maxon::mapPdos] Tx Pdo: "
-                       << "Standard Mode");
-
-      // Disable PDO
-      txSuccess &= sdoVerifyWrite(OD_INDEX_TX_PDO_ASSIGNMENT, 0x00, false,
-                                  static_cast<uint8_t>(0),
-                                  configuration_.configRunSdoVerifyTimeout);
-
-      // Write mapping
-      txSuccess &= sdoVerifyWrite(OD_INDEX_TX_PDO_ASSIGNMENT, 0x01, false,
-                                  OD_INDEX_TX_PDO_MAPPING_3,
-                                  configuration_.configRunSdoVerifyTimeout);
-
-      // Write number of objects
-      txSuccess &= sdoVerifyWrite(OD_INDEX_TX_PDO_MAPPING_3, 0x00, false,
-                                  static_cast<uint8_t>(0),
-                                  configuration_.configRunSdoVerifyTimeout);
-
-      // Enable PDO
-      txSuccess &= sdoVerifyWrite(OD_INDEX_TX_PDO_ASSIGNMENT, 0x00, false,
-                                  static_cast<uint8_t>(1),
-                                  configuration_.configRunSdoVerifyTimeout);
-
+    case TxPdoTypeEnum::TxPdoStandard:
+      bindTxPdo<TxPdoStandard>();
       break;
-    }
-    case TxPdoTypeEnum::TxPdoCSP: {
-      MELO_INFO_STREAM("[maxon_epos_ethercat_sdk:Maxon::mapPdos] Tx Pdo: "
-                       << "Cyclic Synchronous Position Mode");
-
-      // Disable PDO
-      txSuccess &= sdoVerifyWrite(OD_INDEX_TX_PDO_ASSIGNMENT, 0x00, false,
-                                  static_cast<uint8_t>(0),
-                                  configuration_.configRunSdoVerifyTimeout);
-
-      txSuccess &= sdoVerifyWrite(OD_INDEX_TX_PDO_MAPPING_3, 0x00, false,
-                                  static_cast<uint8_t>(0),
-                                  configuration_.configRunSdoVerifyTimeout);
-
-      // Write mapping
-      txSuccess &= sdoVerifyWrite(OD_INDEX_TX_PDO_ASSIGNMENT, 0x01, false,
-                                  OD_INDEX_TX_PDO_MAPPING_3,
-                                  configuration_.configRunSdoVerifyTimeout);
-
-      // Write objects...
-      std::array<uint32_t, 4> objects{
-          (OD_INDEX_STATUSWORD << 16) | (0x00 << 8) | sizeof(uint16_t) * 8,
-          (OD_INDEX_TORQUE_ACTUAL << 16) | (0x00 << 8) | sizeof(int16_t) * 8,
-          (OD_INDEX_VELOCITY_ACTUAL << 16) | (0x00 << 8) | sizeof(int32_t) * 8,
-          (OD_INDEX_POSITION_ACTUAL << 16) | (0x00 << 8) | sizeof(int32_t) * 8,
-      };
-
-      subIndex = 0;
-      for (const auto& objectIndex : objects) {
-        subIndex += 1;
-        txSuccess &= sdoVerifyWrite(OD_INDEX_TX_PDO_MAPPING_3, subIndex, false,
-                                    objectIndex,
-                                    configuration_.configRunSdoVerifyTimeout);
-      }
-
-      // Write number of objects
-      txSuccess &=
-          sdoVerifyWrite(OD_INDEX_TX_PDO_MAPPING_3, 0x00, false, subIndex,
-                         configuration_.configRunSdoVerifyTimeout);
-
-      // Enable PDO
-      txSuccess &= sdoVerifyWrite(OD_INDEX_TX_PDO_ASSIGNMENT, 0x00, false,
-                                  static_cast<uint8_t>(1),
-                                  configuration_.configRunSdoVerifyTimeout);
-
+    case TxPdoTypeEnum::TxPdoCSP:
+      bindTxPdo<TxPdoCSP>();
       break;
-    }
-    case TxPdoTypeEnum::TxPdoCST: {
-      MELO_INFO_STREAM("[maxon_epos_ethercat_sdk:Maxon::mapPdos] Tx Pdo: "
-                       << "Cyclic Synchronous Torque Mode");
-
-      // Disable PDO
-      txSuccess &= sdoVerifyWrite(OD_INDEX_TX_PDO_ASSIGNMENT, 0x00, false,
-                                  static_cast<uint8_t>(0),
-                                  configuration_.configRunSdoVerifyTimeout);
-
-      txSuccess &= sdoVerifyWrite(OD_INDEX_TX_PDO_MAPPING_3, 0x00, false,
-                                  static_cast<uint8_t>(0),
-                                  configuration_.configRunSdoVerifyTimeout);
-
-      // Write mapping
-      txSuccess &= sdoVerifyWrite(OD_INDEX_TX_PDO_ASSIGNMENT, 0x01, false,
-                                  OD_INDEX_TX_PDO_MAPPING_3,
-                                  configuration_.configRunSdoVerifyTimeout);
-
-      // Write objects...
-      std::array<uint32_t, 4> objects{
-          (OD_INDEX_STATUSWORD << 16) | (0x00 << 8) | sizeof(uint16_t) * 8,
-          (OD_INDEX_TORQUE_ACTUAL << 16) | (0x00 << 8) | sizeof(int16_t) * 8,
-          (OD_INDEX_VELOCITY_ACTUAL << 16) | (0x00 << 8) | sizeof(int32_t) * 8,
-          (OD_INDEX_POSITION_ACTUAL << 16) | (0x00 << 8) | sizeof(int32_t) * 8,
-      };
-
-      subIndex = 0;
-      for (const auto& objectIndex : objects) {
-        subIndex += 1;
-        txSuccess &= sdoVerifyWrite(OD_INDEX_TX_PDO_MAPPING_3, subIndex, false,
-                                    objectIndex,
-                                    configuration_.configRunSdoVerifyTimeout);
-      }
-
-      // Write number of objects
-      txSuccess &=
-          sdoVerifyWrite(OD_INDEX_TX_PDO_MAPPING_3, 0x00, false, subIndex,
-                         configuration_.configRunSdoVerifyTimeout);
-
-      // Enable PDO
-      txSuccess &= sdoVerifyWrite(OD_INDEX_TX_PDO_ASSIGNMENT, 0x00, false,
-                                  static_cast<uint8_t>(1),
-                                  configuration_.configRunSdoVerifyTimeout);
-
+    case TxPdoTypeEnum::TxPdoCST:
+      bindTxPdo<TxPdoCST>();
       break;
-    }
-    case TxPdoTypeEnum::TxPdoCSV: {
-      MELO_INFO_STREAM("[maxon_epos_ethercat_sdk:Maxon::mapPdos] Tx Pdo: "
-                       << "Cyclic Synchronous Velocity Mode");
-
-      // Disable PDO
-      txSuccess &= sdoVerifyWrite(OD_INDEX_TX_PDO_ASSIGNMENT, 0x00, false,
-                                  static_cast<uint8_t>(0),
-                                  configuration_.configRunSdoVerifyTimeout);
-
-      txSuccess &= sdoVerifyWrite(OD_INDEX_TX_PDO_MAPPING_3, 0x00, false,
-                                  static_cast<uint8_t>(0),
-                                  configuration_.configRunSdoVerifyTimeout);
-
-      // Write mapping
-      txSuccess &= sdoVerifyWrite(OD_INDEX_TX_PDO_ASSIGNMENT, 0x01, false,
-                                  OD_INDEX_TX_PDO_MAPPING_3,
-                                  configuration_.configRunSdoVerifyTimeout);
-
-      // Write objects...
-      std::array<uint32_t, 4> objects{
-          (OD_INDEX_STATUSWORD << 16) | (0x00 << 8) | sizeof(uint16_t) * 8,
-          (OD_INDEX_TORQUE_ACTUAL << 16) | (0x00 << 8) | sizeof(int16_t) * 8,
-          (OD_INDEX_VELOCITY_ACTUAL << 16) | (0x00 << 8) | sizeof(int32_t) * 8,
-          (OD_INDEX_POSITION_ACTUAL << 16) | (0x00 << 8) | sizeof(int32_t) * 8,
-      };
-
-      subIndex = 0;
-      for (const auto& objectIndex : objects) {
-        subIndex += 1;
-        txSuccess &= sdoVerifyWrite(OD_INDEX_TX_PDO_MAPPING_3, subIndex, false,
-                                    objectIndex,
-                                    configuration_.configRunSdoVerifyTimeout);
-      }
-
-      // Write number of objects
-      txSuccess &=
-          sdoVerifyWrite(OD_INDEX_TX_PDO_MAPPING_3, 0x00, false, subIndex,
-                         configuration_.configRunSdoVerifyTimeout);
-
-      // Enable PDO
-      txSuccess &= sdoVerifyWrite(OD_INDEX_TX_PDO_ASSIGNMENT, 0x00, false,
-                                  static_cast<uint8_t>(1),
-                                  configuration_.configRunSdoVerifyTimeout);
-
+    case TxPdoTypeEnum::TxPdoCSV:
+      bindTxPdo<TxPdoCSV>();
       break;
-    }
-    case TxPdoTypeEnum::TxPdoCSTCSP: {
-      MELO_INFO_STREAM("[maxon_epos_ethercat_sdk:Maxon::mapPdos] Tx Pdo: "
-                       << "Cyclic Synchronous Torque/Position Mixed Mode");
-
-      // Disable PDO
-      txSuccess &= sdoVerifyWrite(OD_INDEX_TX_PDO_ASSIGNMENT, 0x00, false,
-                                  static_cast<uint8_t>(0),
-                                  configuration_.configRunSdoVerifyTimeout);
-
-      txSuccess &= sdoVerifyWrite(OD_INDEX_TX_PDO_MAPPING_3, 0x00, false,
-                                  static_cast<uint8_t>(0),
-                                  configuration_.configRunSdoVerifyTimeout);
-
-      // Write mapping
-      txSuccess &= sdoVerifyWrite(OD_INDEX_TX_PDO_ASSIGNMENT, 0x01, false,
-                                  OD_INDEX_TX_PDO_MAPPING_3,
-                                  configuration_.configRunSdoVerifyTimeout);
-
-      // Write objects...
-      std::array<uint32_t, 4> objects{
-          (OD_INDEX_STATUSWORD << 16) | (0x00 << 8) | sizeof(uint16_t) * 8,
-          (OD_INDEX_TORQUE_ACTUAL << 16) | (0x00 << 8) | sizeof(int16_t) * 8,
-          (OD_INDEX_VELOCITY_ACTUAL << 16) | (0x00 << 8) | sizeof(int32_t) * 8,
-          (OD_INDEX_POSITION_ACTUAL << 16) | (0x00 << 8) | sizeof(int32_t) * 8,
-      };
-
-      subIndex = 0;
-      for (const auto& objectIndex : objects) {
-        subIndex += 1;
-        txSuccess &= sdoVerifyWrite(OD_INDEX_TX_PDO_MAPPING_3, subIndex, false,
-                                    objectIndex,
-                                    configuration_.configRunSdoVerifyTimeout);
-      }
-
-      // Write number of objects
-      txSuccess &=
-          sdoVerifyWrite(OD_INDEX_TX_PDO_MAPPING_3, 0x00, false, subIndex,
-                         configuration_.configRunSdoVerifyTimeout);
-
-      // Enable PDO
-      txSuccess &= sdoVerifyWrite(OD_INDEX_TX_PDO_ASSIGNMENT, 0x00, false,
-                                  static_cast<uint8_t>(1),
-                                  configuration_.configRunSdoVerifyTimeout);
-
+    case TxPdoTypeEnum::TxPdoCSTCSP:
+      bindTxPdo<TxPdoCSTCSP>();
       break;
-    }
-    case TxPdoTypeEnum::TxPdoCSTCSPCSV: {
-      MELO_INFO_STREAM(
-          "[maxon_epos_ethercat_sdk:Maxon::mapPdos] Tx Pdo: "
-          << "Cyclic Synchronous Torque/Position/Velocity Mixed Mode");
-
-      // Disable PDO
-      txSuccess &= sdoVerifyWrite(OD_INDEX_TX_PDO_ASSIGNMENT, 0x00, false,
-                                  static_cast<uint8_t>(0),
-                                  configuration_.configRunSdoVerifyTimeout);
-
-      txSuccess &= sdoVerifyWrite(OD_INDEX_TX_PDO_MAPPING_3, 0x00, false,
-                                  static_cast<uint8_t>(0),
-                                  configuration_.configRunSdoVerifyTimeout);
-
-      // Write mapping
-      txSuccess &= sdoVerifyWrite(OD_INDEX_TX_PDO_ASSIGNMENT, 0x01, false,
-                                  OD_INDEX_TX_PDO_MAPPING_3,
-                                  configuration_.configRunSdoVerifyTimeout);
-
-      // Write objects...
-      std::array<uint32_t, 4> objects{
-          (OD_INDEX_STATUSWORD << 16) | (0x00 << 8) | sizeof(uint16_t) * 8,
-          (OD_INDEX_TORQUE_ACTUAL << 16) | (0x00 << 8) | sizeof(int16_t) * 8,
-          (OD_INDEX_VELOCITY_ACTUAL << 16) | (0x00 << 8) | sizeof(int32_t) * 8,
-          (OD_INDEX_POSITION_ACTUAL << 16) | (0x00 << 8) | sizeof(int32_t) * 8,
-      };
-
-      subIndex = 0;
-      for (const auto& objectIndex : objects) {
-        subIndex += 1;
-        txSuccess &= sdoVerifyWrite(OD_INDEX_TX_PDO_MAPPING_3, subIndex, false,
-                                    objectIndex,
-                                    configuration_.configRunSdoVerifyTimeout);
-      }
-
-      // Write number of objects
-      txSuccess &=
-          sdoVerifyWrite(OD_INDEX_TX_PDO_MAPPING_3, 0x00, false, subIndex,
-                         configuration_.configRunSdoVerifyTimeout);
-
-      // Enable PDO
-      txSuccess &= sdoVerifyWrite(OD_INDEX_TX_PDO_ASSIGNMENT, 0x00, false,
-                                  static_cast<uint8_t>(1),
-                                  configuration_.configRunSdoVerifyTimeout);
-
+    case TxPdoTypeEnum::TxPdoCSTCSPCSV:
+      bindTxPdo<TxPdoCSTCSPCSV>();
       break;
-    }
-    case TxPdoTypeEnum::TxPdoPVM: {
-      // (OD_INDEX_TORQUE_ACTUAL << 16) | (0x01 << 8) | sizeof(int16_t) * 8
-
-      MELO_INFO_STREAM("[maxon_epos_ethercat_sdk:Maxon::mapPdos] Tx Pdo: "
-                       << "Profile Velocity Mode");
-
-      // Disable PDO
-      txSuccess &= sdoVerifyWrite(OD_INDEX_TX_PDO_ASSIGNMENT, 0x00, false,
-                                  static_cast<uint8_t>(0),
-                                  configuration_.configRunSdoVerifyTimeout);
-
-      txSuccess &= sdoVerifyWrite(OD_INDEX_TX_PDO_MAPPING_3, 0x00, false,
-                                  static_cast<uint8_t>(0),
-                                  configuration_.configRunSdoVerifyTimeout);
-
-      // Write mapping
-      txSuccess &= sdoVerifyWrite(OD_INDEX_TX_PDO_ASSIGNMENT, 0x01, false,
-                                  OD_INDEX_TX_PDO_MAPPING_3,
-                                  configuration_.configRunSdoVerifyTimeout);
-
-      // Write objects...
-      std::array<uint32_t, 2> objects{
-          (OD_INDEX_STATUSWORD << 16) | (0x00 << 8) | sizeof(uint16_t) * 8,
-          (OD_INDEX_VELOCITY_DEMAND << 16) | (0x00 << 8) | sizeof(int32_t) * 8,
-      };
-
-      subIndex = 0;
-      for (const auto& objectIndex : objects) {
-        subIndex += 1;
-        txSuccess &= sdoVerifyWrite(OD_INDEX_TX_PDO_MAPPING_3, subIndex, false,
-                                    objectIndex,
-                                    configuration_.configRunSdoVerifyTimeout);
-      }
-
-      // Write number of objects
-      txSuccess &=
-          sdoVerifyWrite(OD_INDEX_TX_PDO_MAPPING_3, 0x00, false, subIndex,
-                         configuration_.configRunSdoVerifyTimeout);
-
-      // Enable PDO
-      txSuccess &= sdoVerifyWrite(OD_INDEX_TX_PDO_ASSIGNMENT, 0x00, false,
-                                  static_cast<uint8_t>(1),
-                                  configuration_.configRunSdoVerifyTimeout);
-
+    case TxPdoTypeEnum::TxPdoPVM:
+      bindTxPdo<TxPdoPVM>();
       break;
-    }
-    case TxPdoTypeEnum::NA:
-      MELO_ERROR_STREAM(
-          "[maxon_epos_ethercat_sdk:Maxon::mapPdos] Cannot map "
-          "TxPdoTypeEnum::NA, PdoType not configured properly");
-      addErrorToReading(ErrorType::TxPdoMappingError);
-      txSuccess = false;
+    case TxPdoTypeEnum::TxPdoCustom:
+      success &=
+          bindCustomTxPdo(std::make_index_sequence<maxCustomPdoSize>());
       break;
-    default:  // if any case was forgotten
-      MELO_ERROR_STREAM(
-          "[maxon_epos_ethercat_sdk:Maxon::mapPdos] Cannot map undefined "
-          "TxPdo, PdoType not configured properly");
-      addErrorToReading(ErrorType::TxPdoMappingError);
-      txSuccess = false;
+    default:  // NA or non-implemented type
+      readTxPdoFunction_ = nullptr;
+      mapTxPdoFunction_ = nullptr;
+      txPdoSize_ = 0;
+      txPdoMapping_.clear();
+      success = false;
       break;
   }
+  return success;
+}
+
+bool Maxon::mapPdos() {
+  MELO_INFO_STREAM("[maxon_epos_ethercat_sdk:Maxon::mapPdos] PDO plan of '"
+                   << name_ << "': " << pdoPlan_);
+  bool rxSuccess = true;
+  if (mapRxPdoFunction_ != nullptr) {
+    rxSuccess &= (this->*mapRxPdoFunction_)();
+  } else {
+    MELO_ERROR_STREAM(
+        "[maxon_epos_ethercat_sdk:Maxon::mapPdos] Cannot map "
+        "RxPdo, PdoType not configured properly");
+    addErrorToReading(ErrorType::PdoMappingError);
+    rxSuccess = false;
+  }
+
+  bool txSuccess = true;
+  if (mapTxPdoFunction_ != nullptr) {
+    txSuccess &= (this->*mapTxPdoFunction_)();
+  } else {
+    MELO_ERROR_STREAM(
+        "[maxon_epos_ethercat_sdk:Maxon::mapPdos] Cannot map "
+        "TxPdo, PdoType not configured properly");
+    addErrorToReading(ErrorType::TxPdoMappingError);
+    txSuccess = false;
+  }
 
   return (txSuccess && rxSuccess);
 }
 
+uint64_t Maxon::getConfigurationFingerprint() const {
+  Fingerprint fingerprint;
+  fingerprint.add(configuration_.getHardwareFingerprint());
+  fingerprint.add(rxPdoTypeEnum_);
+  fingerprint.add(txPdoTypeEnum_);
+  fingerprint.add(getCycleTime());
+  for (const auto& entry : customRxPdo_.getMapping()) {
+    fingerprint.add(entry.getMappingObject());
+  }
+  for (const auto& entry : customTxPdo_.getMapping()) {
+    fingerprint.add(entry.getMappingObject());
+  }
+  return fingerprint.get();
+}
+
+std::string Maxon::getConfigurationCacheFile() {
+  if (configuration_.configurationCacheDirectory.empty()) {
+    return "";
+  }
+  uint32_t serialNumber = 0;
+  if (!sendSdoRead(OD_INDEX_IDENTITY_OBJECT, 0x04, false, serialNumber) ||
+      serialNumber == 0) {
+    MELO_WARN_STREAM(
+        "[maxon_epos_ethercat_sdk:Maxon::getConfigurationCacheFile] "
+        "Could not read the serial number of '"
+        << name_ << "', the configuration is not cached.");
+    return "";
+  }
+  std::stringstream fileName;
+  fileName << configuration_.configurationCacheDirectory << "/maxon_"
+           << std::hex << serialNumber << ".fingerprint";
+  return fileName.str();
+}
+
+bool Maxon::isConfigurationCached(uint64_t fingerprint) {
+  const std::string fileName = getConfigurationCacheFile();
+  if (fileName.empty()) {
+    return false;
+  }
+  std::ifstream file(fileName);
+  uint64_t cachedFingerprint = 0;
+  if (!(file >> std::hex >> cachedFingerprint)) {
+    return false;
+  }
+  return cachedFingerprint == fingerprint;
+}
+
+void Maxon::cacheConfiguration(uint64_t fingerprint) {
+  const std::string fileName = getConfigurationCacheFile();
+  if (fileName.empty()) {
+    return;
+  }
+  std::ofstream file(fileName, std::ios::trunc);
+  if (!(file << std::hex << fingerprint << "\n")) {
+    MELO_WARN_STREAM(
+        "[maxon_epos_ethercat_sdk:Maxon::cacheConfiguration] "
+        "Could not write '"
+        << fileName << "'");
+  }
+}
+
 bool Maxon::configParam() {
   bool configSuccess = true;
   uint32_t maxMotorSpeed;
@@ -721,101 +542,93 @@ bool Maxon::configParam() {
   uint32_t velocity_unit;
   velocity_unit = 0xFAB44700;
   configSuccess &=
-      sdoVerifyWrite(OD_INDEX_SI_UNIT_VELOCITY, 0x00, false, velocity_unit,
-                     configuration_.configRunSdoVerifyTimeout);
+      sdoWriteIfChanged(OD_INDEX_SI_UNIT_VELOCITY, 0x00, false, velocity_unit);
 
   maxMotorSpeed = static_cast<uint32_t>(configuration_.workVoltage *
                                         configuration_.speedConstant);
   configSuccess &=
-      sdoVerifyWrite(OD_INDEX_MAX_MOTOR_SPEED, 0x00, false, maxMotorSpeed,
-                     configuration_.configRunSdoVerifyTimeout);
+      sdoWriteIfChanged(OD_INDEX_MAX_MOTOR_SPEED, 0x00, false, maxMotorSpeed);
 
   maxProfileVelocity = static_cast<uint32_t>(configuration_.maxProfileVelocity *
                                              60.0 * 1e6 / (2 * M_PI));
 
-  configSuccess &= sdoVerifyWrite(OD_INDEX_MAX_PROFILE_VELOCITY, 0x00, false,
-                                  maxProfileVelocity,
-                                  configuration_.configRunSdoVerifyTimeout);
+  configSuccess &= sdoWriteIfChanged(OD_INDEX_MAX_PROFILE_VELOCITY, 0x00, false,
+                                     maxProfileVelocity);
 
   maxGearSpeed =
       static_cast<uint32_t>(maxMotorSpeed / configuration_.gearRatio);
-  configSuccess &= sdoVerifyWrite(OD_INDEX_GEAR_DATA, 0x03, false, maxGearSpeed,
-                                  configuration_.configRunSdoVerifyTimeout);
+  configSuccess &=
+      sdoWriteIfChanged(OD_INDEX_GEAR_DATA, 0x03, false, maxGearSpeed);
 
-  configSuccess &= sdoVerifyWrite(OD_INDEX_SOFTWARE_POSITION_LIMIT, 0x01, false,
-                                  configuration_.minPosition);
+  configSuccess &= sdoWriteIfChanged(OD_INDEX_SOFTWARE_POSITION_LIMIT, 0x01,
+                                     false, configuration_.minPosition);
 
-  configSuccess &= sdoVerifyWrite(OD_INDEX_SOFTWARE_POSITION_LIMIT, 0x02, false,
-                                  configuration_.maxPosition);
+  configSuccess &= sdoWriteIfChanged(OD_INDEX_SOFTWARE_POSITION_LIMIT, 0x02,
+                                     false, configuration_.maxPosition);
 
   nominalCurrent =
       static_cast<uint32_t>(round(1000.0 * configuration_.nominalCurrentA));
   configSuccess &=
-      sdoVerifyWrite(OD_INDEX_MOTOR_DATA, 0x01, false, nominalCurrent,
-                     configuration_.configRunSdoVerifyTimeout);
+      sdoWriteIfChanged(OD_INDEX_MOTOR_DATA, 0x01, false, nominalCurrent);
 
   maxCurrent =
       static_cast<uint32_t>(round(1000.0 * configuration_.maxCurrentA));
-  configSuccess &= sdoVerifyWrite(OD_INDEX_MOTOR_DATA, 0x02, false, maxCurrent,
-                                  configuration_.configRunSdoVerifyTimeout);
+  configSuccess &=
+      sdoWriteIfChanged(OD_INDEX_MOTOR_DATA, 0x02, false, maxCurrent);
 
   torqueConstant =
       static_cast<uint32_t>(1000000.0 * configuration_.torqueConstantNmA);
   configSuccess &=
-      sdoVerifyWrite(OD_INDEX_MOTOR_DATA, 0x05, false, torqueConstant,
-                     configuration_.configRunSdoVerifyTimeout);
+      sdoWriteIfChanged(OD_INDEX_MOTOR_DATA, 0x05, false, torqueConstant);
 
   currentPGain = static_cast<uint32_t>(1000000 * configuration_.currentPGainSI);
-  configSuccess &= sdoVerifyWrite(OD_INDEX_CURRENT_CONTROL_PARAM, 0x01, false,
-                                  static_cast<uint32_t>(currentPGain),
-                                  configuration_.configRunSdoVerifyTimeout);
+  configSuccess &= sdoWriteIfChanged(OD_INDEX_CURRENT_CONTROL_PARAM, 0x01,
+                                     false,
+                                     static_cast<uint32_t>(currentPGain));
 
   currentIGain = static_cast<uint32_t>(1000 * configuration_.currentIGainSI);
-  configSuccess &= sdoVerifyWrite(OD_INDEX_CURRENT_CONTROL_PARAM, 0x02, false,
-                                  static_cast<uint32_t>(currentIGain),
-                                  configuration_.configRunSdoVerifyTimeout);
+  configSuccess &= sdoWriteIfChanged(OD_INDEX_CURRENT_CONTROL_PARAM, 0x02,
+                                     false,
+                                     static_cast<uint32_t>(currentIGain));
 
   positionPGain =
       static_cast<uint32_t>(1000000 * configuration_.positionPGainSI);
-  configSuccess &= sdoVerifyWrite(OD_INDEX_POSITION_CONTROL_PARAM, 0x01, false,
-                                  static_cast<uint32_t>(positionPGain),
-                                  configuration_.configRunSdoVerifyTimeout);
+  configSuccess &= sdoWriteIfChanged(OD_INDEX_POSITION_CONTROL_PARAM, 0x01,
+                                     false,
+                                     static_cast<uint32_t>(positionPGain));
 
   positionIGain =
       static_cast<uint32_t>(1000000 * configuration_.positionIGainSI);
-  configSuccess &= sdoVerifyWrite(OD_INDEX_POSITION_CONTROL_PARAM, 0x02, false,
-                                  static_cast<uint32_t>(positionIGain),
-                                  configuration_.configRunSdoVerifyTimeout);
+  configSuccess &= sdoWriteIfChanged(OD_INDEX_POSITION_CONTROL_PARAM, 0x02,
+                                     false,
+                                     static_cast<uint32_t>(positionIGain));
 
   positionDGain =
       static_cast<uint32_t>(1000000 * configuration_.positionDGainSI);
-  configSuccess &= sdoVerifyWrite(OD_INDEX_POSITION_CONTROL_PARAM, 0x03, false,
-                                  static_cast<uint32_t>(positionDGain),
-                                  configuration_.configRunSdoVerifyTimeout);
+  configSuccess &= sdoWriteIfChanged(OD_INDEX_POSITION_CONTROL_PARAM, 0x03,
+                                     false,
+                                     static_cast<uint32_t>(positionDGain));
 
-  configSuccess &= sdoVerifyWrite(OD_INDEX_QUICKSTOP_DECELERATION, 0x00, false,
-                                  configuration_.quickStopDecel,
-                                  configuration_.configRunSdoVerifyTimeout);
+  configSuccess &= sdoWriteIfChanged(OD_INDEX_QUICKSTOP_DECELERATION, 0x00,
+                                     false, configuration_.quickStopDecel);
 
-  configSuccess &= sdoVerifyWrite(OD_INDEX_PROFILE_DECELERATION, 0x00, false,
-                                  configuration_.profileDecel,
-                                  configuration_.configRunSdoVerifyTimeout);
+  configSuccess &= sdoWriteIfChanged(OD_INDEX_PROFILE_DECELERATION, 0x00, false,
+                                     configuration_.profileDecel);
 
-  configSuccess &= sdoVerifyWrite(OD_INDEX_FOLLOW_ERROR_WINDOW, 0x00, false,
-                                  configuration_.followErrorWindow,
-                                  configuration_.configRunSdoVerifyTimeout);
+  configSuccess &= sdoWriteIfChanged(OD_INDEX_FOLLOW_ERROR_WINDOW, 0x00, false,
+                                     configuration_.followErrorWindow);
 
   velocityPGain =
       static_cast<uint32_t>(1000000 * configuration_.velocityPGainSI);
-  configSuccess &= sdoVerifyWrite(OD_INDEX_VELOCITY_CONTROL_PARAM, 0x01, false,
-                                  static_cast<uint32_t>(velocityPGain),
-                                  configuration_.configRunSdoVerifyTimeout);
+  configSuccess &= sdoWriteIfChanged(OD_INDEX_VELOCITY_CONTROL_PARAM, 0x01,
+                                     false,
+                                     static_cast<uint32_t>(velocityPGain));
 
   velocityIGain =
       static_cast<uint32_t>(1000000 * configuration_.velocityIGainSI);
-  configSuccess &= sdoVerifyWrite(OD_INDEX_VELOCITY_CONTROL_PARAM, 0x02, false,
-                                  static_cast<uint32_t>(velocityIGain),
-                                  configuration_.configRunSdoVerifyTimeout);
+  configSuccess &= sdoWriteIfChanged(OD_INDEX_VELOCITY_CONTROL_PARAM, 0x02,
+                                     false,
+                                     static_cast<uint32_t>(velocityIGain));
 
   if (configSuccess) {
     MELO_INFO("Setting configuration parameters succeeded.");
@@ -0,0 +1,182 @@
+// clang-format off
+/*
+** Copyright 2021 Robotic Systems Lab - ETH Zurich:
+** Linghao Zhang, Jonas Junger, Lennart Nachtigall
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions are met:
+**
+** 1. Redistributions of source code must retain the above copyright notice,
+**    this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright notice,
+**    this list of conditions and the following disclaimer in the documentation
+**    and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its contributors
+**    may be used to endorse or promote products derived from this software without
+**    specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+** AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+** IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+** DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+** FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+** DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+** SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+** CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+** OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+// clang-format on
+
+#include "maxon_epos_ethercat_sdk/CustomPdo.hpp"
+
+#include <array>
+#include <cstring>
+
+#include "maxon_epos_ethercat_sdk/ObjectDictionary.hpp"
+
+#define CUSTOM_RX_PDO_VALUE(member)                          \
+  static_cast<uint16_t>(offsetof(CustomRxPdoSource, member)), \
+      static_cast<uint8_t>(sizeof(CustomRxPdoSource::member))
+
+#define CUSTOM_TX_PDO_VALUE(member)                        \
+  static_cast<uint16_t>(offsetof(ReadingSnapshot, member)), \
+      static_cast<uint8_t>(sizeof(ReadingSnapshot::member))
+
+namespace maxon {
+namespace {
+// clang-format off
+const std::array<CustomPdo::Object, 11> customRxPdoObjects{{
+    {"controlword", {OD_INDEX_CONTROLWORD, 0x00, 16}, CUSTOM_RX_PDO_VALUE(controlword_)},
+    {"mode_of_operation", {OD_INDEX_MODES_OF_OPERATION, 0x00, 8}, CUSTOM_RX_PDO_VALUE(command_.modeOfOperation_)},
+    {"target_position", {OD_INDEX_TARGET_POSITION, 0x00, 32}, CUSTOM_RX_PDO_VALUE(command_.targetPosition_)},
+    {"target_velocity", {OD_INDEX_TARGET_VELOCITY, 0x00, 32}, CUSTOM_RX_PDO_VALUE(command_.targetVelocity_)},
+    {"target_torque", {OD_INDEX_TARGET_TORQUE, 0x00, 16}, CUSTOM_RX_PDO_VALUE(command_.targetTorque_)},
+    {"position_offset", {OD_INDEX_OFFSET_POSITION, 0x00, 32}, CUSTOM_RX_PDO_VALUE(command_.positionOffset_)},
+    {"velocity_offset", {OD_INDEX_OFFSET_VELOCITY, 0x00, 32}, CUSTOM_RX_PDO_VALUE(command_.velocityOffset_)},
+    {"torque_offset", {OD_INDEX_OFFSET_TORQUE, 0x00, 16}, CUSTOM_RX_PDO_VALUE(command_.torqueOffset_)},
+    {"profile_acceleration", {OD_INDEX_PROFILE_ACCELERATION, 0x00, 32}, CUSTOM_RX_PDO_VALUE(command_.profileAccel_)},
+    {"profile_deceleration", {OD_INDEX_PROFILE_DECELERATION, 0x00, 32}, CUSTOM_RX_PDO_VALUE(command_.profileDeccel_)},
+    {"motion_profile_type", {OD_INDEX_MOTION_PROFILE_TYPE, 0x00, 16}, CUSTOM_RX_PDO_VALUE(command_.motionProfileType_)},
+}};
+
+const std::array<CustomPdo::Object, 8> customTxPdoObjects{{
+    {"statusword", {OD_INDEX_STATUSWORD, 0x00, 16}, CUSTOM_TX_PDO_VALUE(statusword_)},
+    {"position_actual", {OD_INDEX_POSITION_ACTUAL, 0x00, 32}, CUSTOM_TX_PDO_VALUE(actualPosition_)},
+    {"velocity_actual", {OD_INDEX_VELOCITY_ACTUAL, 0x00, 32}, CUSTOM_TX_PDO_VALUE(actualVelocity_)},
+    {"velocity_demand", {OD_INDEX_VELOCITY_DEMAND, 0x00, 32}, CUSTOM_TX_PDO_VALUE(demandVelocity_)},
+    {"torque_actual", {OD_INDEX_TORQUE_ACTUAL, 0x00, 16}, CUSTOM_TX_PDO_VALUE(actualCurrent_)},
+    {"digital_inputs", {OD_INDEX_DIGITAL_INPUTS, 0x00, 32}, CUSTOM_TX_PDO_VALUE(digitalInputs_)},
+    {"analog_input", {OD_INDEX_ANALOG_INPUTS, 0x01, 16}, CUSTOM_TX_PDO_VALUE(analogInput_)},
+    {"bus_voltage", {OD_INDEX_5VDC_SUPPLY, 0x01, 16}, CUSTOM_TX_PDO_VALUE(busVoltage_)},
+}};
+// clang-format on
+
+bool isSameObject(const PdoMappingEntry& a, const PdoMappingEntry& b) {
+  return a.getMappingObject() == b.getMappingObject();
+}
+
+template <std::size_t N>
+std::vector<std::string> getObjectNames(
+    const std::array<CustomPdo::Object, N>& objects) {
+  std::vector<std::string> names;
+  for (const auto& object : objects) {
+    names.emplace_back(object.name_);
+  }
+  return names;
+}
+}  // namespace
+
+bool CustomPdo::addRxObject(const std::string& name) {
+  for (const auto& object : customRxPdoObjects) {
+    if (name == object.name_) {
+      return addObject(object);
+    }
+  }
+  return false;
+}
+
+bool CustomPdo::addTxObject(const std::string& name) {
+  for (const auto& object : customTxPdoObjects) {
+    if (name == object.name_) {
+      return addObject(object);
+    }
+  }
+  return false;
+}
+
+bool CustomPdo::addRxObject(const PdoMappingEntry& entry) {
+  for (const auto& object : customRxPdoObjects) {
+    if (isSameObject(entry, object.mapping_)) {
+      return addObject(object);
+    }
+  }
+  return false;
+}
+
+bool CustomPdo::addTxObject(const PdoMappingEntry& entry) {
+  for (const auto& object : customTxPdoObjects) {
+    if (isSameObject(entry, object.mapping_)) {
+      return addObject(object);
+    }
+  }
+  return false;
+}
+
+bool CustomPdo::addObject(const Object& object) {
+  const uint8_t size = object.mapping_.bitLength_ / 8;
+  if (size_ + size > maxCustomPdoSize) {
+    return false;
+  }
+  mapping_.push_back(object.mapping_);
+  bindings_.push_back({static_cast<uint16_t>(size_), object.valueOffset_, size,
+                       object.valueSize_});
+  size_ += size;
+  return true;
+}
+
+void CustomPdo::clear() {
+  mapping_.clear();
+  bindings_.clear();
+  size_ = 0;
+}
+
+void CustomPdo::encode(const CustomRxPdoSource& source, uint8_t* data) const {
+  const uint8_t* values = reinterpret_cast<const uint8_t*>(&source);
+  for (const auto& binding : bindings_) {
+    std::memcpy(data + binding.pdoOffset_, values + binding.valueOffset_,
+                binding.size_);
+  }
+}
+
+void CustomPdo::decode(const uint8_t* data, ReadingSnapshot& snapshot) const {
+  decodeValues(data, reinterpret_cast<uint8_t*>(&snapshot));
+}
+
+void CustomPdo::decode(const uint8_t* data, CustomRxPdoSource& source) const {
+  decodeValues(data, reinterpret_cast<uint8_t*>(&source));
+}
+
+void CustomPdo::decodeValues(const uint8_t* data, uint8_t* values) const {
+  for (const auto& binding : bindings_) {
+    // objects which are narrower than their member are zero extended (the
+    // process data is little endian, as the supported targets)
+    if (binding.valueSize_ > binding.size_) {
+      std::memset(values + binding.valueOffset_, 0, binding.valueSize_);
+    }
+    std::memcpy(values + binding.valueOffset_, data + binding.pdoOffset_,
+                binding.size_);
+  }
+}
+
+std::vector<std::string> CustomPdo::getRxObjectNames() {
+  return getObjectNames(customRxPdoObjects);
+}
+
+std::vector<std::string> CustomPdo::getTxObjectNames() {
+  return getObjectNames(customTxPdoObjects);
+}
+
+}  // namespace maxon
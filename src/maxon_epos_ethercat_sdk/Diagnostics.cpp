@@ -36,8 +36,59 @@
 namespace maxon {
 // Print errors
 void Maxon::addErrorToReading(const ErrorType& errorType) {
-  std::lock_guard<std::recursive_mutex> lock(mutex_);
-  reading_.addError(errorType);
+  RtAuditSite site("Maxon::addErrorToReading");
+  PendingDiagnosis diagnosis;
+  diagnosis.errorType_ = errorType;
+  diagnosis.timePoint_ = ReadingClock::now();
+  pendingDiagnoses_.tryPush(diagnosis);
+
+  ReadingEvent event;
+  event.type_ = ReadingEventType::Error;
+  event.address_ = address_;
+  event.value_ = static_cast<int64_t>(errorType);
+  event.timePoint_ = diagnosis.timePoint_;
+  publishReadingEvent(event);
+}
+
+void Maxon::addFaultToReading(uint16_t errorCode) {
+  RtAuditSite site("Maxon::addFaultToReading");
+  PendingDiagnosis diagnosis;
+  diagnosis.isFault_ = true;
+  diagnosis.faultCode_ = errorCode;
+  diagnosis.timePoint_ = ReadingClock::now();
+  pendingDiagnoses_.tryPush(diagnosis);
+
+  ReadingEvent event;
+  event.type_ = ReadingEventType::Fault;
+  event.address_ = address_;
+  event.value_ = errorCode;
+  event.timePoint_ = diagnosis.timePoint_;
+  publishReadingEvent(event);
+}
+
+void Maxon::drainPendingDiagnoses() const {
+  PendingDiagnosis diagnosis;
+  while (pendingDiagnoses_.tryPop(diagnosis)) {
+    if (diagnosis.isFault_) {
+      reading_.addFault(diagnosis.faultCode_, diagnosis.timePoint_);
+    } else {
+      reading_.addError(diagnosis.errorType_, diagnosis.timePoint_);
+    }
+  }
+}
+
+void Maxon::captureFault() {
+  uint16_t errorCode = 0;
+  if (sendSdoRead(OD_INDEX_ERROR_CODE, 0x00, false, errorCode)) {
+    addFaultToReading(errorCode);
+    MELO_ERROR_STREAM("[maxon_epos_ethercat_sdk:Maxon::captureFault] "
+                      << name_ << ": Error code: " << std::hex << errorCode);
+  } else {
+    MELO_ERROR_STREAM("[maxon_epos_ethercat_sdk:Maxon::captureFault] "
+                      << name_ << ": read error code unsuccessful.");
+  }
+  printErrorHistory();
+  printDiagnosis();
 }
 
 /*
@@ -58,6 +109,36 @@ void Maxon::printErrorCode() {
   }
 }
 
+/*
+ * Print error history, the newest entry first
+ * The lower 16 bits of an entry hold the error code
+ */
+void Maxon::printErrorHistory() {
+  uint8_t numberOfErrors = 0;
+  if (!sendSdoRead(OD_INDEX_ERROR_HISTORY, 0x00, false, numberOfErrors)) {
+    MELO_ERROR_STREAM(
+        "[maxon_epos_ethercat_sdk:Maxon::printErrorHistory] read error "
+        "history unsuccessful.");
+    return;
+  }
+  for (uint8_t i = 1; i <= numberOfErrors; i++) {
+    uint32_t entry = 0;
+    if (sendSdoRead(OD_INDEX_ERROR_HISTORY, i, false, entry)) {
+      MELO_INFO_STREAM("[maxon_epos_ethercat_sdk:Maxon::printErrorHistory] "
+                       << "Error " << static_cast<int>(i) << ": " << std::hex
+                       << (entry & 0xFFFF));
+    }
+  }
+}
+
+std::future<void> Maxon::printErrorCodeAsync() {
+  return submitSdoRequest([this]() { printErrorCode(); });
+}
+
+std::future<void> Maxon::printDiagnosisAsync() {
+  return submitSdoRequest([this]() { printDiagnosis(); });
+}
+
 /*
  * Print diagnosis messages
  */
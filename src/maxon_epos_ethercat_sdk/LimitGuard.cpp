@@ -0,0 +1,73 @@
+// clang-format off
+/*
+** Copyright 2021 Robotic Systems Lab - ETH Zurich:
+** Linghao Zhang, Jonas Junger, Lennart Nachtigall
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions are met:
+**
+** 1. Redistributions of source code must retain the above copyright notice,
+**    this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright notice,
+**    this list of conditions and the following disclaimer in the documentation
+**    and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its contributors
+**    may be used to endorse or promote products derived from this software without
+**    specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+** AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+** IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+** DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+** FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+** DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+** SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+** CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+** OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+// clang-format on
+
+#include "maxon_epos_ethercat_sdk/LimitGuard.hpp"
+
+#include <cmath>
+
+namespace maxon {
+std::string getLimitQuantityString(LimitQuantity quantity) {
+  switch (quantity) {
+    case LimitQuantity::Position:
+      return "position";
+    case LimitQuantity::Velocity:
+      return "velocity";
+    case LimitQuantity::Current:
+      return "current";
+    default:
+      return "NA";
+  }
+}
+
+void LimitGuard::configure(const Configuration& configuration,
+                           const ConversionFactors& conversionFactors) {
+  *this = LimitGuard();
+  if (!configuration.useLimitGuard) {
+    return;
+  }
+  enabled_ = true;
+  const double factor = 1.0 + configuration.limitGuardMargin;
+
+  checkPosition_ = configuration.minPosition < configuration.maxPosition;
+  minPosition_ = configuration.minPosition;
+  maxPosition_ = configuration.maxPosition;
+  // max_profile_velocity is given in rad/s, the reading in micro rpm
+  maxVelocity_ = std::llround(
+      factor * configuration.maxProfileVelocity *
+      ConversionFactors::velocityFactorRadPerSecToMicroRPM_);
+  // the current factor is not finite without a nominal current
+  const double maxCurrent = factor * configuration.maxCurrentA *
+                            conversionFactors.currentFactorAToInteger_;
+  maxCurrent_ = std::isfinite(maxCurrent) ? std::llround(maxCurrent) : 0;
+}
+
+}  // namespace maxon
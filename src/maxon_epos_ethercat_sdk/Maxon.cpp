@@ -40,10 +40,16 @@
 
 #include "maxon_epos_ethercat_sdk/ConfigurationParser.hpp"
 #include "maxon_epos_ethercat_sdk/ObjectDictionary.hpp"
-#include "maxon_epos_ethercat_sdk/RxPdo.hpp"
-#include "maxon_epos_ethercat_sdk/TxPdo.hpp"
+#include "maxon_epos_ethercat_sdk/SaturatingCast.hpp"
 
 namespace maxon {
+namespace {
+uint64_t toNanoseconds(ReadingClock::duration duration) {
+  return static_cast<uint64_t>(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count());
+}
+}  // namespace
+
 std::string binstring(uint16_t var) {
   std::string s = "0000000000000000";
   for (int i = 0; i < 16; i++) {
@@ -67,7 +73,9 @@ Maxon::SharedPtr Maxon::deviceFromFile(const std::string& configFile,
                                        const std::string& name,
                                        const uint32_t address) {
   auto maxon = std::make_shared<Maxon>(name, address);
-  maxon->loadConfigFile(configFile);
+  // drives sharing a file share the parsed configuration
+  maxon->loadConfiguration(
+      ConfigurationRegistry::getInstance().getConfiguration(configFile));
   return maxon;
 }
 
@@ -76,12 +84,134 @@ Maxon::Maxon(const std::string& name, const uint32_t address) {
   name_ = name;
 }
 
+Maxon::~Maxon() {
+  // the SDO worker may still hold requests which access this drive
+  if (sdoWorker_ != nullptr) {
+    sdoWorker_->removeDevice(this);
+  }
+}
+
 bool Maxon::startup() {
+  // the result of a parallel startup, which already covered this drive
+  if (startupCompleted_) {
+    startupCompleted_ = false;
+    return startupSuccessful_;
+  }
+
+  // the first drive of a startup group, which is started by the bus, starts
+  // all of them
+  std::shared_ptr<StartupGroup> startupGroup = startupGroup_;
+  if (startupGroup != nullptr) {
+    std::vector<SharedPtr> drives;
+    bool containsThis = false;
+    for (const auto& weakDrive : startupGroup->drives_) {
+      SharedPtr drive = weakDrive.lock();
+      if (drive != nullptr && !drive->startupCompleted_) {
+        containsThis |= drive.get() == this;
+        drives.push_back(drive);
+      }
+    }
+    if (containsThis) {
+      startupDrives(drives, startupGroup->maxNumberOfThreads_);
+      startupCompleted_ = false;
+      return startupSuccessful_;
+    }
+  }
+  return runStartup();
+}
+
+bool Maxon::startupDrives(const std::vector<SharedPtr>& drives,
+                          unsigned int maxNumberOfThreads) {
+  const auto startupTimePoint = std::chrono::steady_clock::now();
+  const std::size_t numberOfThreads =
+      maxNumberOfThreads == 0
+          ? drives.size()
+          : std::min<std::size_t>(maxNumberOfThreads, drives.size());
+
+  // every thread takes the next drive which has not been started yet
+  std::atomic<std::size_t> nextDrive{0};
+  auto work = [&]() {
+    for (std::size_t i = nextDrive++; i < drives.size(); i = nextDrive++) {
+      drives[i]->startupSuccessful_ = drives[i]->runStartup();
+      drives[i]->startupCompleted_ = true;
+    }
+  };
+  std::vector<std::thread> threads;
+  threads.reserve(numberOfThreads);
+  for (std::size_t i = 1; i < numberOfThreads; i++) {
+    threads.emplace_back(work);
+  }
+  work();
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  bool success = true;
+  std::chrono::microseconds slowestStartup{0};
+  for (const auto& drive : drives) {
+    success &= drive->startupSuccessful_;
+    slowestStartup = std::max(slowestStartup, drive->startupDuration_);
+  }
+  const auto duration = std::chrono::duration_cast<std::chrono::microseconds>(
+      std::chrono::steady_clock::now() - startupTimePoint);
+  MELO_INFO_STREAM("[maxon_epos_ethercat_sdk:Maxon::startupDrives] Startup of "
+                   << drives.size() << " drives took "
+                   << duration.count() / 1000.0 << " ms (slowest drive: "
+                   << slowestStartup.count() / 1000.0 << " ms)");
+  MELO_INFO_STREAM("[maxon_epos_ethercat_sdk:Maxon::startupDrives] Bus plan: "
+                   << planBus(drives));
+  return success;
+}
+
+void Maxon::setParallelStartup(const std::vector<SharedPtr>& drives,
+                               unsigned int maxNumberOfThreads) {
+  auto startupGroup = std::make_shared<StartupGroup>();
+  startupGroup->maxNumberOfThreads_ = maxNumberOfThreads;
+  for (const auto& drive : drives) {
+    startupGroup->drives_.push_back(drive);
+  }
+  for (const auto& drive : drives) {
+    drive->startupGroup_ = drives.size() > 1 ? startupGroup : nullptr;
+  }
+}
+
+BusPlan Maxon::planBus(const std::vector<SharedPtr>& drives) {
+  std::vector<PdoPlan> plans;
+  bool distributedClock = false;
+  for (const auto& drive : drives) {
+    plans.push_back(drive->pdoPlan_);
+    distributedClock |= drive->configuration_.useDistributedClock;
+  }
+  const unsigned int cycleTime =
+      drives.empty() ? 0 : drives.front()->getCycleTime();
+  const BusPlan busPlan = maxon::planBus(plans, cycleTime, distributedClock);
+  if (busPlan.utilization_ > maxBusUtilization) {
+    MELO_WARN_STREAM(
+        "[maxon_epos_ethercat_sdk:Maxon::planBus] The process data frames "
+        "take an estimated "
+        << busPlan.frameTime_ << " us of the cycle time of " << cycleTime
+        << " us, consider minimize_pdo_mapping or a longer cycle time.");
+  }
+  return busPlan;
+}
+
+bool Maxon::runStartup() {
+  const auto startupTimePoint = std::chrono::steady_clock::now();
+  numberOfSdoWrites_ = 0;
+  numberOfSkippedSdoWrites_ = 0;
+
   bool success = true;
-  success &= bus_->waitForState(EC_STATE_PRE_OP, address_, 50, 0.05);
-  // bus_->syncDistributedClock0(address_, true, timeStep_, timeStep_ / 2.f); //
-  // Might not need
-  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  // started here such that the fault capture is ready for the cyclic update
+  getSdoWorker();
+  // polls the state, no need for an additional delay
+  success &= waitForEthercatState(EC_STATE_PRE_OP, 50, 0.05);
+
+  // SYNC0 has to be configured before the drive goes to SAFE-OP
+  const unsigned int cycleTime = getCycleTime();
+  if (configuration_.useDistributedClock) {
+    syncDistributedClock0(true, 1e-6 * cycleTime,
+                          1e-6 * configuration_.distributedClockShift);
+  }
 
   // use hardware motor rated current value if necessary
   // TODO test
@@ -92,34 +222,63 @@ bool Maxon::startup() {
     // rated current value
     configuration_.nominalCurrentA =
         static_cast<double>(nominalCurrent) / 1000.0;
-    // update the reading_ object to ensure correct unit conversion
-    reading_.configureReading(configuration_);
+    // update the factors of the commands and the reading_ object to ensure
+    // correct unit conversion
+    updateConversionFactors();
   }
   // success &= setDriveStateViaSdo(DriveState::ReadyToSwitchOn);
 
-  // PDO mapping
-  success &= mapPdos(rxPdoTypeEnum_, txPdoTypeEnum_);
+  // A drive which still holds the cached configuration only needs its PDO
+  // mapping to be checked. If the mapping had to be written (e.g. after a
+  // power cycle) the cache is stale and the drive is fully configured.
+  const uint64_t fingerprint = getConfigurationFingerprint();
+  bool configurationCached = isConfigurationCached(fingerprint);
 
-  // Set Interpolation
-  success &= sdoVerifyWrite(OD_INDEX_INTERPOLATION_TIME_PERIOD, 0x01, false,
-                            static_cast<uint8_t>(2),
-                            configuration_.configRunSdoVerifyTimeout);
+  // PDO mapping
+  const unsigned int numberOfSdoWritesBeforeMapping = numberOfSdoWrites_;
+  success &= mapPdos();
+  if (configurationCached &&
+      numberOfSdoWrites_ != numberOfSdoWritesBeforeMapping) {
+    configurationCached = false;
+  }
 
-  success &= sdoVerifyWrite(OD_INDEX_INTERPOLATION_TIME_PERIOD, 0x02, false,
-                            static_cast<int8_t>(-3),
-                            configuration_.configRunSdoVerifyTimeout);
+  if (!configurationCached) {
+    // Set Interpolation
+    uint8_t mantissa = 0;
+    int8_t exponent = 0;
+    if (getInterpolationTimePeriod(cycleTime, mantissa, exponent)) {
+      success &= sdoWriteIfChanged(OD_INDEX_INTERPOLATION_TIME_PERIOD, 0x01,
+                                   false, mantissa);
+      success &= sdoWriteIfChanged(OD_INDEX_INTERPOLATION_TIME_PERIOD, 0x02,
+                                   false, exponent);
+    } else {
+      MELO_ERROR_STREAM(
+          "[maxon_epos_ethercat_sdk:Maxon::startup] Cycle time of "
+          << cycleTime << " us cannot be set as interpolation time period.");
+      success = false;
+    }
+  }
 
   // Set initial mode of operation
-  success &=
-      sdoVerifyWrite(OD_INDEX_MODES_OF_OPERATION, 0x00, false,
-                     static_cast<int8_t>(configuration_.modesOfOperation[0]),
-                     configuration_.configRunSdoVerifyTimeout);
+  success &= sdoWriteIfChanged(
+      OD_INDEX_MODES_OF_OPERATION, 0x00, false,
+      static_cast<int8_t>(configuration_.modesOfOperation[0]));
 
   // To be on the safe side: set currect PDO sizes
   autoConfigurePdoSizes();
+  success &= checkPdoSizes();
 
-  // write the configuration parameters via Sdo
-  success &= configParam();
+  if (configurationCached) {
+    MELO_INFO_STREAM("[maxon_epos_ethercat_sdk:Maxon::startup] '"
+                     << name_
+                     << "' is already configured, skipping configuration.");
+  } else {
+    // write the configuration parameters via Sdo
+    success &= configParam();
+    if (success) {
+      cacheConfiguration(fingerprint);
+    }
+  }
 
   if (!success) {
     MELO_ERROR_STREAM(
@@ -128,282 +287,604 @@ bool Maxon::startup() {
         << name_ << "' not successful!");
     addErrorToReading(ErrorType::ConfigurationError);
   }
-  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+  // wait until the drive answers again after the configuration, instead of a
+  // fixed delay
+  Statusword statusword;
+  const auto deadline =
+      std::chrono::steady_clock::now() + std::chrono::milliseconds(100);
+  std::chrono::microseconds backoff{0};
+  bool answered = getStatuswordViaSdo(statusword);
+  while (!answered && std::chrono::steady_clock::now() < deadline) {
+    waitForNextSdoPoll(deadline, backoff);
+    answered = getStatuswordViaSdo(statusword);
+  }
+  if (!answered) {
+    MELO_ERROR_STREAM("[maxon_epos_ethercat_sdk:Maxon::startup] '"
+                      << name_
+                      << "' did not answer within 100 ms after the "
+                         "configuration.");
+    success = false;
+  }
+
+  startupDuration_ = std::chrono::duration_cast<std::chrono::microseconds>(
+      std::chrono::steady_clock::now() - startupTimePoint);
+  MELO_INFO_STREAM("[maxon_epos_ethercat_sdk:Maxon::startup] Startup of '"
+                   << name_ << "' took " << startupDuration_.count() / 1000.0
+                   << " ms (" << numberOfSdoWrites_ << " SDO writes, "
+                   << numberOfSkippedSdoWrites_ << " skipped)");
   return success;
 }
 
+void Maxon::waitForNextSdoPoll(std::chrono::steady_clock::time_point deadline,
+                               std::chrono::microseconds& backoff) {
+  constexpr std::chrono::microseconds minBackoff{50};
+  constexpr std::chrono::microseconds maxBackoff{1000};
+  backoff = std::min(std::max(2 * backoff, minBackoff), maxBackoff);
+  const auto now = std::chrono::steady_clock::now();
+  if (now < deadline) {
+    std::this_thread::sleep_for(
+        std::min<std::chrono::steady_clock::duration>(backoff, deadline - now));
+  }
+}
+
 void Maxon::preShutdown() {
   setDriveStateViaSdo(DriveState::QuickStopActive);
   setDriveStateViaSdo(DriveState::SwitchOnDisabled);
 }
 
-void Maxon::shutdown() { bus_->setState(EC_STATE_INIT, address_); }
+void Maxon::shutdown() { setEthercatState(EC_STATE_INIT); }
+
+void Maxon::setEthercatState(uint16_t state) {
+  if (slaveBackend_ != nullptr) {
+    slaveBackend_->setState(state, static_cast<uint16_t>(address_));
+    return;
+  }
+  bus_->setState(state, static_cast<uint16_t>(address_));
+}
+
+bool Maxon::waitForEthercatState(uint16_t state, unsigned int maxRetries,
+                                 double retrySleep) {
+  if (slaveBackend_ != nullptr) {
+    return slaveBackend_->waitForState(state, static_cast<uint16_t>(address_),
+                                       maxRetries, retrySleep);
+  }
+  return bus_->waitForState(state, static_cast<uint16_t>(address_),
+                            maxRetries, retrySleep);
+}
+
+void Maxon::syncDistributedClock0(bool activate, double cycleTime,
+                                  double cycleShift) {
+  if (slaveBackend_ != nullptr) {
+    slaveBackend_->syncDistributedClock0(static_cast<uint16_t>(address_),
+                                         activate, cycleTime, cycleShift);
+    return;
+  }
+  bus_->syncDistributedClock0(static_cast<uint16_t>(address_), activate,
+                              cycleTime, cycleShift);
+}
+
+bool Maxon::lockCyclicMutex() {
+  if (mutex_.try_lock()) {
+    return false;
+  }
+  mutex_.lock();
+  return true;
+}
 
 void Maxon::updateWrite() {
-  std::lock_guard<std::recursive_mutex> lock(mutex_);
+  const ReadingTimePoint startTimePoint = ReadingClock::now();
+  const bool mutexContended = lockCyclicMutex();
+  std::lock_guard<std::recursive_mutex> lock(mutex_, std::adopt_lock);
+  mutexWaitHistogram_.record(
+      toNanoseconds(ReadingClock::now() - startTimePoint));
+  // the audit is guarded by mutex_, its acquisition is recorded afterwards
+  RtAuditScope auditScope(rtAudit_.get(), "Maxon::updateWrite", name_.c_str(),
+                          false);
+  rt_audit::recordLock("Maxon::mutex_", mutexContended);
+
+  completeSupersededDriveStateChanges();
+
+  // pick up the latest staged command, if there is a new one. Streamed
+  // setpoints take precedence once the first one is due.
+  stagedCommandBuffer_.update();
+  const RawCommand& stagedCommand =
+      setpointStream_.update(startTimePoint, streamedCommand_)
+          ? streamedCommand_
+          : stagedCommandBuffer_.getReadBuffer();
+  const ModeOfOperationEnum modeOfOperation = stagedCommand.modeOfOperation_;
 
   /*
   ** Check if the Mode of Operation has been set properly
   */
-  if (modeOfOperation_ == ModeOfOperationEnum::NA) {
-    reading_.addError(ErrorType::ModeOfOperationError);
-    MELO_ERROR_STREAM(
-        "[maxon_epos_ethercat_sdk:Maxon::updateWrite]"
-        " Mode of operation for '"
-        << name_ << "' has not been set.");
+  if (modeOfOperation == ModeOfOperationEnum::NA) {
+    if (!modeOfOperationErrorLatched_) {
+      modeOfOperationErrorLatched_ = true;
+      addErrorToReading(ErrorType::ModeOfOperationError);
+    }
+    logEvent(LogEventType::ModeOfOperationNotSet);
     return;
   }
+  modeOfOperationErrorLatched_ = false;
 
   /*!
-   * engage the state machine if a state change is requested
+   * engage the state machine if a state change is requested, a tripped limit
+   * guard overrides it until it is reset
    */
-  if (conductStateChange_ && hasRead_) {
+  if (limitGuardTripped_.load(std::memory_order_relaxed)) {
+    if (conductStateChange_) {
+      conductStateChange_ = false;
+      completeDriveStateChange(false);
+    }
+    controlword_ = getStateTransitionControlword(StateTransition::_11);
+  } else if (conductStateChange_ && hasRead_) {
     engagePdoStateMachine();
   }
 
-  switch (rxPdoTypeEnum_) {
-    case RxPdoTypeEnum::RxPdoStandard: {
-      RxPdoStandard rxPdo{};
-      rxPdo.modeOfOperation_ = static_cast<int8_t>(modeOfOperation_);
-      rxPdo.controlWord_ = controlword_.getRawControlword();
+  if (writeRxPdoFunction_ == nullptr) {
+    logEvent(LogEventType::RxPdoTypeNotSupported);
+    addErrorToReading(ErrorType::RxPdoTypeError);
+    return;
+  }
 
-      // actually writing to the hardware
-      bus_->writeRxPdo(address_, rxPdo);
-      break;
-    }
-    case RxPdoTypeEnum::RxPdoCSP: {
-      RxPdoCSP rxPdo{};
-      rxPdo.targetPosition_ = stagedCommand_.getTargetPositionRaw();
-      rxPdo.positionOffset_ = stagedCommand_.getPositionOffsetRaw();
-      rxPdo.torqueOffset_ = stagedCommand_.getTorqueOffsetRaw();
-
-      // Extra data
-      rxPdo.controlWord_ = controlword_.getRawControlword();
-      rxPdo.modeOfOperation_ = static_cast<int8_t>(modeOfOperation_);
-
-      // actually writing to the hardware
-      bus_->writeRxPdo(address_, rxPdo);
-      break;
-    }
-    case RxPdoTypeEnum::RxPdoCST: {
-      RxPdoCST rxPdo{};
-      rxPdo.targetTorque_ = stagedCommand_.getTargetTorqueRaw();
-      rxPdo.torqueOffset_ = stagedCommand_.getTorqueOffsetRaw();
-
-      // Extra data
-      rxPdo.controlWord_ = controlword_.getRawControlword();
-      rxPdo.modeOfOperation_ = static_cast<int8_t>(modeOfOperation_);
-
-      // actually writing to the hardware
-      bus_->writeRxPdo(address_, rxPdo);
-      break;
-    }
-    case RxPdoTypeEnum::RxPdoCSV: {
-      RxPdoCSV rxPdo{};
-      rxPdo.targetVelocity_ = stagedCommand_.getTargetVelocityRaw();
-      rxPdo.velocityOffset_ = stagedCommand_.getVelocityOffsetRaw();
-
-      // Extra data
-      rxPdo.controlWord_ = controlword_.getRawControlword();
-      rxPdo.modeOfOperation_ = static_cast<int8_t>(modeOfOperation_);
-
-      // actually writing to the hardware
-      bus_->writeRxPdo(address_, rxPdo);
-      break;
-    }
-    case RxPdoTypeEnum::RxPdoCSTCSP: {
-      RxPdoCSTCSP rxPdo{};
-      rxPdo.targetPosition_ = stagedCommand_.getTargetPositionRaw();
-      rxPdo.positionOffset_ = stagedCommand_.getPositionOffsetRaw();
-      rxPdo.targetTorque_ = stagedCommand_.getTargetTorqueRaw();
-      rxPdo.torqueOffset_ = stagedCommand_.getTorqueOffsetRaw();
-
-      // Extra data
-      rxPdo.controlWord_ = controlword_.getRawControlword();
-      rxPdo.modeOfOperation_ = static_cast<int8_t>(modeOfOperation_);
-
-      // actually writing to the hardware
-      bus_->writeRxPdo(address_, rxPdo);
-      break;
-    }
-    case RxPdoTypeEnum::RxPdoCSTCSPCSV: {
-      RxPdoCSTCSPCSV rxPdo{};
-      rxPdo.targetPosition_ = stagedCommand_.getTargetPositionRaw();
-      rxPdo.positionOffset_ = stagedCommand_.getPositionOffsetRaw();
-      rxPdo.targetTorque_ = stagedCommand_.getTargetTorqueRaw();
-      rxPdo.torqueOffset_ = stagedCommand_.getTorqueOffsetRaw();
-      rxPdo.targetVelocity_ = stagedCommand_.getTargetVelocityRaw();
-      rxPdo.velocityOffset_ = stagedCommand_.getVelocityOffsetRaw();
-
-      // Extra data
-      rxPdo.controlWord_ = controlword_.getRawControlword();
-      rxPdo.modeOfOperation_ = static_cast<int8_t>(modeOfOperation_);
-
-      // actually writing to the hardware
-      bus_->writeRxPdo(address_, rxPdo);
-      break;
-    }
-    case RxPdoTypeEnum::RxPdoPVM: {
-      RxPdoPVM rxPdo{};
-      rxPdo.controlWord_ = controlword_.getRawControlword();
-      rxPdo.targetVelocity_ = stagedCommand_.getTargetVelocityRaw();
-      rxPdo.profileAccel_ = stagedCommand_.getProfileAccelRaw();
-      rxPdo.profileDeccel_ = stagedCommand_.getProfileDeccelRaw();
-      rxPdo.motionProfileType_ = stagedCommand_.getMotionProfileType();
-
-      // actually writing to the hardware
-      bus_->writeRxPdo(address_, rxPdo);
-      break;
-    }
-    default:
-      MELO_ERROR_STREAM(
-          "[maxon_epos_ethercat_sdk:Maxon::updateWrite] "
-          " Unsupported Rx Pdo type for '"
-          << name_ << "'");
-      addErrorToReading(ErrorType::RxPdoTypeError);
+  // actually writing to the hardware
+  (this->*writeRxPdoFunction_)(stagedCommand);
+
+  if (sharedMemoryExport_ != nullptr) {
+    SharedMemoryDriveData data;
+    data.reading_ = readingSnapshot_;
+    data.command_ = stagedCommand;
+    data.controlword_ = controlword_;
+    sharedMemoryExport_->publish(sharedMemoryIndex_, data);
   }
+
+  // the record holds the Tx PDO of this cycle, read by updateRead()
+  if (telemetryRecorder_ != nullptr) {
+    telemetryRecord_.timeStamp_ = static_cast<int64_t>(
+        toNanoseconds(readingSnapshot_.timePoint_.time_since_epoch()));
+    telemetryRecord_.sequenceNumber_ = readingSnapshot_.sequenceNumber_;
+    telemetryRecord_.controlword_ = controlword_;
+    telemetryRecord_.statusword_ = readingSnapshot_.statusword_;
+    telemetryRecorder_->record(telemetryRecord_);
+  }
+  updateWriteHistogram_.record(
+      toNanoseconds(ReadingClock::now() - startTimePoint));
 }
 
 void Maxon::updateRead() {
-  std::lock_guard<std::recursive_mutex> lock(mutex_);
-
-  // TODO(duboisf): implement some sort of time stamp
-  switch (txPdoTypeEnum_) {
-    case TxPdoTypeEnum::TxPdoStandard: {
-      TxPdoStandard txPdo{};
-      // reading from the bus
-      bus_->readTxPdo(address_, txPdo);
-      reading_.setStatusword(txPdo.statusword_);
-      break;
-    }
-    case TxPdoTypeEnum::TxPdoCSP: {
-      TxPdoCSP txPdo{};
-      // reading from the bus
-      bus_->readTxPdo(address_, txPdo);
-      reading_.setStatusword(txPdo.statusword_);
-      reading_.setActualCurrent(txPdo.actualTorque_);
-      reading_.setActualVelocity(txPdo.actualVelocity_);
-      reading_.setActualPosition(txPdo.actualPosition_);
-      break;
+  const ReadingTimePoint startTimePoint = ReadingClock::now();
+  const bool mutexContended = lockCyclicMutex();
+  std::lock_guard<std::recursive_mutex> lock(mutex_, std::adopt_lock);
+  mutexWaitHistogram_.record(
+      toNanoseconds(ReadingClock::now() - startTimePoint));
+  RtAuditScope auditScope(rtAudit_.get(), "Maxon::updateRead", name_.c_str(),
+                          true);
+  rt_audit::recordLock("Maxon::mutex_", mutexContended);
+
+  // the cycle time is measured between the starts of two updateRead calls
+  const int64_t distributedClockTime =
+      distributedClockTime_ != nullptr ? *distributedClockTime_ : 0;
+  if (lastUpdateReadTimePoint_ != ReadingTimePoint()) {
+    const uint64_t cycleTime =
+        toNanoseconds(startTimePoint - lastUpdateReadTimePoint_);
+    cycleTimeHistogram_.record(cycleTime);
+    const double cycles = timeStep_ > 0 ? 1e-9 * cycleTime / timeStep_ : 0.0;
+    if (cycles > 1.5) {
+      missedCycles_.fetch_add(static_cast<uint64_t>(std::llround(cycles)) - 1,
+                              std::memory_order_relaxed);
     }
-    case TxPdoTypeEnum::TxPdoCST: {
-      TxPdoCST txPdo{};
-      // reading from the bus
-      bus_->readTxPdo(address_, txPdo);
-      reading_.setStatusword(txPdo.statusword_);
-      reading_.setActualCurrent(txPdo.actualTorque_);
-      reading_.setActualVelocity(txPdo.actualVelocity_);
-      reading_.setActualPosition(txPdo.actualPosition_);
-      break;
-    }
-    case TxPdoTypeEnum::TxPdoCSV: {
-      TxPdoCSV txPdo{};
-      // reading from the bus
-      bus_->readTxPdo(address_, txPdo);
-      reading_.setStatusword(txPdo.statusword_);
-      reading_.setActualCurrent(txPdo.actualTorque_);
-      reading_.setActualVelocity(txPdo.actualVelocity_);
-      reading_.setActualPosition(txPdo.actualPosition_);
-      break;
-    }
-    case TxPdoTypeEnum::TxPdoCSTCSP: {
-      TxPdoCSTCSP txPdo{};
-      // reading from the bus
-      bus_->readTxPdo(address_, txPdo);
-      reading_.setStatusword(txPdo.statusword_);
-      reading_.setActualCurrent(txPdo.actualTorque_);
-      reading_.setActualVelocity(txPdo.actualVelocity_);
-      reading_.setActualPosition(txPdo.actualPosition_);
-      break;
-    }
-    case TxPdoTypeEnum::TxPdoCSTCSPCSV: {
-      TxPdoCSTCSPCSV txPdo{};
-      // reading from the bus
-      bus_->readTxPdo(address_, txPdo);
-      reading_.setStatusword(txPdo.statusword_);
-      reading_.setActualCurrent(txPdo.actualTorque_);
-      reading_.setActualVelocity(txPdo.actualVelocity_);
-      reading_.setActualPosition(txPdo.actualPosition_);
-      break;
-    }
-    case TxPdoTypeEnum::TxPdoPVM: {
-      TxPdoPVM txPdo{};
-      // reading from the bus
-      bus_->readTxPdo(address_, txPdo);
-
-      reading_.setDemandVelocity(txPdo.demandVelocity_);
-      reading_.setStatusword(txPdo.statusword_);
-      break;
+
+    // the jitter of the host relative to the frames of the distributed clock
+    const int64_t distributedClockCycleTime =
+        distributedClockTime - lastDistributedClockTime_;
+    if (distributedClockTime != 0 && lastDistributedClockTime_ != 0 &&
+        distributedClockCycleTime > 0) {
+      distributedClockCycleTimeHistogram_.record(
+          static_cast<uint64_t>(distributedClockCycleTime));
+      distributedClockJitterHistogram_.record(static_cast<uint64_t>(std::llabs(
+          static_cast<int64_t>(cycleTime) - distributedClockCycleTime)));
     }
-    default:
-      MELO_ERROR_STREAM(
-          "[maxon_epos_ethercat_sdk:Maxon::updateRead] Unsupported Tx Pdo "
-          "type for '"
-          << name_ << "'");
-      reading_.addError(ErrorType::TxPdoTypeError);
   }
+  lastUpdateReadTimePoint_ = startTimePoint;
+  lastDistributedClockTime_ = distributedClockTime;
+
+  const uint16_t previousStatusword = readingSnapshot_.statusword_;
+  if (readTxPdoFunction_ != nullptr) {
+    // reading from the bus
+    (this->*readTxPdoFunction_)();
+    readingSnapshot_.timePoint_ = ReadingClock::now();
+  } else {
+    logEvent(LogEventType::TxPdoTypeNotSupported);
+    addErrorToReading(ErrorType::TxPdoTypeError);
+  }
+  // decoded once for the state machine and all consumers
+  readingSnapshot_.decodedStatusword_ =
+      decodeStatusword(readingSnapshot_.statusword_, previousStatusword);
+
+  // hand the new values over to the consumers
+  readingSnapshot_.sequenceNumber_++;
+  publishedReadingSnapshot_.write(readingSnapshot_);
+  detectReadingEvents();
+  checkLimits();
 
   // set the hasRead_ variable to true since a nes reading was read
   if (!hasRead_) {
     hasRead_ = true;
   }
 
-  // Print warning if drive is in FaultReactionAcrive state.
-  if (reading_.getDriveState() == DriveState::FaultReactionActive) {
-    MELO_ERROR_STREAM("[maxon_epos_ethercat_sdk:Maxon::updateRead] '"
-                      << name_ << "' is in drive state 'FaultReactionAcrive'");
+  // the fault information is read by the SDO worker, never in this thread
+  if (readingSnapshot_.decodedStatusword_.rose(statusword_bits::fault) &&
+      sdoWorker_ != nullptr) {
+    sdoWorker_->requestFaultCapture(this);
+  }
+
+  const DriveState currentDriveState = getCurrentDriveState();
+
+  // Print warning if drive is in FaultReactionActive state.
+  if (currentDriveState == DriveState::FaultReactionActive) {
+    logEvent(LogEventType::FaultReactionActive);
   }
 
   // Print warning if drive is in Fault state.
-  if (reading_.getDriveState() == DriveState::Fault) {
-    MELO_ERROR_STREAM("[maxon_epos_ethercat_sdk:Maxon::updateRead] '"
-                      << name_ << "' is in drive state 'Fault'");
+  if (currentDriveState == DriveState::Fault) {
+    logEvent(LogEventType::Fault);
   }
+  updateReadHistogram_.record(
+      toNanoseconds(ReadingClock::now() - startTimePoint));
 }
 
 void Maxon::stageCommand(const Command& command) {
-  std::lock_guard<std::recursive_mutex> lock(stagedCommandMutex_);
-  stagedCommand_ = command;
-  stagedCommand_.setPositionFactorRadToInteger(
-      static_cast<double>(configuration_.positionEncoderResolution) /
-      (2.0 * M_PI));
-
-  double currentFactorAToInt = 1000.0 / configuration_.nominalCurrentA;
-  stagedCommand_.setCurrentFactorAToInteger(currentFactorAToInt);
-  stagedCommand_.setTorqueFactorNmToInteger(
-      1000.0 /
-      (configuration_.nominalCurrentA * configuration_.torqueConstantNmA));
-
-  stagedCommand_.setUseRawCommands(configuration_.useRawCommands);
-
-  stagedCommand_.doUnitConversion();
-
-  const auto targetMode = command.getModeOfOperation();
-  if (std::find(configuration_.modesOfOperation.begin(),
-                configuration_.modesOfOperation.end(),
-                targetMode) != configuration_.modesOfOperation.end()) {
+  Command stagedCommand = command;
+  stagedCommand.setPositionFactorRadToInteger(
+      conversionFactors_.positionFactorRadToInteger_);
+  stagedCommand.setCurrentFactorAToInteger(
+      conversionFactors_.currentFactorAToInteger_);
+  stagedCommand.setTorqueFactorNmToInteger(
+      conversionFactors_.torqueFactorNmToInteger_);
+
+  stagedCommand.setUseRawCommands(configuration_.useRawCommands);
+
+  stagedCommand.doUnitConversion();
+
+  stageRawCommand(stagedCommand.getRawCommand());
+}
+
+void Maxon::stageRawCommand(const RawCommand& rawCommand) {
+  const auto targetMode = rawCommand.modeOfOperation_;
+  if (isModeOfOperationAllowed(targetMode)) {
     modeOfOperation_ = targetMode;
   } else {
-    MELO_ERROR_STREAM(
-        "[maxon_epos_ethercat_sdk:Maxon::stageCommand] "
-        "Target mode of operation '"
-        << targetMode << "' for device '" << name_ << "' not allowed");
+    logEvent(LogEventType::ModeOfOperationNotAllowed,
+             static_cast<int64_t>(targetMode));
+  }
+
+  RawCommand& stagedRawCommand = stagedCommandBuffer_.getWriteBuffer();
+  stagedRawCommand = rawCommand;
+  stagedRawCommand.modeOfOperation_ = modeOfOperation_;
+  stagedCommandBuffer_.publish();
+}
+
+bool Maxon::stageCsp(double targetPosition, double positionOffset,
+                     double torqueOffset) {
+  return stageCyclicCommand(
+      getCspCommand(targetPosition, positionOffset, torqueOffset));
+}
+
+bool Maxon::stageCsv(double targetVelocity, double velocityOffset) {
+  return stageCyclicCommand(getCsvCommand(targetVelocity, velocityOffset));
+}
+
+bool Maxon::stageCst(double targetTorque, double torqueOffset) {
+  return stageCyclicCommand(getCstCommand(targetTorque, torqueOffset));
+}
+
+RawCommand Maxon::getCspCommand(double targetPosition, double positionOffset,
+                                double torqueOffset) const {
+  RawCommand rawCommand;
+  rawCommand.modeOfOperation_ =
+      ModeOfOperationEnum::CyclicSynchronousPositionMode;
+  rawCommand.targetPosition_ = saturatingCast<int32_t>(
+      conversionFactors_.positionFactorRadToInteger_ * targetPosition);
+  rawCommand.positionOffset_ = saturatingCast<int32_t>(
+      conversionFactors_.positionFactorRadToInteger_ * positionOffset);
+  rawCommand.torqueOffset_ = saturatingCast<int16_t>(
+      conversionFactors_.torqueFactorNmToInteger_ * torqueOffset);
+  return rawCommand;
+}
+
+RawCommand Maxon::getCsvCommand(double targetVelocity,
+                                double velocityOffset) const {
+  RawCommand rawCommand;
+  rawCommand.modeOfOperation_ =
+      ModeOfOperationEnum::CyclicSynchronousVelocityMode;
+  rawCommand.targetVelocity_ = saturatingCast<int32_t>(
+      ConversionFactors::velocityFactorRadPerSecToMicroRPM_ * targetVelocity);
+  rawCommand.velocityOffset_ = saturatingCast<int32_t>(
+      ConversionFactors::velocityFactorRadPerSecToMicroRPM_ * velocityOffset);
+  return rawCommand;
+}
+
+RawCommand Maxon::getCstCommand(double targetTorque,
+                                double torqueOffset) const {
+  RawCommand rawCommand;
+  rawCommand.modeOfOperation_ =
+      ModeOfOperationEnum::CyclicSynchronousTorqueMode;
+  rawCommand.targetTorque_ = saturatingCast<int16_t>(
+      conversionFactors_.torqueFactorNmToInteger_ * targetTorque);
+  rawCommand.torqueOffset_ = saturatingCast<int16_t>(
+      conversionFactors_.torqueFactorNmToInteger_ * torqueOffset);
+  return rawCommand;
+}
+
+bool Maxon::stageCyclicCommand(const RawCommand& rawCommand) {
+  if (!isModeOfOperationAllowed(rawCommand.modeOfOperation_)) {
+    logEvent(LogEventType::ModeOfOperationNotAllowed,
+             static_cast<int64_t>(rawCommand.modeOfOperation_));
+    return false;
+  }
+  modeOfOperation_ = rawCommand.modeOfOperation_;
+  stagedCommandBuffer_.getWriteBuffer() = rawCommand;
+  stagedCommandBuffer_.publish();
+  return true;
+}
+
+bool Maxon::pushSetpoint(const Setpoint& setpoint) {
+  if (!isModeOfOperationAllowed(setpoint.command_.modeOfOperation_)) {
+    logEvent(LogEventType::ModeOfOperationNotAllowed,
+             static_cast<int64_t>(setpoint.command_.modeOfOperation_));
+    return false;
   }
+  return setpointStream_.push(setpoint);
+}
+
+std::size_t Maxon::pushSetpoints(const Setpoint* setpoints,
+                                 std::size_t numberOfSetpoints) {
+  // the batch ends at the first setpoint in a mode which is not allowed
+  for (std::size_t i = 0; i < numberOfSetpoints; i++) {
+    const ModeOfOperationEnum mode = setpoints[i].command_.modeOfOperation_;
+    if (!isModeOfOperationAllowed(mode)) {
+      logEvent(LogEventType::ModeOfOperationNotAllowed,
+               static_cast<int64_t>(mode));
+      return setpointStream_.push(setpoints, i);
+    }
+  }
+  return setpointStream_.push(setpoints, numberOfSetpoints);
+}
+
+bool Maxon::pushCspSetpoint(ReadingTimePoint timePoint, double targetPosition,
+                            double positionOffset, double torqueOffset) {
+  return pushSetpoint(
+      {timePoint, getCspCommand(targetPosition, positionOffset, torqueOffset)});
+}
+
+bool Maxon::pushCsvSetpoint(ReadingTimePoint timePoint, double targetVelocity,
+                            double velocityOffset) {
+  return pushSetpoint(
+      {timePoint, getCsvCommand(targetVelocity, velocityOffset)});
+}
+
+bool Maxon::pushCstSetpoint(ReadingTimePoint timePoint, double targetTorque,
+                            double torqueOffset) {
+  return pushSetpoint({timePoint, getCstCommand(targetTorque, torqueOffset)});
 }
 
 Reading Maxon::getReading() const {
-  std::lock_guard<std::recursive_mutex> lock(readingMutex_);
-  return reading_;
+  Reading reading;
+  getReading(reading);
+  return reading;
 }
 
 void Maxon::getReading(Reading& reading) const {
-  std::lock_guard<std::recursive_mutex> lock(readingMutex_);
-  reading = reading_;
+  {
+    // only consumers take readingMutex_, the producers of errors and
+    // faults queue them lock-free
+    std::lock_guard<std::recursive_mutex> lock(readingMutex_);
+    drainPendingDiagnoses();
+    reading = reading_;
+  }
+  // the raw values are taken from the lock-free snapshot such that the
+  // EtherCAT thread is never blocked by a consumer
+  const ReadingSnapshot snapshot = publishedReadingSnapshot_.read();
+  countStaleReading(snapshot);
+  reading.setSnapshot(snapshot);
+}
+
+uint64_t Maxon::getReadingSnapshot(ReadingSnapshot& snapshot) const {
+  publishedReadingSnapshot_.read(snapshot);
+  countStaleReading(snapshot);
+  return snapshot.sequenceNumber_;
+}
+
+ReadingSnapshot Maxon::getReadingSnapshot() const {
+  ReadingSnapshot snapshot;
+  getReadingSnapshot(snapshot);
+  return snapshot;
+}
+
+void Maxon::countStaleReading(const ReadingSnapshot& snapshot) const {
+  if (timeStep_ > 0 && snapshot.sequenceNumber_ != 0 &&
+      ReadingClock::now() - snapshot.timePoint_ >
+          std::chrono::duration<double>(2 * timeStep_)) {
+    staleReadings_.fetch_add(1, std::memory_order_relaxed);
+  }
+}
+
+ReadingSubscription::SharedPtr Maxon::subscribeReadingEvents(
+    uint32_t eventMask, const std::vector<ReadingThreshold>& thresholds) {
+  auto subscription =
+      std::make_shared<ReadingSubscription>(eventMask, thresholds);
+  std::lock_guard<std::recursive_mutex> lock(mutex_);
+  readingSubscriptions_.push_back(subscription);
+  return subscription;
+}
+
+void Maxon::unsubscribeReadingEvents(
+    const ReadingSubscription::SharedPtr& subscription) {
+  std::lock_guard<std::recursive_mutex> lock(mutex_);
+  readingSubscriptions_.erase(
+      std::remove(readingSubscriptions_.begin(), readingSubscriptions_.end(),
+                  subscription),
+      readingSubscriptions_.end());
+}
+
+void Maxon::publishReadingEvent(const ReadingEvent& event) {
+  pendingReadingEvents_.tryPush(event);
+}
+
+void Maxon::notifyReadingSubscriptions(const ReadingEvent& event) {
+  for (const auto& subscription : readingSubscriptions_) {
+    if (subscription->wants(event.type_)) {
+      subscription->push(event);
+    }
+  }
+}
+
+void Maxon::detectReadingEvents() {
+  ReadingEvent pendingEvent;
+  while (pendingReadingEvents_.tryPop(pendingEvent)) {
+    notifyReadingSubscriptions(pendingEvent);
+  }
+  if (readingSubscriptions_.empty()) {
+    hasLastEventStatusword_ = false;
+    return;
+  }
+
+  for (const auto& subscription : readingSubscriptions_) {
+    subscription->checkThresholds(readingSnapshot_, address_,
+                                  conversionFactors_,
+                                  getConversionFactorsVersion());
+  }
+
+  // the first reading only sets the reference
+  const uint16_t statusword = readingSnapshot_.statusword_;
+  if (!hasLastEventStatusword_) {
+    lastEventStatusword_ = statusword;
+    hasLastEventStatusword_ = true;
+    return;
+  }
+  if (statusword == lastEventStatusword_) {
+    return;
+  }
+
+  ReadingEvent event;
+  event.address_ = address_;
+  event.sequenceNumber_ = readingSnapshot_.sequenceNumber_;
+  event.timePoint_ = readingSnapshot_.timePoint_;
+  event.type_ = ReadingEventType::StatuswordChanged;
+  event.previousValue_ = lastEventStatusword_;
+  event.value_ = statusword;
+  notifyReadingSubscriptions(event);
+
+  const DriveState previousDriveState =
+      getDriveStateFromStatusword(lastEventStatusword_);
+  const DriveState currentDriveState =
+      readingSnapshot_.decodedStatusword_.driveState_;
+  if (previousDriveState != currentDriveState) {
+    event.type_ = ReadingEventType::DriveStateChanged;
+    event.previousValue_ = static_cast<int64_t>(previousDriveState);
+    event.value_ = static_cast<int64_t>(currentDriveState);
+    notifyReadingSubscriptions(event);
+  }
+  lastEventStatusword_ = statusword;
+}
+
+void Maxon::checkLimits() {
+  // only a moving drive is stopped, a tripped guard waits for its reset
+  if (!limitGuard_.isEnabled() ||
+      limitGuardTripped_.load(std::memory_order_relaxed) ||
+      getCurrentDriveState() != DriveState::OperationEnabled) {
+    return;
+  }
+  LimitViolation violation;
+  if (!limitGuard_.check(readingSnapshot_, violation)) {
+    return;
+  }
+  limitViolation_.write(violation);
+  limitGuardTripped_.store(true, std::memory_order_release);
+  logEvent(LogEventType::LimitViolation,
+           static_cast<int64_t>(violation.quantity_), violation.value_);
+
+  ReadingEvent event;
+  event.type_ = ReadingEventType::LimitViolation;
+  event.index_ = static_cast<std::size_t>(violation.quantity_);
+  event.address_ = address_;
+  event.previousValue_ = violation.limit_;
+  event.value_ = violation.value_;
+  event.sequenceNumber_ = violation.sequenceNumber_;
+  event.timePoint_ = violation.timePoint_;
+  notifyReadingSubscriptions(event);
+}
+
+void Maxon::resetLimitGuard() {
+  std::lock_guard<std::recursive_mutex> lock(mutex_);
+  limitGuard_.release();
+  limitGuardTripped_.store(false, std::memory_order_release);
+}
+
+StateTransitionStatistics Maxon::getStateTransitionStatistics() const {
+  StateTransitionStatistics statistics;
+  for (std::size_t i = 0; i < numberOfStateTransitions; i++) {
+    statistics.transitions_[i] = stateTransitionHistograms_[i].getStatistics();
+  }
+  statistics.stateChange_ = stateChangeHistogram_.getStatistics();
+  statistics.repeatedTransitions_ =
+      repeatedStateTransitions_.load(std::memory_order_relaxed);
+  return statistics;
+}
+
+void Maxon::resetStateTransitionStatistics() {
+  for (auto& histogram : stateTransitionHistograms_) {
+    histogram.reset();
+  }
+  stateChangeHistogram_.reset();
+  repeatedStateTransitions_.store(0, std::memory_order_relaxed);
+}
+
+TimingStatistics Maxon::getTimingStatistics() const {
+  TimingStatistics statistics;
+  statistics.updateRead_ = updateReadHistogram_.getStatistics();
+  statistics.updateWrite_ = updateWriteHistogram_.getStatistics();
+  statistics.mutexWait_ = mutexWaitHistogram_.getStatistics();
+  statistics.cycleTime_ = cycleTimeHistogram_.getStatistics();
+  statistics.distributedClockCycleTime_ =
+      distributedClockCycleTimeHistogram_.getStatistics();
+  statistics.distributedClockJitter_ =
+      distributedClockJitterHistogram_.getStatistics();
+  statistics.missedCycles_ = missedCycles_.load(std::memory_order_relaxed);
+  statistics.staleReadings_ = staleReadings_.load(std::memory_order_relaxed);
+  return statistics;
+}
+
+void Maxon::resetTimingStatistics() {
+  updateReadHistogram_.reset();
+  updateWriteHistogram_.reset();
+  mutexWaitHistogram_.reset();
+  cycleTimeHistogram_.reset();
+  distributedClockCycleTimeHistogram_.reset();
+  distributedClockJitterHistogram_.reset();
+  missedCycles_.store(0, std::memory_order_relaxed);
+  staleReadings_.store(0, std::memory_order_relaxed);
+}
+
+void Maxon::setDistributedClockTimeSource(const int64_t* distributedClockTime) {
+  std::lock_guard<std::recursive_mutex> lock(mutex_);
+  distributedClockTime_ = distributedClockTime;
+  lastDistributedClockTime_ = 0;
+}
+
+unsigned int Maxon::getCycleTime() const {
+  if (configuration_.cycleTime != 0) {
+    return configuration_.cycleTime;
+  }
+  if (timeStep_ > 0) {
+    return static_cast<unsigned int>(std::llround(timeStep_ * 1e6));
+  }
+  return 2000;
 }
 
 bool Maxon::loadConfigFile(const std::string& fileName) {
-  ConfigurationParser configurationParser(fileName);
-  return loadConfiguration(configurationParser.getConfiguration());
+  return loadConfiguration(
+      ConfigurationRegistry::getInstance().getConfiguration(fileName));
 }
 
 bool Maxon::loadConfigNode(YAML::Node configNode) {
@@ -412,20 +893,112 @@ bool Maxon::loadConfigNode(YAML::Node configNode) {
 }
 
 bool Maxon::loadConfiguration(const Configuration& configuration) {
-  reading_.configureReading(configuration);
+  const bool customPdoSuccess =
+      applyConfiguration(configuration, configuration.getPdoTypeSolution());
+  MELO_INFO_STREAM("[maxon_epos_ethercat_sdk] Sanity check for '" << name_
+                                                                  << "':");
+  return configuration.sanityCheck() && customPdoSuccess;
+}
+
+bool Maxon::loadConfiguration(
+    const ConfigurationRegistry::ConfigurationPtr& configuration,
+    const std::function<void(Configuration&)>& override) {
+  if (configuration == nullptr) {
+    MELO_ERROR_STREAM(
+        "[maxon_epos_ethercat_sdk:Maxon::loadConfiguration] No configuration "
+        "for '"
+        << name_ << "'");
+    return false;
+  }
+  if (override) {
+    Configuration overriddenConfiguration = configuration->configuration_;
+    override(overriddenConfiguration);
+    return loadConfiguration(overriddenConfiguration);
+  }
+  return applyConfiguration(configuration->configuration_,
+                            configuration->pdoTypeSolution_) &&
+         configuration->sane_;
+}
+
+bool Maxon::applyConfiguration(
+    const Configuration& configuration,
+    const std::pair<RxPdoTypeEnum, TxPdoTypeEnum>& pdoTypeSolution) {
   modeOfOperation_ = configuration.modesOfOperation[0];
-  const auto pdoTypeSolution = configuration.getPdoTypeSolution();
-  rxPdoTypeEnum_ = pdoTypeSolution.first;
-  txPdoTypeEnum_ = pdoTypeSolution.second;
+  // initial (zero) command in the first mode of operation
+  RawCommand& rawCommand = stagedCommandBuffer_.getWriteBuffer();
+  rawCommand = RawCommand();
+  rawCommand.modeOfOperation_ = modeOfOperation_;
+  stagedCommandBuffer_.publish();
+  // custom (or minimal) PDOs replace the ones derived from the modes of
+  // operation
+  pdoPlan_ = planPdoMapping(configuration, pdoTypeSolution);
+  rxPdoTypeEnum_ = pdoPlan_.rxPdoType_;
+  txPdoTypeEnum_ = pdoPlan_.txPdoType_;
+  bool customPdoSuccess = true;
+  customRxPdo_.clear();
+  for (const auto& name : pdoPlan_.rxObjects_) {
+    if (!customRxPdo_.addRxObject(name)) {
+      MELO_ERROR_STREAM(
+          "[maxon_epos_ethercat_sdk:Maxon::loadConfiguration] Cannot add '"
+          << name << "' to the custom Rx PDO of '" << name_ << "'");
+      customPdoSuccess = false;
+    }
+  }
+  customTxPdo_.clear();
+  for (const auto& name : pdoPlan_.txObjects_) {
+    if (!customTxPdo_.addTxObject(name)) {
+      MELO_ERROR_STREAM(
+          "[maxon_epos_ethercat_sdk:Maxon::loadConfiguration] Cannot add '"
+          << name << "' to the custom Tx PDO of '" << name_ << "'");
+      customPdoSuccess = false;
+    }
+  }
+
+  bindPdoTypes(rxPdoTypeEnum_, txPdoTypeEnum_);
   configuration_ = configuration;
+  updateConversionFactors();
+  // start the logging thread outside of the cyclic update
+  AsyncLogger::getInstance();
+  allowedModesOfOperation_ = 0;
+  for (const auto modeOfOperation : configuration.modesOfOperation) {
+    const auto bit = static_cast<uint8_t>(modeOfOperation);
+    if (bit < 32) {
+      allowedModesOfOperation_ |= 1u << bit;
+    }
+  }
 
-  MELO_INFO_STREAM("[maxon_epos_ethercat_sdk] Sanity check for '" << name_
-                                                                  << "':");
-  return configuration.sanityCheck();
+  return customPdoSuccess;
 }
 
 Configuration Maxon::getConfiguration() const { return configuration_; }
 
+PdoPlan Maxon::getPdoPlan() const { return pdoPlan_; }
+
+void Maxon::logEvent(LogEventType type, int64_t value0, int64_t value1) const {
+  AsyncLogger& asyncLogger = AsyncLogger::getInstance();
+  LogEvent event;
+  event.timePoint_ = std::chrono::steady_clock::now();
+  if (!logThrottles_[static_cast<std::size_t>(type)].pass(
+          event.timePoint_, asyncLogger.getRateLimitInterval(),
+          event.numberOfSuppressedEvents_)) {
+    return;
+  }
+  event.type_ = type;
+  event.address_ = address_;
+  name_.copy(event.deviceName_, sizeof(event.deviceName_) - 1);
+  event.values_[0] = value0;
+  event.values_[1] = value1;
+  asyncLogger.push(event);
+}
+
+void Maxon::updateConversionFactors() {
+  conversionFactors_ = ConversionFactors(configuration_);
+  limitGuard_.configure(configuration_, conversionFactors_);
+  conversionFactorsVersion_.fetch_add(1, std::memory_order_release);
+  std::lock_guard<std::recursive_mutex> lock(readingMutex_);
+  reading_.configureReading(configuration_);
+}
+
 bool Maxon::getStatuswordViaSdo(Statusword& statusword) {
   uint16_t statuswordValue = 0;
   bool success = sendSdoRead(OD_INDEX_STATUSWORD, 0, false, statuswordValue);
@@ -433,274 +1006,120 @@ bool Maxon::getStatuswordViaSdo(Statusword& statusword) {
   return success;
 }
 
+std::future<std::pair<bool, Statusword>> Maxon::getStatuswordViaSdoAsync() {
+  return submitSdoRequest([this]() {
+    Statusword statusword;
+    const bool success = getStatuswordViaSdo(statusword);
+    return std::make_pair(success, statusword);
+  });
+}
+
+std::future<bool> Maxon::setDriveStateViaSdoAsync(
+    const DriveState& driveState) {
+  return submitSdoRequest(
+      [this, driveState]() { return setDriveStateViaSdo(driveState); });
+}
+
+SdoWorker& Maxon::getSdoWorker() {
+  std::lock_guard<std::recursive_mutex> lock(mutex_);
+  if (sdoWorker_ == nullptr) {
+    sdoWorker_ = SdoWorker::getInstance(bus_);
+    sdoWorker_->addDevice(this);
+  }
+  return *sdoWorker_;
+}
+
 bool Maxon::setControlwordViaSdo(Controlword& controlword) {
   return sendSdoWrite(OD_INDEX_CONTROLWORD, 0, false,
                       controlword.getRawControlword());
 }
 
 bool Maxon::setDriveStateViaSdo(const DriveState& driveState) {
-  bool success = true;
   Statusword currentStatusword;
-  success &= getStatuswordViaSdo(currentStatusword);
-  DriveState currentDriveState = currentStatusword.getDriveState();
-
-  // do the adequate state changes (via sdo) depending on the requested and
-  // current drive states
-  switch (driveState) {
-    // Target: switch on disabled
-    // This is the lowest state in which the state machine can be brought over
-    // EtherCAT
-    case DriveState::SwitchOnDisabled:
-      switch (currentDriveState) {
-        case DriveState::SwitchOnDisabled:
-          success &= true;
-          break;
-        case DriveState::ReadyToSwitchOn:
-          success &= stateTransitionViaSdo(StateTransition::_7);
-          break;
-        case DriveState::SwitchedOn:
-          success &= stateTransitionViaSdo(StateTransition::_10);
-          break;
-        case DriveState::OperationEnabled:
-          success &= stateTransitionViaSdo(StateTransition::_9);
-          break;
-        case DriveState::QuickStopActive:
-          success &= stateTransitionViaSdo(StateTransition::_12);
-          break;
-        case DriveState::Fault:
-          success &= stateTransitionViaSdo(StateTransition::_15);
-          break;
-        default:
-          MELO_ERROR_STREAM(
-              "[maxon_epos_ethercat_sdk:Maxon::setDriveStateViaSdo] State "
-              "Transition not implemented");
-          addErrorToReading(ErrorType::SdoStateTransitionError);
-          success = false;
-      }
-      break;
-
-    case DriveState::ReadyToSwitchOn:
-      switch (currentDriveState) {
-        case DriveState::SwitchOnDisabled:
-          success &= stateTransitionViaSdo(StateTransition::_2);
-          break;
-        case DriveState::ReadyToSwitchOn:
-          success &= true;
-          break;
-        case DriveState::SwitchedOn:
-          success &= stateTransitionViaSdo(StateTransition::_6);
-          break;
-        case DriveState::OperationEnabled:
-          success &= stateTransitionViaSdo(StateTransition::_8);
-          break;
-        case DriveState::QuickStopActive:
-          success &= stateTransitionViaSdo(StateTransition::_12);
-          success &= stateTransitionViaSdo(StateTransition::_2);
-          break;
-        case DriveState::Fault:
-          success &= stateTransitionViaSdo(StateTransition::_15);
-          success &= stateTransitionViaSdo(StateTransition::_2);
-          break;
-        default:
-          MELO_ERROR_STREAM(
-              "[maxon_epos_ethercat_sdk:Maxon::setDriveStateViaSdo] State "
-              "Transition not implemented");
-          addErrorToReading(ErrorType::SdoStateTransitionError);
-          success = false;
-      }
-      break;
-
-    case DriveState::SwitchedOn:
-      switch (currentDriveState) {
-        case DriveState::SwitchOnDisabled:
-          success &= stateTransitionViaSdo(StateTransition::_2);
-          success &= stateTransitionViaSdo(StateTransition::_3);
-          break;
-        case DriveState::ReadyToSwitchOn:
-          success &= stateTransitionViaSdo(StateTransition::_3);
-          break;
-        case DriveState::SwitchedOn:
-          success &= true;
-          break;
-        case DriveState::OperationEnabled:
-          success &= stateTransitionViaSdo(StateTransition::_5);
-          break;
-        case DriveState::QuickStopActive:
-          success &= stateTransitionViaSdo(StateTransition::_12);
-          success &= stateTransitionViaSdo(StateTransition::_2);
-          success &= stateTransitionViaSdo(StateTransition::_3);
-          break;
-        case DriveState::Fault:
-          success &= stateTransitionViaSdo(StateTransition::_15);
-          success &= stateTransitionViaSdo(StateTransition::_2);
-          success &= stateTransitionViaSdo(StateTransition::_3);
-          break;
-        default:
-          MELO_ERROR_STREAM(
-              "[maxon_epos_ethercat_sdk:Maxon::setDriveStateViaSdo] State "
-              "Transition not implemented");
-          addErrorToReading(ErrorType::SdoStateTransitionError);
-          success = false;
-      }
-      break;
-
-    case DriveState::OperationEnabled:
-      switch (currentDriveState) {
-        case DriveState::SwitchOnDisabled:
-          success &= stateTransitionViaSdo(StateTransition::_2);
-          success &= stateTransitionViaSdo(StateTransition::_3);
-          success &= stateTransitionViaSdo(StateTransition::_4);
-          break;
-        case DriveState::ReadyToSwitchOn:
-          success &= stateTransitionViaSdo(StateTransition::_3);
-          success &= stateTransitionViaSdo(StateTransition::_4);
-          break;
-        case DriveState::SwitchedOn:
-          success &= stateTransitionViaSdo(StateTransition::_4);
-          break;
-        case DriveState::OperationEnabled:
-          success &= true;
-          break;
-        case DriveState::QuickStopActive:
-          success &= stateTransitionViaSdo(StateTransition::_12);
-          success &= stateTransitionViaSdo(StateTransition::_2);
-          success &= stateTransitionViaSdo(StateTransition::_3);
-          success &= stateTransitionViaSdo(StateTransition::_4);
-          break;
-        case DriveState::Fault:
-          success &= stateTransitionViaSdo(StateTransition::_15);
-          success &= stateTransitionViaSdo(StateTransition::_2);
-          success &= stateTransitionViaSdo(StateTransition::_3);
-          success &= stateTransitionViaSdo(StateTransition::_4);
-          break;
-        default:
-          MELO_ERROR_STREAM(
-              "[maxon_epos_ethercat_sdk:Maxon::setDriveStateViaSdo] State "
-              "Transition not implemented");
-          addErrorToReading(ErrorType::SdoStateTransitionError);
-          success = false;
-      }
-      break;
-
-    case DriveState::QuickStopActive:
-      switch (currentDriveState) {
-        case DriveState::SwitchOnDisabled:
-          success &= stateTransitionViaSdo(StateTransition::_2);
-          success &= stateTransitionViaSdo(StateTransition::_3);
-          success &= stateTransitionViaSdo(StateTransition::_4);
-          success &= stateTransitionViaSdo(StateTransition::_11);
-          break;
-        case DriveState::ReadyToSwitchOn:
-          success &= stateTransitionViaSdo(StateTransition::_3);
-          success &= stateTransitionViaSdo(StateTransition::_4);
-          success &= stateTransitionViaSdo(StateTransition::_11);
-          break;
-        case DriveState::SwitchedOn:
-          success &= stateTransitionViaSdo(StateTransition::_4);
-          success &= stateTransitionViaSdo(StateTransition::_11);
-          break;
-        case DriveState::OperationEnabled:
-          success &= stateTransitionViaSdo(StateTransition::_11);
-          break;
-        case DriveState::QuickStopActive:
-          success &= true;
-          break;
-        case DriveState::Fault:
-          success &= stateTransitionViaSdo(StateTransition::_15);
-          success &= stateTransitionViaSdo(StateTransition::_2);
-          success &= stateTransitionViaSdo(StateTransition::_3);
-          success &= stateTransitionViaSdo(StateTransition::_4);
-          success &= stateTransitionViaSdo(StateTransition::_11);
-          break;
-        default:
-          MELO_ERROR_STREAM(
-              "[maxon_epos_ethercat_sdk:Maxon::setDriveStateViaSdo] State "
-              "Transition not implemented");
-          addErrorToReading(ErrorType::SdoStateTransitionError);
-          success = false;
-      }
-      break;
+  if (!getStatuswordViaSdo(currentStatusword)) {
+    return false;
+  }
 
-    default:
-      MELO_ERROR_STREAM(
-          "[maxon_epos_ethercat_sdk:Maxon::setDriveStateViaSdo] State "
-          "Transition not implemented");
-      addErrorToReading(ErrorType::SdoStateTransitionError);
-      success = false;
+  // walk the transition table from the current to the requested drive state
+  bool success = true;
+  StateTransitionStep step =
+      getStateTransitionStep(driveState, currentStatusword.getDriveState());
+  while (step.type_ == StateTransitionStepType::Transition) {
+    success &= stateTransitionViaSdo(step.transition_);
+    step = getStateTransitionStep(driveState, step.nextDriveState_);
+  }
+  if (step.type_ == StateTransitionStepType::NotImplemented) {
+    MELO_ERROR_STREAM(
+        "[maxon_epos_ethercat_sdk:Maxon::setDriveStateViaSdo] State "
+        "Transition not implemented");
+    addErrorToReading(ErrorType::SdoStateTransitionError);
+    success = false;
   }
   return success;
 }
 
 bool Maxon::stateTransitionViaSdo(const StateTransition& stateTransition) {
-  Controlword controlword;
-  switch (stateTransition) {
-    case StateTransition::_2:
-      controlword.setStateTransition2();
-      return setControlwordViaSdo(controlword);
-      break;
-    case StateTransition::_3:
-      controlword.setStateTransition3();
-      return setControlwordViaSdo(controlword);
-      break;
-    case StateTransition::_4:
-      controlword.setStateTransition4();
-      return setControlwordViaSdo(controlword);
-      break;
-    case StateTransition::_5:
-      controlword.setStateTransition5();
-      return setControlwordViaSdo(controlword);
-      break;
-    case StateTransition::_6:
-      controlword.setStateTransition6();
-      return setControlwordViaSdo(controlword);
-      break;
-    case StateTransition::_7:
-      controlword.setStateTransition7();
-      return setControlwordViaSdo(controlword);
-      break;
-    case StateTransition::_8:
-      controlword.setStateTransition8();
-      return setControlwordViaSdo(controlword);
-      break;
-    case StateTransition::_9:
-      controlword.setStateTransition9();
-      return setControlwordViaSdo(controlword);
-      break;
-    case StateTransition::_10:
-      controlword.setStateTransition10();
-      return setControlwordViaSdo(controlword);
-      break;
-    case StateTransition::_11:
-      controlword.setStateTransition11();
-      return setControlwordViaSdo(controlword);
-      break;
-    case StateTransition::_12:
-      controlword.setStateTransition12();
-      return setControlwordViaSdo(controlword);
-      break;
-    case StateTransition::_15:
-      controlword.setStateTransition15();
-      return setControlwordViaSdo(controlword);
-      break;
-    default:
-      MELO_ERROR_STREAM(
-          "[maxon_epos_ethercat_sdk:Maxon::stateTransitionViaSdo] State "
-          "Transition not implemented");
-      addErrorToReading(ErrorType::SdoStateTransitionError);
-      return false;
+  if (static_cast<std::size_t>(stateTransition) >= numberOfStateTransitions) {
+    MELO_ERROR_STREAM(
+        "[maxon_epos_ethercat_sdk:Maxon::stateTransitionViaSdo] State "
+        "Transition not implemented");
+    addErrorToReading(ErrorType::SdoStateTransitionError);
+    return false;
   }
+  return sendSdoWrite(OD_INDEX_CONTROLWORD, 0, false,
+                      getStateTransitionControlword(stateTransition));
 }
 
 bool Maxon::setDriveStateViaPdo(const DriveState& driveState,
                                 const bool waitForState) {
-  bool success = false;
-  /*
-  ** locking the mutex_
-  ** This is not done with a lock_guard here because during the waiting time the
-  ** mutex_ must be unlocked periodically such that PDO writing (and thus state
-  ** changes) may occur at all!
-  */
-  mutex_.lock();
+  if (!waitForState) {
+    setDriveStateViaPdoAsync(driveState, DriveStateCallback());
+    return true;
+  }
+
+  // the mutex_ is not held while waiting, such that updateWrite() (and thus
+  // the state change) is never blocked by the waiting thread
+  std::future<bool> stateChange = setDriveStateViaPdoAsync(driveState);
+  if (stateChange.wait_for(std::chrono::microseconds(
+          configuration_.driveStateChangeMaxTimeout)) !=
+      std::future_status::ready) {
+    return false;
+  }
+  return stateChange.get();
+}
+
+std::future<bool> Maxon::setDriveStateViaPdoAsync(
+    const DriveState& driveState) {
+  auto promise = std::make_shared<std::promise<bool>>();
+  std::future<bool> future = promise->get_future();
+  setDriveStateViaPdoAsync(driveState, [promise](bool success) {
+    promise->set_value(success);
+  });
+  return future;
+}
+
+void Maxon::setDriveStateViaPdoAsync(const DriveState& driveState,
+                                     DriveStateCallback callback) {
+  std::lock_guard<std::recursive_mutex> lock(mutex_);
+
+  // a pending request is superseded by the new one. Its callback is handed
+  // to the EtherCAT thread instead of being called here with mutex_ held.
+  if (driveStateCallbackPending_) {
+    if (supersededDriveStateCallbackPending_) {
+      DriveStateCallback first = std::move(supersededDriveStateCallback_);
+      DriveStateCallback second = std::move(driveStateCallback_);
+      supersededDriveStateCallback_ = [first, second](bool success) {
+        first(success);
+        second(success);
+      };
+    } else {
+      supersededDriveStateCallback_ = std::move(driveStateCallback_);
+    }
+    supersededDriveStateCallbackPending_ = true;
+    driveStateCallbackPending_ = false;
+  }
+  driveStateCallback_ = std::move(callback);
+  driveStateCallbackPending_ = static_cast<bool>(driveStateCallback_);
 
   // reset the "stateChangeSuccessful_" flag to false such that a new successful
   // state change can be detected
@@ -718,236 +1137,107 @@ bool Maxon::setDriveStateViaPdo(const DriveState& driveState,
 
   // set the time point of the last pdo change to now
   driveStateChangeTimePoint_ = std::chrono::steady_clock::now();
+  driveStateChangeStartTimePoint_ = driveStateChangeTimePoint_;
+  stateTransitionPending_ = false;
+  lastControlwordDriveState_ = DriveState::NA;
+}
 
-  // set a temporary time point to prevent getting caught in an infinite loop
-  auto driveStateChangeStartTimePoint = std::chrono::steady_clock::now();
+std::future<bool> Maxon::setDriveStatesViaPdoAsync(
+    const std::vector<SharedPtr>& drives, const DriveState& driveState) {
+  struct GroupStateChange {
+    std::promise<bool> promise_;
+    std::atomic<size_t> numberOfPendingDrives_{0};
+    std::atomic<bool> success_{true};
+  };
+  auto group = std::make_shared<GroupStateChange>();
+  group->numberOfPendingDrives_ = drives.size();
+  std::future<bool> future = group->promise_.get_future();
+  if (drives.empty()) {
+    group->promise_.set_value(true);
+    return future;
+  }
+
+  // the drives may be updated by different EtherCAT threads, the last one to
+  // complete signals the group
+  for (const auto& drive : drives) {
+    drive->setDriveStateViaPdoAsync(driveState, [group](bool success) {
+      if (!success) {
+        group->success_ = false;
+      }
+      if (group->numberOfPendingDrives_.fetch_sub(1) == 1) {
+        group->promise_.set_value(group->success_);
+      }
+    });
+  }
+  return future;
+}
 
-  // return if no waiting is requested
+bool Maxon::setDriveStatesViaPdo(const std::vector<SharedPtr>& drives,
+                                 const DriveState& driveState,
+                                 const bool waitForState) {
   if (!waitForState) {
-    // unlock the mutex
-    mutex_.unlock();
-    // return true if no waiting is requested
+    for (const auto& drive : drives) {
+      drive->setDriveStateViaPdo(driveState, false);
+    }
     return true;
   }
 
-  // Wait for the state change to be successful
-  // during the waiting time the mutex MUST be unlocked!
+  // the drives change their state in parallel, so the longest timeout bounds
+  // the waiting time of the whole group
+  unsigned int maxTimeout = 0;
+  for (const auto& drive : drives) {
+    maxTimeout = std::max(maxTimeout,
+                          drive->configuration_.driveStateChangeMaxTimeout);
+  }
+  std::future<bool> stateChange = setDriveStatesViaPdoAsync(drives, driveState);
+  if (stateChange.wait_for(std::chrono::microseconds(maxTimeout)) !=
+      std::future_status::ready) {
+    return false;
+  }
+  return stateChange.get();
+}
 
-  while (true) {
-    // break loop as soon as the state change was successful
-    if (stateChangeSuccessful_) {
-      success = true;
-      break;
-    }
+void Maxon::completeSupersededDriveStateChanges() {
+  if (!supersededDriveStateCallbackPending_) {
+    return;
+  }
+  supersededDriveStateCallbackPending_ = false;
+  RtAuditSite site("Maxon::completeSupersededDriveStateChanges");
+  // the captures are released by the next superseding request, see
+  // completeDriveStateChange()
+  std::swap(supersededDriveStateCallback_, completedDriveStateCallback_);
+  completedDriveStateCallback_(false);
+}
 
-    // break the loop if the state change takes too long
-    // this prevents a freezing of the end user's program if the hardware is not
-    // able to change it's state.
-    if ((std::chrono::duration_cast<std::chrono::microseconds>(
-             std::chrono::steady_clock::now() - driveStateChangeStartTimePoint))
-            .count() > configuration_.driveStateChangeMaxTimeout) {
-      break;
-    }
-    // unlock the mutex during sleep time
-    mutex_.unlock();
-    std::this_thread::sleep_for(std::chrono::milliseconds(1));
-    // lock the mutex to be able to check the success flag
-    mutex_.lock();
-  }
-  // unlock the mutex one last time
-  mutex_.unlock();
-  return success;
+void Maxon::completeDriveStateChange(bool success) {
+  if (!driveStateCallbackPending_) {
+    return;
+  }
+  driveStateCallbackPending_ = false;
+  RtAuditSite site("Maxon::completeDriveStateChange");
+  // swapping neither allocates nor releases the captures, and the callback may
+  // safely request a new state change
+  std::swap(driveStateCallback_, completedDriveStateCallback_);
+  completedDriveStateCallback_(success);
 }
 
-Controlword Maxon::getNextStateTransitionControlword(
+StateTransitionStep Maxon::getNextStateTransitionStep(
     const DriveState& requestedDriveState,
     const DriveState& currentDriveState) {
-  Controlword controlword;
-  controlword.setAllFalse();
-  switch (requestedDriveState) {
-    case DriveState::SwitchOnDisabled:
-      switch (currentDriveState) {
-        case DriveState::SwitchOnDisabled:
-          MELO_ERROR_STREAM(
-              "[maxon_epos_ethercat_sdk:Maxon::"
-              "getNextStateTransitionControlword] "
-              << "drive state has already been reached for '" << name_ << "'");
-          addErrorToReading(ErrorType::PdoStateTransitionError);
-          break;
-        case DriveState::ReadyToSwitchOn:
-          controlword.setStateTransition7();
-          break;
-        case DriveState::SwitchedOn:
-          controlword.setStateTransition10();
-          break;
-        case DriveState::OperationEnabled:
-          controlword.setStateTransition9();
-          break;
-        case DriveState::QuickStopActive:
-          controlword.setStateTransition12();
-          break;
-        case DriveState::Fault:
-          controlword.setStateTransition15();
-          break;
-        default:
-          MELO_ERROR_STREAM(
-              "[maxon_epos_ethercat_sdk:Maxon::"
-              "getNextStateTransitionControlword] "
-              << "PDO state transition not implemented for '" << name_ << "'\n"
-              << "Current: " << currentDriveState << "\n"
-              << "Requested: " << requestedDriveState);
-          addErrorToReading(ErrorType::PdoStateTransitionError);
-      }
-      break;
-
-    case DriveState::ReadyToSwitchOn:
-      switch (currentDriveState) {
-        case DriveState::SwitchOnDisabled:
-          controlword.setStateTransition2();
-          break;
-        case DriveState::ReadyToSwitchOn:
-          MELO_ERROR_STREAM(
-              "[maxon_epos_ethercat_sdk:Maxon::"
-              "getNextStateTransitionControlword] "
-              << "drive state has already been reached for '" << name_ << "'");
-          addErrorToReading(ErrorType::PdoStateTransitionError);
-          break;
-        case DriveState::SwitchedOn:
-          controlword.setStateTransition6();
-          break;
-        case DriveState::OperationEnabled:
-          controlword.setStateTransition8();
-          break;
-        case DriveState::QuickStopActive:
-          controlword.setStateTransition12();
-          break;
-        case DriveState::Fault:
-          controlword.setStateTransition15();
-          break;
-        default:
-          MELO_ERROR_STREAM(
-              "[maxon_epos_ethercat_sdk:Maxon::"
-              "getNextStateTransitionControlword] "
-              << "PDO state transition not implemented for '" << name_ << "'\n"
-              << "Current: " << currentDriveState << "\n"
-              << "Requested: " << requestedDriveState);
-          addErrorToReading(ErrorType::PdoStateTransitionError);
-      }
-      break;
-
-    case DriveState::SwitchedOn:
-      switch (currentDriveState) {
-        case DriveState::SwitchOnDisabled:
-          controlword.setStateTransition2();
-          break;
-        case DriveState::ReadyToSwitchOn:
-          controlword.setStateTransition3();
-          break;
-        case DriveState::SwitchedOn:
-          MELO_ERROR_STREAM(
-              "[maxon_epos_ethercat_sdk:Maxon::"
-              "getNextStateTransitionControlword] "
-              << "drive state has already been reached for '" << name_ << "'");
-          addErrorToReading(ErrorType::PdoStateTransitionError);
-          break;
-        case DriveState::OperationEnabled:
-          controlword.setStateTransition5();
-          break;
-        case DriveState::QuickStopActive:
-          controlword.setStateTransition12();
-          break;
-        case DriveState::Fault:
-          controlword.setStateTransition15();
-          break;
-        default:
-          MELO_ERROR_STREAM(
-              "[maxon_epos_ethercat_sdk:Maxon::"
-              "getNextStateTransitionControlword] "
-              << "PDO state transition not implemented for '" << name_ << "'\n"
-              << "Current: " << currentDriveState << "\n"
-              << "Requested: " << requestedDriveState);
-          addErrorToReading(ErrorType::PdoStateTransitionError);
-      }
-      break;
-
-    case DriveState::OperationEnabled:
-      switch (currentDriveState) {
-        case DriveState::SwitchOnDisabled:
-          controlword.setStateTransition2();
-          break;
-        case DriveState::ReadyToSwitchOn:
-          controlword.setStateTransition3();
-          break;
-        case DriveState::SwitchedOn:
-          controlword.setStateTransition4();
-          break;
-        case DriveState::OperationEnabled:
-          MELO_ERROR_STREAM(
-              "[maxon_epos_ethercat_sdk:Maxon::"
-              "getNextStateTransitionControlword] "
-              << "drive state has already been reached for '" << name_ << "'");
-          addErrorToReading(ErrorType::PdoStateTransitionError);
-          break;
-        case DriveState::QuickStopActive:
-          controlword.setStateTransition12();
-          break;
-        case DriveState::Fault:
-          controlword.setStateTransition15();
-          break;
-        default:
-          MELO_ERROR_STREAM(
-              "[maxon_epos_ethercat_sdk:Maxon::"
-              "getNextStateTransitionControlword] "
-              << "PDO state transition not implemented for '" << name_ << "'\n"
-              << "Current: " << currentDriveState << "\n"
-              << "Requested: " << requestedDriveState);
-          addErrorToReading(ErrorType::PdoStateTransitionError);
-      }
-      break;
-
-    case DriveState::QuickStopActive:
-      switch (currentDriveState) {
-        case DriveState::SwitchOnDisabled:
-          controlword.setStateTransition2();
-          break;
-        case DriveState::ReadyToSwitchOn:
-          controlword.setStateTransition3();
-          break;
-        case DriveState::SwitchedOn:
-          controlword.setStateTransition4();
-          break;
-        case DriveState::OperationEnabled:
-          controlword.setStateTransition11();
-          break;
-        case DriveState::QuickStopActive:
-          MELO_ERROR_STREAM(
-              "[maxon_epos_ethercat_sdk:Maxon::"
-              "getNextStateTransitionControlword] "
-              << "drive state has already been reached for '" << name_ << "'");
-          addErrorToReading(ErrorType::PdoStateTransitionError);
-          break;
-        case DriveState::Fault:
-          controlword.setStateTransition15();
-          break;
-        default:
-          MELO_ERROR_STREAM(
-              "[maxon_epos_ethercat_sdk:Maxon::"
-              "getNextStateTransitionControlword] "
-              << "PDO state transition not implemented for '" << name_ << "'\n"
-              << "Current: " << currentDriveState << "\n"
-              << "Requested: " << requestedDriveState);
-          addErrorToReading(ErrorType::PdoStateTransitionError);
-      }
-      break;
-
-    default:
-      MELO_ERROR_STREAM(
-          "[maxon_epos_ethercat_sdk:Maxon::getNextStateTransitionControlword] "
-          << "PDO state cannot be reached for '" << name_ << "'");
-      addErrorToReading(ErrorType::PdoStateTransitionError);
+  const StateTransitionStep step =
+      getStateTransitionStep(requestedDriveState, currentDriveState);
+  if (step.type_ == StateTransitionStepType::TargetReached) {
+    logEvent(LogEventType::DriveStateAlreadyReached,
+             static_cast<int64_t>(currentDriveState));
+    addErrorToReading(ErrorType::PdoStateTransitionError);
+  } else if (step.type_ == StateTransitionStepType::NotImplemented) {
+    logEvent(LogEventType::StateTransitionNotImplemented,
+             static_cast<int64_t>(currentDriveState),
+             static_cast<int64_t>(requestedDriveState));
+    addErrorToReading(ErrorType::PdoStateTransitionError);
   }
-
-  return controlword;
+  // the controlword of the steps without a transition is 0
+  return step;
 }
 
 void Maxon::autoConfigurePdoSizes() {
@@ -960,37 +1250,76 @@ uint16_t Maxon::getTxPdoSize() { return pdoInfo_.txPdoSize_; }
 
 uint16_t Maxon::getRxPdoSize() { return pdoInfo_.rxPdoSize_; }
 
-void Maxon::engagePdoStateMachine() {
-  // locking the mutex
-  std::lock_guard<std::recursive_mutex> lock(mutex_);
+DriveState Maxon::getCurrentDriveState() const {
+  return readingSnapshot_.decodedStatusword_.driveState_;
+}
 
+void Maxon::engagePdoStateMachine() {
+  const auto now = std::chrono::steady_clock::now();
   // elapsed time since the last new controlword
   auto microsecondsSinceChange =
       (std::chrono::duration_cast<std::chrono::microseconds>(
-           std::chrono::steady_clock::now() - driveStateChangeTimePoint_))
+           now - driveStateChangeTimePoint_))
           .count();
 
   // get the current state
   // since we wait until "hasRead" is true, this is guaranteed to be a newly
   // read value
-  const DriveState currentDriveState = reading_.getDriveState();
+  const DriveState currentDriveState = getCurrentDriveState();
+  // the drive acknowledged the last controlword
+  if (stateTransitionPending_ &&
+      currentDriveState == pendingStateTransitionStep_.nextDriveState_) {
+    stateTransitionHistograms_[static_cast<std::size_t>(
+                                   pendingStateTransitionStep_.transition_)]
+        .record(toNanoseconds(now - driveStateChangeTimePoint_));
+    stateTransitionPending_ = false;
+  }
+
   // check if the state change already was successful:
   if (currentDriveState == targetDriveState_) {
     numberOfSuccessfulTargetStateReadings_++;
+    const unsigned int minNumberOfSuccessfulTargetStateReadings =
+        configuration_.fastDriveStateChange
+            ? 1
+            : configuration_.minNumberOfSuccessfulTargetStateReadings;
     if (numberOfSuccessfulTargetStateReadings_ >=
-        configuration_.minNumberOfSuccessfulTargetStateReadings) {
+        minNumberOfSuccessfulTargetStateReadings) {
       // disable the state machine
       conductStateChange_ = false;
       numberOfSuccessfulTargetStateReadings_ = 0;
       stateChangeSuccessful_ = true;
+      stateChangeHistogram_.record(
+          toNanoseconds(now - driveStateChangeStartTimePoint_));
+      completeDriveStateChange(true);
       return;
     }
   } else if (microsecondsSinceChange >
-             configuration_.driveStateChangeMinTimeout) {
+                 configuration_.driveStateChangeMinTimeout ||
+             (configuration_.fastDriveStateChange &&
+              currentDriveState != lastControlwordDriveState_)) {
+    // in the fast mode the next controlword follows as soon as the drive
+    // state has changed, the timeout only repeats a lost one
+    if (stateTransitionPending_ &&
+        currentDriveState == lastControlwordDriveState_) {
+      repeatedStateTransitions_.fetch_add(1, std::memory_order_relaxed);
+    }
     // get the next controlword from the state machine
-    controlword_ =
-        getNextStateTransitionControlword(targetDriveState_, currentDriveState);
-    driveStateChangeTimePoint_ = std::chrono::steady_clock::now();
+    pendingStateTransitionStep_ =
+        getNextStateTransitionStep(targetDriveState_, currentDriveState);
+    controlword_ = pendingStateTransitionStep_.controlword_;
+    stateTransitionPending_ = pendingStateTransitionStep_.type_ ==
+                              StateTransitionStepType::Transition;
+    lastControlwordDriveState_ = currentDriveState;
+    driveStateChangeTimePoint_ = now;
+  }
+
+  // report a timeout to the waiting caller, the state machine keeps trying
+  // until a new target state is requested
+  if (driveStateCallbackPending_ &&
+      std::chrono::duration_cast<std::chrono::microseconds>(
+          now - driveStateChangeStartTimePoint_)
+              .count() > configuration_.driveStateChangeMaxTimeout) {
+    completeDriveStateChange(false);
   }
 
   // set the "hasRead" variable to false such that there will definitely be a
@@ -0,0 +1,237 @@
+// clang-format off
+/*
+** Copyright 2021 Robotic Systems Lab - ETH Zurich:
+** Linghao Zhang, Jonas Junger, Lennart Nachtigall
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions are met:
+**
+** 1. Redistributions of source code must retain the above copyright notice,
+**    this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright notice,
+**    this list of conditions and the following disclaimer in the documentation
+**    and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its contributors
+**    may be used to endorse or promote products derived from this software without
+**    specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+** AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+** IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+** DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+** FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+** DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+** SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+** CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+** OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+// clang-format on
+
+#include "maxon_epos_ethercat_sdk/MaxonGroup.hpp"
+
+#include <limits>
+#include <utility>
+
+#include "maxon_epos_ethercat_sdk/SaturatingCast.hpp"
+
+namespace maxon {
+void MaxonGroupCommand::resize(size_t numberOfDrives) {
+  targetPosition_.resize(numberOfDrives, 0);
+  targetVelocity_.resize(numberOfDrives, 0);
+  targetTorque_.resize(numberOfDrives, 0);
+  positionOffset_.resize(numberOfDrives, 0);
+  velocityOffset_.resize(numberOfDrives, 0);
+  torqueOffset_.resize(numberOfDrives, 0);
+  modeOfOperation_.resize(numberOfDrives, ModeOfOperationEnum::NA);
+}
+
+void MaxonGroupReading::resize(size_t numberOfDrives) {
+  actualPosition_.resize(numberOfDrives, 0);
+  actualVelocity_.resize(numberOfDrives, 0);
+  actualCurrent_.resize(numberOfDrives, 0);
+  actualTorque_.resize(numberOfDrives, 0);
+  statusword_.resize(numberOfDrives, 0);
+  decodedStatusword_.resize(numberOfDrives);
+  sequenceNumber_.resize(numberOfDrives, 0);
+}
+
+MaxonGroup::MaxonGroup(std::vector<Maxon::SharedPtr> drives)
+    : drives_(std::move(drives)) {
+  const size_t numberOfDrives = drives_.size();
+  targetPositionRaw_.resize(numberOfDrives);
+  targetVelocityRaw_.resize(numberOfDrives);
+  targetTorqueRaw_.resize(numberOfDrives);
+  positionOffsetRaw_.resize(numberOfDrives);
+  velocityOffsetRaw_.resize(numberOfDrives);
+  torqueOffsetRaw_.resize(numberOfDrives);
+  snapshots_.resize(numberOfDrives);
+  positionFactorRadToInteger_.resize(numberOfDrives);
+  torqueFactorNmToInteger_.resize(numberOfDrives);
+  positionFactorIntegerToRad_.resize(numberOfDrives);
+  currentFactorIntegerToAmp_.resize(numberOfDrives);
+  torqueFactorIntegerToNm_.resize(numberOfDrives);
+  updateConversionFactors();
+}
+
+void MaxonGroup::updateConversionFactors() {
+  // invalidate all copies, the versions of the drives start at 0
+  const size_t numberOfDrives = drives_.size();
+  commandFactorsVersion_.assign(numberOfDrives,
+                                std::numeric_limits<uint64_t>::max());
+  readingFactorsVersion_.assign(numberOfDrives,
+                                std::numeric_limits<uint64_t>::max());
+  refreshCommandFactors();
+  refreshReadingFactors();
+}
+
+void MaxonGroup::refreshCommandFactors() {
+  for (size_t i = 0; i < drives_.size(); i++) {
+    const uint64_t version = drives_[i]->getConversionFactorsVersion();
+    if (version == commandFactorsVersion_[i]) {
+      continue;
+    }
+    const ConversionFactors& conversionFactors =
+        drives_[i]->getConversionFactors();
+    positionFactorRadToInteger_[i] =
+        conversionFactors.positionFactorRadToInteger_;
+    torqueFactorNmToInteger_[i] = conversionFactors.torqueFactorNmToInteger_;
+    commandFactorsVersion_[i] = version;
+  }
+}
+
+void MaxonGroup::refreshReadingFactors() {
+  for (size_t i = 0; i < drives_.size(); i++) {
+    const uint64_t version = drives_[i]->getConversionFactorsVersion();
+    if (version == readingFactorsVersion_[i]) {
+      continue;
+    }
+    const ConversionFactors& conversionFactors =
+        drives_[i]->getConversionFactors();
+    positionFactorIntegerToRad_[i] =
+        conversionFactors.positionFactorIntegerToRad_;
+    currentFactorIntegerToAmp_[i] =
+        conversionFactors.currentFactorIntegerToAmp_;
+    torqueFactorIntegerToNm_[i] = conversionFactors.torqueFactorIntegerToNm_;
+    readingFactorsVersion_[i] = version;
+  }
+}
+
+bool MaxonGroup::stageCommands(const MaxonGroupCommand& command) {
+  const size_t numberOfDrives = drives_.size();
+  if (command.targetPosition_.size() != numberOfDrives ||
+      command.targetVelocity_.size() != numberOfDrives ||
+      command.targetTorque_.size() != numberOfDrives ||
+      command.positionOffset_.size() != numberOfDrives ||
+      command.velocityOffset_.size() != numberOfDrives ||
+      command.torqueOffset_.size() != numberOfDrives ||
+      command.modeOfOperation_.size() != numberOfDrives) {
+    MELO_ERROR_STREAM(
+        "[maxon_epos_ethercat_sdk:MaxonGroup::stageCommands] The command "
+        "does not match the "
+        << numberOfDrives << " drives of the group");
+    return false;
+  }
+
+  refreshCommandFactors();
+
+  // one pass per quantity over all drives, such that the loops vectorize
+  for (size_t i = 0; i < numberOfDrives; i++) {
+    targetPositionRaw_[i] = saturatingCast<int32_t>(
+        positionFactorRadToInteger_[i] * command.targetPosition_[i]);
+  }
+  for (size_t i = 0; i < numberOfDrives; i++) {
+    positionOffsetRaw_[i] = saturatingCast<int32_t>(
+        positionFactorRadToInteger_[i] * command.positionOffset_[i]);
+  }
+  for (size_t i = 0; i < numberOfDrives; i++) {
+    targetVelocityRaw_[i] = saturatingCast<int32_t>(
+        ConversionFactors::velocityFactorRadPerSecToMicroRPM_ *
+        command.targetVelocity_[i]);
+  }
+  for (size_t i = 0; i < numberOfDrives; i++) {
+    velocityOffsetRaw_[i] = saturatingCast<int32_t>(
+        ConversionFactors::velocityFactorRadPerSecToMicroRPM_ *
+        command.velocityOffset_[i]);
+  }
+  for (size_t i = 0; i < numberOfDrives; i++) {
+    targetTorqueRaw_[i] = saturatingCast<int16_t>(
+        torqueFactorNmToInteger_[i] * command.targetTorque_[i]);
+  }
+  for (size_t i = 0; i < numberOfDrives; i++) {
+    torqueOffsetRaw_[i] = saturatingCast<int16_t>(
+        torqueFactorNmToInteger_[i] * command.torqueOffset_[i]);
+  }
+
+  for (size_t i = 0; i < numberOfDrives; i++) {
+    RawCommand rawCommand;
+    rawCommand.targetPosition_ = targetPositionRaw_[i];
+    rawCommand.targetVelocity_ = targetVelocityRaw_[i];
+    rawCommand.targetTorque_ = targetTorqueRaw_[i];
+    rawCommand.positionOffset_ = positionOffsetRaw_[i];
+    rawCommand.velocityOffset_ = velocityOffsetRaw_[i];
+    rawCommand.torqueOffset_ = torqueOffsetRaw_[i];
+    rawCommand.modeOfOperation_ = command.modeOfOperation_[i];
+    drives_[i]->stageRawCommand(rawCommand);
+  }
+  return true;
+}
+
+void MaxonGroup::getReadings(MaxonGroupReading& reading) {
+  const size_t numberOfDrives = drives_.size();
+  reading.resize(numberOfDrives);
+  refreshReadingFactors();
+
+  for (size_t i = 0; i < numberOfDrives; i++) {
+    reading.sequenceNumber_[i] = drives_[i]->getReadingSnapshot(snapshots_[i]);
+  }
+
+  for (size_t i = 0; i < numberOfDrives; i++) {
+    reading.actualPosition_[i] =
+        static_cast<double>(snapshots_[i].actualPosition_) *
+        positionFactorIntegerToRad_[i];
+  }
+  for (size_t i = 0; i < numberOfDrives; i++) {
+    reading.actualVelocity_[i] =
+        static_cast<double>(snapshots_[i].actualVelocity_) *
+        ConversionFactors::velocityFactorMicroRPMToRadPerSec_;
+  }
+  for (size_t i = 0; i < numberOfDrives; i++) {
+    reading.actualCurrent_[i] =
+        static_cast<double>(snapshots_[i].actualCurrent_) *
+        currentFactorIntegerToAmp_[i];
+  }
+  for (size_t i = 0; i < numberOfDrives; i++) {
+    reading.actualTorque_[i] =
+        static_cast<double>(snapshots_[i].actualCurrent_) *
+        torqueFactorIntegerToNm_[i];
+  }
+  for (size_t i = 0; i < numberOfDrives; i++) {
+    reading.statusword_[i] = snapshots_[i].statusword_;
+    reading.decodedStatusword_[i] = snapshots_[i].decodedStatusword_;
+  }
+}
+
+bool MaxonGroup::setDriveStateViaPdo(const DriveState& driveState,
+                                     const bool waitForState) {
+  return Maxon::setDriveStatesViaPdo(drives_, driveState, waitForState);
+}
+
+std::future<bool> MaxonGroup::setDriveStateViaPdoAsync(
+    const DriveState& driveState) {
+  return Maxon::setDriveStatesViaPdoAsync(drives_, driveState);
+}
+
+bool MaxonGroup::startup(unsigned int maxNumberOfThreads) {
+  return Maxon::startupDrives(drives_, maxNumberOfThreads);
+}
+
+void MaxonGroup::setParallelStartup(unsigned int maxNumberOfThreads) {
+  Maxon::setParallelStartup(drives_, maxNumberOfThreads);
+}
+
+BusPlan MaxonGroup::planBus() const { return Maxon::planBus(drives_); }
+
+}  // namespace maxon
@@ -0,0 +1,290 @@
+// clang-format off
+/*
+** Copyright 2021 Robotic Systems Lab - ETH Zurich:
+** Linghao Zhang, Jonas Junger, Lennart Nachtigall
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions are met:
+**
+** 1. Redistributions of source code must retain the above copyright notice,
+**    this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright notice,
+**    this list of conditions and the following disclaimer in the documentation
+**    and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its contributors
+**    may be used to endorse or promote products derived from this software without
+**    specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+** AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+** IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+** DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+** FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+** DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+** SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+** CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+** OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+// clang-format on
+
+#include "maxon_epos_ethercat_sdk/PdoPlanner.hpp"
+
+#include <algorithm>
+#include <iomanip>
+
+#include "maxon_epos_ethercat_sdk/CustomPdo.hpp"
+#include "maxon_epos_ethercat_sdk/RxPdo.hpp"
+#include "maxon_epos_ethercat_sdk/TxPdo.hpp"
+
+namespace maxon {
+namespace {
+// Ethernet: preamble and SFD, header, FCS and inter-frame gap [bytes]
+constexpr std::size_t ethernetOverhead = 8 + 14 + 4 + 12;
+constexpr std::size_t minEthernetPayload = 46;
+constexpr std::size_t maxEthernetPayload = 1500;
+constexpr std::size_t ethercatHeaderSize = 2;
+// datagram header and working counter
+constexpr std::size_t datagramOverhead = 10 + 2;
+// the DC time datagram (FRMW of the system time)
+constexpr std::size_t distributedClockDatagramSize = datagramOverhead + 8;
+// 100 Mbit/s
+constexpr double byteTime = 0.08;
+// processing and forwarding of both directions through one slave [us]
+constexpr double slaveForwardingDelay = 1.0;
+
+std::size_t getRxPdoSize(RxPdoTypeEnum rxPdoType) {
+  switch (rxPdoType) {
+    case RxPdoTypeEnum::RxPdoStandard:
+      return sizeof(RxPdoStandard);
+    case RxPdoTypeEnum::RxPdoCSP:
+      return sizeof(RxPdoCSP);
+    case RxPdoTypeEnum::RxPdoCST:
+      return sizeof(RxPdoCST);
+    case RxPdoTypeEnum::RxPdoCSV:
+      return sizeof(RxPdoCSV);
+    case RxPdoTypeEnum::RxPdoCSTCSP:
+      return sizeof(RxPdoCSTCSP);
+    case RxPdoTypeEnum::RxPdoCSTCSPCSV:
+      return sizeof(RxPdoCSTCSPCSV);
+    case RxPdoTypeEnum::RxPdoPVM:
+      return sizeof(RxPdoPVM);
+    default:
+      return 0;
+  }
+}
+
+std::size_t getTxPdoSize(TxPdoTypeEnum txPdoType) {
+  switch (txPdoType) {
+    case TxPdoTypeEnum::TxPdoStandard:
+      return sizeof(TxPdoStandard);
+    case TxPdoTypeEnum::TxPdoCSP:
+      return sizeof(TxPdoCSP);
+    case TxPdoTypeEnum::TxPdoCST:
+      return sizeof(TxPdoCST);
+    case TxPdoTypeEnum::TxPdoCSV:
+      return sizeof(TxPdoCSV);
+    case TxPdoTypeEnum::TxPdoCSTCSP:
+      return sizeof(TxPdoCSTCSP);
+    case TxPdoTypeEnum::TxPdoCSTCSPCSV:
+      return sizeof(TxPdoCSTCSPCSV);
+    case TxPdoTypeEnum::TxPdoPVM:
+      return sizeof(TxPdoPVM);
+    default:
+      return 0;
+  }
+}
+
+bool contains(const std::vector<std::string>& names, const std::string& name) {
+  return std::find(names.begin(), names.end(), name) != names.end();
+}
+
+void addUnique(std::vector<std::string>& names, const std::string& name) {
+  if (!contains(names, name)) {
+    names.push_back(name);
+  }
+}
+
+/*!
+ * The targets a mode of operation needs in the Rx PDO.
+ * @return	false if the mode is not cyclic, i.e. has no minimal PDO
+ */
+bool addTargets(ModeOfOperationEnum modeOfOperation,
+                std::vector<std::string>& names) {
+  switch (modeOfOperation) {
+    case ModeOfOperationEnum::CyclicSynchronousPositionMode:
+      addUnique(names, "target_position");
+      return true;
+    case ModeOfOperationEnum::CyclicSynchronousVelocityMode:
+      addUnique(names, "target_velocity");
+      return true;
+    case ModeOfOperationEnum::CyclicSynchronousTorqueMode:
+      addUnique(names, "target_torque");
+      return true;
+    case ModeOfOperationEnum::ProfiledVelocityMode:
+      addUnique(names, "target_velocity");
+      addUnique(names, "profile_acceleration");
+      addUnique(names, "profile_deceleration");
+      addUnique(names, "motion_profile_type");
+      return true;
+    default:
+      return false;
+  }
+}
+
+std::size_t getRxObjectsSize(const std::vector<std::string>& names) {
+  CustomPdo pdo;
+  for (const auto& name : names) {
+    pdo.addRxObject(name);
+  }
+  return pdo.getSize();
+}
+
+std::size_t getTxObjectsSize(const std::vector<std::string>& names) {
+  CustomPdo pdo;
+  for (const auto& name : names) {
+    pdo.addTxObject(name);
+  }
+  return pdo.getSize();
+}
+}  // namespace
+
+PdoPlan planPdoMapping(
+    const Configuration& configuration,
+    const std::pair<RxPdoTypeEnum, TxPdoTypeEnum>& pdoTypeSolution) {
+  PdoPlan plan;
+  plan.rxPdoType_ = pdoTypeSolution.first;
+  plan.txPdoType_ = pdoTypeSolution.second;
+  plan.defaultRxSize_ = getRxPdoSize(pdoTypeSolution.first);
+  plan.defaultTxSize_ = getTxPdoSize(pdoTypeSolution.second);
+
+  std::vector<std::string> rxObjects;
+  std::vector<std::string> txObjects;
+  if (configuration.minimizePdoMapping &&
+      pdoTypeSolution.first != RxPdoTypeEnum::NA) {
+    const auto rxObjectNames = CustomPdo::getRxObjectNames();
+    const auto txObjectNames = CustomPdo::getTxObjectNames();
+    rxObjects.emplace_back("controlword");
+    if (configuration.modesOfOperation.size() > 1) {
+      rxObjects.emplace_back("mode_of_operation");
+    }
+    bool cyclic = true;
+    for (const auto modeOfOperation : configuration.modesOfOperation) {
+      cyclic &= addTargets(modeOfOperation, rxObjects);
+    }
+    for (const auto& name : configuration.usedPdoObjects) {
+      if (contains(rxObjectNames, name)) {
+        addUnique(rxObjects, name);
+      } else if (contains(txObjectNames, name)) {
+        if (txObjects.empty()) {
+          txObjects.emplace_back("statusword");
+        }
+        addUnique(txObjects, name);
+      }
+    }
+    if (!cyclic) {
+      rxObjects.clear();
+      txObjects.clear();
+    }
+  }
+  // the objects of the configuration take precedence
+  if (!configuration.customRxPdo.empty()) {
+    rxObjects = configuration.customRxPdo;
+  }
+  if (!configuration.customTxPdo.empty()) {
+    txObjects = configuration.customTxPdo;
+  }
+
+  plan.rxSize_ = plan.defaultRxSize_;
+  if (!rxObjects.empty()) {
+    plan.rxPdoType_ = RxPdoTypeEnum::RxPdoCustom;
+    plan.rxObjects_ = rxObjects;
+    plan.rxSize_ = getRxObjectsSize(rxObjects);
+  }
+  plan.txSize_ = plan.defaultTxSize_;
+  if (!txObjects.empty()) {
+    plan.txPdoType_ = TxPdoTypeEnum::TxPdoCustom;
+    plan.txObjects_ = txObjects;
+    plan.txSize_ = getTxObjectsSize(txObjects);
+  }
+  return plan;
+}
+
+BusPlan planBus(const std::vector<PdoPlan>& plans, unsigned int cycleTime,
+                bool distributedClock) {
+  BusPlan busPlan;
+  busPlan.numberOfDrives_ = plans.size();
+  busPlan.cycleTime_ = cycleTime;
+  for (const auto& plan : plans) {
+    busPlan.rxSize_ += plan.rxSize_;
+    busPlan.txSize_ += plan.txSize_;
+    busPlan.defaultRxSize_ += plan.defaultRxSize_;
+    busPlan.defaultTxSize_ += plan.defaultTxSize_;
+  }
+
+  // outputs and inputs share the logical address space of one LRW, which is
+  // split into as many frames as required
+  std::size_t remainingData = busPlan.rxSize_ + busPlan.txSize_;
+  std::size_t extraDatagrams = distributedClock ? distributedClockDatagramSize
+                                                : 0;
+  do {
+    const std::size_t capacity = maxEthernetPayload - ethercatHeaderSize -
+                                 datagramOverhead - extraDatagrams;
+    const std::size_t data = std::min(remainingData, capacity);
+    const std::size_t payload =
+        ethercatHeaderSize + extraDatagrams + datagramOverhead + data;
+    busPlan.wireSize_ +=
+        ethernetOverhead + std::max(payload, minEthernetPayload);
+    busPlan.numberOfFrames_++;
+    remainingData -= data;
+    extraDatagrams = 0;
+  } while (remainingData > 0);
+
+  // the frames are sent back to back, the last one returns after passing
+  // through all slaves
+  busPlan.frameTime_ = byteTime * busPlan.wireSize_ +
+                       slaveForwardingDelay * busPlan.numberOfDrives_;
+  if (cycleTime > 0) {
+    busPlan.utilization_ = busPlan.frameTime_ / cycleTime;
+  }
+  return busPlan;
+}
+
+std::ostream& operator<<(std::ostream& os, const PdoPlan& plan) {
+  // the operators of the PDO type enums are declared in the global namespace
+  using ::operator<<;
+  os << "Rx " << plan.rxSize_ << " bytes (" << plan.rxPdoType_;
+  for (const auto& name : plan.rxObjects_) {
+    os << (&name == &plan.rxObjects_.front() ? ": " : ", ") << name;
+  }
+  os << "), Tx " << plan.txSize_ << " bytes (" << plan.txPdoType_;
+  for (const auto& name : plan.txObjects_) {
+    os << (&name == &plan.txObjects_.front() ? ": " : ", ") << name;
+  }
+  os << "), derived from the modes: Rx " << plan.defaultRxSize_
+     << " bytes, Tx " << plan.defaultTxSize_ << " bytes";
+  return os;
+}
+
+std::ostream& operator<<(std::ostream& os, const BusPlan& plan) {
+  // the format of the caller is restored at the end
+  const std::ios_base::fmtflags flags = os.flags();
+  const std::streamsize precision = os.precision();
+  os << plan.numberOfDrives_ << " drives, Rx " << plan.rxSize_
+     << " bytes, Tx " << plan.txSize_ << " bytes (derived from the modes: "
+     << plan.defaultRxSize_ << " / " << plan.defaultTxSize_ << " bytes), "
+     << plan.numberOfFrames_ << " frame(s) of " << plan.wireSize_
+     << " bytes on the wire, estimated frame time " << std::fixed
+     << std::setprecision(1) << plan.frameTime_ << " us";
+  if (plan.cycleTime_ > 0) {
+    os << " = " << 100 * plan.utilization_ << " % of the cycle time of "
+       << plan.cycleTime_ << " us";
+  }
+  os.flags(flags);
+  os.precision(precision);
+  return os;
+}
+
+}  // namespace maxon
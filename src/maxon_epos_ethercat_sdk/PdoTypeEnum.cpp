@@ -50,6 +50,18 @@ std::ostream& operator<<(std::ostream& os,
     case maxon::TxPdoTypeEnum::TxPdoCSV:
       os << "TxPdoCSV";
       break;
+    case maxon::TxPdoTypeEnum::TxPdoCSTCSP:
+      os << "TxPdoCSTCSP";
+      break;
+    case maxon::TxPdoTypeEnum::TxPdoCSTCSPCSV:
+      os << "TxPdoCSTCSPCSV";
+      break;
+    case maxon::TxPdoTypeEnum::TxPdoPVM:
+      os << "TxPdoPVM";
+      break;
+    case maxon::TxPdoTypeEnum::TxPdoCustom:
+      os << "TxPdoCustom";
+      break;
     default:
       break;
   }
@@ -73,9 +85,18 @@ std::ostream& operator<<(std::ostream& os,
     case maxon::RxPdoTypeEnum::RxPdoCSV:
       os << "RxPdoCSV";
       break;
+    case maxon::RxPdoTypeEnum::RxPdoCSTCSP:
+      os << "RxPdoCSTCSP";
+      break;
+    case maxon::RxPdoTypeEnum::RxPdoCSTCSPCSV:
+      os << "RxPdoCSTCSPCSV";
+      break;
     case maxon::RxPdoTypeEnum::RxPdoPVM:
       os << "RxPdoPVM";
       break;
+    case maxon::RxPdoTypeEnum::RxPdoCustom:
+      os << "RxPdoCustom";
+      break;
     default:
       break;
   }
@@ -33,6 +33,7 @@
 #define _USE_MATH_DEFINES  // for M_PI
 #include <cmath>
 
+#include "maxon_epos_ethercat_sdk/ConversionFactors.hpp"
 #include "maxon_epos_ethercat_sdk/Reading.hpp"
 
 std::ostream& operator<<(std::ostream& os, const maxon::Reading& reading) {
@@ -56,8 +57,9 @@ std::ostream& operator<<(std::ostream& os, const maxon::Reading& reading) {
 namespace maxon {
 std::string Reading::getDigitalInputString() const {
   std::string binString;
-  for (unsigned int i = 0; i < 8 * sizeof(digitalInputs_); i++) {
-    if ((digitalInputs_ & (1 << (8 * sizeof(digitalInputs_) - 1 - i))) != 0) {
+  const int32_t digitalInputs = snapshot_.digitalInputs_;
+  for (unsigned int i = 0; i < 8 * sizeof(digitalInputs); i++) {
+    if ((digitalInputs & (1 << (8 * sizeof(digitalInputs) - 1 - i))) != 0) {
       binString += "1";
     } else {
       binString += "0";
@@ -71,82 +73,103 @@ std::string Reading::getDigitalInputString() const {
 }
 
 DriveState Reading::getDriveState() const {
-  return getStatusword().getDriveState();
+  return snapshot_.decodedStatusword_.driveState_;
+}
+
+const DecodedStatusword& Reading::getDecodedStatusword() const {
+  return snapshot_.decodedStatusword_;
 }
 
 double Reading::getAgeOfLastReadingInMicroseconds() const {
-  ReadingDuration readingDuration = ReadingClock::now() - lastReadingTimePoint_;
+  const std::chrono::duration<double, std::micro> readingDuration =
+      ReadingClock::now() - snapshot_.timePoint_;
   return readingDuration.count();
 }
 
 /*!
  * Raw get methods
  */
-int32_t Reading::getActualPositionRaw() const { return actualPosition_; }
-int32_t Reading::getActualVelocityRaw() const { return actualVelocity_; }
-uint16_t Reading::getRawStatusword() const { return statusword_; }
-int16_t Reading::getActualCurrentRaw() const { return actualCurrent_; }
-uint16_t Reading::getAnalogInputRaw() const { return analogInput_; }
-uint32_t Reading::getBusVoltageRaw() const { return busVoltage_; }
+int32_t Reading::getActualPositionRaw() const {
+  return snapshot_.actualPosition_;
+}
+int32_t Reading::getActualVelocityRaw() const {
+  return snapshot_.actualVelocity_;
+}
+uint16_t Reading::getRawStatusword() const { return snapshot_.statusword_; }
+int16_t Reading::getActualCurrentRaw() const {
+  return snapshot_.actualCurrent_;
+}
+uint16_t Reading::getAnalogInputRaw() const { return snapshot_.analogInput_; }
+uint32_t Reading::getBusVoltageRaw() const { return snapshot_.busVoltage_; }
 
 /*!
  * User unit get methods
  */
 double Reading::getActualPosition() const {
-  return static_cast<double>(actualPosition_) * positionFactorIntegerToRad_;
+  return static_cast<double>(snapshot_.actualPosition_) *
+         positionFactorIntegerToRad_;
 }
 double Reading::getActualVelocity() const {
-  return static_cast<double>(actualVelocity_) *
+  return static_cast<double>(snapshot_.actualVelocity_) *
          velocityFactorMicroRPMToRadPerSec_;
 }
 double Reading::getActualCurrent() const {
-  return static_cast<double>(actualCurrent_) * currentFactorIntegerToAmp_;
+  return static_cast<double>(snapshot_.actualCurrent_) *
+         currentFactorIntegerToAmp_;
 }
 double Reading::getActualTorque() const {
-  return static_cast<double>(actualCurrent_) * torqueFactorIntegerToNm_;
+  return static_cast<double>(snapshot_.actualCurrent_) *
+         torqueFactorIntegerToNm_;
 }
 double Reading::getAnalogInput() const {
-  return static_cast<double>(analogInput_) * 0.001;
+  return static_cast<double>(snapshot_.analogInput_) * 0.001;
 }
 
 /*!
  * Other readings
  */
-int32_t Reading::getDigitalInputs() const { return digitalInputs_; }
+int32_t Reading::getDigitalInputs() const { return snapshot_.digitalInputs_; }
 Statusword Reading::getStatusword() const {
   Statusword statusword;
-  statusword.setFromRawStatusword(statusword_);
+  statusword.setFromRawStatusword(snapshot_.statusword_);
   return statusword;
 }
 double Reading::getBusVoltage() const {
-  return 0.001 * static_cast<double>(busVoltage_);
+  // power supply voltage (0x2200 sub 1) is given in 0.1 V
+  return 0.1 * static_cast<double>(snapshot_.busVoltage_);
 }
 
 /*!
  * Raw set methods
  */
 void Reading::setActualPosition(int32_t actualPosition) {
-  actualPosition_ = actualPosition;
+  snapshot_.actualPosition_ = actualPosition;
 }
 void Reading::setDigitalInputs(int32_t digitalInputs) {
-  digitalInputs_ = digitalInputs;
+  snapshot_.digitalInputs_ = digitalInputs;
 }
 void Reading::setActualVelocity(int32_t actualVelocity) {
-  actualVelocity_ = actualVelocity;
+  snapshot_.actualVelocity_ = actualVelocity;
 }
 void Reading::setDemandVelocity(int32_t demandVelocity) {
-  demandVelocity_ = demandVelocity;
+  snapshot_.demandVelocity_ = demandVelocity;
+}
+void Reading::setStatusword(uint16_t statusword) {
+  snapshot_.decodedStatusword_ =
+      decodeStatusword(statusword, snapshot_.statusword_);
+  snapshot_.statusword_ = statusword;
 }
-void Reading::setStatusword(uint16_t statusword) { statusword_ = statusword; }
 
 void Reading::setAnalogInput(int16_t analogInput) {
-  analogInput_ = analogInput;
+  snapshot_.analogInput_ = analogInput;
 }
 void Reading::setActualCurrent(int16_t actualCurrent) {
-  actualCurrent_ = actualCurrent;
+  snapshot_.actualCurrent_ = actualCurrent;
+}
+void Reading::setBusVoltage(uint32_t busVoltage) {
+  snapshot_.busVoltage_ = busVoltage;
 }
-void Reading::setBusVoltage(uint32_t busVoltage) { busVoltage_ = busVoltage; }
-void Reading::setTimePointNow() { lastReadingTimePoint_ = ReadingClock::now(); }
+void Reading::setTimePointNow() { snapshot_.timePoint_ = ReadingClock::now(); }
 
 void Reading::setPositionFactorIntegerToRad(double positionFactor) {
   positionFactorIntegerToRad_ = positionFactor;
@@ -158,6 +181,14 @@ void Reading::setTorqueFactorIntegerToNm(double torqueFactor) {
   torqueFactorIntegerToNm_ = torqueFactor;
 }
 
+const ReadingSnapshot& Reading::getSnapshot() const { return snapshot_; }
+void Reading::setSnapshot(const ReadingSnapshot& snapshot) {
+  snapshot_ = snapshot;
+}
+uint64_t Reading::getSequenceNumber() const {
+  return snapshot_.sequenceNumber_;
+}
+
 double Reading::getAgeOfLastErrorInMicroseconds() const {
   ReadingDuration errorDuration = ReadingClock::now() - lastError_.second;
   return errorDuration.count();
@@ -169,44 +200,36 @@ double Reading::getAgeOfLastFaultInMicroseconds() const {
 }
 
 void Reading::addError(ErrorType errorType) {
+  addError(errorType, ReadingClock::now());
+}
+
+void Reading::addError(ErrorType errorType, ReadingTimePoint timePoint) {
   ErrorPair errorPair;
   errorPair.first = errorType;
-  errorPair.second = ReadingClock::now();
-  if (lastError_.first == errorType) {
-    if (forceAppendEqualError_) {
-      errors_.push_front(errorPair);
-    } else {
-      errors_.pop_front();
-      errors_.push_front(errorPair);
-    }
+  errorPair.second = timePoint;
+  if (lastError_.first == errorType && !forceAppendEqualError_) {
+    errors_.replaceFront(errorPair);
   } else {
-    errors_.push_front(errorPair);
+    errors_.pushFront(errorPair);
   }
   lastError_ = errorPair;
-  if (errors_.size() > errorStorageCapacity_) {
-    errors_.pop_back();
-  }
   hasUnreadError_ = true;
 }
 
 void Reading::addFault(uint16_t faultCode) {
+  addFault(faultCode, ReadingClock::now());
+}
+
+void Reading::addFault(uint16_t faultCode, ReadingTimePoint timePoint) {
   FaultPair faultPair;
   faultPair.first = faultCode;
-  faultPair.second = ReadingClock::now();
-  if (lastFault_.first == faultCode) {
-    if (forceAppendEqualFault_) {
-      faults_.push_front(faultPair);
-    } else {
-      faults_.pop_front();
-      faults_.push_front(faultPair);
-    }
+  faultPair.second = timePoint;
+  if (lastFault_.first == faultCode && !forceAppendEqualFault_) {
+    faults_.replaceFront(faultPair);
   } else {
-    faults_.push_front(faultPair);
+    faults_.pushFront(faultPair);
   }
   lastFault_ = faultPair;
-  if (faults_.size() > faultStorageCapacity_) {
-    faults_.pop_back();
-  }
   hasUnreadFault_ = true;
 }
 
@@ -238,6 +261,19 @@ FaultTimePairDeque Reading::getFaults() const {
   return faults;
 }
 
+unsigned int Reading::getNumberOfErrors() const { return errors_.size(); }
+unsigned int Reading::getNumberOfFaults() const { return faults_.size(); }
+
+std::pair<ErrorType, double> Reading::getError(unsigned int index) const {
+  const ReadingDuration duration = ReadingClock::now() - errors_[index].second;
+  return {errors_[index].first, duration.count()};
+}
+
+std::pair<uint16_t, double> Reading::getFault(unsigned int index) const {
+  const ReadingDuration duration = ReadingClock::now() - faults_[index].second;
+  return {faults_[index].first, duration.count()};
+}
+
 ErrorType Reading::getLastError() const {
   hasUnreadError_ = false;
   return lastError_.first;
@@ -251,20 +287,25 @@ uint16_t Reading::getLastFault() const {
   return lastFault_.first;
 }
 
+Reading::Reading(unsigned int errorStorageCapacity,
+                 unsigned int faultStorageCapacity, bool forceAppendEqualError,
+                 bool forceAppendEqualFault)
+    : errors_(errorStorageCapacity),
+      faults_(faultStorageCapacity),
+      forceAppendEqualError_(forceAppendEqualError),
+      forceAppendEqualFault_(forceAppendEqualFault) {}
+
 void Reading::configureReading(const Configuration& configuration) {
-  errorStorageCapacity_ = configuration.errorStorageCapacity;
-  faultStorageCapacity_ = configuration.faultStorageCapacity;
+  // allocates only if the capacities change
+  errors_.setCapacity(configuration.errorStorageCapacity);
+  faults_.setCapacity(configuration.faultStorageCapacity);
   forceAppendEqualError_ = configuration.forceAppendEqualError;
   forceAppendEqualFault_ = configuration.forceAppendEqualFault;
 
-  double currentFactor = configuration.nominalCurrentA / 1000.0;
-
-  currentFactorIntegerToAmp_ = currentFactor;
-  positionFactorIntegerToRad_ =
-      (2.0 * M_PI) /
-      static_cast<double>(configuration.positionEncoderResolution);
-  torqueFactorIntegerToNm_ =
-      configuration.nominalCurrentA * configuration.torqueConstantNmA / 1000.0;
+  const ConversionFactors conversionFactors(configuration);
+  currentFactorIntegerToAmp_ = conversionFactors.currentFactorIntegerToAmp_;
+  positionFactorIntegerToRad_ = conversionFactors.positionFactorIntegerToRad_;
+  torqueFactorIntegerToNm_ = conversionFactors.torqueFactorIntegerToNm_;
 }
 
 }  // namespace maxon
@@ -0,0 +1,184 @@
+// clang-format off
+/*
+** Copyright 2021 Robotic Systems Lab - ETH Zurich:
+** Linghao Zhang, Jonas Junger, Lennart Nachtigall
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions are met:
+**
+** 1. Redistributions of source code must retain the above copyright notice,
+**    this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright notice,
+**    this list of conditions and the following disclaimer in the documentation
+**    and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its contributors
+**    may be used to endorse or promote products derived from this software without
+**    specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+** AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+** IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+** DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+** FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+** DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+** SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+** CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+** OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+// clang-format on
+
+#include "maxon_epos_ethercat_sdk/ReadingEvents.hpp"
+
+#include <algorithm>
+
+#include "maxon_epos_ethercat_sdk/RtAudit.hpp"
+
+namespace maxon {
+std::string getReadingEventTypeString(ReadingEventType type) {
+  switch (type) {
+    case ReadingEventType::StatuswordChanged:
+      return "StatuswordChanged";
+    case ReadingEventType::DriveStateChanged:
+      return "DriveStateChanged";
+    case ReadingEventType::Error:
+      return "Error";
+    case ReadingEventType::Fault:
+      return "Fault";
+    case ReadingEventType::ThresholdCrossed:
+      return "ThresholdCrossed";
+    case ReadingEventType::LimitViolation:
+      return "LimitViolation";
+    default:
+      return "NA";
+  }
+}
+
+namespace {
+// factor from user units to raw values
+double getRawFactor(ReadingQuantity quantity,
+                    const ConversionFactors& conversionFactors) {
+  switch (quantity) {
+    case ReadingQuantity::ActualPosition:
+      return conversionFactors.positionFactorRadToInteger_;
+    case ReadingQuantity::ActualVelocity:
+    case ReadingQuantity::DemandVelocity:
+      return ConversionFactors::velocityFactorRadPerSecToMicroRPM_;
+    case ReadingQuantity::ActualCurrent:
+      return conversionFactors.currentFactorAToInteger_;
+    case ReadingQuantity::ActualTorque:
+      return conversionFactors.torqueFactorNmToInteger_;
+    case ReadingQuantity::AnalogInput:
+      return 1000.0;
+    case ReadingQuantity::BusVoltage:
+      return 10.0;
+    default:
+      return 1.0;
+  }
+}
+
+int64_t getRawValue(ReadingQuantity quantity,
+                    const ReadingSnapshot& snapshot) {
+  switch (quantity) {
+    case ReadingQuantity::ActualPosition:
+      return snapshot.actualPosition_;
+    case ReadingQuantity::ActualVelocity:
+      return snapshot.actualVelocity_;
+    case ReadingQuantity::DemandVelocity:
+      return snapshot.demandVelocity_;
+    case ReadingQuantity::ActualCurrent:
+    case ReadingQuantity::ActualTorque:
+      return snapshot.actualCurrent_;
+    case ReadingQuantity::AnalogInput:
+      return snapshot.analogInput_;
+    case ReadingQuantity::BusVoltage:
+      return snapshot.busVoltage_;
+    default:
+      return 0;
+  }
+}
+}  // namespace
+
+ReadingSubscription::ReadingSubscription(
+    uint32_t eventMask, const std::vector<ReadingThreshold>& thresholds)
+    : eventMask_(eventMask) {
+  thresholds_.reserve(thresholds.size());
+  for (const auto& threshold : thresholds) {
+    thresholds_.push_back({threshold.quantity_, threshold.threshold_, 0.0});
+  }
+}
+
+bool ReadingSubscription::waitPop(ReadingEvent& event,
+                                  std::chrono::microseconds timeout) {
+  if (tryPop(event)) {
+    return true;
+  }
+
+  // The producer notifies without taking the mutex, such that it never
+  // blocks. A notification between tryPop() and wait_for() can therefore be
+  // missed, waiting in short slices bounds the delay in that case.
+  const auto deadline = std::chrono::steady_clock::now() + timeout;
+  waiters_.fetch_add(1, std::memory_order_seq_cst);
+  std::unique_lock<std::mutex> lock(waitMutex_);
+  bool success = false;
+  while (!(success = tryPop(event))) {
+    const auto now = std::chrono::steady_clock::now();
+    if (now >= deadline) {
+      break;
+    }
+    waitCondition_.wait_for(
+        lock, std::min<std::chrono::steady_clock::duration>(
+                  deadline - now, std::chrono::milliseconds(1)));
+  }
+  waiters_.fetch_sub(1, std::memory_order_relaxed);
+  return success;
+}
+
+void ReadingSubscription::push(const ReadingEvent& event) {
+  if (!queue_.tryPush(event)) {
+    droppedEvents_.fetch_add(1, std::memory_order_relaxed);
+    return;
+  }
+  if (waiters_.load(std::memory_order_seq_cst) > 0) {
+    rt_audit::recordBlockingCall("ReadingSubscription::push notify_one");
+    waitCondition_.notify_one();
+  }
+}
+
+void ReadingSubscription::checkThresholds(
+    const ReadingSnapshot& snapshot, uint32_t address,
+    const ConversionFactors& conversionFactors,
+    uint64_t conversionFactorsVersion) {
+  if (!hasRawThresholds_ ||
+      conversionFactorsVersion != conversionFactorsVersion_) {
+    for (RawThreshold& threshold : thresholds_) {
+      threshold.rawThreshold_ =
+          threshold.threshold_ *
+          getRawFactor(threshold.quantity_, conversionFactors);
+    }
+    conversionFactorsVersion_ = conversionFactorsVersion;
+    hasRawThresholds_ = true;
+  }
+
+  for (std::size_t i = 0; i < thresholds_.size(); i++) {
+    RawThreshold& threshold = thresholds_[i];
+    const int64_t value = getRawValue(threshold.quantity_, snapshot);
+    const int8_t state = static_cast<double>(value) > threshold.rawThreshold_;
+    if (threshold.state_ >= 0 && state != threshold.state_) {
+      ReadingEvent event;
+      event.type_ = ReadingEventType::ThresholdCrossed;
+      event.index_ = i;
+      event.rising_ = state != 0;
+      event.address_ = address;
+      event.value_ = value;
+      event.sequenceNumber_ = snapshot.sequenceNumber_;
+      event.timePoint_ = snapshot.timePoint_;
+      push(event);
+    }
+    threshold.state_ = state;
+  }
+}
+
+}  // namespace maxon
@@ -0,0 +1,248 @@
+// clang-format off
+/*
+** Copyright 2021 Robotic Systems Lab - ETH Zurich:
+** Linghao Zhang, Jonas Junger, Lennart Nachtigall
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions are met:
+**
+** 1. Redistributions of source code must retain the above copyright notice,
+**    this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright notice,
+**    this list of conditions and the following disclaimer in the documentation
+**    and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its contributors
+**    may be used to endorse or promote products derived from this software without
+**    specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+** AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+** IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+** DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+** FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+** DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+** SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+** CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+** OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+// clang-format on
+
+#include "maxon_epos_ethercat_sdk/RtAudit.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <iomanip>
+
+namespace maxon {
+namespace {
+/*!
+ * The audit of the current thread. Constant initialized, such that the hooks
+ * can be called from operator new at any time.
+ */
+struct RtAuditContext {
+  RtAudit* audit_;
+  const char* scope_;
+  const char* driveName_;
+  const char* site_;
+  // set while an event is recorded, e.g. if the handler allocates
+  bool recording_;
+};
+
+thread_local RtAuditContext context{nullptr, "", "", "", false};
+}  // namespace
+
+std::string getRtAuditEventTypeString(RtAuditEventType type) {
+  switch (type) {
+    case RtAuditEventType::Allocation:
+      return "allocation";
+    case RtAuditEventType::Lock:
+      return "lock";
+    case RtAuditEventType::BlockingCall:
+      return "blocking call";
+    default:
+      return "unknown";
+  }
+}
+
+std::ostream& operator<<(std::ostream& os, const RtAuditViolation& violation) {
+  os << getRtAuditEventTypeString(violation.type_) << " #" << violation.count_
+     << " in cycle " << violation.cycle_ << " of '" << violation.driveName_
+     << "' (" << violation.scope_;
+  if (violation.site_[0] != '\0') {
+    os << ", " << violation.site_;
+  }
+  os << ")";
+  return os;
+}
+
+std::ostream& operator<<(std::ostream& os,
+                         const RtAuditStatistics& statistics) {
+  os << std::left << std::setw(16) << "" << std::setw(12) << "total"
+     << std::setw(12) << "max/cycle"
+     << "\n";
+  for (std::size_t i = 0; i < numberOfRtAuditEventTypes; i++) {
+    os << std::setw(16)
+       << getRtAuditEventTypeString(static_cast<RtAuditEventType>(i))
+       << std::setw(12) << statistics.total_[i] << std::setw(12)
+       << statistics.maxPerCycle_[i] << "\n";
+  }
+  os << std::setw(16) << "cycles" << statistics.numberOfCycles_ << "\n"
+     << std::setw(16) << "violating" << statistics.numberOfViolatingCycles_
+     << "\n";
+  if (statistics.numberOfViolations_ > 0) {
+    os << std::setw(16) << "first" << statistics.firstViolation_ << "\n"
+       << std::setw(16) << "last" << statistics.lastViolation_ << "\n";
+  }
+  os << std::right;
+  return os;
+}
+
+RtAudit::RtAudit() {
+  for (auto& allowed : allowed_) {
+    allowed.store(0, std::memory_order_relaxed);
+  }
+  setAllowedPerCycle(RtAuditEventType::Lock, defaultAllowedLocksPerCycle);
+}
+
+void RtAudit::setAllowedPerCycle(RtAuditEventType type, uint64_t allowed) {
+  if (type < RtAuditEventType::NumberOfTypes) {
+    allowed_[static_cast<std::size_t>(type)].store(allowed,
+                                                   std::memory_order_relaxed);
+  }
+}
+
+void RtAudit::setViolationHandler(ViolationHandler handler) {
+  violationHandler_.store(handler, std::memory_order_release);
+}
+
+void RtAudit::abortOnViolation(const RtAuditViolation& violation) {
+  std::fprintf(stderr,
+               "[maxon_epos_ethercat_sdk:RtAudit::abortOnViolation] "
+               "Real-time violation: %s #%llu in cycle %llu of '%s' (%s, %s)\n",
+               getRtAuditEventTypeString(violation.type_).c_str(),
+               static_cast<unsigned long long>(violation.count_),
+               static_cast<unsigned long long>(violation.cycle_),
+               violation.driveName_, violation.scope_, violation.site_);
+  std::abort();
+}
+
+RtAuditStatistics RtAudit::getStatistics() const {
+  return publishedStatistics_.read();
+}
+
+void RtAudit::reset() {
+  resetRequested_.store(true, std::memory_order_relaxed);
+}
+
+void RtAudit::beginCycle() {
+  if (resetRequested_.exchange(false, std::memory_order_relaxed)) {
+    statistics_ = RtAuditStatistics();
+  }
+  cycleCounts_.fill(0);
+  cycleViolated_ = false;
+  statistics_.numberOfCycles_++;
+}
+
+void RtAudit::record(RtAuditEventType type, const char* site,
+                     const char* scope, const char* driveName) {
+  const auto index = static_cast<std::size_t>(type);
+  statistics_.total_[index]++;
+  const uint64_t count = ++cycleCounts_[index];
+  statistics_.maxPerCycle_[index] =
+      std::max(statistics_.maxPerCycle_[index], count);
+  if (count <= allowed_[index].load(std::memory_order_relaxed)) {
+    return;
+  }
+  RtAuditViolation violation;
+  violation.type_ = type;
+  violation.site_ = site;
+  violation.scope_ = scope;
+  violation.driveName_ = driveName;
+  violation.cycle_ = statistics_.numberOfCycles_;
+  violation.count_ = count;
+  if (statistics_.numberOfViolations_++ == 0) {
+    statistics_.firstViolation_ = violation;
+  }
+  statistics_.lastViolation_ = violation;
+  if (!cycleViolated_) {
+    statistics_.numberOfViolatingCycles_++;
+    cycleViolated_ = true;
+  }
+  const ViolationHandler handler =
+      violationHandler_.load(std::memory_order_acquire);
+  if (handler != nullptr) {
+    handler(violation);
+  }
+}
+
+void RtAudit::recordOnCurrentThread(RtAuditEventType type, const char* site) {
+  if (context.audit_ == nullptr || context.recording_) {
+    return;
+  }
+  context.recording_ = true;
+  context.audit_->record(type, site != nullptr ? site : context.site_,
+                         context.scope_, context.driveName_);
+  context.recording_ = false;
+}
+
+RtAuditScope::RtAuditScope(RtAudit* audit, const char* scope,
+                           const char* driveName, bool beginsCycle)
+    : audit_(audit),
+      previousAudit_(context.audit_),
+      previousScope_(context.scope_),
+      previousDriveName_(context.driveName_),
+      previousSite_(context.site_) {
+  if (audit_ == nullptr) {
+    return;
+  }
+  if (beginsCycle) {
+    audit_->beginCycle();
+  }
+  context.audit_ = audit_;
+  context.scope_ = scope;
+  context.driveName_ = driveName;
+  context.site_ = "";
+}
+
+RtAuditScope::~RtAuditScope() {
+  if (audit_ == nullptr) {
+    return;
+  }
+  context.audit_ = previousAudit_;
+  context.scope_ = previousScope_;
+  context.driveName_ = previousDriveName_;
+  context.site_ = previousSite_;
+  // the SeqLock neither allocates nor locks
+  audit_->publish();
+}
+
+RtAuditSite::RtAuditSite(const char* site) : previousSite_(context.site_) {
+  context.site_ = site;
+}
+
+RtAuditSite::~RtAuditSite() { context.site_ = previousSite_; }
+
+namespace rt_audit {
+bool isActive() { return context.audit_ != nullptr; }
+
+void recordAllocation() {
+  RtAudit::recordOnCurrentThread(RtAuditEventType::Allocation, nullptr);
+}
+
+void recordLock(const char* site, bool contended) {
+  RtAudit::recordOnCurrentThread(RtAuditEventType::Lock, site);
+  if (contended) {
+    RtAudit::recordOnCurrentThread(RtAuditEventType::BlockingCall, site);
+  }
+}
+
+void recordBlockingCall(const char* site) {
+  RtAudit::recordOnCurrentThread(RtAuditEventType::BlockingCall, site);
+}
+}  // namespace rt_audit
+
+}  // namespace maxon
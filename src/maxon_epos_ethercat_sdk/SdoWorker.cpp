@@ -0,0 +1,131 @@
+// clang-format off
+/*
+** Copyright 2021 Robotic Systems Lab - ETH Zurich:
+** Linghao Zhang, Jonas Junger, Lennart Nachtigall
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions are met:
+**
+** 1. Redistributions of source code must retain the above copyright notice,
+**    this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright notice,
+**    this list of conditions and the following disclaimer in the documentation
+**    and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its contributors
+**    may be used to endorse or promote products derived from this software without
+**    specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+** AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+** IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+** DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+** FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+** DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+** SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+** CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+** OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+// clang-format on
+
+#include "maxon_epos_ethercat_sdk/SdoWorker.hpp"
+
+#include <map>
+
+#include "maxon_epos_ethercat_sdk/Maxon.hpp"
+
+namespace maxon {
+SdoWorker::SharedPtr SdoWorker::getInstance(const void* bus) {
+  static std::mutex instancesMutex;
+  static std::map<const void*, std::weak_ptr<SdoWorker>> instances;
+  std::lock_guard<std::mutex> lock(instancesMutex);
+  // drop the entries of the buses whose workers are gone
+  for (auto it = instances.begin(); it != instances.end();) {
+    if (it->first != bus && it->second.expired()) {
+      it = instances.erase(it);
+    } else {
+      ++it;
+    }
+  }
+  SharedPtr instance = instances[bus].lock();
+  if (instance == nullptr) {
+    instance = std::make_shared<SdoWorker>();
+    instances[bus] = instance;
+  }
+  return instance;
+}
+
+SdoWorker::SdoWorker() : thread_(&SdoWorker::run, this) {}
+
+SdoWorker::~SdoWorker() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    running_ = false;
+  }
+  requestCondition_.notify_one();
+  thread_.join();
+}
+
+void SdoWorker::addDevice(Maxon* drive) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  devices_.insert(drive);
+}
+
+void SdoWorker::removeDevice(Maxon* drive) {
+  std::deque<Request> droppedRequests;
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    devices_.erase(drive);
+    for (auto it = requests_.begin(); it != requests_.end();) {
+      if (it->owner_ == drive) {
+        droppedRequests.push_back(std::move(*it));
+        it = requests_.erase(it);
+      } else {
+        ++it;
+      }
+    }
+    doneCondition_.wait(lock, [&]() { return runningOwner_ != drive; });
+  }
+  // complete the futures without touching the drive
+  for (Request& request : droppedRequests) {
+    request.function_(true);
+  }
+}
+
+void SdoWorker::run() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (running_) {
+    // the fault captures of removed drives are skipped
+    Maxon* drive = nullptr;
+    while (faultCaptureRequests_.tryPop(drive)) {
+      if (devices_.count(drive) == 0) {
+        continue;
+      }
+      runningOwner_ = drive;
+      lock.unlock();
+      drive->captureFault();
+      lock.lock();
+      runningOwner_ = nullptr;
+      doneCondition_.notify_all();
+    }
+
+    if (!requests_.empty()) {
+      Request request = std::move(requests_.front());
+      requests_.pop_front();
+      runningOwner_ = request.owner_;
+      lock.unlock();
+      request.function_(false);
+      lock.lock();
+      runningOwner_ = nullptr;
+      doneCondition_.notify_all();
+      continue;
+    }
+
+    // the fault captures are polled, the EtherCAT thread never signals
+    requestCondition_.wait_for(lock, std::chrono::milliseconds(10));
+  }
+}
+
+}  // namespace maxon
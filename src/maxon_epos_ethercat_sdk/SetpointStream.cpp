@@ -0,0 +1,271 @@
+// clang-format off
+/*
+** Copyright 2021 Robotic Systems Lab - ETH Zurich:
+** Linghao Zhang, Jonas Junger, Lennart Nachtigall
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions are met:
+**
+** 1. Redistributions of source code must retain the above copyright notice,
+**    this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright notice,
+**    this list of conditions and the following disclaimer in the documentation
+**    and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its contributors
+**    may be used to endorse or promote products derived from this software without
+**    specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+** AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+** IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+** DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+** FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+** DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+** SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+** CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+** OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+// clang-format on
+
+#include "maxon_epos_ethercat_sdk/SetpointStream.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <limits>
+
+namespace maxon {
+namespace {
+constexpr std::size_t numberOfFields = 6;
+
+// the interpolated fields of a command
+void getFields(const RawCommand& command, double (&fields)[numberOfFields]) {
+  fields[0] = command.targetPosition_;
+  fields[1] = command.targetVelocity_;
+  fields[2] = command.targetTorque_;
+  fields[3] = command.positionOffset_;
+  fields[4] = command.torqueOffset_;
+  fields[5] = command.velocityOffset_;
+}
+
+template <typename Value>
+Value toValue(double value) {
+  return static_cast<Value>(std::llround(
+      std::min(std::max(value,
+                        static_cast<double>(std::numeric_limits<Value>::min())),
+               static_cast<double>(std::numeric_limits<Value>::max()))));
+}
+
+void setFields(const double (&fields)[numberOfFields], RawCommand& command) {
+  command.targetPosition_ = toValue<int32_t>(fields[0]);
+  command.targetVelocity_ = toValue<int32_t>(fields[1]);
+  command.targetTorque_ = toValue<int16_t>(fields[2]);
+  command.positionOffset_ = toValue<int32_t>(fields[3]);
+  command.torqueOffset_ = toValue<int16_t>(fields[4]);
+  command.velocityOffset_ = toValue<int32_t>(fields[5]);
+}
+
+double getSeconds(ReadingTimePoint end, ReadingTimePoint start) {
+  return std::chrono::duration<double>(end - start).count();
+}
+}  // namespace
+
+bool SetpointStream::push(const Setpoint& setpoint) {
+  // the consumer interpolates between neighbours, which must be ordered
+  if (hasLastPushedTimePoint_ &&
+      setpoint.timePoint_ <= lastPushedTimePoint_) {
+    rejectedSetpoints_.fetch_add(1, std::memory_order_relaxed);
+    return false;
+  }
+  QueuedSetpoint queuedSetpoint;
+  queuedSetpoint.setpoint_ = setpoint;
+  queuedSetpoint.generation_ = generation_.load(std::memory_order_relaxed);
+  if (!queue_.tryPush(queuedSetpoint)) {
+    droppedSetpoints_.fetch_add(1, std::memory_order_relaxed);
+    return false;
+  }
+  lastPushedTimePoint_ = setpoint.timePoint_;
+  hasLastPushedTimePoint_ = true;
+  return true;
+}
+
+std::size_t SetpointStream::push(const Setpoint* setpoints,
+                                 std::size_t numberOfSetpoints) {
+  for (std::size_t i = 0; i < numberOfSetpoints; i++) {
+    if (!push(setpoints[i])) {
+      return i;
+    }
+  }
+  return numberOfSetpoints;
+}
+
+void SetpointStream::clear() {
+  hasLastPushedTimePoint_ = false;
+  generation_.fetch_add(1, std::memory_order_release);
+}
+
+bool SetpointStream::update(ReadingTimePoint timePoint, RawCommand& command) {
+  // restart after clear()
+  const uint32_t generation = generation_.load(std::memory_order_acquire);
+  if (generation != consumerGeneration_) {
+    consumerGeneration_ = generation;
+    windowSize_ = 0;
+    hasPrevious_ = false;
+    starving_ = false;
+  }
+  refill();
+
+  // advance to the segment which contains the time point
+  unsigned int numberOfPassedSetpoints = 0;
+  while (windowSize_ >= 2 && window_[1].timePoint_ <= timePoint) {
+    popFront();
+    refill();
+    numberOfPassedSetpoints++;
+  }
+  if (numberOfPassedSetpoints > 1) {
+    skippedSetpoints_.fetch_add(numberOfPassedSetpoints - 1,
+                                std::memory_order_relaxed);
+  }
+  if (windowSize_ == 0 || window_[0].timePoint_ > timePoint) {
+    return false;
+  }
+
+  // hold the last setpoint until a newer one arrives
+  if (windowSize_ == 1 && timePoint > window_[0].timePoint_) {
+    starvedCycles_.fetch_add(1, std::memory_order_relaxed);
+    if (!starving_) {
+      underruns_.fetch_add(1, std::memory_order_relaxed);
+      starving_ = true;
+    }
+  } else {
+    starving_ = false;
+  }
+
+  command = interpolate(timePoint);
+  return true;
+}
+
+void SetpointStream::refill() {
+  QueuedSetpoint queuedSetpoint;
+  while (windowSize_ < window_.size() && queue_.tryPop(queuedSetpoint)) {
+    const auto age = static_cast<int32_t>(queuedSetpoint.generation_ -
+                                          consumerGeneration_);
+    if (age < 0) {
+      // pushed before the last clear()
+      continue;
+    }
+    if (age > 0) {
+      // pushed after a clear() which happened after the check in update()
+      consumerGeneration_ = queuedSetpoint.generation_;
+      windowSize_ = 0;
+      hasPrevious_ = false;
+    }
+    window_[windowSize_++] = queuedSetpoint.setpoint_;
+  }
+}
+
+void SetpointStream::popFront() {
+  previous_ = window_[0];
+  hasPrevious_ = true;
+  for (std::size_t i = 1; i < windowSize_; i++) {
+    window_[i - 1] = window_[i];
+  }
+  windowSize_--;
+}
+
+RawCommand SetpointStream::interpolate(ReadingTimePoint timePoint) const {
+  const Setpoint& start = window_[0];
+  const SetpointInterpolation interpolation = getInterpolation();
+  if (windowSize_ < 2 || interpolation == SetpointInterpolation::None) {
+    return start.command_;
+  }
+  const Setpoint& end = window_[1];
+  const ModeOfOperationEnum modeOfOperation =
+      start.command_.modeOfOperation_;
+  const double duration = getSeconds(end.timePoint_, start.timePoint_);
+  if (end.command_.modeOfOperation_ != modeOfOperation || duration <= 0.0) {
+    return start.command_;
+  }
+  const double s = std::min(
+      std::max(getSeconds(timePoint, start.timePoint_) / duration, 0.0), 1.0);
+
+  double startFields[numberOfFields];
+  double endFields[numberOfFields];
+  double fields[numberOfFields];
+  getFields(start.command_, startFields);
+  getFields(end.command_, endFields);
+
+  if (interpolation == SetpointInterpolation::Linear) {
+    for (std::size_t i = 0; i < numberOfFields; i++) {
+      fields[i] = startFields[i] + s * (endFields[i] - startFields[i]);
+    }
+  } else {
+    // cubic Hermite segment with the tangents of a Catmull-Rom spline, scaled
+    // to the duration of the segment; one sided at the ends of the stream
+    const bool usePrevious =
+        hasPrevious_ &&
+        previous_.command_.modeOfOperation_ == modeOfOperation &&
+        end.timePoint_ > previous_.timePoint_;
+    const bool useNext =
+        windowSize_ >= 3 &&
+        window_[2].command_.modeOfOperation_ == modeOfOperation &&
+        window_[2].timePoint_ > start.timePoint_;
+    double previousFields[numberOfFields];
+    double nextFields[numberOfFields];
+    getFields(usePrevious ? previous_.command_ : start.command_,
+              previousFields);
+    getFields(useNext ? window_[2].command_ : end.command_, nextFields);
+    const double startScale =
+        usePrevious
+            ? duration / getSeconds(end.timePoint_, previous_.timePoint_)
+            : 1.0;
+    const double endScale =
+        useNext ? duration / getSeconds(window_[2].timePoint_,
+                                        start.timePoint_)
+                : 1.0;
+
+    const double s2 = s * s;
+    const double s3 = s2 * s;
+    const double h00 = 2 * s3 - 3 * s2 + 1;
+    const double h10 = s3 - 2 * s2 + s;
+    const double h01 = -2 * s3 + 3 * s2;
+    const double h11 = s3 - s2;
+    for (std::size_t i = 0; i < numberOfFields; i++) {
+      const double startTangent =
+          startScale * (endFields[i] - previousFields[i]);
+      const double endTangent = endScale * (nextFields[i] - startFields[i]);
+      fields[i] = h00 * startFields[i] + h10 * startTangent +
+                  h01 * endFields[i] + h11 * endTangent;
+    }
+  }
+
+  RawCommand command = start.command_;
+  setFields(fields, command);
+  return command;
+}
+
+SetpointStatistics SetpointStream::getStatistics() const {
+  SetpointStatistics statistics;
+  statistics.underruns_ = underruns_.load(std::memory_order_relaxed);
+  statistics.starvedCycles_ = starvedCycles_.load(std::memory_order_relaxed);
+  statistics.droppedSetpoints_ =
+      droppedSetpoints_.load(std::memory_order_relaxed);
+  statistics.rejectedSetpoints_ =
+      rejectedSetpoints_.load(std::memory_order_relaxed);
+  statistics.skippedSetpoints_ =
+      skippedSetpoints_.load(std::memory_order_relaxed);
+  return statistics;
+}
+
+void SetpointStream::resetStatistics() {
+  underruns_.store(0, std::memory_order_relaxed);
+  starvedCycles_.store(0, std::memory_order_relaxed);
+  droppedSetpoints_.store(0, std::memory_order_relaxed);
+  rejectedSetpoints_.store(0, std::memory_order_relaxed);
+  skippedSetpoints_.store(0, std::memory_order_relaxed);
+}
+
+}  // namespace maxon
@@ -0,0 +1,201 @@
+// clang-format off
+/*
+** Copyright 2021 Robotic Systems Lab - ETH Zurich:
+** Linghao Zhang, Jonas Junger, Lennart Nachtigall
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions are met:
+**
+** 1. Redistributions of source code must retain the above copyright notice,
+**    this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright notice,
+**    this list of conditions and the following disclaimer in the documentation
+**    and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its contributors
+**    may be used to endorse or promote products derived from this software without
+**    specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+** AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+** IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+** DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+** FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+** DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+** SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+** CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+** OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+// clang-format on
+
+#include "maxon_epos_ethercat_sdk/SharedMemoryExport.hpp"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+#include <message_logger/message_logger.hpp>
+#include <new>
+
+namespace maxon {
+constexpr uint32_t SharedMemoryHeader::currentVersion;
+
+namespace {
+std::size_t getSegmentSize(uint32_t maxNumberOfDrives) {
+  return sizeof(SharedMemoryHeader) +
+         maxNumberOfDrives * sizeof(SharedMemoryDrive);
+}
+}  // namespace
+
+SharedMemoryExport::SharedMemoryExport(const std::string& name,
+                                       uint32_t maxNumberOfDrives)
+    : name_(name), maxNumberOfDrives_(maxNumberOfDrives) {}
+
+SharedMemoryExport::~SharedMemoryExport() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  close();
+}
+
+bool SharedMemoryExport::open() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (isOpen()) {
+    return true;
+  }
+
+  // a segment of a previous run is replaced, its readers keep the old one
+  ::shm_unlink(name_.c_str());
+  const int fileDescriptor =
+      ::shm_open(name_.c_str(), O_RDWR | O_CREAT | O_EXCL, 0644);
+  size_ = getSegmentSize(maxNumberOfDrives_);
+  if (fileDescriptor < 0 ||
+      ::ftruncate(fileDescriptor, static_cast<off_t>(size_)) != 0) {
+    MELO_ERROR_STREAM(
+        "[maxon_epos_ethercat_sdk:SharedMemoryExport::open] Cannot create '"
+        << name_ << "': " << std::strerror(errno));
+    if (fileDescriptor >= 0) {
+      ::close(fileDescriptor);
+      ::shm_unlink(name_.c_str());
+    }
+    return false;
+  }
+  void* map = ::mmap(nullptr, size_, PROT_READ | PROT_WRITE, MAP_SHARED,
+                     fileDescriptor, 0);
+  ::close(fileDescriptor);
+  if (map == MAP_FAILED) {
+    MELO_ERROR_STREAM(
+        "[maxon_epos_ethercat_sdk:SharedMemoryExport::open] Cannot map '"
+        << name_ << "': " << std::strerror(errno));
+    ::shm_unlink(name_.c_str());
+    return false;
+  }
+  // keep the segment in memory, such that publishing never page faults
+  ::mlock(map, size_);
+
+  auto* bytes = static_cast<uint8_t*>(map);
+  drives_ = reinterpret_cast<SharedMemoryDrive*>(bytes +
+                                                 sizeof(SharedMemoryHeader));
+  for (uint32_t i = 0; i < maxNumberOfDrives_; i++) {
+    new (&drives_[i]) SharedMemoryDrive();
+  }
+  // the header is written last, readers check its magic
+  header_ = new (map) SharedMemoryHeader();
+  header_->maxNumberOfDrives_ = maxNumberOfDrives_;
+  header_->writerProcessId_ = static_cast<int32_t>(::getpid());
+  return true;
+}
+
+void SharedMemoryExport::close() {
+  if (!isOpen()) {
+    return;
+  }
+  ::munmap(header_, size_);
+  ::shm_unlink(name_.c_str());
+  header_ = nullptr;
+  drives_ = nullptr;
+}
+
+int SharedMemoryExport::addDrive(const SharedMemoryDriveInfo& driveInfo) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (!isOpen()) {
+    MELO_ERROR_STREAM(
+        "[maxon_epos_ethercat_sdk:SharedMemoryExport::addDrive] '"
+        << name_ << "' is not open.");
+    return -1;
+  }
+  const uint32_t index =
+      header_->numberOfDrives_.load(std::memory_order_relaxed);
+  if (index >= maxNumberOfDrives_) {
+    MELO_ERROR_STREAM(
+        "[maxon_epos_ethercat_sdk:SharedMemoryExport::addDrive] All "
+        << maxNumberOfDrives_ << " drive slots of '" << name_
+        << "' are used.");
+    return -1;
+  }
+  drives_[index].info_ = driveInfo;
+  header_->numberOfDrives_.store(index + 1, std::memory_order_release);
+  return static_cast<int>(index);
+}
+
+SharedMemoryReader::~SharedMemoryReader() { close(); }
+
+bool SharedMemoryReader::open(const std::string& name) {
+  close();
+  const int fileDescriptor = ::shm_open(name.c_str(), O_RDONLY, 0);
+  struct stat status;
+  if (fileDescriptor < 0 || ::fstat(fileDescriptor, &status) != 0 ||
+      static_cast<std::size_t>(status.st_size) < sizeof(SharedMemoryHeader)) {
+    MELO_ERROR_STREAM("[maxon_epos_ethercat_sdk:SharedMemoryReader::open] "
+                      "Cannot open '"
+                      << name << "': " << std::strerror(errno));
+    if (fileDescriptor >= 0) {
+      ::close(fileDescriptor);
+    }
+    return false;
+  }
+  size_ = static_cast<std::size_t>(status.st_size);
+  void* map = ::mmap(nullptr, size_, PROT_READ, MAP_SHARED, fileDescriptor, 0);
+  ::close(fileDescriptor);
+  if (map == MAP_FAILED) {
+    MELO_ERROR_STREAM(
+        "[maxon_epos_ethercat_sdk:SharedMemoryReader::open] Cannot map '"
+        << name << "': " << std::strerror(errno));
+    return false;
+  }
+
+  const auto* header = static_cast<const SharedMemoryHeader*>(map);
+  const SharedMemoryHeader expectedHeader;
+  if (std::memcmp(header->magic_, expectedHeader.magic_,
+                  sizeof(header->magic_)) != 0 ||
+      header->version_ != expectedHeader.version_ ||
+      header->headerSize_ != expectedHeader.headerSize_ ||
+      header->driveSize_ != expectedHeader.driveSize_ ||
+      header->dataSize_ != expectedHeader.dataSize_ ||
+      size_ < getSegmentSize(header->maxNumberOfDrives_)) {
+    MELO_ERROR_STREAM(
+        "[maxon_epos_ethercat_sdk:SharedMemoryReader::open] '"
+        << name << "' has an incompatible layout (version "
+        << header->version_ << ").");
+    ::munmap(map, size_);
+    return false;
+  }
+  header_ = header;
+  drives_ = reinterpret_cast<const SharedMemoryDrive*>(
+      static_cast<const uint8_t*>(map) + sizeof(SharedMemoryHeader));
+  return true;
+}
+
+void SharedMemoryReader::close() {
+  if (!isOpen()) {
+    return;
+  }
+  ::munmap(const_cast<SharedMemoryHeader*>(header_), size_);
+  header_ = nullptr;
+  drives_ = nullptr;
+}
+
+}  // namespace maxon
@@ -32,6 +32,8 @@
 
 #include "maxon_epos_ethercat_sdk/Statusword.hpp"
 
+#include "maxon_epos_ethercat_sdk/StateTransitionTable.hpp"
+
 namespace maxon {
 std::ostream& operator<<(std::ostream& os, const Statusword& statusword) {
   using std::setfill;
@@ -110,29 +112,9 @@ void Statusword::setFromRawStatusword(uint16_t status) {
 }
 
 DriveState Statusword::getDriveState() const {
-  DriveState driveState = DriveState::NA;
-
-  // MAN-G-DS402 manual page 47
-  if ((rawStatusword_ & 0b0000000001101111) == 0b0000000000000000) {
-    driveState = DriveState::NotReadyToSwitchOn;
-  } else if ((rawStatusword_ & 0b0000000001101111) == 0b00000000001000000) {
-    driveState = DriveState::SwitchOnDisabled;
-  } else if ((rawStatusword_ & 0b0000000001101111) == 0b00000000000100001) {
-    driveState = DriveState::ReadyToSwitchOn;
-  } else if ((rawStatusword_ & 0b0000000001101111) == 0b00000000000100011) {
-    driveState = DriveState::SwitchedOn;
-  } else if ((rawStatusword_ & 0b0000000001101111) == 0b00000000000100111) {
-    driveState = DriveState::OperationEnabled;
-  } else if ((rawStatusword_ & 0b0000000001101111) == 0b00000000000000111) {
-    driveState = DriveState::QuickStopActive;
-  } else if ((rawStatusword_ & 0b0000000001101111) == 0b00000000000001111) {
-    driveState = DriveState::FaultReactionActive;
-  } else if ((rawStatusword_ & 0b0000000001101111) == 0b00000000000001000) {
-    driveState = DriveState::Fault;
-  }
-
-  return driveState;
+  return getDriveStateFromStatusword(rawStatusword_);
 }
+
 std::string Statusword::getDriveStateString() const {
   DriveState driveState = getDriveState();
   switch (driveState) {
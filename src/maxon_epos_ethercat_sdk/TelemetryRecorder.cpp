@@ -0,0 +1,352 @@
+// clang-format off
+/*
+** Copyright 2021 Robotic Systems Lab - ETH Zurich:
+** Linghao Zhang, Jonas Junger, Lennart Nachtigall
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions are met:
+**
+** 1. Redistributions of source code must retain the above copyright notice,
+**    this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright notice,
+**    this list of conditions and the following disclaimer in the documentation
+**    and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its contributors
+**    may be used to endorse or promote products derived from this software without
+**    specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+** AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+** IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+** DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+** FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+** DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+** SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+** CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+** OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+// clang-format on
+
+#include "maxon_epos_ethercat_sdk/TelemetryRecorder.hpp"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <new>
+#include <message_logger/message_logger.hpp>
+
+namespace maxon {
+constexpr std::size_t TelemetryRecorder::queueCapacity;
+
+namespace {
+std::size_t getHeaderSize(std::size_t numberOfDrives) {
+  return sizeof(TelemetryFileHeader) +
+         numberOfDrives * sizeof(TelemetryDriveInfo);
+}
+}  // namespace
+
+TelemetryRecorder::TelemetryRecorder(const std::string& fileName,
+                                     std::size_t maxFileSize,
+                                     unsigned int numberOfFiles)
+    : fileName_(fileName),
+      maxFileSize_(maxFileSize),
+      numberOfFiles_(numberOfFiles > 0 ? numberOfFiles : 1) {}
+
+TelemetryRecorder::~TelemetryRecorder() { stop(); }
+
+bool TelemetryRecorder::addDrive(const TelemetryDriveInfo& driveInfo) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (isRunning()) {
+    MELO_ERROR_STREAM(
+        "[maxon_epos_ethercat_sdk:TelemetryRecorder::addDrive] Drives cannot "
+        "be added while recording.");
+    return false;
+  }
+  driveInfos_.push_back(driveInfo);
+  return true;
+}
+
+bool TelemetryRecorder::start() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (isRunning()) {
+    return true;
+  }
+  if (getHeaderSize(driveInfos_.size()) + sizeof(TelemetryRecord) >
+      maxFileSize_) {
+    MELO_ERROR_STREAM(
+        "[maxon_epos_ethercat_sdk:TelemetryRecorder::start] The file size of "
+        << maxFileSize_ << " bytes is too small.");
+    return false;
+  }
+  fileIndex_ = 0;
+  if (!openFile()) {
+    return false;
+  }
+  running_ = true;
+  thread_ = std::thread(&TelemetryRecorder::run, this);
+  return true;
+}
+
+void TelemetryRecorder::stop() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (!isRunning()) {
+    return;
+  }
+  running_ = false;
+  thread_.join();
+  // records which were pushed while stopping
+  drainQueue();
+  closeFile();
+}
+
+bool TelemetryRecorder::openFile() {
+  const std::string fileName =
+      fileName_ + "." + std::to_string(fileIndex_ % numberOfFiles_);
+  fileDescriptor_ = ::open(fileName.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+  if (fileDescriptor_ < 0 ||
+      ::ftruncate(fileDescriptor_, static_cast<off_t>(maxFileSize_)) != 0) {
+    MELO_ERROR_STREAM(
+        "[maxon_epos_ethercat_sdk:TelemetryRecorder::openFile] Cannot create "
+        "'"
+        << fileName << "': " << std::strerror(errno));
+    if (fileDescriptor_ >= 0) {
+      ::close(fileDescriptor_);
+      fileDescriptor_ = -1;
+    }
+    return false;
+  }
+  void* map = ::mmap(nullptr, maxFileSize_, PROT_READ | PROT_WRITE, MAP_SHARED,
+                     fileDescriptor_, 0);
+  if (map == MAP_FAILED) {
+    MELO_ERROR_STREAM(
+        "[maxon_epos_ethercat_sdk:TelemetryRecorder::openFile] Cannot map '"
+        << fileName << "': " << std::strerror(errno));
+    ::close(fileDescriptor_);
+    fileDescriptor_ = -1;
+    return false;
+  }
+  map_ = static_cast<uint8_t*>(map);
+
+  const std::size_t headerSize = getHeaderSize(driveInfos_.size());
+  header_ = new (map_) TelemetryFileHeader();
+  header_->numberOfDrives_ = static_cast<uint32_t>(driveInfos_.size());
+  if (!driveInfos_.empty()) {
+    std::memcpy(map_ + sizeof(TelemetryFileHeader), driveInfos_.data(),
+                driveInfos_.size() * sizeof(TelemetryDriveInfo));
+  }
+  records_ = reinterpret_cast<TelemetryRecord*>(map_ + headerSize);
+  recordCapacity_ = (maxFileSize_ - headerSize) / sizeof(TelemetryRecord);
+  return true;
+}
+
+bool TelemetryRecorder::retryOpenFile() {
+  uint32_t numberOfSuppressedAttempts = 0;
+  if (!openFileThrottle_.pass(std::chrono::steady_clock::now(),
+                              std::chrono::seconds(1),
+                              numberOfSuppressedAttempts)) {
+    return false;
+  }
+  if (!openFile()) {
+    return false;
+  }
+  MELO_INFO_STREAM(
+      "[maxon_epos_ethercat_sdk:TelemetryRecorder::retryOpenFile] Recording "
+      "to file "
+      << fileIndex_ % numberOfFiles_ << ", "
+      << numberOfUnwrittenRecords_.load(std::memory_order_relaxed)
+      << " records could not be written so far.");
+  return true;
+}
+
+void TelemetryRecorder::closeFile() {
+  if (map_ == nullptr) {
+    return;
+  }
+  const std::size_t usedSize =
+      getHeaderSize(header_->numberOfDrives_) +
+      header_->numberOfRecords_ * sizeof(TelemetryRecord);
+  ::munmap(map_, maxFileSize_);
+  // drop the unused preallocated part of the file
+  if (::ftruncate(fileDescriptor_, static_cast<off_t>(usedSize)) != 0) {
+    MELO_WARN_STREAM(
+        "[maxon_epos_ethercat_sdk:TelemetryRecorder::closeFile] Cannot "
+        "truncate the file: "
+        << std::strerror(errno));
+  }
+  ::close(fileDescriptor_);
+  fileDescriptor_ = -1;
+  map_ = nullptr;
+  header_ = nullptr;
+  records_ = nullptr;
+}
+
+std::size_t TelemetryRecorder::drainQueue() {
+  std::size_t numberOfRecords = 0;
+  TelemetryRecord record;
+  while (queue_.tryPop(record)) {
+    if (map_ == nullptr && !retryOpenFile()) {
+      numberOfUnwrittenRecords_.fetch_add(1, std::memory_order_relaxed);
+      continue;
+    }
+    records_[header_->numberOfRecords_] = record;
+    header_->numberOfRecords_++;
+    numberOfRecords++;
+    if (header_->numberOfRecords_ == recordCapacity_) {
+      closeFile();
+      fileIndex_++;
+      if (!openFile()) {
+        // start the interval of retryOpenFile() with this failure
+        uint32_t numberOfSuppressedAttempts = 0;
+        openFileThrottle_.pass(std::chrono::steady_clock::now(),
+                               std::chrono::seconds(1),
+                               numberOfSuppressedAttempts);
+      }
+    }
+  }
+  numberOfWrittenRecords_.fetch_add(numberOfRecords,
+                                    std::memory_order_relaxed);
+  return numberOfRecords;
+}
+
+void TelemetryRecorder::run() {
+  while (isRunning()) {
+    if (drainQueue() == 0) {
+      // a full queue lasts 8192 records, i.e. several cycles of many drives
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+  }
+}
+
+bool TelemetryDecoder::open(const std::string& fileName) {
+  driveInfos_.clear();
+  drives_.clear();
+  records_.clear();
+
+  std::ifstream file(fileName, std::ios::binary);
+  TelemetryFileHeader header;
+  const TelemetryFileHeader expectedHeader;
+  file.read(reinterpret_cast<char*>(&header), sizeof(header));
+  if (!file ||
+      std::memcmp(header.magic_, expectedHeader.magic_,
+                  sizeof(header.magic_)) != 0 ||
+      header.recordSize_ != expectedHeader.recordSize_ ||
+      header.driveInfoSize_ != expectedHeader.driveInfoSize_) {
+    MELO_ERROR_STREAM(
+        "[maxon_epos_ethercat_sdk:TelemetryDecoder::open] '"
+        << fileName << "' is not a telemetry file of this version.");
+    return false;
+  }
+
+  driveInfos_.resize(header.numberOfDrives_);
+  records_.resize(header.numberOfRecords_);
+  file.read(reinterpret_cast<char*>(driveInfos_.data()),
+            driveInfos_.size() * sizeof(TelemetryDriveInfo));
+  file.read(reinterpret_cast<char*>(records_.data()),
+            records_.size() * sizeof(TelemetryRecord));
+  if (!file) {
+    MELO_ERROR_STREAM("[maxon_epos_ethercat_sdk:TelemetryDecoder::open] '"
+                      << fileName << "' is truncated.");
+    return false;
+  }
+
+  for (const auto& driveInfo : driveInfos_) {
+    Drive drive;
+    for (uint32_t i = 0; i < driveInfo.rxPdoMappingSize_; i++) {
+      drive.rxPdo_.addRxObject(driveInfo.rxPdoMapping_[i]);
+    }
+    for (uint32_t i = 0; i < driveInfo.txPdoMappingSize_; i++) {
+      drive.txPdo_.addTxObject(driveInfo.txPdoMapping_[i]);
+    }
+    drives_.push_back(drive);
+  }
+  return true;
+}
+
+bool TelemetryDecoder::decode(std::size_t i, TelemetrySample& sample) const {
+  const TelemetryRecord& record = records_[i];
+  std::size_t driveIndex = 0;
+  while (driveIndex < driveInfos_.size() &&
+         driveInfos_[driveIndex].address_ != record.address_) {
+    driveIndex++;
+  }
+  if (driveIndex == driveInfos_.size()) {
+    return false;
+  }
+  const ConversionFactors& factors =
+      driveInfos_[driveIndex].conversionFactors_;
+  const Drive& drive = drives_[driveIndex];
+
+  CustomRxPdoSource rxPdo;
+  ReadingSnapshot txPdo;
+  drive.rxPdo_.decode(record.rxPdo_, rxPdo);
+  drive.txPdo_.decode(record.txPdo_, txPdo);
+
+  sample.timeStamp_ = record.timeStamp_;
+  sample.sequenceNumber_ = record.sequenceNumber_;
+  sample.address_ = record.address_;
+  sample.controlword_ = record.controlword_;
+  sample.statusword_ = record.statusword_;
+  sample.modeOfOperation_ = rxPdo.command_.modeOfOperation_;
+
+  const RawCommand& command = rxPdo.command_;
+  const double positionFactor = factors.positionFactorIntegerToRad_;
+  const double velocityFactor =
+      ConversionFactors::velocityFactorMicroRPMToRadPerSec_;
+  const double torqueFactor = factors.torqueFactorIntegerToNm_;
+  sample.targetPosition_ = command.targetPosition_ * positionFactor;
+  sample.positionOffset_ = command.positionOffset_ * positionFactor;
+  sample.targetVelocity_ = command.targetVelocity_ * velocityFactor;
+  sample.velocityOffset_ = command.velocityOffset_ * velocityFactor;
+  sample.targetTorque_ = command.targetTorque_ * torqueFactor;
+  sample.torqueOffset_ = command.torqueOffset_ * torqueFactor;
+
+  // same conversions as in Reading
+  sample.actualPosition_ = txPdo.actualPosition_ * positionFactor;
+  sample.actualVelocity_ = txPdo.actualVelocity_ * velocityFactor;
+  sample.demandVelocity_ = txPdo.demandVelocity_ * velocityFactor;
+  sample.actualCurrent_ =
+      txPdo.actualCurrent_ * factors.currentFactorIntegerToAmp_;
+  sample.actualTorque_ = txPdo.actualCurrent_ * torqueFactor;
+  sample.analogInput_ = 0.001 * txPdo.analogInput_;
+  sample.busVoltage_ = 0.1 * txPdo.busVoltage_;
+  sample.digitalInputs_ = txPdo.digitalInputs_;
+  return true;
+}
+
+void TelemetryDecoder::writeCsv(std::ostream& os) const {
+  os << "time,sequence_number,address,controlword,statusword,"
+        "mode_of_operation,target_position,position_offset,target_velocity,"
+        "velocity_offset,target_torque,torque_offset,actual_position,"
+        "actual_velocity,demand_velocity,actual_current,actual_torque,"
+        "analog_input,bus_voltage,digital_inputs\n";
+  os << std::setprecision(9);
+  TelemetrySample sample;
+  for (std::size_t i = 0; i < records_.size(); i++) {
+    if (!decode(i, sample)) {
+      continue;
+    }
+    os << 1e-9 * (sample.timeStamp_ - records_.front().timeStamp_) << ","
+       << sample.sequenceNumber_ << "," << sample.address_ << ","
+       << sample.controlword_ << "," << sample.statusword_ << ","
+       << static_cast<int>(sample.modeOfOperation_) << ","
+       << sample.targetPosition_ << "," << sample.positionOffset_ << ","
+       << sample.targetVelocity_ << "," << sample.velocityOffset_ << ","
+       << sample.targetTorque_ << "," << sample.torqueOffset_ << ","
+       << sample.actualPosition_ << "," << sample.actualVelocity_ << ","
+       << sample.demandVelocity_ << "," << sample.actualCurrent_ << ","
+       << sample.actualTorque_ << "," << sample.analogInput_ << ","
+       << sample.busVoltage_ << "," << sample.digitalInputs_ << "\n";
+  }
+}
+
+}  // namespace maxon
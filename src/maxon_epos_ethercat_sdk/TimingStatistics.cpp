@@ -0,0 +1,171 @@
+// clang-format off
+/*
+** Copyright 2021 Robotic Systems Lab - ETH Zurich:
+** Linghao Zhang, Jonas Junger, Lennart Nachtigall
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions are met:
+**
+** 1. Redistributions of source code must retain the above copyright notice,
+**    this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright notice,
+**    this list of conditions and the following disclaimer in the documentation
+**    and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its contributors
+**    may be used to endorse or promote products derived from this software without
+**    specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+** AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+** IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+** DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+** FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+** DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+** SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+** CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+** OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+// clang-format on
+
+#include "maxon_epos_ethercat_sdk/TimingStatistics.hpp"
+
+#include <iomanip>
+
+namespace maxon {
+constexpr unsigned int LatencyHistogram::subBucketBits_;
+constexpr unsigned int LatencyHistogram::subBucketCount_;
+constexpr unsigned int LatencyHistogram::maxExponent_;
+constexpr unsigned int LatencyHistogram::bucketCount_;
+
+uint64_t LatencyHistogram::getBucketLowerBound(unsigned int index) {
+  if (index < subBucketCount_) {
+    return index;
+  }
+  const unsigned int exponent = (index >> subBucketBits_) + subBucketBits_ - 1;
+  const uint64_t mantissa = index & (subBucketCount_ - 1);
+  return (subBucketCount_ + mantissa) << (exponent - subBucketBits_);
+}
+
+LatencyStatistics LatencyHistogram::getStatistics() const {
+  std::array<uint64_t, bucketCount_> buckets;
+  uint64_t count = 0;
+  for (unsigned int i = 0; i < bucketCount_; i++) {
+    buckets[i] = buckets_[i].load(std::memory_order_relaxed);
+    count += buckets[i];
+  }
+
+  LatencyStatistics statistics;
+  statistics.count_ = count;
+  if (count == 0) {
+    return statistics;
+  }
+  statistics.min_ = 1e-3 * min_.load(std::memory_order_relaxed);
+  statistics.max_ = 1e-3 * max_.load(std::memory_order_relaxed);
+  statistics.mean_ = 1e-3 * sum_.load(std::memory_order_relaxed) / count;
+
+  // the percentiles are reported as the lower bound of their bucket
+  const std::array<double, 4> quantiles{{0.5, 0.9, 0.99, 0.999}};
+  const std::array<double*, 4> percentiles{{&statistics.p50_, &statistics.p90_,
+                                            &statistics.p99_,
+                                            &statistics.p999_}};
+  uint64_t cumulativeCount = 0;
+  unsigned int quantileIndex = 0;
+  for (unsigned int i = 0; i < bucketCount_ && quantileIndex < 4; i++) {
+    cumulativeCount += buckets[i];
+    while (quantileIndex < 4 &&
+           cumulativeCount >= quantiles[quantileIndex] * count) {
+      *percentiles[quantileIndex] = 1e-3 * getBucketLowerBound(i);
+      quantileIndex++;
+    }
+  }
+  return statistics;
+}
+
+void LatencyHistogram::reset() {
+  for (auto& bucket : buckets_) {
+    bucket.store(0, std::memory_order_relaxed);
+  }
+  count_.store(0, std::memory_order_relaxed);
+  sum_.store(0, std::memory_order_relaxed);
+  min_.store(0, std::memory_order_relaxed);
+  max_.store(0, std::memory_order_relaxed);
+}
+
+namespace {
+void printLatencyStatistics(std::ostream& os, const std::string& name,
+                            const LatencyStatistics& statistics) {
+  os << std::setw(16) << name << std::setw(10) << statistics.count_
+     << std::setw(10) << statistics.min_ << std::setw(10) << statistics.mean_
+     << std::setw(10) << statistics.p50_ << std::setw(10) << statistics.p99_
+     << std::setw(10) << statistics.p999_ << std::setw(10) << statistics.max_
+     << "\n";
+}
+}  // namespace
+
+std::ostream& operator<<(std::ostream& os,
+                         const TimingStatistics& statistics) {
+  os << std::left << std::fixed << std::setprecision(1) << std::setw(16)
+     << "[us]" << std::setw(10) << "count" << std::setw(10) << "min"
+     << std::setw(10) << "mean" << std::setw(10) << "p50" << std::setw(10)
+     << "p99" << std::setw(10) << "p99.9" << std::setw(10) << "max"
+     << "\n";
+  printLatencyStatistics(os, "updateRead", statistics.updateRead_);
+  printLatencyStatistics(os, "updateWrite", statistics.updateWrite_);
+  printLatencyStatistics(os, "mutex wait", statistics.mutexWait_);
+  printLatencyStatistics(os, "cycle time", statistics.cycleTime_);
+  if (statistics.distributedClockCycleTime_.count_ > 0) {
+    printLatencyStatistics(os, "dc cycle time",
+                           statistics.distributedClockCycleTime_);
+    printLatencyStatistics(os, "dc jitter", statistics.distributedClockJitter_);
+  }
+  os << std::setw(16) << "missed cycles" << statistics.missedCycles_ << "\n"
+     << std::setw(16) << "stale readings" << statistics.staleReadings_ << "\n"
+     << std::right << std::defaultfloat;
+  return os;
+}
+
+std::ostream& operator<<(std::ostream& os,
+                         const StateTransitionStatistics& statistics) {
+  static const char* const transitionNames[numberOfStateTransitions] = {
+      "transition 2",  "transition 3",  "transition 4",  "transition 5",
+      "transition 6",  "transition 7",  "transition 8",  "transition 9",
+      "transition 10", "transition 11", "transition 12", "transition 15"};
+  os << std::left << std::fixed << std::setprecision(1) << std::setw(16)
+     << "[us]" << std::setw(10) << "count" << std::setw(10) << "min"
+     << std::setw(10) << "mean" << std::setw(10) << "p50" << std::setw(10)
+     << "p99" << std::setw(10) << "p99.9" << std::setw(10) << "max"
+     << "\n";
+  for (std::size_t i = 0; i < numberOfStateTransitions; i++) {
+    if (statistics.transitions_[i].count_ > 0) {
+      printLatencyStatistics(os, transitionNames[i],
+                             statistics.transitions_[i]);
+    }
+  }
+  printLatencyStatistics(os, "state change", statistics.stateChange_);
+  os << std::setw(16) << "repeated" << statistics.repeatedTransitions_ << "\n"
+     << std::right << std::defaultfloat;
+  return os;
+}
+
+std::ostream& operator<<(std::ostream& os, const BusStatistics& statistics) {
+  os << std::left << std::fixed << std::setprecision(1) << std::setw(16)
+     << "[us]" << std::setw(10) << "count" << std::setw(10) << "min"
+     << std::setw(10) << "mean" << std::setw(10) << "p50" << std::setw(10)
+     << "p99" << std::setw(10) << "p99.9" << std::setw(10) << "max"
+     << "\n";
+  printLatencyStatistics(os, "cycle duration", statistics.cycleDuration_);
+  printLatencyStatistics(os, "wakeup latency", statistics.wakeupLatency_);
+  os << std::setw(16) << "cycles" << statistics.cycles_ << "\n"
+     << std::setw(16) << "overruns" << statistics.overruns_ << "\n"
+     << std::setw(16) << "cpu" << statistics.cpu_ << "\n"
+     << std::setw(16) << "numa node" << statistics.numaNode_ << "\n"
+     << std::setw(16) << "realtime" << (statistics.realtime_ ? "yes" : "no")
+     << "\n"
+     << std::right << std::defaultfloat;
+  return os;
+}
+
+}  // namespace maxon
@@ -0,0 +1,802 @@
+// clang-format off
+/*
+** Copyright 2021 Robotic Systems Lab - ETH Zurich:
+** Linghao Zhang, Jonas Junger, Lennart Nachtigall
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions are met:
+**
+** 1. Redistributions of source code must retain the above copyright notice,
+**    this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright notice,
+**    this list of conditions and the following disclaimer in the documentation
+**    and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its contributors
+**    may be used to endorse or promote products derived from this software without
+**    specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+** AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+** IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+** DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+** FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+** DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+** SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+** CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+** OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+// clang-format on
+
+#include "maxon_epos_ethercat_sdk/VirtualEpos4.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <ethercat_sdk_master/EthercatDevice.hpp>
+#include <limits>
+#include <thread>
+
+#include "maxon_epos_ethercat_sdk/ModeOfOperationEnum.hpp"
+#include "maxon_epos_ethercat_sdk/ObjectDictionary.hpp"
+
+namespace maxon {
+namespace {
+// flags of an object
+constexpr uint8_t writable = 0x01;
+constexpr uint8_t rxPdo = 0x02;
+constexpr uint8_t txPdo = 0x04;
+constexpr uint8_t ro = 0x00;
+constexpr uint8_t rw = writable;
+
+struct ObjectDefinition {
+  uint16_t index_;
+  uint8_t subIndex_;
+  uint8_t size_;
+  uint8_t flags_;
+  int64_t defaultValue_;
+};
+
+// clang-format off
+const ObjectDefinition objectDefinitions[] = {
+    {OD_INDEX_ERROR_REGISTER, 0x00, 1, ro, 0},
+    {OD_INDEX_ERROR_HISTORY, 0x00, 1, rw, 0},
+    {OD_INDEX_ERROR_HISTORY, 0x01, 4, ro, 0},
+    {OD_INDEX_ERROR_HISTORY, 0x02, 4, ro, 0},
+    {OD_INDEX_ERROR_HISTORY, 0x03, 4, ro, 0},
+    {OD_INDEX_ERROR_HISTORY, 0x04, 4, ro, 0},
+    {OD_INDEX_ERROR_HISTORY, 0x05, 4, ro, 0},
+    {OD_INDEX_IDENTITY_OBJECT, 0x00, 1, ro, 4},
+    {OD_INDEX_IDENTITY_OBJECT, 0x01, 4, ro, 0x000000FB},
+    {OD_INDEX_IDENTITY_OBJECT, 0x02, 4, ro, 0x61500000},
+    {OD_INDEX_IDENTITY_OBJECT, 0x03, 4, ro, 0x01600000},
+    {OD_INDEX_IDENTITY_OBJECT, 0x04, 4, ro, 0},
+    {OD_INDEX_DIAGNOSIS, 0x01, 1, ro, 0},
+    {OD_INDEX_DIAGNOSIS, 0x02, 1, ro, 0},
+    {OD_INDEX_DIAGNOSIS, 0x04, 1, ro, 0},
+    {OD_INDEX_5VDC_SUPPLY, 0x01, 2, ro | txPdo, 5000},
+    {OD_INDEX_MOTOR_DATA, 0x01, 4, rw, 1000},
+    {OD_INDEX_MOTOR_DATA, 0x02, 4, rw, 2000},
+    {OD_INDEX_MOTOR_DATA, 0x05, 4, rw, 30000},
+    {OD_INDEX_GEAR_DATA, 0x03, 4, rw, 10000},
+    {OD_INDEX_CURRENT_CONTROL_PARAM, 0x01, 4, rw, 0},
+    {OD_INDEX_CURRENT_CONTROL_PARAM, 0x02, 4, rw, 0},
+    {OD_INDEX_POSITION_CONTROL_PARAM, 0x01, 4, rw, 0},
+    {OD_INDEX_POSITION_CONTROL_PARAM, 0x02, 4, rw, 0},
+    {OD_INDEX_POSITION_CONTROL_PARAM, 0x03, 4, rw, 0},
+    {OD_INDEX_POSITION_CONTROL_PARAM, 0x04, 4, rw, 0},
+    {OD_INDEX_POSITION_CONTROL_PARAM, 0x05, 4, rw, 0},
+    {OD_INDEX_VELOCITY_CONTROL_PARAM, 0x01, 4, rw, 0},
+    {OD_INDEX_VELOCITY_CONTROL_PARAM, 0x02, 4, rw, 0},
+    {OD_INDEX_VELOCITY_CONTROL_PARAM, 0x03, 4, rw, 0},
+    {OD_INDEX_VELOCITY_CONTROL_PARAM, 0x04, 4, rw, 0},
+    {OD_INDEX_CURRENT_ACTUAL, 0x01, 4, ro | txPdo, 0},
+    {OD_INDEX_CURRENT_ACTUAL, 0x02, 4, ro | txPdo, 0},
+    {OD_INDEX_ANALOG_INPUTS, 0x01, 2, ro | txPdo, 0},
+    {OD_INDEX_ERROR_CODE, 0x00, 2, ro | txPdo, 0},
+    {OD_INDEX_ABORT_CONNECTION_OPTION_CODE, 0x00, 2, rw, 1},
+    {OD_INDEX_CONTROLWORD, 0x00, 2, rw | rxPdo, 0},
+    {OD_INDEX_STATUSWORD, 0x00, 2, ro | txPdo, 0},
+    {OD_INDEX_QUICKSTOP_OPTION_CODE, 0x00, 2, rw, 6},
+    {OD_INDEX_SHUTDOWN_OPTION_CODE, 0x00, 2, rw, 0},
+    {OD_INDEX_DISABLE_OPERATION_OPTION_CODE, 0x00, 2, rw, 1},
+    {OD_INDEX_FAULT_REACTION_OPTION_CODE, 0x00, 2, rw, 2},
+    {OD_INDEX_MODES_OF_OPERATION, 0x00, 1, rw | rxPdo, 0},
+    {OD_INDEX_MODES_OF_OPERATION_DISPLAY, 0x00, 1, ro | txPdo, 0},
+    {OD_INDEX_POSITION_ACTUAL, 0x00, 4, ro | txPdo, 0},
+    {OD_INDEX_FOLLOW_ERROR_WINDOW, 0x00, 4, rw, 2000},
+    {OD_INDEX_VELOCITY_DEMAND, 0x00, 4, ro | txPdo, 0},
+    {OD_INDEX_VELOCITY_ACTUAL, 0x00, 4, ro | txPdo, 0},
+    {OD_INDEX_TARGET_TORQUE, 0x00, 2, rw | rxPdo, 0},
+    {OD_INDEX_MOTOR_RATED_TORQUE, 0x00, 4, rw, 0},
+    {OD_INDEX_TORQUE_ACTUAL, 0x00, 2, ro | txPdo, 0},
+    {OD_INDEX_TARGET_POSITION, 0x00, 4, rw | rxPdo, 0},
+    {OD_INDEX_POSITION_RANGE_LIMIT, 0x01, 4, rw, 0},
+    {OD_INDEX_POSITION_RANGE_LIMIT, 0x02, 4, rw, 0},
+    {OD_INDEX_SOFTWARE_POSITION_LIMIT, 0x01, 4, rw, 0},
+    {OD_INDEX_SOFTWARE_POSITION_LIMIT, 0x02, 4, rw, 0},
+    {OD_INDEX_MAX_PROFILE_VELOCITY, 0x00, 4, rw, 0},
+    {OD_INDEX_MAX_MOTOR_SPEED, 0x00, 4, rw, 0},
+    {OD_INDEX_PROFILE_VELOCITY, 0x00, 4, rw | rxPdo, 0},
+    {OD_INDEX_PROFILE_ACCELERATION, 0x00, 4, rw | rxPdo, 10000},
+    {OD_INDEX_PROFILE_DECELERATION, 0x00, 4, rw | rxPdo, 10000},
+    {OD_INDEX_QUICKSTOP_DECELERATION, 0x00, 4, rw, 10000},
+    {OD_INDEX_MOTION_PROFILE_TYPE, 0x00, 2, rw | rxPdo, 0},
+    {OD_INDEX_SI_UNIT_VELOCITY, 0x00, 4, rw, 0x00B44700},
+    {OD_INDEX_OFFSET_POSITION, 0x00, 4, rw | rxPdo, 0},
+    {OD_INDEX_OFFSET_VELOCITY, 0x00, 4, rw | rxPdo, 0},
+    {OD_INDEX_OFFSET_TORQUE, 0x00, 2, rw | rxPdo, 0},
+    {OD_INDEX_INTERPOLATION_TIME_PERIOD, 0x01, 1, rw, 1},
+    {OD_INDEX_INTERPOLATION_TIME_PERIOD, 0x02, 1, rw, -3},
+    {OD_INDEX_MAX_ACCELERATION, 0x00, 4, rw, 0},
+    {OD_INDEX_DIGITAL_INPUTS, 0x00, 4, ro | txPdo, 0},
+    {OD_INDEX_TARGET_VELOCITY, 0x00, 4, rw | rxPdo, 0},
+};
+// clang-format on
+
+constexpr uint8_t numberOfPdoMappingEntries = 8;
+constexpr uint8_t numberOfPdoAssignmentEntries = 4;
+constexpr uint16_t numberOfPdoMappings = 4;
+
+bool isPdoMapping(uint16_t index) {
+  return (index >= OD_INDEX_RX_PDO_MAPPING_1 &&
+          index < OD_INDEX_RX_PDO_MAPPING_1 + numberOfPdoMappings) ||
+         (index >= OD_INDEX_TX_PDO_MAPPING_1 &&
+          index < OD_INDEX_TX_PDO_MAPPING_1 + numberOfPdoMappings);
+}
+
+bool isPdoAssignment(uint16_t index) {
+  return index == OD_INDEX_RX_PDO_ASSIGNMENT ||
+         index == OD_INDEX_TX_PDO_ASSIGNMENT;
+}
+
+template <typename Value>
+Value getValue(const void* data) {
+  Value value;
+  std::memcpy(&value, data, sizeof(Value));
+  return value;
+}
+
+template <typename Value>
+void setValue(void* data, Value value) {
+  std::memcpy(data, &value, sizeof(Value));
+}
+
+template <typename Value>
+Value saturate(double value) {
+  const double min = std::numeric_limits<Value>::min();
+  const double max = std::numeric_limits<Value>::max();
+  return static_cast<Value>(std::round(std::min(std::max(value, min), max)));
+}
+
+// the bits of the statusword which encode the drive state, without the
+// voltage enabled and remote bits
+uint16_t getDriveStateBits(DriveState driveState) {
+  switch (driveState) {
+    case DriveState::SwitchOnDisabled:
+      return 0x0040;
+    case DriveState::ReadyToSwitchOn:
+      return 0x0021;
+    case DriveState::SwitchedOn:
+      return 0x0023;
+    case DriveState::OperationEnabled:
+      return 0x0027;
+    case DriveState::QuickStopActive:
+      return 0x0007;
+    case DriveState::FaultReactionActive:
+      return 0x000F;
+    case DriveState::Fault:
+      return 0x0008;
+    default:
+      return 0x0000;
+  }
+}
+
+// move a value towards a target by at most the given step
+double ramp(double value, double target, double step) {
+  if (step <= 0.0) {
+    return target;
+  }
+  if (value < target) {
+    return std::min(value + step, target);
+  }
+  return std::max(value - step, target);
+}
+}  // namespace
+
+VirtualEpos4::VirtualEpos4(uint16_t address,
+                           const VirtualEpos4Parameters& parameters)
+    : address_(address),
+      parameters_(parameters),
+      ethercatState_(EC_STATE_PRE_OP) {
+  for (const auto& definition : objectDefinitions) {
+    Object object{};
+    object.size_ = definition.size_;
+    object.flags_ = definition.flags_;
+    std::memcpy(object.data_, &definition.defaultValue_, object.size_);
+    objects_[getKey(definition.index_, definition.subIndex_)] = object;
+  }
+  for (uint16_t i = 0; i < numberOfPdoMappings; i++) {
+    for (const uint16_t index :
+         {static_cast<uint16_t>(OD_INDEX_RX_PDO_MAPPING_1 + i),
+          static_cast<uint16_t>(OD_INDEX_TX_PDO_MAPPING_1 + i)}) {
+      objects_[getKey(index, 0)] = Object{{}, 1, rw};
+      for (uint8_t subIndex = 1; subIndex <= numberOfPdoMappingEntries;
+           subIndex++) {
+        objects_[getKey(index, subIndex)] = Object{{}, 4, rw};
+      }
+    }
+  }
+  for (const uint16_t index :
+       {OD_INDEX_RX_PDO_ASSIGNMENT, OD_INDEX_TX_PDO_ASSIGNMENT}) {
+    objects_[getKey(index, 0)] = Object{{}, 1, rw};
+    for (uint8_t subIndex = 1; subIndex <= numberOfPdoAssignmentEntries;
+         subIndex++) {
+      objects_[getKey(index, subIndex)] = Object{{}, 2, rw};
+    }
+  }
+  const uint32_t serialNumber = parameters_.serialNumber_ != 0
+                                    ? parameters_.serialNumber_
+                                    : 0x56450000u + address_;
+  setValue(findObject(OD_INDEX_IDENTITY_OBJECT, 0x04)->data_, serialNumber);
+
+  controlword_ = findObject(OD_INDEX_CONTROLWORD, 0x00);
+  statusword_ = findObject(OD_INDEX_STATUSWORD, 0x00);
+  modesOfOperation_ = findObject(OD_INDEX_MODES_OF_OPERATION, 0x00);
+  modesOfOperationDisplay_ =
+      findObject(OD_INDEX_MODES_OF_OPERATION_DISPLAY, 0x00);
+  errorCode_ = findObject(OD_INDEX_ERROR_CODE, 0x00);
+  errorRegister_ = findObject(OD_INDEX_ERROR_REGISTER, 0x00);
+  targetPosition_ = findObject(OD_INDEX_TARGET_POSITION, 0x00);
+  targetVelocity_ = findObject(OD_INDEX_TARGET_VELOCITY, 0x00);
+  targetTorque_ = findObject(OD_INDEX_TARGET_TORQUE, 0x00);
+  positionOffset_ = findObject(OD_INDEX_OFFSET_POSITION, 0x00);
+  velocityOffset_ = findObject(OD_INDEX_OFFSET_VELOCITY, 0x00);
+  torqueOffset_ = findObject(OD_INDEX_OFFSET_TORQUE, 0x00);
+  profileAcceleration_ = findObject(OD_INDEX_PROFILE_ACCELERATION, 0x00);
+  profileDeceleration_ = findObject(OD_INDEX_PROFILE_DECELERATION, 0x00);
+  quickStopDeceleration_ = findObject(OD_INDEX_QUICKSTOP_DECELERATION, 0x00);
+  quickStopOptionCode_ = findObject(OD_INDEX_QUICKSTOP_OPTION_CODE, 0x00);
+  positionActual_ = findObject(OD_INDEX_POSITION_ACTUAL, 0x00);
+  velocityActual_ = findObject(OD_INDEX_VELOCITY_ACTUAL, 0x00);
+  velocityDemand_ = findObject(OD_INDEX_VELOCITY_DEMAND, 0x00);
+  torqueActual_ = findObject(OD_INDEX_TORQUE_ACTUAL, 0x00);
+  currentActual_ = findObject(OD_INDEX_CURRENT_ACTUAL, 0x02);
+  nominalCurrent_ = findObject(OD_INDEX_MOTOR_DATA, 0x01);
+  updateStatusword();
+}
+
+bool VirtualEpos4::sdoRead(uint16_t index, uint8_t subIndex,
+                           bool completeAccess, void* value,
+                           std::size_t size) {
+  if (parameters_.sdoLatency_ > 0.0) {
+    // not holding mutex_, the cyclic update goes on during the transfer
+    std::this_thread::sleep_for(
+        std::chrono::duration<double>(parameters_.sdoLatency_));
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  numberOfSdoReads_++;
+  if (ethercatState_ == EC_STATE_INIT) {
+    return false;
+  }
+  if (completeAccess) {
+    return readCompleteAccess(index, static_cast<uint8_t*>(value), size);
+  }
+  return readObject(index, subIndex, value, size);
+}
+
+bool VirtualEpos4::sdoWrite(uint16_t index, uint8_t subIndex,
+                            bool completeAccess, const void* value,
+                            std::size_t size) {
+  if (parameters_.sdoLatency_ > 0.0) {
+    std::this_thread::sleep_for(
+        std::chrono::duration<double>(parameters_.sdoLatency_));
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  numberOfSdoWrites_++;
+  if (ethercatState_ == EC_STATE_INIT) {
+    return false;
+  }
+  if (completeAccess) {
+    return writeCompleteAccess(index, static_cast<const uint8_t*>(value),
+                               size);
+  }
+  return writeObject(index, subIndex, value, size);
+}
+
+void VirtualEpos4::setEthercatState(uint16_t state) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  ethercatState_ = state;
+}
+
+uint16_t VirtualEpos4::getEthercatState() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return ethercatState_;
+}
+
+void VirtualEpos4::update(double timeStep) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (ethercatState_ == EC_STATE_OPERATIONAL) {
+    for (const auto& binding : rxPdoBindings_) {
+      std::memcpy(binding.object_->data_, rxPdo_.data() + binding.offset_,
+                  binding.size_);
+    }
+  }
+  time_ += timeStep;
+  evaluateControlword();
+  updateMotor(timeStep);
+  updateStatusword();
+  if (ethercatState_ == EC_STATE_SAFE_OP ||
+      ethercatState_ == EC_STATE_OPERATIONAL) {
+    for (const auto& binding : txPdoBindings_) {
+      std::memcpy(txPdo_.data() + binding.offset_, binding.object_->data_,
+                  binding.size_);
+    }
+  }
+}
+
+std::size_t VirtualEpos4::getRxPdoSize() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return rxPdoSize_;
+}
+
+std::size_t VirtualEpos4::getTxPdoSize() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return txPdoSize_;
+}
+
+void VirtualEpos4::injectFault(uint16_t errorCode) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  setValue(errorCode_->data_, errorCode);
+  setValue(errorRegister_->data_, static_cast<uint8_t>(0x01));
+  // the newest error is subindex 1
+  Object* numberOfErrors = findObject(OD_INDEX_ERROR_HISTORY, 0x00);
+  for (uint8_t subIndex = 5; subIndex > 1; subIndex--) {
+    std::memcpy(findObject(OD_INDEX_ERROR_HISTORY, subIndex)->data_,
+                findObject(OD_INDEX_ERROR_HISTORY, subIndex - 1)->data_, 4);
+  }
+  setValue(findObject(OD_INDEX_ERROR_HISTORY, 0x01)->data_,
+           static_cast<uint32_t>(errorCode));
+  setValue(numberOfErrors->data_,
+           static_cast<uint8_t>(std::min(
+               getValue<uint8_t>(numberOfErrors->data_) + 1, 5)));
+  enterDriveState(DriveState::Fault);
+  updateStatusword();
+}
+
+DriveState VirtualEpos4::getDriveState() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return driveState_;
+}
+
+uint16_t VirtualEpos4::getStatusword() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return getValue<uint16_t>(statusword_->data_);
+}
+
+double VirtualEpos4::getPosition() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return position_;
+}
+
+double VirtualEpos4::getVelocity() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return velocity_;
+}
+
+double VirtualEpos4::getTorque() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return torque_;
+}
+
+double VirtualEpos4::getTime() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return time_;
+}
+
+uint64_t VirtualEpos4::getNumberOfSdoReads() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return numberOfSdoReads_;
+}
+
+uint64_t VirtualEpos4::getNumberOfSdoWrites() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return numberOfSdoWrites_;
+}
+
+VirtualEpos4::Object* VirtualEpos4::findObject(uint16_t index,
+                                               uint8_t subIndex) {
+  auto it = objects_.find(getKey(index, subIndex));
+  return it != objects_.end() ? &it->second : nullptr;
+}
+
+bool VirtualEpos4::readObject(uint16_t index, uint8_t subIndex, void* value,
+                              std::size_t size) {
+  const Object* object = findObject(index, subIndex);
+  if (object == nullptr || size < object->size_) {
+    return false;
+  }
+  std::memset(value, 0, size);
+  std::memcpy(value, object->data_, object->size_);
+  return true;
+}
+
+bool VirtualEpos4::writeObject(uint16_t index, uint8_t subIndex,
+                               const void* value, std::size_t size) {
+  Object* object = findObject(index, subIndex);
+  if (object == nullptr || (object->flags_ & writable) == 0 ||
+      size != object->size_) {
+    return false;
+  }
+  // the entries of a mapping (resp. assignment) can only be changed while
+  // it is disabled
+  if ((isPdoMapping(index) || isPdoAssignment(index)) && subIndex != 0 &&
+      getValue<uint8_t>(findObject(index, 0x00)->data_) != 0) {
+    return false;
+  }
+  if (index == OD_INDEX_ERROR_HISTORY && getValue<uint8_t>(value) != 0) {
+    return false;
+  }
+
+  const Object previous = *object;
+  std::memcpy(object->data_, value, size);
+  if ((isPdoMapping(index) || isPdoAssignment(index)) && subIndex == 0) {
+    std::vector<PdoBinding> bindings;
+    std::size_t pdoSize = 0;
+    // a new mapping is validated even if it is not assigned
+    const uint8_t pdoFlag = index < OD_INDEX_TX_PDO_MAPPING_1 ? rxPdo : txPdo;
+    if ((isPdoMapping(index) &&
+         !bindPdoMapping(index, pdoFlag, bindings, pdoSize)) ||
+        !bindPdoAssignments()) {
+      *object = previous;
+      bindPdoAssignments();
+      return false;
+    }
+  } else if (index == OD_INDEX_CONTROLWORD) {
+    evaluateControlword();
+    updateStatusword();
+  } else if (index == OD_INDEX_ERROR_HISTORY) {
+    for (uint8_t i = 1; i <= 5; i++) {
+      setValue(findObject(OD_INDEX_ERROR_HISTORY, i)->data_, uint32_t{0});
+    }
+  }
+  return true;
+}
+
+bool VirtualEpos4::readCompleteAccess(uint16_t index, uint8_t* value,
+                                      std::size_t size) {
+  // subindex 0 is padded to 16 bit, followed by all other subindices
+  const Object* numberOfEntries = findObject(index, 0x00);
+  if (numberOfEntries == nullptr || size < 2) {
+    return false;
+  }
+  std::memset(value, 0, size);
+  value[0] = numberOfEntries->data_[0];
+  std::size_t offset = 2;
+  for (auto it = objects_.upper_bound(getKey(index, 0x00));
+       it != objects_.end() && (it->first >> 8) == index && offset < size;
+       ++it) {
+    const std::size_t length =
+        std::min<std::size_t>(it->second.size_, size - offset);
+    std::memcpy(value + offset, it->second.data_, length);
+    offset += length;
+  }
+  return true;
+}
+
+bool VirtualEpos4::writeCompleteAccess(uint16_t index, const uint8_t* value,
+                                       std::size_t size) {
+  Object* numberOfEntries = findObject(index, 0x00);
+  if (numberOfEntries == nullptr ||
+      (numberOfEntries->flags_ & writable) == 0 || size < 2) {
+    return false;
+  }
+  // the entries are written while subindex 0 is 0, it is written last such
+  // that it validates the new entries
+  std::vector<std::pair<Object*, Object>> previous{
+      {numberOfEntries, *numberOfEntries}};
+  numberOfEntries->data_[0] = 0;
+  std::size_t offset = 2;
+  bool success = true;
+  for (auto it = objects_.upper_bound(getKey(index, 0x00));
+       it != objects_.end() && (it->first >> 8) == index && offset < size;
+       ++it) {
+    Object& object = it->second;
+    if ((object.flags_ & writable) == 0 || size - offset < object.size_) {
+      success = false;
+      break;
+    }
+    previous.emplace_back(&object, object);
+    std::memcpy(object.data_, value + offset, object.size_);
+    offset += object.size_;
+  }
+  success = success && offset == size &&
+            writeObject(index, 0x00, value, numberOfEntries->size_);
+  if (!success) {
+    for (const auto& object : previous) {
+      *object.first = object.second;
+    }
+    bindPdoAssignments();
+  }
+  return success;
+}
+
+bool VirtualEpos4::bindPdoMapping(uint16_t mappingIndex, uint8_t pdoFlag,
+                                  std::vector<PdoBinding>& bindings,
+                                  std::size_t& size) {
+  const uint8_t numberOfObjects =
+      getValue<uint8_t>(findObject(mappingIndex, 0x00)->data_);
+  if (numberOfObjects > numberOfPdoMappingEntries) {
+    return false;
+  }
+  for (uint8_t subIndex = 1; subIndex <= numberOfObjects; subIndex++) {
+    const uint32_t entry =
+        getValue<uint32_t>(findObject(mappingIndex, subIndex)->data_);
+    Object* object = findObject(static_cast<uint16_t>(entry >> 16),
+                                static_cast<uint8_t>(entry >> 8));
+    if (object == nullptr || (object->flags_ & pdoFlag) == 0 ||
+        (entry & 0xFF) != 8u * object->size_ ||
+        size + object->size_ > maxCustomPdoSize) {
+      return false;
+    }
+    bindings.push_back({static_cast<uint16_t>(size), object->size_, object});
+    size += object->size_;
+  }
+  return true;
+}
+
+bool VirtualEpos4::bindPdoAssignments() {
+  bool success = true;
+  success &= bindPdoAssignment(OD_INDEX_RX_PDO_ASSIGNMENT);
+  success &= bindPdoAssignment(OD_INDEX_TX_PDO_ASSIGNMENT);
+  return success;
+}
+
+bool VirtualEpos4::bindPdoAssignment(uint16_t assignmentIndex) {
+  const bool rx = assignmentIndex == OD_INDEX_RX_PDO_ASSIGNMENT;
+  const uint16_t firstMappingIndex =
+      rx ? OD_INDEX_RX_PDO_MAPPING_1 : OD_INDEX_TX_PDO_MAPPING_1;
+  const uint8_t numberOfMappings =
+      getValue<uint8_t>(findObject(assignmentIndex, 0x00)->data_);
+  if (numberOfMappings > numberOfPdoAssignmentEntries) {
+    return false;
+  }
+  std::vector<PdoBinding> bindings;
+  std::size_t size = 0;
+  for (uint8_t subIndex = 1; subIndex <= numberOfMappings; subIndex++) {
+    const uint16_t mappingIndex =
+        getValue<uint16_t>(findObject(assignmentIndex, subIndex)->data_);
+    if (mappingIndex < firstMappingIndex ||
+        mappingIndex >= firstMappingIndex + numberOfPdoMappings ||
+        !bindPdoMapping(mappingIndex, rx ? rxPdo : txPdo, bindings, size)) {
+      return false;
+    }
+  }
+  if (rx) {
+    rxPdoBindings_ = std::move(bindings);
+    rxPdoSize_ = size;
+    rxPdo_.fill(0);
+  } else {
+    txPdoBindings_ = std::move(bindings);
+    txPdoSize_ = size;
+    txPdo_.fill(0);
+  }
+  return true;
+}
+
+/*!
+ * CiA-402 device control, the transitions are numbered like in
+ * StateTransition.
+ */
+void VirtualEpos4::evaluateControlword() {
+  const uint16_t controlword = getValue<uint16_t>(controlword_->data_);
+  const bool faultReset =
+      (controlword & 0x0080) != 0 && (lastControlword_ & 0x0080) == 0;
+  lastControlword_ = controlword;
+  const bool switchOn = (controlword & 0x0001) != 0;
+  const bool enableVoltage = (controlword & 0x0002) != 0;
+  // quick stop is active low
+  const bool quickStop = (controlword & 0x0004) == 0;
+  const bool enableOperation = (controlword & 0x0008) != 0;
+  const int16_t quickStopOptionCode =
+      getValue<int16_t>(quickStopOptionCode_->data_);
+
+  // "switch on" and "enable operation" may be combined in one controlword
+  for (int step = 0; step < 3; step++) {
+    const DriveState driveState = driveState_;
+    switch (driveState_) {
+      case DriveState::SwitchOnDisabled:
+        if (enableVoltage && !quickStop && !switchOn) {
+          enterDriveState(DriveState::ReadyToSwitchOn);  // 2
+        }
+        break;
+      case DriveState::ReadyToSwitchOn:
+        if (!enableVoltage || quickStop) {
+          enterDriveState(DriveState::SwitchOnDisabled);  // 7
+        } else if (switchOn) {
+          enterDriveState(DriveState::SwitchedOn);  // 3
+        }
+        break;
+      case DriveState::SwitchedOn:
+        if (!enableVoltage || quickStop) {
+          enterDriveState(DriveState::SwitchOnDisabled);  // 10
+        } else if (!switchOn) {
+          enterDriveState(DriveState::ReadyToSwitchOn);  // 6
+        } else if (enableOperation) {
+          // 4, the power stage takes enableTime_ to get ready
+          if (!enablePending_) {
+            enablePending_ = true;
+            enableTimePoint_ = time_ + parameters_.enableTime_;
+          }
+          if (time_ >= enableTimePoint_) {
+            enterDriveState(DriveState::OperationEnabled);
+          }
+        } else {
+          enablePending_ = false;
+        }
+        break;
+      case DriveState::OperationEnabled:
+        if (!enableVoltage) {
+          enterDriveState(DriveState::SwitchOnDisabled);  // 9
+        } else if (quickStop) {
+          enterDriveState(DriveState::QuickStopActive);  // 11
+        } else if (!switchOn) {
+          enterDriveState(DriveState::ReadyToSwitchOn);  // 8
+        } else if (!enableOperation) {
+          enterDriveState(DriveState::SwitchedOn);  // 5
+        }
+        break;
+      case DriveState::QuickStopActive:
+        if (!enableVoltage) {
+          enterDriveState(DriveState::SwitchOnDisabled);  // 12
+        } else if (quickStopOptionCode <= 2 && velocity_ == 0.0) {
+          // the option codes 0..2 disable the drive after the stop
+          enterDriveState(DriveState::SwitchOnDisabled);  // 12
+        } else if (quickStopOptionCode >= 5 && !quickStop && switchOn &&
+                   enableOperation) {
+          enterDriveState(DriveState::OperationEnabled);  // 16
+        }
+        break;
+      case DriveState::Fault:
+        if (faultReset) {
+          // 15
+          setValue(errorCode_->data_, uint16_t{0});
+          setValue(errorRegister_->data_, uint8_t{0});
+          enterDriveState(DriveState::SwitchOnDisabled);
+        }
+        break;
+      default:
+        break;
+    }
+    if (driveState_ == driveState) {
+      break;
+    }
+  }
+}
+
+void VirtualEpos4::enterDriveState(DriveState driveState) {
+  enablePending_ = false;
+  if (driveState == DriveState::QuickStopActive &&
+      getValue<int16_t>(quickStopOptionCode_->data_) == 0) {
+    // option code 0 disables the drive and lets the motor coast
+    velocity_ = 0.0;
+    driveState = DriveState::SwitchOnDisabled;
+  }
+  if (driveState == DriveState::Fault) {
+    velocity_ = 0.0;
+    torque_ = 0.0;
+  }
+  driveState_ = driveState;
+}
+
+void VirtualEpos4::updateMotor(double timeStep) {
+  const auto modeOfOperation =
+      getValue<ModeOfOperationEnum>(modesOfOperation_->data_);
+  setValue(modesOfOperationDisplay_->data_, modeOfOperation);
+  const double rpmToIncrementsPerSecond =
+      parameters_.incrementsPerRevolution_ / 60.0;
+  const double tracking =
+      parameters_.trackingTimeConstant_ > 0.0
+          ? 1.0 - std::exp(-timeStep / parameters_.trackingTimeConstant_)
+          : 1.0;
+  double velocityDemand = 0.0;
+
+  if (driveState_ == DriveState::OperationEnabled && timeStep > 0.0) {
+    switch (modeOfOperation) {
+      case ModeOfOperationEnum::CyclicSynchronousPositionMode: {
+        const double target =
+            static_cast<double>(getValue<int32_t>(targetPosition_->data_)) +
+            getValue<int32_t>(positionOffset_->data_);
+        const double position = position_ + (target - position_) * tracking;
+        velocity_ =
+            (position - position_) / timeStep / rpmToIncrementsPerSecond;
+        position_ = position;
+        torque_ = getValue<int16_t>(torqueOffset_->data_);
+        velocityDemand = velocity_;
+        break;
+      }
+      case ModeOfOperationEnum::CyclicSynchronousVelocityMode:
+        velocityDemand =
+            (static_cast<double>(getValue<int32_t>(targetVelocity_->data_)) +
+             getValue<int32_t>(velocityOffset_->data_)) /
+            parameters_.velocityUnitsPerRpm_;
+        velocity_ += (velocityDemand - velocity_) * tracking;
+        torque_ = getValue<int16_t>(torqueOffset_->data_);
+        break;
+      case ModeOfOperationEnum::CyclicSynchronousTorqueMode:
+        torque_ = static_cast<double>(getValue<int16_t>(targetTorque_->data_)) +
+                  getValue<int16_t>(torqueOffset_->data_);
+        velocity_ += (torque_ * parameters_.accelerationPerTorque_ -
+                      parameters_.damping_ * velocity_) *
+                     timeStep;
+        velocityDemand = velocity_;
+        break;
+      case ModeOfOperationEnum::ProfiledVelocityMode: {
+        velocityDemand =
+            getValue<int32_t>(targetVelocity_->data_) /
+            parameters_.velocityUnitsPerRpm_;
+        // accelerate away from (resp. decelerate towards) standstill
+        const bool accelerating =
+            std::abs(velocityDemand) > std::abs(velocity_);
+        const Object* acceleration =
+            accelerating ? profileAcceleration_ : profileDeceleration_;
+        velocity_ = ramp(velocity_, velocityDemand,
+                         getValue<uint32_t>(acceleration->data_) * timeStep);
+        torque_ = 0.0;
+        break;
+      }
+      default:
+        // the other modes hold the position
+        velocity_ = 0.0;
+        torque_ = 0.0;
+        break;
+    }
+  } else if (driveState_ == DriveState::QuickStopActive) {
+    velocity_ = ramp(
+        velocity_, 0.0,
+        getValue<uint32_t>(quickStopDeceleration_->data_) * timeStep);
+    torque_ = 0.0;
+  } else {
+    velocity_ = 0.0;
+    torque_ = 0.0;
+  }
+  if (modeOfOperation != ModeOfOperationEnum::CyclicSynchronousPositionMode ||
+      driveState_ != DriveState::OperationEnabled) {
+    position_ += velocity_ * rpmToIncrementsPerSecond * timeStep;
+  }
+
+  setValue(positionActual_->data_,
+           static_cast<int32_t>(static_cast<int64_t>(std::round(position_))));
+  setValue(velocityActual_->data_,
+           saturate<int32_t>(velocity_ * parameters_.velocityUnitsPerRpm_));
+  setValue(
+      velocityDemand_->data_,
+      saturate<int32_t>(velocityDemand * parameters_.velocityUnitsPerRpm_));
+  setValue(torqueActual_->data_, saturate<int16_t>(torque_));
+  setValue(currentActual_->data_,
+           saturate<int32_t>(torque_ / 1000.0 *
+                             getValue<uint32_t>(nominalCurrent_->data_)));
+}
+
+void VirtualEpos4::updateStatusword() {
+  uint16_t statusword = getDriveStateBits(driveState_);
+  // remote
+  statusword |= 0x0200;
+  if (driveState_ == DriveState::ReadyToSwitchOn ||
+      driveState_ == DriveState::SwitchedOn ||
+      driveState_ == DriveState::OperationEnabled ||
+      driveState_ == DriveState::QuickStopActive) {
+    // voltage enabled
+    statusword |= 0x0010;
+  }
+  if (driveState_ == DriveState::QuickStopActive && velocity_ == 0.0) {
+    // target reached
+    statusword |= 0x0400;
+  }
+  setValue(statusword_->data_, statusword);
+}
+
+}  // namespace maxon
@@ -0,0 +1,138 @@
+// clang-format off
+/*
+** Copyright 2021 Robotic Systems Lab - ETH Zurich:
+** Linghao Zhang, Jonas Junger, Lennart Nachtigall
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions are met:
+**
+** 1. Redistributions of source code must retain the above copyright notice,
+**    this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright notice,
+**    this list of conditions and the following disclaimer in the documentation
+**    and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its contributors
+**    may be used to endorse or promote products derived from this software without
+**    specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+** AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+** IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+** DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+** FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+** DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+** SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+** CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+** OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+// clang-format on
+
+#include "maxon_epos_ethercat_sdk/VirtualEpos4Bus.hpp"
+
+#include "maxon_epos_ethercat_sdk/Maxon.hpp"
+
+namespace maxon {
+VirtualEpos4Bus::VirtualEpos4Bus(const std::string& name)
+    : soem_interface::EthercatBusBase(name),
+      drivesByAddress_(maxNumberOfDrives + 1) {}
+
+VirtualEpos4* VirtualEpos4Bus::addDrive(
+    uint16_t address, const VirtualEpos4Parameters& parameters) {
+  if (address == 0 || address > maxNumberOfDrives ||
+      drivesByAddress_[address] != nullptr) {
+    MELO_ERROR_STREAM(
+        "[maxon_epos_ethercat_sdk:VirtualEpos4Bus::addDrive] Address "
+        << address << " is invalid or already taken.");
+    return nullptr;
+  }
+  drivesByAddress_[address].reset(new VirtualEpos4(address, parameters));
+  VirtualEpos4* drive = drivesByAddress_[address].get();
+  drives_.push_back(drive);
+  ecatContext_.slavelist[address].outputs = drive->getRxPdo();
+  ecatContext_.slavelist[address].inputs = drive->getTxPdo();
+  updateProcessImage(*drive);
+  if (*ecatContext_.slavecount < address) {
+    *ecatContext_.slavecount = address;
+  }
+  return drive;
+}
+
+VirtualEpos4* VirtualEpos4Bus::attach(
+    Maxon& drive, const VirtualEpos4Parameters& parameters) {
+  VirtualEpos4* virtualDrive =
+      addDrive(static_cast<uint16_t>(drive.getAddress()), parameters);
+  if (virtualDrive != nullptr) {
+    drive.setEthercatBusBasePointer(this);
+    drive.setSlaveBackend(this);
+  }
+  return virtualDrive;
+}
+
+VirtualEpos4* VirtualEpos4Bus::getDrive(uint16_t address) const {
+  return address < drivesByAddress_.size() ? drivesByAddress_[address].get()
+                                           : nullptr;
+}
+
+void VirtualEpos4Bus::update(double timeStep) {
+  for (VirtualEpos4* drive : drives_) {
+    drive->update(timeStep);
+  }
+}
+
+bool VirtualEpos4Bus::sdoRead(uint16_t address, uint16_t index,
+                              uint8_t subIndex, bool completeAccess,
+                              void* value, std::size_t size) {
+  VirtualEpos4* drive = getDrive(address);
+  return drive != nullptr &&
+         drive->sdoRead(index, subIndex, completeAccess, value, size);
+}
+
+bool VirtualEpos4Bus::sdoWrite(uint16_t address, uint16_t index,
+                               uint8_t subIndex, bool completeAccess,
+                               const void* value, std::size_t size) {
+  VirtualEpos4* drive = getDrive(address);
+  if (drive == nullptr) {
+    return false;
+  }
+  const bool success =
+      drive->sdoWrite(index, subIndex, completeAccess, value, size);
+  updateProcessImage(*drive);
+  return success;
+}
+
+void VirtualEpos4Bus::setState(uint16_t state, uint16_t address) {
+  if (address == 0) {
+    for (VirtualEpos4* drive : drives_) {
+      drive->setEthercatState(state);
+    }
+  } else if (VirtualEpos4* drive = getDrive(address)) {
+    drive->setEthercatState(state);
+  }
+}
+
+bool VirtualEpos4Bus::waitForState(uint16_t state, uint16_t address,
+                                   unsigned int /*maxRetries*/,
+                                   double /*retrySleep*/) {
+  // the state changes immediately, there is nothing to wait for
+  if (address == 0) {
+    for (const VirtualEpos4* drive : drives_) {
+      if (drive->getEthercatState() != state) {
+        return false;
+      }
+    }
+    return true;
+  }
+  const VirtualEpos4* drive = getDrive(address);
+  return drive != nullptr && drive->getEthercatState() == state;
+}
+
+void VirtualEpos4Bus::updateProcessImage(const VirtualEpos4& drive) {
+  auto& slave = ecatContext_.slavelist[drive.getAddress()];
+  slave.Obytes = static_cast<uint32_t>(drive.getRxPdoSize());
+  slave.Ibytes = static_cast<uint32_t>(drive.getTxPdoSize());
+}
+
+}  // namespace maxon
@@ -0,0 +1,172 @@
+// clang-format off
+/*
+** Copyright 2021 Robotic Systems Lab - ETH Zurich:
+** Linghao Zhang, Jonas Junger, Lennart Nachtigall
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions are met:
+**
+** 1. Redistributions of source code must retain the above copyright notice,
+**    this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright notice,
+**    this list of conditions and the following disclaimer in the documentation
+**    and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its contributors
+**    may be used to endorse or promote products derived from this software without
+**    specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+** AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+** IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+** DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+** FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+** DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+** SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+** CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+** OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+// clang-format on
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+
+#include "VirtualDriveTest.hpp"
+#include "maxon_epos_ethercat_sdk/LimitGuard.hpp"
+
+namespace maxon {
+namespace test {
+namespace {
+ReadingSnapshot getSnapshot(int32_t position, int32_t velocity,
+                            int32_t current) {
+  ReadingSnapshot snapshot;
+  snapshot.actualPosition_ = position;
+  snapshot.actualVelocity_ = velocity;
+  snapshot.actualCurrent_ = current;
+  snapshot.sequenceNumber_ = 7;
+  return snapshot;
+}
+}  // namespace
+
+class LimitGuardTest : public ::testing::Test {
+ protected:
+  LimitGuardTest() {
+    configuration_.useLimitGuard = true;
+    configuration_.limitGuardMargin = 0.0;
+    configuration_.minPosition = -1000;
+    configuration_.maxPosition = 1000;
+    configuration_.maxProfileVelocity = 1.0;
+    configuration_.maxCurrentA = 1.0;
+    conversionFactors_.currentFactorAToInteger_ = 1000.0;
+  }
+
+  Configuration configuration_;
+  ConversionFactors conversionFactors_;
+  LimitGuard limitGuard_;
+};
+
+TEST_F(LimitGuardTest, IsDisabledByDefault) {
+  configuration_.useLimitGuard = false;
+  limitGuard_.configure(configuration_, conversionFactors_);
+  LimitViolation violation;
+  EXPECT_FALSE(limitGuard_.isEnabled());
+  EXPECT_FALSE(limitGuard_.check(getSnapshot(5000, 0, 0), violation));
+}
+
+TEST_F(LimitGuardTest, TripsOnEveryQuantity) {
+  limitGuard_.configure(configuration_, conversionFactors_);
+  const int32_t maxVelocity = static_cast<int32_t>(
+      std::llround(ConversionFactors::velocityFactorRadPerSecToMicroRPM_));
+  LimitViolation violation;
+  EXPECT_FALSE(
+      limitGuard_.check(getSnapshot(1000, maxVelocity, -1000), violation));
+
+  ASSERT_TRUE(limitGuard_.check(getSnapshot(-1001, 0, 0), violation));
+  EXPECT_EQ(violation.quantity_, LimitQuantity::Position);
+  EXPECT_EQ(violation.value_, -1001);
+  EXPECT_EQ(violation.limit_, -1000);
+  EXPECT_EQ(violation.sequenceNumber_, 7u);
+
+  ASSERT_TRUE(
+      limitGuard_.check(getSnapshot(0, -maxVelocity - 2, 0), violation));
+  EXPECT_EQ(violation.quantity_, LimitQuantity::Velocity);
+  EXPECT_EQ(violation.limit_, maxVelocity);
+
+  ASSERT_TRUE(limitGuard_.check(getSnapshot(0, 0, 1001), violation));
+  EXPECT_EQ(violation.quantity_, LimitQuantity::Current);
+  EXPECT_EQ(violation.limit_, 1000);
+}
+
+TEST_F(LimitGuardTest, MarginWidensVelocityAndCurrent) {
+  configuration_.limitGuardMargin = 0.1;
+  limitGuard_.configure(configuration_, conversionFactors_);
+  LimitViolation violation;
+  EXPECT_FALSE(limitGuard_.check(getSnapshot(0, 0, 1099), violation));
+  EXPECT_TRUE(limitGuard_.check(getSnapshot(0, 0, 1101), violation));
+  // the position bounds are not widened
+  EXPECT_TRUE(limitGuard_.check(getSnapshot(1001, 0, 0), violation));
+}
+
+TEST_F(LimitGuardTest, ReleaseToleratesThePositionUntilBackInBounds) {
+  limitGuard_.configure(configuration_, conversionFactors_);
+  LimitViolation violation;
+  ASSERT_TRUE(limitGuard_.check(getSnapshot(1500, 0, 0), violation));
+  limitGuard_.release();
+  EXPECT_FALSE(limitGuard_.check(getSnapshot(1500, 0, 0), violation));
+  EXPECT_FALSE(limitGuard_.check(getSnapshot(500, 0, 0), violation));
+  EXPECT_TRUE(limitGuard_.check(getSnapshot(1500, 0, 0), violation));
+}
+
+TEST_F(VirtualDriveTest, LimitGuardStopsTheDrive) {
+  Configuration configuration = getConfiguration();
+  configuration.useLimitGuard = true;
+  configuration.minPosition = -1000;
+  configuration.maxPosition = 1000;
+  auto drive = addDrive(1, configuration);
+  ASSERT_TRUE(startup());
+  auto subscription = drive->subscribeReadingEvents(
+      readingEventMask(ReadingEventType::LimitViolation));
+  ASSERT_TRUE(setDriveState(DriveState::OperationEnabled));
+
+  // move beyond max_position at 10 rad/s
+  double targetPosition = 0.0;
+  for (int i = 0; i < 2000 && !drive->isLimitGuardTripped(); i++) {
+    targetPosition += 0.01;
+    drive->stageCsp(targetPosition);
+    cycle();
+  }
+  ASSERT_TRUE(drive->isLimitGuardTripped());
+  const LimitViolation violation = drive->getLimitViolation();
+  EXPECT_EQ(violation.quantity_, LimitQuantity::Position);
+  EXPECT_GT(violation.value_, 1000);
+  EXPECT_EQ(violation.limit_, 1000);
+
+  // the next updateWrite() writes the quick stop
+  cycle();
+  EXPECT_EQ(bus_.getDrive(1)->getDriveState(), DriveState::QuickStopActive);
+  ReadingEvent event;
+  ASSERT_TRUE(subscription->tryPop(event));
+  EXPECT_EQ(event.type_, ReadingEventType::LimitViolation);
+  EXPECT_EQ(event.index_,
+            static_cast<std::size_t>(LimitQuantity::Position));
+  EXPECT_EQ(event.value_, violation.value_);
+
+  // a tripped guard blocks state changes until it is reset
+  auto future = drive->setDriveStateViaPdoAsync(DriveState::OperationEnabled);
+  ASSERT_TRUE(cycleUntilReady(future));
+  EXPECT_FALSE(future.get());
+  EXPECT_EQ(bus_.getDrive(1)->getDriveState(), DriveState::QuickStopActive);
+
+  drive->resetLimitGuard();
+  Reading reading;
+  drive->getReading(reading);
+  drive->stageCsp(reading.getActualPosition());
+  ASSERT_TRUE(setDriveState(DriveState::OperationEnabled));
+  EXPECT_FALSE(drive->isLimitGuardTripped());
+}
+
+}  // namespace test
+}  // namespace maxon
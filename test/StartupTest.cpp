@@ -0,0 +1,94 @@
+// clang-format off
+/*
+** Copyright 2021 Robotic Systems Lab - ETH Zurich:
+** Linghao Zhang, Jonas Junger, Lennart Nachtigall
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions are met:
+**
+** 1. Redistributions of source code must retain the above copyright notice,
+**    this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright notice,
+**    this list of conditions and the following disclaimer in the documentation
+**    and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its contributors
+**    may be used to endorse or promote products derived from this software without
+**    specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+** AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+** IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+** DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+** FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+** DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+** SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+** CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+** OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+// clang-format on
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+
+#include "VirtualDriveTest.hpp"
+
+namespace maxon {
+namespace test {
+TEST_F(VirtualDriveTest, StartupConfiguresTheDrive) {
+  auto drive = addDrive(1);
+  ASSERT_TRUE(Maxon::startupDrives(drives_));
+  VirtualEpos4* virtualDrive = bus_.getDrive(1);
+  EXPECT_GT(virtualDrive->getNumberOfSdoWrites(), 0u);
+  EXPECT_EQ(virtualDrive->getEthercatState(), EC_STATE_PRE_OP);
+  EXPECT_EQ(virtualDrive->getDriveState(), DriveState::SwitchOnDisabled);
+
+  // the process image follows the PDOs which startup() mapped
+  const BusPlan busPlan = Maxon::planBus(drives_);
+  EXPECT_EQ(virtualDrive->getRxPdoSize(), busPlan.rxSize_);
+  EXPECT_EQ(virtualDrive->getTxPdoSize(), busPlan.txSize_);
+
+  EXPECT_TRUE(
+      std::isfinite(drive->getConversionFactors().torqueFactorNmToInteger_));
+
+  ASSERT_TRUE(drive->putIntoOperation());
+  EXPECT_EQ(virtualDrive->getEthercatState(), EC_STATE_OPERATIONAL);
+}
+
+TEST_F(VirtualDriveTest, StartupOfSeveralDrivesRunsConcurrently) {
+  constexpr uint16_t numberOfDrives = 4;
+  for (uint16_t address = 1; address <= numberOfDrives; address++) {
+    addDrive(address);
+  }
+  ASSERT_TRUE(startup());
+  for (uint16_t address = 1; address <= numberOfDrives; address++) {
+    EXPECT_GT(bus_.getDrive(address)->getNumberOfSdoWrites(), 0u);
+    EXPECT_EQ(bus_.getDrive(address)->getEthercatState(),
+              EC_STATE_OPERATIONAL);
+  }
+
+  // the next startup() only returns the result of the concurrent one
+  const uint64_t numberOfSdoWrites = bus_.getDrive(1)->getNumberOfSdoWrites();
+  EXPECT_TRUE(drives_.front()->startup());
+  EXPECT_EQ(bus_.getDrive(1)->getNumberOfSdoWrites(), numberOfSdoWrites);
+}
+
+TEST_F(VirtualDriveTest, StartedDriveFollowsTheStagedPosition) {
+  auto drive = addDrive(1);
+  ASSERT_TRUE(startup());
+  ASSERT_TRUE(setDriveState(DriveState::OperationEnabled));
+
+  ASSERT_TRUE(drive->stageCsp(1.0));
+  for (int i = 0; i < 100; i++) {
+    cycle();
+  }
+  Reading reading;
+  drive->getReading(reading);
+  EXPECT_NEAR(reading.getActualPosition(), 1.0, 1e-2);
+}
+
+}  // namespace test
+}  // namespace maxon
@@ -0,0 +1,215 @@
+// clang-format off
+/*
+** Copyright 2021 Robotic Systems Lab - ETH Zurich:
+** Linghao Zhang, Jonas Junger, Lennart Nachtigall
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions are met:
+**
+** 1. Redistributions of source code must retain the above copyright notice,
+**    this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright notice,
+**    this list of conditions and the following disclaimer in the documentation
+**    and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its contributors
+**    may be used to endorse or promote products derived from this software without
+**    specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+** AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+** IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+** DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+** FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+** DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+** SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+** CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+** OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+// clang-format on
+
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <vector>
+
+#include "VirtualDriveTest.hpp"
+#include "maxon_epos_ethercat_sdk/Controlword.hpp"
+#include "maxon_epos_ethercat_sdk/StateTransitionTable.hpp"
+
+namespace maxon {
+namespace test {
+namespace {
+DriveState getDriveState(std::size_t index) {
+  return static_cast<DriveState>(index);
+}
+
+Controlword getControlword(StateTransition transition) {
+  Controlword controlword;
+  switch (transition) {
+    case StateTransition::_2:
+      controlword.setStateTransition2();
+      break;
+    case StateTransition::_3:
+      controlword.setStateTransition3();
+      break;
+    case StateTransition::_4:
+      controlword.setStateTransition4();
+      break;
+    case StateTransition::_5:
+      controlword.setStateTransition5();
+      break;
+    case StateTransition::_6:
+      controlword.setStateTransition6();
+      break;
+    case StateTransition::_7:
+      controlword.setStateTransition7();
+      break;
+    case StateTransition::_8:
+      controlword.setStateTransition8();
+      break;
+    case StateTransition::_9:
+      controlword.setStateTransition9();
+      break;
+    case StateTransition::_10:
+      controlword.setStateTransition10();
+      break;
+    case StateTransition::_11:
+      controlword.setStateTransition11();
+      break;
+    case StateTransition::_12:
+      controlword.setStateTransition12();
+      break;
+    case StateTransition::_15:
+      controlword.setStateTransition15();
+      break;
+  }
+  return controlword;
+}
+}  // namespace
+
+TEST(StateTransitionTable, ControlwordsMatchControlword) {
+  for (std::size_t i = 0; i < numberOfStateTransitions; i++) {
+    const auto transition = static_cast<StateTransition>(i);
+    EXPECT_EQ(getStateTransitionControlword(transition),
+              getControlword(transition).getRawControlword())
+        << "transition index " << i;
+  }
+}
+
+TEST(StateTransitionTable, StepsReachEveryRequestableState) {
+  const std::vector<DriveState> targets = {
+      DriveState::SwitchOnDisabled, DriveState::ReadyToSwitchOn,
+      DriveState::SwitchedOn, DriveState::OperationEnabled,
+      DriveState::QuickStopActive};
+  const std::vector<DriveState> starts = {
+      DriveState::SwitchOnDisabled, DriveState::ReadyToSwitchOn,
+      DriveState::SwitchedOn,       DriveState::OperationEnabled,
+      DriveState::QuickStopActive,  DriveState::Fault};
+  for (const DriveState target : targets) {
+    for (const DriveState start : starts) {
+      DriveState state = start;
+      std::size_t numberOfSteps = 0;
+      StateTransitionStep step = getStateTransitionStep(target, state);
+      while (step.type_ == StateTransitionStepType::Transition &&
+             numberOfSteps < numberOfDriveStates) {
+        EXPECT_EQ(step.controlword_,
+                  getStateTransitionControlword(step.transition_));
+        state = step.nextDriveState_;
+        step = getStateTransitionStep(target, state);
+        numberOfSteps++;
+      }
+      EXPECT_EQ(step.type_, StateTransitionStepType::TargetReached)
+          << "from " << static_cast<int>(start) << " to "
+          << static_cast<int>(target);
+      EXPECT_EQ(state, target) << "from " << static_cast<int>(start) << " to "
+          << static_cast<int>(target);
+    }
+  }
+}
+
+TEST(StateTransitionTable, OnlyRequestableStatesAreImplemented) {
+  const std::vector<DriveState> targets = {DriveState::NotReadyToSwitchOn,
+                                           DriveState::FaultReactionActive,
+                                           DriveState::Fault, DriveState::NA};
+  for (const DriveState target : targets) {
+    for (std::size_t current = 0; current < numberOfDriveStates; current++) {
+      EXPECT_EQ(getStateTransitionStep(target, getDriveState(current)).type_,
+                StateTransitionStepType::NotImplemented)
+          << "to " << static_cast<int>(target);
+    }
+  }
+  // the drive leaves these states on its own
+  EXPECT_EQ(getStateTransitionStep(DriveState::OperationEnabled,
+                                   DriveState::FaultReactionActive)
+                .type_,
+            StateTransitionStepType::NotImplemented);
+}
+
+TEST_F(VirtualDriveTest, PdoStateChangesFollowTheTable) {
+  auto drive = addDrive(1);
+  ASSERT_TRUE(startup());
+  VirtualEpos4* virtualDrive = bus_.getDrive(1);
+  ASSERT_EQ(virtualDrive->getDriveState(), DriveState::SwitchOnDisabled);
+
+  // record every drive state the virtual drive passes on its way
+  auto future = drive->setDriveStateViaPdoAsync(DriveState::OperationEnabled);
+  std::vector<DriveState> driveStates = {virtualDrive->getDriveState()};
+  for (int i = 0; i < 5000 && future.wait_for(std::chrono::seconds(0)) !=
+                                  std::future_status::ready;
+       i++) {
+    cycle();
+    if (virtualDrive->getDriveState() != driveStates.back()) {
+      driveStates.push_back(virtualDrive->getDriveState());
+    }
+  }
+  ASSERT_TRUE(future.get());
+  const std::vector<DriveState> expectedDriveStates = {
+      DriveState::SwitchOnDisabled, DriveState::ReadyToSwitchOn,
+      DriveState::SwitchedOn, DriveState::OperationEnabled};
+  EXPECT_EQ(driveStates, expectedDriveStates);
+
+  const StateTransitionStatistics statistics =
+      drive->getStateTransitionStatistics();
+  for (const StateTransition transition :
+       {StateTransition::_2, StateTransition::_3, StateTransition::_4}) {
+    EXPECT_EQ(
+        statistics.transitions_[static_cast<std::size_t>(transition)].count_,
+        1u);
+  }
+  EXPECT_EQ(statistics.stateChange_.count_, 1u);
+
+  // transition 9 disables the voltage directly
+  ASSERT_TRUE(setDriveState(DriveState::SwitchOnDisabled));
+  EXPECT_EQ(virtualDrive->getDriveState(), DriveState::SwitchOnDisabled);
+  EXPECT_EQ(drive->getStateTransitionStatistics()
+                .transitions_[static_cast<std::size_t>(StateTransition::_9)]
+                .count_,
+            1u);
+}
+
+TEST_F(VirtualDriveTest, FaultIsResetByTransition15) {
+  auto drive = addDrive(1);
+  ASSERT_TRUE(startup());
+  ASSERT_TRUE(setDriveState(DriveState::OperationEnabled));
+
+  VirtualEpos4* virtualDrive = bus_.getDrive(1);
+  virtualDrive->injectFault(0x7320);
+  for (int i = 0; i < 10; i++) {
+    cycle();
+  }
+  EXPECT_EQ(drive->getReadingSnapshot().decodedStatusword_.driveState_,
+            DriveState::Fault);
+
+  ASSERT_TRUE(setDriveState(DriveState::SwitchOnDisabled));
+  EXPECT_EQ(virtualDrive->getDriveState(), DriveState::SwitchOnDisabled);
+  EXPECT_EQ(drive->getStateTransitionStatistics()
+                .transitions_[static_cast<std::size_t>(StateTransition::_15)]
+                .count_,
+            1u);
+}
+
+}  // namespace test
+}  // namespace maxon
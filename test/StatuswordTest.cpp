@@ -0,0 +1,118 @@
+// clang-format off
+/*
+** Copyright 2021 Robotic Systems Lab - ETH Zurich:
+** Linghao Zhang, Jonas Junger, Lennart Nachtigall
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions are met:
+**
+** 1. Redistributions of source code must retain the above copyright notice,
+**    this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright notice,
+**    this list of conditions and the following disclaimer in the documentation
+**    and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its contributors
+**    may be used to endorse or promote products derived from this software without
+**    specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+** AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+** IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+** DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+** FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+** DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+** SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+** CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+** OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+// clang-format on
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+
+#include "VirtualDriveTest.hpp"
+#include "maxon_epos_ethercat_sdk/Statusword.hpp"
+
+namespace maxon {
+namespace test {
+TEST(Statusword, LookupMatchesTheDecodingOfEveryStatusword) {
+  for (uint32_t value = 0; value <= 0xFFFF; value++) {
+    const auto statusword = static_cast<uint16_t>(value);
+    Statusword decodedStatusword;
+    decodedStatusword.setFromRawStatusword(statusword);
+    ASSERT_EQ(getDriveStateFromStatusword(statusword),
+              state_transition_table::decodeDriveState(statusword))
+        << "statusword " << value;
+    ASSERT_EQ(getDriveStateFromStatusword(statusword),
+              decodedStatusword.getDriveState())
+        << "statusword " << value;
+  }
+}
+
+TEST(Statusword, DecodesTheDriveStates) {
+  EXPECT_EQ(getDriveStateFromStatusword(0x0000),
+            DriveState::NotReadyToSwitchOn);
+  EXPECT_EQ(getDriveStateFromStatusword(0x0040), DriveState::SwitchOnDisabled);
+  EXPECT_EQ(getDriveStateFromStatusword(0x0021), DriveState::ReadyToSwitchOn);
+  EXPECT_EQ(getDriveStateFromStatusword(0x0023), DriveState::SwitchedOn);
+  EXPECT_EQ(getDriveStateFromStatusword(0x0637), DriveState::OperationEnabled);
+  EXPECT_EQ(getDriveStateFromStatusword(0x0007), DriveState::QuickStopActive);
+  EXPECT_EQ(getDriveStateFromStatusword(0x000F),
+            DriveState::FaultReactionActive);
+  EXPECT_EQ(getDriveStateFromStatusword(0x0008), DriveState::Fault);
+  EXPECT_EQ(getDriveStateFromStatusword(0x0001), DriveState::NA);
+}
+
+TEST(Statusword, DecodesTheEdges) {
+  const uint16_t operationEnabled = 0x0237;
+  const DecodedStatusword rising = decodeStatusword(
+      operationEnabled | statusword_bits::targetReached, operationEnabled);
+  EXPECT_EQ(rising.driveState_, DriveState::OperationEnabled);
+  EXPECT_TRUE(rising.rose(statusword_bits::targetReached));
+  EXPECT_FALSE(rising.fell(statusword_bits::targetReached));
+  EXPECT_FALSE(rising.rose(statusword_bits::fault));
+
+  const DecodedStatusword falling = decodeStatusword(
+      operationEnabled, operationEnabled | statusword_bits::warning);
+  EXPECT_TRUE(falling.fell(statusword_bits::warning));
+  EXPECT_EQ(falling.rising_, 0u);
+
+  // bits which do not have edges, e.g. the state bits, are ignored
+  const DecodedStatusword unchanged = decodeStatusword(0x0040, 0x0237);
+  EXPECT_EQ(unchanged.rising_, 0u);
+  EXPECT_EQ(unchanged.falling_, 0u);
+}
+
+TEST_F(VirtualDriveTest, SnapshotsHoldTheDecodedStatusword) {
+  auto drive = addDrive(1);
+  ASSERT_TRUE(startup());
+  ASSERT_TRUE(setDriveState(DriveState::OperationEnabled));
+  VirtualEpos4* virtualDrive = bus_.getDrive(1);
+
+  ReadingSnapshot snapshot;
+  drive->getReadingSnapshot(snapshot);
+  EXPECT_EQ(snapshot.statusword_, virtualDrive->getStatusword());
+  EXPECT_EQ(snapshot.decodedStatusword_.driveState_,
+            DriveState::OperationEnabled);
+
+  // the fault edge is only set in the snapshot of the first faulty statusword
+  virtualDrive->injectFault(0x7320);
+  cycle();
+  drive->getReadingSnapshot(snapshot);
+  EXPECT_EQ(snapshot.decodedStatusword_.driveState_, DriveState::Fault);
+  EXPECT_TRUE(snapshot.decodedStatusword_.rose(statusword_bits::fault));
+  cycle();
+  drive->getReadingSnapshot(snapshot);
+  EXPECT_FALSE(snapshot.decodedStatusword_.rose(statusword_bits::fault));
+
+  Reading reading;
+  drive->getReading(reading);
+  EXPECT_EQ(reading.getDecodedStatusword().driveState_, DriveState::Fault);
+}
+
+}  // namespace test
+}  // namespace maxon
@@ -0,0 +1,134 @@
+// clang-format off
+/*
+** Copyright 2021 Robotic Systems Lab - ETH Zurich:
+** Linghao Zhang, Jonas Junger, Lennart Nachtigall
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions are met:
+**
+** 1. Redistributions of source code must retain the above copyright notice,
+**    this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright notice,
+**    this list of conditions and the following disclaimer in the documentation
+**    and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its contributors
+**    may be used to endorse or promote products derived from this software without
+**    specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+** AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+** IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+** DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+** FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+** DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+** SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+** CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+** OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+// clang-format on
+
+#pragma once
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cstdint>
+#include <future>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "maxon_epos_ethercat_sdk/Maxon.hpp"
+#include "maxon_epos_ethercat_sdk/VirtualEpos4Bus.hpp"
+
+namespace maxon {
+namespace test {
+constexpr double timeStep = 0.001;
+
+/*!
+ * Drives on a VirtualEpos4Bus, configured from the example configuration.
+ * cycle() runs the cyclic update of all drives like an EtherCAT thread.
+ */
+class VirtualDriveTest : public ::testing::Test {
+ protected:
+  VirtualDriveTest() { parameters_.enableTime_ = 0.005; }
+
+  void TearDown() override {
+    for (const auto& drive : drives_) {
+      drive->shutdown();
+    }
+  }
+
+  // call before addDrive() to change the configuration, e.g. the limits
+  static Configuration getConfiguration() {
+    Maxon drive("configuration", 0);
+    EXPECT_TRUE(drive.loadConfigFile(MAXON_EPOS_ETHERCAT_SDK_TEST_CONFIG));
+    return drive.getConfiguration();
+  }
+
+  Maxon::SharedPtr addDrive(uint16_t address) {
+    return addDrive(address, getConfiguration());
+  }
+
+  Maxon::SharedPtr addDrive(uint16_t address,
+                            const Configuration& configuration) {
+    auto drive = std::make_shared<Maxon>("drive" + std::to_string(address),
+                                         address);
+    EXPECT_TRUE(drive->loadConfiguration(configuration));
+    drive->setTimeStep(timeStep);
+    EXPECT_NE(bus_.attach(*drive, parameters_), nullptr);
+    drives_.push_back(drive);
+    return drive;
+  }
+
+  // start all drives and bring them to EtherCAT OP
+  bool startup() {
+    bool success = Maxon::startupDrives(drives_);
+    for (const auto& drive : drives_) {
+      success &= drive->putIntoOperation();
+    }
+    return success;
+  }
+
+  // the state machine times out in wall clock time, hence the sleep
+  void cycle() {
+    for (const auto& drive : drives_) {
+      drive->updateWrite();
+    }
+    bus_.update(timeStep);
+    for (const auto& drive : drives_) {
+      drive->updateRead();
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+
+  // cycle until the future is ready, false if it is not within maxCycles
+  template <typename Result>
+  bool cycleUntilReady(std::future<Result>& future,
+                       unsigned int maxCycles = 5000) {
+    for (unsigned int i = 0; i < maxCycles; i++) {
+      if (future.wait_for(std::chrono::seconds(0)) ==
+          std::future_status::ready) {
+        return true;
+      }
+      cycle();
+    }
+    return false;
+  }
+
+  // request the drive state of all drives via PDO and cycle until it is set
+  bool setDriveState(DriveState driveState) {
+    auto future = Maxon::setDriveStatesViaPdoAsync(drives_, driveState);
+    return cycleUntilReady(future) && future.get();
+  }
+
+  VirtualEpos4Parameters parameters_;
+  VirtualEpos4Bus bus_;
+  std::vector<Maxon::SharedPtr> drives_;
+};
+
+}  // namespace test
+}  // namespace maxon